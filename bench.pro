@@ -7,6 +7,7 @@ DEPENDPATH += ext/googletest/src \
 INCLUDEPATH += src \
                ext/googletest \
                ext/googletest/include \
+               src/Tests \
                utils/bench
 #DEFINES += QT_NO_DEBUG_OUTPUT
 #DEFINES += QT_NO_WARNING_OUTPUT
@@ -33,9 +34,24 @@ HEADERS += ext/googletest/include/gtest/gtest-death-test.h \
            ext/googletest/include/gtest/internal/gtest-string.h \
            ext/googletest/include/gtest/internal/gtest-tuple.h \
            ext/googletest/include/gtest/internal/gtest-type-util.h \
-           utils/bench/Benchmark.hpp
+           src/Tests/MockEdgeHandler.hpp \
+           src/Tests/RpcTest.hpp \
+           src/Tests/TestNode.hpp \
+           utils/bench/Benchmark.hpp \
+           utils/bench/EdgeBench.hpp \
+           utils/bench/SimulationBench.hpp \
+           utils/bench/TunnelBench.hpp
 
 SOURCES += ext/googletest/src/gtest-all.cc \
+           src/Tests/TestNode.cpp \
            utils/bench/MainBench.cpp\
+           utils/bench/ArenaBench.cpp\
+           utils/bench/BlogDropRoundBench.cpp\
+           utils/bench/EdgeBench.cpp\
            utils/bench/Exp.cpp\
-           utils/bench/MicroLength.cpp
+           utils/bench/HashBench.cpp\
+           utils/bench/MicroLength.cpp\
+           utils/bench/SimulationBench.cpp\
+           utils/bench/TimerBench.cpp\
+           utils/bench/TunnelBench.cpp\
+           utils/bench/XorBench.cpp
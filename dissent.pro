@@ -12,6 +12,17 @@ QMAKE_CXX = g++-4.6
 
 # Dissent Wire protocol version
 DEFINES += "VERSION=3"
+
+# Compile-time log filtering: "debug" keeps all messages, "warning" removes
+# qDebug, and "critical" also removes qWarning.  Removed messages cost
+# nothing, their arguments are never evaluated.
+LOG_LEVEL = debug
+contains(LOG_LEVEL, warning) {
+  DEFINES += QT_NO_DEBUG_OUTPUT
+}
+contains(LOG_LEVEL, critical) {
+  DEFINES += QT_NO_DEBUG_OUTPUT QT_NO_WARNING_OUTPUT
+}
 QMAKE_CXXFLAGS += -Werror
 QMAKE_CFLAGS += -Werror
 
@@ -65,6 +76,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Applications/ConsoleSink.hpp \
            src/Applications/FileSink.hpp \
            src/Applications/Node.hpp \
+           src/Applications/NodeThread.hpp \
            src/Applications/SessionFactory.hpp \
            src/Applications/Settings.hpp \
            src/ClientServer/CSBroadcast.hpp \
@@ -89,6 +101,8 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Connections/RelayEdgeListener.hpp \
            src/Connections/RelayForwarder.hpp \
            src/Crypto/AsymmetricKey.hpp \
+           src/Crypto/Blake2bHash.hpp \
+           src/Crypto/CppCtrRandom.hpp \
            src/Crypto/CppDiffieHellman.hpp \
            src/Crypto/CppDsaPrivateKey.hpp \
            src/Crypto/CppDsaPublicKey.hpp \
@@ -103,6 +117,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Crypto/DiffieHellman.hpp \
            src/Crypto/NullDiffieHellman.hpp \
            src/Crypto/Hash.hpp \
+           src/Crypto/Hmac.hpp \
            src/Crypto/Integer.hpp \
            src/Crypto/IntegerData.hpp \
            src/Crypto/KeyShare.hpp \
@@ -115,6 +130,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Crypto/NullPrivateKey.hpp \
            src/Crypto/Library.hpp \
            src/Crypto/OnionEncryptor.hpp \
+           src/Crypto/OpenBnContext.hpp \
            src/Crypto/OpenIntegerData.hpp \
            src/Crypto/OpenLibrary.hpp \
            src/Crypto/ThreadedOnionEncryptor.hpp \
@@ -130,8 +146,10 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Crypto/AbstractGroup/ECParams.hpp \
            src/Crypto/AbstractGroup/Element.hpp \
            src/Crypto/AbstractGroup/ElementData.hpp \
+           src/Crypto/AbstractGroup/FixedBase.hpp \
            src/Crypto/AbstractGroup/IntegerElementData.hpp \
            src/Crypto/AbstractGroup/IntegerGroup.hpp \
+           src/Crypto/AbstractGroup/MultiExponentiation.hpp \
            src/Crypto/AbstractGroup/OpenECElementData.hpp \
            src/Crypto/AbstractGroup/OpenECGroup.hpp \
            src/Crypto/AbstractGroup/PairingElementData.hpp \
@@ -146,6 +164,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Crypto/BlogDrop/ChangingGenServerCiphertext.hpp \
            src/Crypto/BlogDrop/CiphertextFactory.hpp \
            src/Crypto/BlogDrop/ClientCiphertext.hpp \
+           src/Crypto/BlogDrop/ClientCiphertextPool.hpp \
            src/Crypto/BlogDrop/ElGamalClientCiphertext.hpp \
            src/Crypto/BlogDrop/ElGamalServerCiphertext.hpp \
            src/Crypto/BlogDrop/HashingGenClientCiphertext.hpp \
@@ -179,6 +198,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/LRS/SigmaProof.hpp \
            src/Messaging/BufferSink.hpp \
            src/Messaging/DummySink.hpp \
+           src/Messaging/Envelope.hpp \
            src/Messaging/Filter.hpp \
            src/Messaging/FilterObject.hpp \
            src/Messaging/GetDataCallback.hpp \
@@ -209,6 +229,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Transports/BufferAddress.hpp \
            src/Transports/BufferEdge.hpp \
            src/Transports/BufferEdgeListener.hpp \
+           src/Transports/BufferLinkModel.hpp \
            src/Transports/Edge.hpp \
            src/Transports/EdgeFactory.hpp \
            src/Transports/EdgeListener.hpp \
@@ -216,24 +237,32 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Transports/TcpAddress.hpp \
            src/Transports/TcpEdge.hpp \
            src/Transports/TcpEdgeListener.hpp \
+           src/Tunnel/DnsCache.hpp \
+           src/Tunnel/DownstreamScheduler.hpp \
            src/Tunnel/EntryTunnel.hpp \
            src/Tunnel/ExitTunnel.hpp \
            src/Tunnel/SocksConnection.hpp \
            src/Tunnel/SocksHostAddress.hpp \
+           src/Tunnel/TcpConnectionPool.hpp \
            src/Tunnel/TunnelConnectionTable.hpp \
            src/Tunnel/Packets/Packet.hpp \
            src/Tunnel/Packets/FinishPacket.hpp \
+           src/Tunnel/Packets/KeyAgreementPacket.hpp \
+           src/Tunnel/Packets/TcpAckPacket.hpp \
            src/Tunnel/Packets/TcpRequestPacket.hpp \
            src/Tunnel/Packets/UdpRequestPacket.hpp \
            src/Tunnel/Packets/TcpResponsePacket.hpp \
            src/Tunnel/Packets/UdpResponsePacket.hpp \
            src/Tunnel/Packets/TcpStartPacket.hpp \
            src/Tunnel/Packets/UdpStartPacket.hpp \
+           src/Utils/Arena.hpp \
            src/Utils/Logging.hpp \
+           src/Utils/Metrics.hpp \
            src/Utils/Random.hpp \
            src/Utils/QRunTimeError.hpp \
            src/Utils/Serialization.hpp \
            src/Utils/SignalCounter.hpp \
+           src/Utils/SimulatedCpu.hpp \
            src/Utils/Sleeper.hpp \
            src/Utils/StartStop.hpp \
            src/Utils/StartStopSlots.hpp \
@@ -241,9 +270,11 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Utils/Timer.hpp \
            src/Utils/TimerCallback.hpp \
            src/Utils/TimerEvent.hpp \
+           src/Utils/TimerWheel.hpp \
            src/Utils/Triggerable.hpp \
            src/Utils/Triple.hpp \
            src/Utils/Utils.hpp \
+           src/Utils/Xor.hpp \
            src/Web/HttpRequest.hpp \
            src/Web/HttpResponse.hpp \
            src/Web/WebRequest.hpp \
@@ -253,6 +284,7 @@ HEADERS += ext/joyent-http-parser/http_parser.h \
            src/Web/Services/GetFileService.hpp \
            src/Web/Services/GetMessagesService.hpp \
            src/Web/Services/MessageWebService.hpp \
+           src/Web/Services/MetricsService.hpp \
            src/Web/Services/RoundIdService.hpp \
            src/Web/Services/SendMessageService.hpp \
            src/Web/Services/SessionIdService.hpp \
@@ -290,6 +322,7 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Applications/ConsoleSink.cpp \
            src/Applications/FileSink.cpp \
            src/Applications/Node.cpp \
+           src/Applications/NodeThread.cpp \
            src/Applications/SessionFactory.cpp \
            src/Applications/Settings.cpp \
            src/ClientServer/CSBroadcast.cpp \
@@ -308,6 +341,8 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Connections/RelayEdgeListener.cpp \
            src/Connections/RelayForwarder.cpp \
            src/Crypto/AsymmetricKey.cpp \
+           src/Crypto/Blake2bHash.cpp \
+           src/Crypto/CppCtrRandom.cpp \
            src/Crypto/CppDiffieHellman.cpp \
            src/Crypto/CppDsaPrivateKey.cpp \
            src/Crypto/CppDsaPublicKey.cpp \
@@ -318,6 +353,7 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Crypto/CppRandom.cpp \
            src/Crypto/CryptoFactory.cpp \
            src/Crypto/DiffieHellman.cpp \
+           src/Crypto/Hmac.cpp \
            src/Crypto/KeyShare.cpp \
            src/Crypto/LRSPrivateKey.cpp \
            src/Crypto/LRSPublicKey.cpp \
@@ -326,11 +362,13 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Crypto/NullPublicKey.cpp \
            src/Crypto/NullPrivateKey.cpp \
            src/Crypto/OnionEncryptor.cpp \
+           src/Crypto/OpenBnContext.cpp \
            src/Crypto/ThreadedOnionEncryptor.cpp \
            src/Crypto/AbstractGroup/AbstractGroup.cpp \
            src/Crypto/AbstractGroup/BotanECGroup.cpp \
            src/Crypto/AbstractGroup/ByteGroup.cpp \
            src/Crypto/AbstractGroup/CompositeIntegerGroup.cpp \
+           src/Crypto/AbstractGroup/FixedBase.cpp \
            src/Crypto/AbstractGroup/IntegerGroup.cpp \
            src/Crypto/AbstractGroup/CppECGroup.cpp \
            src/Crypto/AbstractGroup/ECParams.cpp \
@@ -346,6 +384,7 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Crypto/BlogDrop/ChangingGenServerCiphertext.cpp \
            src/Crypto/BlogDrop/CiphertextFactory.cpp \
            src/Crypto/BlogDrop/ClientCiphertext.cpp \
+           src/Crypto/BlogDrop/ClientCiphertextPool.cpp \
            src/Crypto/BlogDrop/ElGamalClientCiphertext.cpp \
            src/Crypto/BlogDrop/ElGamalServerCiphertext.cpp \
            src/Crypto/BlogDrop/HashingGenClientCiphertext.cpp \
@@ -368,6 +407,7 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/LRS/RingSignature.cpp \
            src/LRS/SchnorrProof.cpp \
            src/LRS/SigmaProof.cpp \
+           src/Messaging/Envelope.cpp \
            src/Messaging/RpcHandler.cpp \
            src/Messaging/SignalSink.cpp \
            src/Overlay/BaseOverlay.cpp \
@@ -389,27 +429,37 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Transports/TcpAddress.cpp \
            src/Transports/TcpEdge.cpp \
            src/Transports/TcpEdgeListener.cpp \
+           src/Tunnel/DnsCache.cpp \
+           src/Tunnel/DownstreamScheduler.cpp \
            src/Tunnel/EntryTunnel.cpp \
            src/Tunnel/ExitTunnel.cpp \
            src/Tunnel/SocksConnection.cpp \
            src/Tunnel/SocksHostAddress.cpp \
+           src/Tunnel/TcpConnectionPool.cpp \
            src/Tunnel/TunnelConnectionTable.cpp \
            src/Tunnel/Packets/Packet.cpp \
            src/Tunnel/Packets/FinishPacket.cpp \
+           src/Tunnel/Packets/KeyAgreementPacket.cpp \
+           src/Tunnel/Packets/TcpAckPacket.cpp \
            src/Tunnel/Packets/TcpRequestPacket.cpp \
            src/Tunnel/Packets/UdpRequestPacket.cpp \
            src/Tunnel/Packets/TcpResponsePacket.cpp \
            src/Tunnel/Packets/UdpResponsePacket.cpp \
            src/Tunnel/Packets/TcpStartPacket.cpp \
            src/Tunnel/Packets/UdpStartPacket.cpp \
+           src/Utils/Arena.cpp \
            src/Utils/Logging.cpp \
+           src/Utils/Metrics.cpp \
            src/Utils/Random.cpp \
+           src/Utils/SimulatedCpu.cpp \
            src/Utils/Sleeper.cpp \
            src/Utils/StartStop.cpp \
            src/Utils/Time.cpp \
            src/Utils/Timer.cpp \
            src/Utils/TimerEvent.cpp \
+           src/Utils/TimerWheel.cpp \
            src/Utils/Utils.cpp \
+           src/Utils/Xor.cpp \
            src/Web/HttpRequest.cpp \
            src/Web/HttpResponse.cpp \
            src/Web/WebRequest.cpp \
@@ -417,6 +467,7 @@ SOURCES += ext/joyent-http-parser/http_parser.c \
            src/Web/Packagers/JsonPackager.cpp \
            src/Web/Services/GetFileService.cpp \
            src/Web/Services/GetMessagesService.cpp \
+           src/Web/Services/MetricsService.cpp \
            src/Web/Services/RoundIdService.cpp \
            src/Web/Services/SendMessageService.cpp \
            src/Web/Services/SessionIdService.cpp \
@@ -5,6 +5,7 @@
 #include "Messaging/Request.hpp"
 #include "Utils/Timer.hpp"
 #include "Utils/TimerCallback.hpp"
+#include "Utils/Xor.hpp"
 
 #include "BaseBulkRound.hpp"
 #include "BulkRound.hpp"
@@ -84,13 +85,7 @@ namespace Anonymity {
   void BaseBulkRound::Xor(QByteArray &dst, const QByteArray &t1,
       const QByteArray &t2)
   {
-    /// @todo use qint64 or qint32 depending on architecture
-    int count = std::min(dst.size(), t1.size());
-    count = std::min(count, t2.size());
-
-    for(int idx = 0; idx < count; idx++) {
-      dst[idx] = t1[idx] ^ t2[idx];
-    }
+    Utils::XorBytes(dst, t1, t2);
   }
 }
 }
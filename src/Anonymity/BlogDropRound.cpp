@@ -1,3 +1,4 @@
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
 #include "Crypto/Hash.hpp"
@@ -297,6 +298,8 @@ namespace Anonymity {
       Stop("Stopped for join");
       return false;
     }
+
+    PrecomputeClientCiphertexts();
     return true;
   }
 
@@ -925,6 +928,8 @@ namespace Anonymity {
     // are initialized
     _state->slot_pks.clear();
 
+    PrecomputeClientCiphertexts();
+
     _state_machine.StateComplete();
     Utils::PrintResourceUsage(ToString() + " " + "beginning bulk");
   }
@@ -1181,6 +1186,21 @@ namespace Anonymity {
     return (_state->slots_open[slot_idx] || slot_idx == _state->always_open);
   }
 
+  void BlogDropRound::PrecomputeClientCiphertexts()
+  {
+    for(int slot_idx=0; slot_idx<_state->n_clients; slot_idx++) {
+      if(!SlotIsOpen(slot_idx)) {
+        continue;
+      }
+
+      if(slot_idx == _state->my_idx) {
+        _state->blogdrop_author->Precompute();
+      } else {
+        _state->blogdrop_clients[slot_idx]->Precompute();
+      }
+    }
+  }
+
   void BlogDropRound::Abort(QString reason)
   {
     SetInterrupted();
@@ -1223,6 +1243,54 @@ namespace BlogDropPrivate {
     emit Finished(out);
   }
 
+  void CloseSlot(SlotCiphertext &slot)
+  {
+    slot.server->AddClientCiphertexts(slot.client_ctexts, slot.client_pks,
+        slot.verify_proofs);
+    slot.server_ctext = slot.server->CloseBin();
+  }
+
+  void RevealSlot(SlotValidation &slot)
+  {
+    slot.valid = slot.server->AddServerCiphertexts(slot.server_ctexts,
+        slot.server_pks);
+    if(slot.valid) {
+      slot.revealed = slot.server->RevealPlaintext(slot.plain);
+    }
+  }
+
+namespace {
+  /**
+   * Each slot has its own BlogDropServer and Parameters, so when
+   * multithreaded the slots are handled concurrently.  The work within a
+   * slot is itself spread across the pool and the calling thread takes part
+   * in each blocking map, so nesting them cannot starve the pool.
+   */
+  template<typename T> void RunSlots(QList<T> &open_slots, void (*func)(T &))
+  {
+    CryptoFactory::ThreadingType tt =
+      CryptoFactory::GetInstance().GetThreadingType();
+
+    if(tt == CryptoFactory::MultiThreaded && open_slots.count() > 1) {
+      QtConcurrent::blockingMap(open_slots, func);
+    } else {
+      for(int idx=0; idx<open_slots.count(); idx++) {
+        func(open_slots[idx]);
+      }
+    }
+  }
+}
+
+  void CloseSlots(QList<SlotCiphertext> &open_slots)
+  {
+    RunSlots(open_slots, &CloseSlot);
+  }
+
+  void RevealSlots(QList<SlotValidation> &open_slots)
+  {
+    RunSlots(open_slots, &RevealSlot);
+  }
+
   void GenerateServerCiphertext::run() 
   {
     Q_ASSERT(_round->_server_state->all_client_ciphertexts.count() == _round->GetGroup().Count());
@@ -1269,19 +1337,30 @@ namespace BlogDropPrivate {
       Q_ASSERT(!_round->_state->master_client_pks[id].isNull());
     }
 
-    QList<QByteArray> server_ctexts;
+    QList<SlotCiphertext> open_slots;
     for(int slot_idx=0; slot_idx<_round->_state->n_clients; slot_idx++) {
-      QByteArray c;
       if(_round->SlotIsOpen(slot_idx)) {
         Q_ASSERT(by_slot[slot_idx].count() == _round->_state->n_clients);
 
-        //qDebug() << "Creating server ciphertext for slot" << slot_idx;
-        _round->_server_state->blogdrop_servers[slot_idx]->AddClientCiphertexts(by_slot[slot_idx], 
-            client_pks, _round->VerifyAllProofs);
-        c = _round->_server_state->blogdrop_servers[slot_idx]->CloseBin();
-      } 
+        SlotCiphertext slot;
+        slot.slot_idx = slot_idx;
+        slot.server = _round->_server_state->blogdrop_servers[slot_idx];
+        slot.client_ctexts = by_slot[slot_idx];
+        slot.client_pks = client_pks;
+        slot.verify_proofs = _round->VerifyAllProofs;
+        open_slots.append(slot);
+      }
+    }
+
+    CloseSlots(open_slots);
+
+    QList<QByteArray> server_ctexts;
+    for(int slot_idx=0; slot_idx<_round->_state->n_clients; slot_idx++) {
+      server_ctexts.append(QByteArray());
+    }
 
-      server_ctexts.append(c);
+    foreach(const SlotCiphertext &slot, open_slots) {
+      server_ctexts[slot.slot_idx] = slot.server_ctext;
     }
 
     Q_ASSERT(server_ctexts.count() == _round->_state->n_clients);
@@ -1315,28 +1394,44 @@ namespace BlogDropPrivate {
       }
     }
 
+    QList<SlotValidation> open_slots;
     for(int slot_idx=0; slot_idx<_round->_state->n_clients; slot_idx++) {
       if(_round->SlotIsOpen(slot_idx)) {
-        if(!_round->_server_state->blogdrop_servers[slot_idx]->AddServerCiphertexts(
-                by_slot[slot_idx],
-                _round->_state->master_server_pks_list)) {
-              _round->Abort("Server submitted invalid ciphertext");
-              return;
-          }
+        SlotValidation slot;
+        slot.slot_idx = slot_idx;
+        slot.server = _round->_server_state->blogdrop_servers[slot_idx];
+        slot.server_ctexts = by_slot[slot_idx];
+        slot.server_pks = _round->_state->master_server_pks_list;
+        slot.valid = false;
+        slot.revealed = false;
+        open_slots.append(slot);
       } else {
         //qDebug() << "Not adding server ciphertext to closed slot" << slot_idx;
       }
     }
 
+    RevealSlots(open_slots);
+
+    foreach(const SlotValidation &slot, open_slots) {
+      if(!slot.valid) {
+        _round->Abort("Server submitted invalid ciphertext");
+        return;
+      }
+    }
+
     QList<QByteArray> plaintexts;
+    QList<SlotValidation>::const_iterator revealed = open_slots.constBegin();
     for(int slot_idx=0; slot_idx<_round->_state->n_clients; slot_idx++) {
       QByteArray plain;
 
       if(_round->SlotIsOpen(slot_idx)) {
-        if(!_round->_server_state->blogdrop_servers[slot_idx]->RevealPlaintext(plain)) {
+        Q_ASSERT(revealed->slot_idx == slot_idx);
+        const SlotValidation &slot = *(revealed++);
+        if(!slot.revealed) {
           qWarning() << "Could not decode plaintext message. Maybe bad anon author?";
           continue;
         }
+        plain = slot.plain;
 
         if(!_round->VerifyAllProofs) {
           const int siglen = _round->_state->slot_sig_keys[slot_idx]->GetSignatureLength();
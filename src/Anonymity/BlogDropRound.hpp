@@ -444,6 +444,13 @@ namespace BlogDropPrivate {
       void PushCleartext();
 
       void ProcessCleartext();
+
+      /**
+       * Starts precomputing the client and author ciphertexts for the
+       * open slots of the next phase
+       */
+      void PrecomputeClientCiphertexts();
+
       void ConcludeClientCiphertextSubmission(const int &);
 
       /**
@@ -516,6 +523,58 @@ namespace BlogDropPrivate {
   }
 
 namespace BlogDropPrivate {
+  /**
+   * A server's work on one open slot when generating its ciphertext
+   */
+  struct SlotCiphertext {
+    int slot_idx;
+    QSharedPointer<Crypto::BlogDrop::BlogDropServer> server;
+    QList<QByteArray> client_ctexts;
+    QList<QSharedPointer<const Crypto::BlogDrop::PublicKey> > client_pks;
+    bool verify_proofs;
+    QByteArray server_ctext;
+  };
+
+  /**
+   * Adds a slot's client ciphertexts to its server and sets server_ctext
+   * to the server's ciphertext
+   * @param slot the slot
+   */
+  void CloseSlot(SlotCiphertext &slot);
+
+  /**
+   * Closes every slot, concurrently when multithreaded
+   * @param open_slots the open slots
+   */
+  void CloseSlots(QList<SlotCiphertext> &open_slots);
+
+  /**
+   * A server's work on one open slot when validating the server
+   * ciphertexts and revealing the plaintext
+   */
+  struct SlotValidation {
+    int slot_idx;
+    QSharedPointer<Crypto::BlogDrop::BlogDropServer> server;
+    QList<QByteArray> server_ctexts;
+    QList<QSharedPointer<const Crypto::BlogDrop::PublicKey> > server_pks;
+    bool valid;
+    bool revealed;
+    QByteArray plain;
+  };
+
+  /**
+   * Adds a slot's server ciphertexts to its server, setting valid, and
+   * if they are valid reveals the plaintext, setting revealed and plain
+   * @param slot the slot
+   */
+  void RevealSlot(SlotValidation &slot);
+
+  /**
+   * Reveals every slot, concurrently when multithreaded
+   * @param open_slots the open slots
+   */
+  void RevealSlots(QList<SlotValidation> &open_slots);
+
   class GenerateClientCiphertext : public QObject, public QRunnable {
     Q_OBJECT
 
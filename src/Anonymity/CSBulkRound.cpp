@@ -6,6 +6,11 @@
  * Consider how to have server exchange ciphertext bits ... already know both colluding parties one needs to submit the shared secret
  */
 
+#include <QAtomicInt>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <QThread>
+
 #include "Crypto/Hash.hpp"
 #include "Identity/PublicIdentity.hpp"
 #include "Utils/Random.hpp"
@@ -15,6 +20,7 @@
 #include "Utils/Timer.hpp"
 #include "Utils/TimerCallback.hpp"
 #include "Utils/Utils.hpp"
+#include "Utils/Xor.hpp"
 
 #include "NeffShuffle.hpp"
 #include "NeffKeyShuffle.hpp"
@@ -31,11 +37,97 @@ namespace Dissent {
   using Utils::Serialization;
 
 namespace Anonymity {
+namespace {
+  /**
+   * A contiguous subset of the anonymous rngs whose pads are generated and
+   * combined by a single worker thread
+   */
+  struct PadChunk {
+    QVector<QSharedPointer<Utils::Random> > rngs;
+    int length;
+    QByteArray xor_pad;
+  };
+
+  void GeneratePadChunk(PadChunk &chunk)
+  {
+    chunk.xor_pad = QByteArray(chunk.length, 0);
+    QByteArray pad(chunk.length, 0);
+    foreach(const QSharedPointer<Utils::Random> &rng, chunk.rngs) {
+      rng->GenerateBlock(pad);
+      Utils::XorBytes(chunk.xor_pad, chunk.xor_pad, pad);
+    }
+  }
+
+  QAtomicInt default_pipeline_depth(CSBulkRound::DEFAULT_PIPELINE_DEPTH);
+  QAtomicInt default_pad_version(CSBulkRound::DEFAULT_PAD_VERSION);
+}
+
+  QByteArray CSBulkRound::XorPads(const QVector<QSharedPointer<Random> > &rngs,
+      int length)
+  {
+    CryptoFactory::ThreadingType tt =
+      CryptoFactory::GetInstance().GetThreadingType();
+    int workers = qMin(QThread::idealThreadCount(), rngs.count());
+
+    if(tt == CryptoFactory::SingleThreaded || workers < 2) {
+      PadChunk chunk;
+      chunk.rngs = rngs;
+      chunk.length = length;
+      GeneratePadChunk(chunk);
+      return chunk.xor_pad;
+    }
+
+    // Each rng is owned by exactly one worker, so the pads (and their xor)
+    // are identical to those of the serial path
+    QList<PadChunk> chunks;
+    int count = rngs.count();
+    int per_chunk = count / workers + (count % workers ? 1 : 0);
+    for(int start = 0; start < count; start += per_chunk) {
+      PadChunk chunk;
+      chunk.rngs = rngs.mid(start, per_chunk);
+      chunk.length = length;
+      chunks.append(chunk);
+    }
+
+    QtConcurrent::blockingMap(chunks, GeneratePadChunk);
+
+    QList<QByteArray> partials;
+    foreach(const PadChunk &chunk, chunks) {
+      partials.append(chunk.xor_pad);
+    }
+
+    QByteArray xor_msg(length, 0);
+    Utils::XorAccumulate(xor_msg, partials);
+    return xor_msg;
+  }
+
+  void CSBulkRound::SetPipelineDepth(int depth)
+  {
+    default_pipeline_depth.fetchAndStoreOrdered(qMax(1, depth));
+  }
+
+  int CSBulkRound::GetPipelineDepth()
+  {
+    return default_pipeline_depth.fetchAndAddOrdered(0);
+  }
+
+  void CSBulkRound::SetPadVersion(int version)
+  {
+    default_pad_version.fetchAndStoreOrdered(version);
+  }
+
+  int CSBulkRound::GetPadVersion()
+  {
+    return default_pad_version.fetchAndAddOrdered(0);
+  }
+
   CSBulkRound::CSBulkRound(const Group &group, const PrivateIdentity &ident,
       const Id &round_id, QSharedPointer<Network> network,
       GetDataCallback &get_data, CreateRound create_shuffle) :
     BaseBulkRound(group, ident, round_id, network, get_data, create_shuffle),
     _state_machine(this),
+    _pipeline_depth(GetPipelineDepth()),
+    _pad_version(GetPadVersion()),
     _stop_next(false),
     _get_blame_data(this, &CSBulkRound::GetBlameData)
   {
@@ -72,8 +164,6 @@ namespace Anonymity {
       InitClient();
     }
 
-    _state->slot_open = false;
-
     Library *lib = CryptoFactory::GetInstance().GetLibrary();
     QScopedPointer<Hash> hashalgo(lib->GetHashAlgorithm());
     QByteArray hashval = GetRoundId().GetByteArray();
@@ -311,9 +401,11 @@ namespace Anonymity {
       _server_state->client_ciphertexts.clear();
       _server_state->server_ciphertexts.clear();
 
+      // Accusations arrive up to a pipeline depth after the phase
       int nphase = _state_machine.GetPhase() + 1;
-      if(nphase > 5) {
-        _server_state->phase_logs.remove(nphase - 5);
+      int logged = 4 + _pipeline_depth;
+      if(nphase > logged) {
+        _server_state->phase_logs.remove(nphase - logged);
       }
       _server_state->current_phase_log =
         QSharedPointer<PhaseLog>(
@@ -337,14 +429,20 @@ namespace Anonymity {
       throw QRunTimeError("Not a server");
     }
 
+    QString reason;
+    if(!ReadRoundParameters(stream, reason)) {
+      Stop(reason);
+      return;
+    }
+
     QHash<int, QByteArray> signatures;
     QByteArray cleartext;
     stream >> signatures >> cleartext;
 
-    if(cleartext.size() != _state->msg_length) {
+    if(cleartext.size() != GetMessageLength()) {
       throw QRunTimeError("Cleartext size mismatch: " +
           QString::number(cleartext.size()) + " :: " +
-          QString::number(_state->msg_length));
+          QString::number(GetMessageLength()));
     }
 
     int server_length = GetGroup().GetSubgroup().Count();
@@ -367,6 +465,24 @@ namespace Anonymity {
     }
   }
 
+  bool CSBulkRound::ReadRoundParameters(QDataStream &stream,
+      QString &reason) const
+  {
+    int depth, pad_version;
+    stream >> depth >> pad_version;
+
+    if(depth != _pipeline_depth) {
+      reason = "Pipeline depth mismatch: " + QString::number(depth) +
+        " :: " + QString::number(_pipeline_depth);
+      return false;
+    } else if(pad_version != _pad_version) {
+      reason = "Pad version mismatch: " + QString::number(pad_version) +
+        " :: " + QString::number(_pad_version);
+      return false;
+    }
+    return true;
+  }
+
   void CSBulkRound::HandleClientCiphertext(const Id &from, QDataStream &stream)
   {
     if(!IsServer()) {
@@ -382,13 +498,18 @@ namespace Anonymity {
       throw QRunTimeError("Already have ciphertext");
     }
 
+    QString reason;
+    if(!ReadRoundParameters(stream, reason)) {
+      throw QRunTimeError(reason);
+    }
+
     QByteArray payload;
     stream >> payload;
 
-    if(payload.size() != _server_state->msg_length) {
+    if(payload.size() != GetMessageLength()) {
       throw QRunTimeError("Incorrect message length, got " +
           QString::number(payload.size()) + " expected " +
-          QString::number(_server_state->msg_length));
+          QString::number(GetMessageLength()));
     }
 
     _server_state->handled_clients[idx] = true;
@@ -435,6 +556,12 @@ namespace Anonymity {
       throw QRunTimeError("Already have client list");
     }
 
+    QString reason;
+    if(!ReadRoundParameters(stream, reason)) {
+      Stop(reason + " with server (" + from.ToString() + ")");
+      return;
+    }
+
     QBitArray clients;
     stream >> clients;
 
@@ -507,10 +634,10 @@ namespace Anonymity {
     QByteArray ciphertext;
     stream >> ciphertext;
 
-    if(ciphertext.size() != _server_state->msg_length) {
+    if(ciphertext.size() != GetMessageLength()) {
       throw QRunTimeError("Incorrect message length, got " +
           QString::number(ciphertext.size()) + " expected " +
-          QString::number(_server_state->msg_length));
+          QString::number(GetMessageLength()));
     }
 
     Library *lib = CryptoFactory::GetInstance().GetLibrary();
@@ -628,22 +755,9 @@ namespace Anonymity {
       throw QRunTimeError("Invalid server claim");
     }
 
-    Library *lib = CryptoFactory::GetInstance().GetLibrary();
-    QSharedPointer<Hash> hashalgo(lib->GetHashAlgorithm());
-    hashalgo->Update(shared_secret);
-
-    QByteArray bphase(4, 0);
-    Serialization::WriteInt(_server_state->current_blame.third, bphase, 0);
-    hashalgo->Update(bphase);
-
-    hashalgo->Update(GetRoundId().GetByteArray());
-    QByteArray seed = hashalgo->ComputeHash();
-    QSharedPointer<Random> rng(lib->GetRandomNumberGenerator(seed));
-    int byte_idx = _server_state->current_blame.second / 8;
-    int bit_idx = _server_state->current_blame.second % 8;
-    QByteArray tmp(byte_idx + 1, 0);
-    rng->GenerateBlock(tmp);
-    if(((tmp[byte_idx] & bit_masks[bit_idx % 8]) != 0) == _server_state->server_bits[rebuttal.first]) {
+    bool bit = GetPadBit(shared_secret, _server_state->current_blame.third,
+        _server_state->current_blame.second);
+    if(bit == _server_state->server_bits[rebuttal.first]) {
       _server_state->bad_dude = from;
       qDebug() << "Client misbehaves!";
     } else {
@@ -838,11 +952,15 @@ namespace Anonymity {
 
   void CSBulkRound::PrepareForBulk()
   {
-    _state->msg_length = (GetGroup().Count() / 8);
+    _state->base_msg_length = (GetGroup().Count() / 8);
     if(GetGroup().Count() % 8) {
-      ++_state->msg_length;
+      ++_state->base_msg_length;
+    }
+
+    // No slots are open until a cleartext requests them
+    for(int phase = 0; phase < _pipeline_depth; phase++) {
+      _state->layouts[phase] = SlotLayout(_state->base_msg_length);
     }
-    _state->base_msg_length = _state->msg_length;
 
     SetupRngSeeds();
     _state_machine.StateComplete();
@@ -871,21 +989,15 @@ namespace Anonymity {
 
   void CSBulkRound::SetupRngs()
   {
-    Library *lib = CryptoFactory::GetInstance().GetLibrary();
-    QSharedPointer<Hash> hashalgo(lib->GetHashAlgorithm());
-
-    QByteArray phase(4, 0);
-    Serialization::WriteInt(_state_machine.GetPhase(), phase, 0);
-
-    _state->anonymous_rngs.clear();
-
     QList<QByteArray> seeds = _state->base_seeds;
     if(IsServer()) {
       seeds = QList<QByteArray>();
       _server_state->rng_to_gidx.clear();
+      _server_state->current_phase_log->pad_owners.clear();
       for(int idx = 0; idx < _server_state->handled_clients.size(); idx++) {
         if(_server_state->handled_clients.at(idx)) {
           _server_state->rng_to_gidx[seeds.size()] = idx;
+          _server_state->current_phase_log->pad_owners.append(idx);
           seeds.append(_state->base_seeds[idx]);
         }
       }
@@ -905,53 +1017,181 @@ namespace Anonymity {
       */
     }
 
-    foreach(const QByteArray &base_seed, seeds) {
-      if(base_seed.isEmpty()) {
-        continue;
+    _state->anonymous_rngs = GetPadRngs(seeds, _state->ciphertext_phase);
+  }
+
+  QByteArray CSBulkRound::GetPadSeed(const QByteArray &base_seed,
+      int phase) const
+  {
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QSharedPointer<Hash> hashalgo(lib->GetHashAlgorithm());
+
+    QByteArray bphase(4, 0);
+    Serialization::WriteInt(phase, bphase, 0);
+
+    hashalgo->Update(base_seed);
+    hashalgo->Update(bphase);
+    hashalgo->Update(GetRoundId().GetByteArray());
+    return hashalgo->ComputeHash();
+  }
+
+  QVector<QSharedPointer<Random> > CSBulkRound::GetPadRngs(
+      const QList<QByteArray> &base_seeds, int phase) const
+  {
+    QByteArray suffix(4, 0);
+    Serialization::WriteInt(phase, suffix, 0);
+    suffix.append(GetRoundId().GetByteArray());
+
+    // The same input as GetPadSeed, hashed for every peer at once
+    QVector<QByteArray> inputs;
+    foreach(const QByteArray &base_seed, base_seeds) {
+      if(!base_seed.isEmpty()) {
+        inputs.append(base_seed + suffix);
       }
-      hashalgo->Update(base_seed);
-      hashalgo->Update(phase);
-      hashalgo->Update(GetRoundId().GetByteArray());
-      QByteArray seed = hashalgo->ComputeHash();
-      QSharedPointer<Random> rng(lib->GetRandomNumberGenerator(seed));
-      _state->anonymous_rngs.append(rng);
     }
+
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QSharedPointer<Hash> hashalgo(lib->GetHashAlgorithm());
+    QVector<QByteArray> seeds = hashalgo->ComputeHashes(inputs);
+
+    QVector<QSharedPointer<Random> > rngs;
+    foreach(const QByteArray &seed, seeds) {
+      rngs.append(QSharedPointer<Random>(CreatePadRng(seed)));
+    }
+    return rngs;
+  }
+
+  Random *CSBulkRound::CreatePadRng(const QByteArray &seed) const
+  {
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    if(_pad_version == PAD_VERSION_LEGACY) {
+      return lib->GetRandomNumberGenerator(seed);
+    }
+    return lib->GetSeekableRandomNumberGenerator(seed);
+  }
+
+  bool CSBulkRound::GetPadBit(const QByteArray &base_seed, int phase,
+      int msg_idx) const
+  {
+    QSharedPointer<Random> rng(CreatePadRng(GetPadSeed(base_seed, phase)));
+    int byte_idx = msg_idx / 8;
+    QByteArray tmp(1, 0);
+    if(rng->Seek(byte_idx)) {
+      rng->GenerateBlock(tmp);
+    } else {
+      tmp.resize(byte_idx + 1);
+      rng->GenerateBlock(tmp);
+      tmp = tmp.right(1);
+    }
+    return (tmp[0] & bit_masks[msg_idx % 8]) != 0;
   }
 
   void CSBulkRound::SubmitClientCiphertext()
   {
-    SetupRngs();
+    // Keep a ciphertext submitted for each phase whose layout is known,
+    // servers hold on to those for future phases
+    int end = _state_machine.GetPhase() + _pipeline_depth;
+    for(; _state->next_ciphertext_phase < end; _state->next_ciphertext_phase++) {
+      _state->ciphertext_phase = _state->next_ciphertext_phase;
+      SetupRngs();
 
-    QByteArray payload;
-    QDataStream stream(&payload, QIODevice::WriteOnly);
-    stream << CLIENT_CIPHERTEXT << GetRoundId() << _state_machine.GetPhase()
-      << GenerateCiphertext();
+      QByteArray payload;
+      QDataStream stream(&payload, QIODevice::WriteOnly);
+      stream << CLIENT_CIPHERTEXT << GetRoundId() << _state->ciphertext_phase
+        << _pipeline_depth << _pad_version << GenerateCiphertext();
+
+      VerifiableSend(_state->my_server, payload);
+    }
+  }
+
+  QByteArray CSBulkRound::GeneratePads()
+  {
+    QByteArray xor_msg = TakePrecomputedPads();
+    if(!xor_msg.isEmpty()) {
+      return xor_msg;
+    }
+
+    return XorPads(_state->anonymous_rngs,
+        _state->layouts.value(_state->ciphertext_phase).length);
+  }
+
+  void CSBulkRound::PrecomputePads(int phase)
+  {
+    if(CryptoFactory::GetInstance().GetThreadingType() ==
+        CryptoFactory::SingleThreaded || !_state->layouts.contains(phase))
+    {
+      return;
+    }
+
+    QList<QByteArray> base_seeds;
+    foreach(int gidx, _server_state->current_phase_log->pad_owners) {
+      base_seeds.append(_state->base_seeds[gidx]);
+    }
+    QVector<QSharedPointer<Random> > rngs = GetPadRngs(base_seeds, phase);
 
-    VerifiableSend(_state->my_server, payload);
+    _server_state->precomputed_owners = _server_state->current_phase_log->pad_owners;
+    _server_state->precomputed_phase = phase;
+    _server_state->precomputed_pads = QtConcurrent::run(XorPads, rngs,
+        _state->layouts[phase].length);
+  }
+
+  QByteArray CSBulkRound::TakePrecomputedPads()
+  {
+    if(!_server_state ||
+        _server_state->precomputed_phase != _state->ciphertext_phase)
+    {
+      return QByteArray();
+    }
+
+    _server_state->precomputed_phase = -1;
+    QByteArray xor_msg = _server_state->precomputed_pads.result();
+    int length = _state->layouts.value(_state->ciphertext_phase).length;
+    if(xor_msg.size() != length) {
+      return QByteArray();
+    }
+
+    // Xor is its own inverse, so a pad included for a client that did not
+    // submit is removed by applying it again
+    QSet<int> expected = _server_state->precomputed_owners.toList().toSet();
+    QSet<int> actual = _server_state->current_phase_log->pad_owners.toList().toSet();
+    QSet<int> differ = (expected - actual) + (actual - expected);
+
+    QList<QByteArray> base_seeds;
+    foreach(int gidx, differ) {
+      base_seeds.append(_state->base_seeds[gidx]);
+    }
+    QVector<QSharedPointer<Random> > rngs = GetPadRngs(base_seeds,
+        _state->ciphertext_phase);
+
+    if(!rngs.isEmpty()) {
+      Utils::XorBytes(xor_msg, xor_msg, XorPads(rngs, length));
+    }
+
+    qDebug() << ToString() << "using precomputed pads, corrected" <<
+      rngs.count() << "clients";
+    return xor_msg;
   }
 
   QByteArray CSBulkRound::GenerateCiphertext()
   {
-    QByteArray xor_msg(_state->msg_length, 0);
-    QByteArray tmsg(_state->msg_length, 0);
-    
-    int idx = 0;
-    foreach(const QSharedPointer<Random> &rng, _state->anonymous_rngs) {
-      rng->GenerateBlock(tmsg);
-      if(IsServer()) {
-        int gidx = _server_state->rng_to_gidx[idx++];
-        _server_state->current_phase_log->my_sub_ciphertexts[gidx] = tmsg;
-      }
-      Xor(xor_msg, xor_msg, tmsg);
+    QByteArray xor_msg = GeneratePads();
+
+    int phase = _state->ciphertext_phase;
+    const QMap<int, int> messages = _state->layouts.value(phase).messages;
+
+    while(!_state->slot_requests.isEmpty() &&
+        _state->slot_requests.first() + _pipeline_depth <= phase)
+    {
+      _state->slot_requests.removeFirst();
     }
 
-    if(_state->slot_open) {
+    if(messages.contains(_state->my_idx)) {
       int offset = _state->base_msg_length;
-      foreach(int owner, _state->next_messages.keys()) {
+      foreach(int owner, messages.keys()) {
         if(owner == _state->my_idx) {
           break;
         }
-        offset += _state->next_messages[owner];
+        offset += messages[owner];
       }
 
       QByteArray my_msg = GenerateSlotMessage();
@@ -962,13 +1202,23 @@ namespace Anonymity {
 
       qDebug() << "Writing ciphertext into my slot" << _state->my_idx <<
         "starting at" << offset << "for" << my_msg.size() << "bytes.";
+      return xor_msg;
+    }
 
-    } else if(CheckData()) {
+    // A slot we were expecting never opened, keep its message for later
+    if(_state->slot_msgs.contains(phase)) {
+      QByteArray msg = _state->slot_msgs.take(phase);
+      if(!msg.isEmpty()) {
+        _state->unsent_msgs.prepend(msg);
+      }
+    }
+
+    if(CheckData()) {
       qDebug() << "Opening my slot" << _state->my_idx;
       xor_msg[_state->my_idx / 8] = xor_msg[_state->my_idx / 8] ^
         bit_masks[_state->my_idx % 8];
-      _state->read = false;
-      _state->slot_open = true;
+      _state->slot_requests.append(phase);
+      _state->slot_msgs[phase + _pipeline_depth] = QByteArray();
     }
 
     return xor_msg;
@@ -976,46 +1226,57 @@ namespace Anonymity {
 
   bool CSBulkRound::CheckData()
   {
-    if(!_state->next_msg.isEmpty()) {
-      return true;
-    }
-
-    QPair<QByteArray, bool> pair = GetData(MAX_GET);
-    if(pair.first.size() > 0) {
+    int requested = _state->slot_requests.count();
+    while(_state->unsent_msgs.count() <= requested) {
+      QPair<QByteArray, bool> pair = GetData(MAX_GET);
+      if(pair.first.isEmpty()) {
+        break;
+      }
       qDebug() << "Found a message of" << pair.first.size();
+      _state->unsent_msgs.append(pair.first);
     }
-    _state->next_msg = pair.first;
-    _state->last_msg = QByteArray();
-    return !_state->next_msg.isEmpty();
+
+    return _state->unsent_msgs.count() > requested;
   }
 
   QByteArray CSBulkRound::GenerateSlotMessage()
   {
-    QByteArray msg = _state->next_msg;
-    if(_state->read) {
-      QPair<QByteArray, bool> pair = GetData(MAX_GET);
-      _state->last_msg = _state->next_msg;
-      _state->next_msg = pair.first;
+    int phase = _state->ciphertext_phase;
+    int next_phase = phase + _pipeline_depth;
+
+    QByteArray msg = _state->slot_msgs.take(phase);
+    _state->sent_msgs[phase] = msg;
+
+    QByteArray next_msg;
+    if(_state->unsent_msgs.isEmpty()) {
+      next_msg = GetData(MAX_GET).first;
     } else {
-      msg = _state->last_msg;
-      _state->read = true;
+      next_msg = _state->unsent_msgs.takeFirst();
     }
 
     QByteArray msg_p(8, 0);
-    Serialization::WriteInt(_state_machine.GetPhase(), msg_p, 0);
-    int length = _state->next_msg.size() + SlotHeaderLength(_state->my_idx);
+    Serialization::WriteInt(phase, msg_p, 0);
+    int length = next_msg.size() + SlotHeaderLength(_state->my_idx);
+    bool closing = false;
 #ifdef CSBR_CLOSE_SLOT
-    if(_state->next_msg.size() == 0) {
-      _state->slot_open = false;
+    if(next_msg.size() == 0) {
+      closing = true;
       length = 0;
     }
 #endif
     if(_state->accuse) {
       Serialization::WriteInt(SlotHeaderLength(_state->my_idx), msg_p, 4);
       msg_p.append(QByteArray(msg.size(), 0));
+      if(!next_msg.isEmpty()) {
+        _state->unsent_msgs.prepend(next_msg);
+      }
+      _state->slot_msgs[next_phase] = QByteArray();
     } else {
       Serialization::WriteInt(length, msg_p, 4);
       msg_p.append(msg);
+      if(!closing) {
+        _state->slot_msgs[next_phase] = next_msg;
+      }
     }
 #ifdef CSBR_SIGN_SLOTS
     QByteArray sig = _state->anonymous_key->Sign(msg_p);
@@ -1031,8 +1292,20 @@ namespace Anonymity {
     }
 
     QByteArray msg_pp = accusation + msg_p + sig;
-    _state->last_ciphertext  = Randomize(msg_pp);
-    return _state->last_ciphertext;
+    _state->sent_ciphertexts[phase] = Randomize(msg_pp);
+    return _state->sent_ciphertexts[phase];
+  }
+
+  void CSBulkRound::ResendSlotMessage(int phase)
+  {
+    int next_phase = phase + _pipeline_depth;
+    if(_state->slot_msgs.contains(next_phase)) {
+      QByteArray msg = _state->slot_msgs[next_phase];
+      if(!msg.isEmpty()) {
+        _state->unsent_msgs.prepend(msg);
+      }
+    }
+    _state->slot_msgs[next_phase] = _state->sent_msgs.value(phase);
   }
 
   void CSBulkRound::SetOnlineClients()
@@ -1084,13 +1357,15 @@ namespace Anonymity {
     QByteArray payload;
     QDataStream stream(&payload, QIODevice::WriteOnly);
     stream << SERVER_CLIENT_LIST << GetRoundId() <<
-      _state_machine.GetPhase() << _server_state->handled_clients;
+      _state_machine.GetPhase() << _pipeline_depth << _pad_version <<
+      _server_state->handled_clients;
 
     VerifiableBroadcastToServers(payload);
   }
 
   void CSBulkRound::SubmitCommit()
   {
+    _state->ciphertext_phase = _state_machine.GetPhase();
     SetupRngs();
 
     qDebug() << ToString() << "generating ciphertext for" <<
@@ -1104,14 +1379,18 @@ namespace Anonymity {
       _state_machine.GetPhase() << _server_state->my_commit;
 
     VerifiableBroadcastToServers(payload);
+
+    // When pipelined the next layout is already known, generate its pads
+    // while the servers finish this phase
+    if(_pipeline_depth > 1) {
+      PrecomputePads(_state_machine.GetPhase() + 1);
+    }
   }
 
   void CSBulkRound::GenerateServerCiphertext()
   {
     QByteArray ciphertext = GenerateCiphertext();
-    foreach(const QByteArray &text, _server_state->client_ciphertexts) {
-      Xor(ciphertext, ciphertext, text);
-    }
+    Utils::XorAccumulate(ciphertext, _server_state->client_ciphertexts);
     _server_state->my_ciphertext = ciphertext;
 
     Library *lib = CryptoFactory::GetInstance().GetLibrary();
@@ -1131,11 +1410,8 @@ namespace Anonymity {
 
   void CSBulkRound::SubmitValidation()
   {
-    QByteArray cleartext(_state->msg_length, 0);
-
-    foreach(const QByteArray &ciphertext, _server_state->server_ciphertexts) {
-      Xor(cleartext, cleartext, ciphertext);
-    }
+    QByteArray cleartext(GetMessageLength(), 0);
+    Utils::XorAccumulate(cleartext, _server_state->server_ciphertexts.values());
 
     _state->cleartext = cleartext;
     QByteArray signature = GetPrivateIdentity().GetSigningKey()->
@@ -1154,7 +1430,8 @@ namespace Anonymity {
     QByteArray payload;
     QDataStream stream(&payload, QIODevice::WriteOnly);
     stream << SERVER_CLEARTEXT << GetRoundId() << _state_machine.GetPhase()
-      << _server_state->signatures << _server_state->cleartext;
+      << _pipeline_depth << _pad_version << _server_state->signatures
+      << _server_state->cleartext;
 
     VerifiableBroadcastToClients(payload);
     ProcessCleartext();
@@ -1233,9 +1510,17 @@ namespace Anonymity {
 
   void CSBulkRound::TransmitBlameBits()
   {
-    QPair<QBitArray, QBitArray> bits =
-      _server_state->phase_logs[_server_state->current_blame.third]->
-      GetBitsAtIndex(_server_state->current_blame.second);
+    int phase = _server_state->current_blame.third;
+    int msg_idx = _server_state->current_blame.second;
+    QSharedPointer<PhaseLog> phase_log = _server_state->phase_logs[phase];
+
+    QBitArray mine(phase_log->GetMax(), false);
+    foreach(int gidx, phase_log->pad_owners) {
+      mine[gidx] = GetPadBit(_state->base_seeds[gidx], phase, msg_idx);
+    }
+
+    QPair<QBitArray, QBitArray> bits(
+        phase_log->GetClientBitsAtIndex(msg_idx), mine);
 
     QByteArray payload;
     QDataStream stream(&payload, QIODevice::WriteOnly);
@@ -1315,6 +1600,10 @@ namespace Anonymity {
 
   void CSBulkRound::ProcessCleartext()
   {
+    // This phase's cleartext lays out the slots pipeline depth phases ahead
+    int phase = _state_machine.GetPhase();
+    const QMap<int, int> messages = _state->layouts.value(phase).messages;
+
     int next_msg_length = _state->base_msg_length;
     QMap<int, int> next_msgs;
     for(int idx = 0; idx < GetGroup().Count(); idx++) {
@@ -1342,29 +1631,48 @@ namespace Anonymity {
       for(int idx = 0; idx < GetGroup().Count(); idx++) {
         if(IsServer()) {
           _server_state->current_phase_log->message_offsets.append(calc);
-          int msg_length = _state->next_messages.contains(idx) ?
-            _state->next_messages[idx] : 0;
+          int msg_length = messages.value(idx, 0);
           calc += msg_length;
         }
       }
     }
 
-    foreach(int owner, _state->next_messages.keys()) {
-      int msg_length = _state->next_messages[owner];
+    // Derandomize every slot up front, so their digests are checked in a
+    // single batch
+    const QList<int> owners = messages.keys();
+    QVector<QByteArray> derandomized;
+    int slot_offset = offset;
+    foreach(int owner, owners) {
+      derandomized.append(Derandomize(QByteArray::fromRawData(
+              _state->cleartext.constData() + slot_offset, messages[owner])));
+      slot_offset += messages[owner];
+    }
+
+#ifndef CSBR_SIGN_SLOTS
+    QVector<QByteArray> bodies;
+    foreach(const QByteArray &msg_pp, derandomized) {
+      bodies.append(QByteArray::fromRawData(msg_pp.constData() + 1,
+            qMax(0, msg_pp.size() - 1 - sig_length)));
+    }
+    const QVector<QByteArray> digests = hash->ComputeHashes(bodies);
+#endif
+
+    for(int slot = 0; slot < owners.count(); slot++) {
+      int owner = owners[slot];
+      int msg_length = messages[owner];
 
       QByteArray msg_ppp = QByteArray::fromRawData(
           _state->cleartext.constData() + offset, msg_length);
       offset += msg_length;
 
-      QByteArray msg_pp = Derandomize(msg_ppp);
+      const QByteArray &msg_pp = derandomized[slot];
       if(msg_pp.isEmpty()) {
         qDebug() << "No message at" << owner;
         next_msg_length += msg_length;
         next_msgs[owner] = msg_length;
 
         if(_state->my_idx == owner) {
-          _state->read = false;
-          _state->slot_open = true;
+          ResendSlotMessage(phase);
           qDebug() << "My message didn't make it in time.";
         }
         continue;
@@ -1391,7 +1699,7 @@ namespace Anonymity {
 #ifdef CSBR_SIGN_SLOTS
       if(!vkey->Verify(msg_p, sig)) {
 #else
-      if(hash->ComputeHash(msg_p) != sig) {
+      if(digests[slot] != sig) {
 #endif
         
         qDebug() << "Unable to verify message for peer at" << owner;
@@ -1399,11 +1707,13 @@ namespace Anonymity {
         next_msgs[owner] = msg_length;
 
         if(owner == _state->my_idx && !_state->accuse) {
-          _state->read = false;
-          _state->slot_open = true;
+          ResendSlotMessage(phase);
           _state->accuse = false;
-          for(int pidx = 0; pidx < msg_ppp.size(); pidx++) {
-            const char expected = _state->last_ciphertext[pidx];
+          const QByteArray last_ciphertext = _state->sent_ciphertexts.value(phase);
+          for(int pidx = 0; pidx < msg_ppp.size() &&
+              pidx < last_ciphertext.size(); pidx++)
+          {
+            const char expected = last_ciphertext[pidx];
             const char actual = msg_ppp[pidx];
             if(expected == actual) {
               continue;
@@ -1419,7 +1729,7 @@ namespace Anonymity {
               }
               _state->accuse_idx = (offset - msg_length + pidx) * 8 + bidx;
               _state->accuse = true;
-              _state->blame_phase = _state_machine.GetPhase();
+              _state->blame_phase = phase;
               break;
             }
 
@@ -1437,8 +1747,8 @@ namespace Anonymity {
         continue;
       }
 
-      int phase = Serialization::ReadInt(msg_p, 0);
-      if(phase != _state_machine.GetPhase()) {
+      int msg_phase = Serialization::ReadInt(msg_p, 0);
+      if(msg_phase != phase) {
         next_msg_length += msg_length;
         next_msgs[owner] = msg_length;
         qDebug() << "Incorrect phase, skipping message";
@@ -1470,8 +1780,13 @@ namespace Anonymity {
       _server_state->current_phase_log->message_length = offset;
     }
 
-    _state->next_messages = next_msgs;
-    _state->msg_length = next_msg_length;
+    SlotLayout next_layout(next_msg_length);
+    next_layout.messages = next_msgs;
+    _state->layouts[phase + _pipeline_depth] = next_layout;
+
+    _state->layouts.remove(phase);
+    _state->sent_msgs.remove(phase);
+    _state->sent_ciphertexts.remove(phase);
   }
 
   QByteArray CSBulkRound::NullSeed()
@@ -1495,7 +1810,7 @@ namespace Anonymity {
     QByteArray random_text(msg.size(), 0);
     rng1->GenerateBlock(random_text);
 
-    Xor(random_text, random_text, msg);
+    Utils::XorBytes(random_text, random_text, msg);
 
     return seed + random_text;
   }
@@ -1520,7 +1835,7 @@ namespace Anonymity {
     QByteArray random_text(msg.size(), 0);
     rng->GenerateBlock(random_text);
 
-    Xor(random_text, random_text, msg);
+    Utils::XorBytes(random_text, random_text, msg);
     return random_text;
   }
 
@@ -1567,25 +1882,10 @@ namespace Anonymity {
   QPair<int, QByteArray> CSBulkRound::GetRebuttal(int phase, int accuse_idx,
       const QBitArray &server_bits)
   {
-    Library *lib = CryptoFactory::GetInstance().GetLibrary();
-    QSharedPointer<Hash> hashalgo(lib->GetHashAlgorithm());
-
-    QByteArray bphase(4, 0);
-    Serialization::WriteInt(phase, bphase, 0);
-
-    QVector<QSharedPointer<Random> > rngs;
-    int msg_size = accuse_idx / 8 + (accuse_idx % 8 > 0 ? 1 : 0);
     int bidx = -1;
-    QByteArray tmp(msg_size, 0);
     for(int idx = 0; idx < _state->base_seeds.size(); idx++) {
       const QByteArray &base_seed = _state->base_seeds[idx];
-      hashalgo->Update(base_seed);
-      hashalgo->Update(bphase);
-      hashalgo->Update(GetRoundId().GetByteArray());
-      QByteArray seed = hashalgo->ComputeHash();
-      QSharedPointer<Random> rng(lib->GetRandomNumberGenerator(seed));
-      rng->GenerateBlock(tmp);
-      if(((tmp[accuse_idx / 8] & bit_masks[accuse_idx % 8]) != 0) != server_bits[idx]) {
+      if(GetPadBit(base_seed, phase, accuse_idx) != server_bits[idx]) {
         bidx = idx;
         break;
       }
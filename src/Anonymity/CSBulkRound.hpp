@@ -1,6 +1,7 @@
 #ifndef DISSENT_ANONYMITY_CS_BULK_ROUND_H_GUARD
 #define DISSENT_ANONYMITY_CS_BULK_ROUND_H_GUARD
 
+#include <QFuture>
 #include <QMetaEnum>
 
 #include "Utils/TimerEvent.hpp"
@@ -37,6 +38,15 @@ namespace Anonymity {
    * and then distribute the final cleartext to all clients. RNGs are reset
    * each round to map to the shared secret between the client and server,
    * the RoundID (or nonce), and then the current phase.
+   *
+   * The round may optionally be pipelined k phases deep: the cleartext of
+   * phase N fixes the slot layout of phase N + k rather than N + 1, so the
+   * next message length in a slot refers to the owner's slot k phases
+   * later.  Clients submit their ciphertexts up to k - 1 phases ahead and
+   * servers generate pads for the next phase while the current one
+   * completes.  Each phase still has its own pads, layout, and log, so
+   * accusations continue to refer to a single phase.  A depth of 1 is the
+   * lock-step protocol; every member must use the same depth.
    */
   class CSBulkRound : public BaseBulkRound
   {
@@ -153,6 +163,17 @@ namespace Anonymity {
        * @param randomized_text the randomized text
        */
       static QByteArray Derandomize(const QByteArray &randomized_text);
+
+      /**
+       * Generates a pad of length bytes from each rng and returns their xor.
+       * When the CryptoFactory is multithreaded, the rngs are split across a
+       * worker pool and the partial results combined at the end, the result
+       * is the same either way.
+       * @param rngs the pad generators, each is consumed
+       * @param length the pad length in bytes
+       */
+      static QByteArray XorPads(const QVector<QSharedPointer<Random> > &rngs,
+          int length);
  
       /**
        * Returns the string representation of the round
@@ -183,6 +204,64 @@ namespace Anonymity {
 
       static const int MAX_GET = 4096;
 
+      /**
+       * The default pipeline depth, lock-step phases
+       */
+      static const int DEFAULT_PIPELINE_DEPTH = 1;
+
+      /**
+       * Sets the pipeline depth used by rounds constructed afterward.  A
+       * round fixes its depth when constructed and carries it in client
+       * ciphertexts, client lists, and cleartexts, members with a different
+       * depth are rejected
+       * @param depth the number of phases between a cleartext and the phase
+       * whose slot layout it determines, at least 1
+       */
+      static void SetPipelineDepth(int depth);
+
+      /**
+       * Returns the pipeline depth used by newly constructed rounds
+       */
+      static int GetPipelineDepth();
+
+      /**
+       * Returns the pipeline depth of this round
+       */
+      inline int GetRoundPipelineDepth() const { return _pipeline_depth; }
+
+      /**
+       * Versions of the generator DC-net pads are drawn from, every member
+       * of a round must use the same version
+       */
+      enum PadVersion {
+        /// The library's deterministic random number generator
+        PAD_VERSION_LEGACY = 1,
+        /// The library's seekable counter-mode generator
+        PAD_VERSION_COUNTER = 2
+      };
+
+      /**
+       * The default pad version
+       */
+      static const int DEFAULT_PAD_VERSION = PAD_VERSION_COUNTER;
+
+      /**
+       * Sets the pad version used by rounds constructed afterward, it is
+       * carried and checked alongside the pipeline depth
+       * @param version a PadVersion
+       */
+      static void SetPadVersion(int version);
+
+      /**
+       * Returns the pad version used by newly constructed rounds
+       */
+      static int GetPadVersion();
+
+      /**
+       * Returns the pad version of this round
+       */
+      inline int GetRoundPadVersion() const { return _pad_version; }
+
       virtual bool CSGroupCapable() const
       {
 #if DISSENT_TEST
@@ -231,30 +310,87 @@ namespace Anonymity {
       //Needed in protected for testing
       virtual QByteArray GenerateCiphertext();
 
+      /**
+       * The slots of a single phase
+       */
+      class SlotLayout {
+        public:
+          explicit SlotLayout(int length = 0) : length(length) {}
+
+          /**
+           * Slot owner to the length of its slot
+           */
+          QMap<int, int> messages;
+
+          /**
+           * Length of the phase's cleartext, including the slot request bits
+           */
+          int length;
+      };
+
       /**
        * Holds the internal state for this round
        */
       class State {
         public:
-          State() : accuse(false), start_accuse(false), my_accuse(false) {}
+          State() :
+            accuse(false),
+            ciphertext_phase(0),
+            next_ciphertext_phase(0),
+            start_accuse(false),
+            my_accuse(false)
+          {
+          }
+
           virtual ~State() {}
 
           QVector<QSharedPointer<AsymmetricKey> > anonymous_keys;
           QList<QByteArray> base_seeds;
           QVector<QSharedPointer<Random> > anonymous_rngs;
-          QMap<int, int> next_messages;
           QHash<int, QByteArray> signatures;
           QByteArray cleartext;
 
           QSharedPointer<AsymmetricKey> anonymous_key;
           QByteArray shuffle_data;
-          bool read;
-          bool slot_open;
           bool accuse;
-          QByteArray next_msg;
-          QByteArray last_msg;
-          QByteArray last_ciphertext;
-          int msg_length;
+
+          /**
+           * Slot layouts of the current and upcoming phases
+           */
+          QMap<int, SlotLayout> layouts;
+
+          /**
+           * The phase a ciphertext is being generated for
+           */
+          int ciphertext_phase;
+
+          /**
+           * The next phase a client will submit a ciphertext for
+           */
+          int next_ciphertext_phase;
+
+          /**
+           * Messages whose length has been announced, by the phase in which
+           * they will be written into our slot
+           */
+          QMap<int, QByteArray> slot_msgs;
+
+          /**
+           * Messages retrieved but not yet announced
+           */
+          QList<QByteArray> unsent_msgs;
+
+          /**
+           * Phases in which we requested a slot that has not yet started
+           */
+          QList<int> slot_requests;
+
+          /**
+           * The message and randomized slot contents we wrote in each phase
+           */
+          QMap<int, QByteArray> sent_msgs;
+          QMap<int, QByteArray> sent_ciphertexts;
+
           int base_msg_length;
           int my_idx;
           Id my_server;
@@ -275,7 +411,10 @@ namespace Anonymity {
         public:
           PhaseLog(int phase, int max) : phase(phase), _max(max) { }
 
-          QPair<QBitArray, QBitArray> GetBitsAtIndex(int msg_idx)
+          /**
+           * Returns the bit at msg_idx of each client's ciphertext
+           */
+          QBitArray GetClientBitsAtIndex(int msg_idx)
           {
             QBitArray clients(_max, false);
             foreach(int idx, messages.keys()) {
@@ -283,23 +422,22 @@ namespace Anonymity {
               int bit_idx = msg_idx % 8;
               clients[idx] = (messages[idx][byte_idx] & bit_masks[bit_idx]) > 0;
             }
-
-            QBitArray mine(_max, false);
-            foreach(int idx, my_sub_ciphertexts.keys()) {
-              int byte_idx = msg_idx / 8;
-              int bit_idx = msg_idx % 8;
-              mine[idx] = (my_sub_ciphertexts[idx][byte_idx] & bit_masks[bit_idx]) > 0;
-            }
-
-            return QPair<QBitArray, QBitArray>(clients, mine);
+            return clients;
           }
 
+          inline int GetMax() const { return _max; }
+
           QBitArray clients;
           QVector<int> message_offsets;
           int message_length;
           QHash<int, int> client_to_server;
           QHash<int, QByteArray> messages;
-          QHash<int, QByteArray> my_sub_ciphertexts;
+
+          /**
+           * Group indexes of the clients whose pads were included in our
+           * ciphertext, the pads themselves are regenerated on demand
+           */
+          QVector<int> pad_owners;
           int phase;
 
         private:
@@ -312,7 +450,7 @@ namespace Anonymity {
        */
       class ServerState : public State {
         public:
-          ServerState() : accuse_found(false) { }
+          ServerState() : precomputed_phase(-1), accuse_found(false) { }
           virtual ~ServerState() {}
 
           Utils::TimerEvent client_ciphertext_period;
@@ -329,6 +467,15 @@ namespace Anonymity {
           QList<QByteArray> client_ciphertexts;
 
           QSet<Id> handled_servers;
+
+          /**
+           * Xor of the pads of the next phase's expected clients, generated
+           * in the background while the current phase completes
+           */
+          QFuture<QByteArray> precomputed_pads;
+          int precomputed_phase;
+          QVector<int> precomputed_owners;
+
           QHash<int, int> rng_to_gidx;
           QHash<int, QByteArray> server_commits;
           QHash<int, QByteArray> server_ciphertexts;
@@ -435,6 +582,15 @@ namespace Anonymity {
        */
       void HandleServerCleartext(const Id &from, QDataStream &stream);
 
+      /**
+       * Reads the pipeline depth and pad version carried by client
+       * ciphertexts, client lists, and cleartexts
+       * @param stream message
+       * @param reason set to the mismatch if they differ from this round's
+       * @returns true if they match this round's
+       */
+      bool ReadRoundParameters(QDataStream &stream, QString &reason) const;
+
       void HandleBlameBits(const Id &from, QDataStream &stream);
 
       void HandleRebuttal(const Id &from, QDataStream &stream);
@@ -449,11 +605,51 @@ namespace Anonymity {
       void SetupRngSeeds();
 
       /**
-       * For clients, this is a trivial setup, one for each server, servers
-       * need to set this after determining the online client set.
+       * Sets up the rngs for the ciphertext phase.  For clients, this is a
+       * trivial setup, one for each server, servers need to set this after
+       * determining the online client set.
        */
       void SetupRngs();
 
+      /**
+       * Returns the length of the current phase's cleartext
+       */
+      inline int GetMessageLength() const
+      {
+        return _state->layouts.value(_state_machine.GetPhase()).length;
+      }
+
+      /**
+       * Derives the seed of the pad shared with a peer for a given phase
+       * @param base_seed the shared secret with the peer
+       * @param phase the phase of the pad
+       */
+      QByteArray GetPadSeed(const QByteArray &base_seed, int phase) const;
+
+      /**
+       * Returns the generator for a pad seed according to the pad version
+       * @param seed the pad seed
+       */
+      Random *CreatePadRng(const QByteArray &seed) const;
+
+      /**
+       * Returns generators of the pads shared with peers for a
+       * given phase, deriving every seed in a single batch hash
+       * @param base_seeds the shared secrets, empty secrets are skipped
+       * @param phase the phase of the pads
+       */
+      QVector<QSharedPointer<Random> > GetPadRngs(
+          const QList<QByteArray> &base_seeds, int phase) const;
+
+      /**
+       * Regenerates a single bit of the pad shared with a peer, seeking
+       * directly to it when the generator supports it
+       * @param base_seed the shared secret with the peer
+       * @param phase the phase of the pad
+       * @param msg_idx the bit index into the pad
+       */
+      bool GetPadBit(const QByteArray &base_seed, int phase, int msg_idx) const;
+
       /* Below are the state transitions */
       void StartShuffle();
       void ProcessDataShuffle();
@@ -475,10 +671,47 @@ namespace Anonymity {
       void PushVerdict();
 
       /* Below are the ciphertext generation helpers */
+
+      /**
+       * Generates a pad from each anonymous rng and returns their xor, on
+       * servers the individual pads are logged for blame.  When the
+       * CryptoFactory is multithreaded, the rngs are split across a worker
+       * pool and the partial results combined at the end.  Pads precomputed
+       * for the ciphertext phase are used when available.
+       */
+      QByteArray GeneratePads();
+
+      /**
+       * Servers start generating, in the background, the pads for a phase
+       * assuming the same clients as the current phase submit
+       * @param phase the upcoming phase
+       */
+      void PrecomputePads(int phase);
+
+      /**
+       * Returns the precomputed pads for the ciphertext phase, corrected for
+       * the clients that actually submitted, or an empty array if there are
+       * none
+       */
+      QByteArray TakePrecomputedPads();
+
       void GenerateServerCiphertext();
       QByteArray GenerateSlotMessage();
+
+      /**
+       * Returns true if there is a message waiting for a slot that has not
+       * yet been requested
+       */
       bool CheckData();
 
+      /**
+       * Schedules the message written in our slot during phase to be
+       * written again in the slot pipeline depth phases later, used when
+       * the slot's contents did not make it into the cleartext
+       * @param phase the phase whose slot failed
+       */
+      void ResendSlotMessage(int phase);
+
       void ProcessCleartext();
       void ConcludeClientCiphertextSubmission(const int &);
       virtual void IncomingDataSpecial(const Request &notification)
@@ -510,6 +743,8 @@ namespace Anonymity {
       QSharedPointer<ServerState> _server_state;
       QSharedPointer<State> _state;
       RoundStateMachine<CSBulkRound> _state_machine;
+      const int _pipeline_depth;
+      const int _pad_version;
       bool _stop_next;
       Messaging::GetDataMethod<CSBulkRound> _get_blame_data;
       BufferSink _blame_sink;
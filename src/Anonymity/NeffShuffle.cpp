@@ -1,3 +1,4 @@
+#include <QThread>
 #include <QThreadPool>
 #include "Crypto/CppDsaPrivateKey.hpp"
 #include "Crypto/CppDsaPublicKey.hpp"
@@ -23,8 +24,12 @@ namespace Anonymity {
       GetDataCallback &get_data,
       bool key_shuffle) :
     Round(group, ident, round_id, network, get_data),
-    _state_machine(this)
+    _state_machine(this),
+    _verify_cancelled(new QAtomicInt(0))
   {
+    qRegisterMetaType<QVector<QByteArray> >("QVector<QByteArray>");
+    _verify_pool.setMaxThreadCount(QThread::idealThreadCount());
+
     _state_machine.AddState(OFFLINE);
     _state_machine.AddState(MSG_GENERATION, -1, 0, &NeffShuffle::GenerateMessage);
     _state_machine.AddState(MSG_SUBMISSION, -1, 0, &NeffShuffle::SubmitMessage);
@@ -41,6 +46,8 @@ namespace Anonymity {
 
   NeffShuffle::~NeffShuffle()
   {
+    _verify_cancelled->fetchAndStoreOrdered(1);
+    _verify_pool.waitForDone();
   }
 
   void NeffShuffle::VerifiableBroadcastToServers(const QByteArray &data)
@@ -75,6 +82,7 @@ namespace Anonymity {
   void NeffShuffle::InitServer()
   {
     _server_state = QSharedPointer<ServerState>(new ServerState());
+    _server_state->verified = QVector<bool>(GetGroup().GetSubgroup().Count(), false);
     _state = _server_state;
 
     _state_machine.AddState(KEY_GENERATION, -1, 0, &NeffShuffle::GenerateKey);
@@ -151,6 +159,7 @@ namespace Anonymity {
 
   void NeffShuffle::OnStop()
   {
+    _verify_cancelled->fetchAndStoreOrdered(1);
     Round::OnStop();
   }
 
@@ -328,22 +337,18 @@ namespace Anonymity {
     qDebug() << GetGroup().GetIndex(GetLocalId()) << GetLocalId() <<
         ": received shuffle data from" << GetGroup().GetIndex(from) << from;
 
-    int index = GetGroup().GetSubgroup().GetIndex(from);
-    if(index == _server_state->new_end_verify_idx) {
-      int increment = 0;
-      for(Id current = from; _server_state->shuffle_proof.contains(current);
-          current = GetGroup().GetSubgroup().Next(current))
-      {
-        increment++;
-      }
+    VerifyShuffles();
+    if(Stopped()) {
+      return;
+    }
 
-      if(_server_state->verifying) {
-        _server_state->new_end_verify_idx += increment;
-      } else {
-        _server_state->new_end_verify_idx += increment;
-        _server_state->end_verify_idx += increment;
-        VerifyShuffles();
-      }
+    // Shuffle the claimed input now, it is only transmitted once every
+    // previous transcript has been verified
+    if(_state_machine.GetState() == WAITING_FOR_SHUFFLES_BEFORE_TURN &&
+        _server_state->next_verify_idx ==
+        GetGroup().GetSubgroup().GetIndex(GetLocalId()))
+    {
+      _state_machine.StateComplete();
     }
   }
 
@@ -521,13 +526,39 @@ namespace Anonymity {
 
   void NeffShuffle::ShuffleMessages()
   {
+    _server_state->shuffled = false;
     NeffShufflePrivate::ShuffleMessages *shuffler =
       new NeffShufflePrivate::ShuffleMessages(this);
     QObject::connect(shuffler, SIGNAL(Finished()),
-        this, SLOT(OperationFinished()));
+        this, SLOT(ShuffleMessagesDone()));
     QThreadPool::globalInstance()->start(shuffler);
   }
 
+  void NeffShuffle::ShuffleMessagesDone()
+  {
+    _server_state->shuffled = true;
+    TryTransmitShuffle();
+  }
+
+  void NeffShuffle::TryTransmitShuffle()
+  {
+    if(_state_machine.GetState() != SHUFFLING || !_server_state->shuffled) {
+      return;
+    }
+
+    if(_server_state->verified_count <
+        GetGroup().GetSubgroup().GetIndex(GetLocalId()))
+    {
+      qDebug() << GetGroup().GetIndex(GetLocalId()) << GetLocalId() <<
+        ": shuffle ready, waiting on verification of" <<
+        _server_state->verified_count << "of" <<
+        GetGroup().GetSubgroup().GetIndex(GetLocalId()) << "transcripts";
+      return;
+    }
+
+    _state_machine.StateComplete();
+  }
+
   void NeffShuffle::TransmitShuffle()
   {
     QByteArray transcript = _server_state->shuffle_proof.value(GetLocalId());
@@ -548,28 +579,70 @@ namespace Anonymity {
 
   void NeffShuffle::VerifyShuffles()
   {
-    NeffShufflePrivate::VerifyShuffles *verifier =
-      new NeffShufflePrivate::VerifyShuffles(this);
-    QObject::connect(verifier, SIGNAL(Finished()),
-        this, SLOT(VerifyShufflesDone()));
-    QThreadPool::globalInstance()->start(verifier);
+    while(_server_state->next_verify_idx < GetGroup().GetSubgroup().Count()) {
+      int idx = _server_state->next_verify_idx;
+      Id id = GetGroup().GetSubgroup().GetId(idx);
+      if(!_server_state->shuffle_proof.contains(id)) {
+        return;
+      }
+
+      QByteArray transcript = _server_state->shuffle_proof[id];
+      QSharedPointer<KeyType> key;
+      if(idx == GetGroup().GetSubgroup().Count() - 1) {
+        key = _server_state->my_key;
+      }
+
+      NeffShufflePrivate::VerifyShuffles *verifier =
+        new NeffShufflePrivate::VerifyShuffles(idx, key,
+            _server_state->next_verify_input,
+            _server_state->next_verify_keys, transcript, _verify_cancelled);
+      QObject::connect(verifier,
+          SIGNAL(Finished(int, bool, const QVector<QByteArray> &)),
+          this, SLOT(VerifyShufflesDone(int, bool, const QVector<QByteArray> &)));
+      _verify_pool.start(verifier);
+
+      QVector<QByteArray> output;
+      if(!CppNeffShuffle::GetOutput(transcript, output)) {
+        Stop("Unable to parse transcript from " + id.ToString());
+        return;
+      }
+
+      _server_state->next_verify_input = output;
+      _server_state->next_verify_keys.pop_front();
+      _server_state->next_verify_idx++;
+    }
   }
 
-  void NeffShuffle::VerifyShufflesDone()
+  void NeffShuffle::VerifyShufflesDone(int idx, bool valid,
+      const QVector<QByteArray> &cleartext)
   {
-    _server_state->verifying = false;
-    if(_server_state->new_end_verify_idx != _server_state->end_verify_idx) {
-      _server_state->end_verify_idx = _server_state->new_end_verify_idx;
-      VerifyShuffles();
+    if(Stopped()) {
       return;
     }
 
-    if(_server_state->end_verify_idx == GetGroup().GetSubgroup().GetIndex(GetLocalId())) {
-      _state_machine.StateComplete();
+    Id id = GetGroup().GetSubgroup().GetId(idx);
+    if(!valid) {
+      qCritical() << "Invalid transcript from" << id << "at idx" << idx;
+      Stop("Invalid transcript from " + id.ToString());
       return;
     }
 
-    if(_server_state->end_verify_idx == GetGroup().GetSubgroup().Count()) {
+    if(idx == GetGroup().GetSubgroup().Count() - 1) {
+      _server_state->cleartext = cleartext;
+    }
+
+    _server_state->verified[idx] = true;
+    while(_server_state->verified_count < _server_state->verified.size() &&
+        _server_state->verified[_server_state->verified_count])
+    {
+      _server_state->verified_count++;
+    }
+
+    if(_state_machine.GetState() == SHUFFLING) {
+      TryTransmitShuffle();
+    } else if(_state_machine.GetState() == WAITING_FOR_SHUFFLES_AFTER_TURN &&
+        _server_state->verified_count == GetGroup().GetSubgroup().Count())
+    {
       _state_machine.StateComplete();
     }
   }
@@ -628,6 +701,7 @@ namespace Anonymity {
     }
 
     _server_state->initial_input = pruned;
+    _server_state->next_verify_input = pruned;
 
     _state_machine.StateComplete();
   }
@@ -680,37 +754,26 @@ namespace NeffShufflePrivate {
 
   void VerifyShuffles::run()
   {
-    QVector<QSharedPointer<Crypto::AsymmetricKey> > remaining_keys =
-      _shuffle->_server_state->next_verify_keys;
-    QVector<QByteArray> input = _shuffle->_server_state->next_verify_input;
+    if(_cancelled->fetchAndAddOrdered(0)) {
+      return;
+    }
+
     QVector<QByteArray> output;
     CppNeffShuffle shuffle;
+    bool valid = shuffle.Verify(_input, _keys, _transcript, output);
 
-    for(int idx = _shuffle->_server_state->next_verify_idx; 
-        idx < _shuffle->_server_state->end_verify_idx; idx++)
-    {
-      Connections::Id id = _shuffle->GetGroup().GetSubgroup().GetId(idx);
-      QByteArray transcript = _shuffle->_server_state->shuffle_proof[id];
-      if(!shuffle.Verify(input, remaining_keys, transcript, output)) {
-        qCritical() << "Invalid transcript from" << id << "at idx" << idx;
+    QVector<QByteArray> cleartext;
+    if(valid && !_key.isNull()) {
+      foreach(const QByteArray &pair, output) {
+        cleartext.append(_key->SeriesDecryptFinish(pair));
       }
-      input = output;
-      remaining_keys.pop_front();
     }
 
-    _shuffle->_server_state->next_verify_keys = remaining_keys;
-    _shuffle->_server_state->next_verify_input = input;
-    _shuffle->_server_state->next_verify_idx = _shuffle->_server_state->end_verify_idx;
-
-    if(_shuffle->_server_state->end_verify_idx == _shuffle->GetGroup().GetSubgroup().Count()) {
-      _shuffle->_state->cleartext.clear();
-      foreach(const QByteArray &pair, output) {
-        _shuffle->_server_state->cleartext.append(
-            _shuffle->_server_state->my_key->SeriesDecryptFinish(pair));
-      }
+    if(_cancelled->fetchAndAddOrdered(0)) {
+      return;
     }
 
-    emit Finished();
+    emit Finished(_idx, valid, cleartext);
   }
 }
 }
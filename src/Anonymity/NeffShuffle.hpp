@@ -1,6 +1,9 @@
 #ifndef DISSENT_ANONYMITY_NEFF_MSG_SHUFFLE_H_GUARD
 #define DISSENT_ANONYMITY_NEFF_MSG_SHUFFLE_H_GUARD
 
+#include <QAtomicInt>
+#include <QThreadPool>
+
 #include "Connections/Network.hpp"
 #include "Crypto/AsymmetricKey.hpp"
 #include "Crypto/CppDsaPrivateKey.hpp"
@@ -181,7 +184,6 @@ namespace NeffShufflePrivate {
     private:
       friend class NeffShufflePrivate::KeyGeneration;
       friend class NeffShufflePrivate::ShuffleMessages;
-      friend class NeffShufflePrivate::VerifyShuffles;
 
       void InitServer();
       void InitClient();
@@ -205,13 +207,26 @@ namespace NeffShufflePrivate {
       void PrepareForMessageSubmissions();
       void ShuffleMessages();
       void TransmitShuffle();
-      void VerifyShuffles();
       void SubmitSignature();
       void PushMessages();
       void Finished();
 
       void ConcludeMessageSubmission(const int &);
 
+      /**
+       * Starts verifying, each on its own pool thread, every received
+       * transcript whose input is known.  The input to the next transcript
+       * is the output claimed by the previous one, so verification of a
+       * transcript overlaps with later shuffles and verifications.
+       */
+      void VerifyShuffles();
+
+      /**
+       * Moves on to transmitting the local shuffle once it is done and the
+       * transcripts of all previous servers have been verified
+       */
+      void TryTransmitShuffle();
+
       /**
        * Internal state specific to servers
        */
@@ -219,10 +234,9 @@ namespace NeffShufflePrivate {
         public:
           ServerState() :
             msgs_received(0),
-            verifying(false),
             next_verify_idx(0),
-            end_verify_idx(0),
-            new_end_verify_idx(0)
+            verified_count(0),
+            shuffled(false)
           {}
 
           virtual ~ServerState() {}
@@ -238,10 +252,10 @@ namespace NeffShufflePrivate {
           QVector<QByteArray> initial_input;
           QHash<Id, QByteArray > shuffle_proof;
           QVector<QByteArray> next_verify_input;
-          bool verifying;
           int next_verify_idx;
-          int end_verify_idx;
-          int new_end_verify_idx;
+          QVector<bool> verified;
+          int verified_count;
+          bool shuffled;
           QVector<QSharedPointer<AsymmetricKey> > next_verify_keys;
           QByteArray cleartext_hash;
           QHash<Id, QByteArray > signatures;
@@ -251,9 +265,21 @@ namespace NeffShufflePrivate {
       QSharedPointer<State> _state;
       RoundStateMachine<NeffShuffle> _state_machine;
 
+      /**
+       * Set on stop so queued verifiers return without verifying
+       */
+      QSharedPointer<QAtomicInt> _verify_cancelled;
+
+      /**
+       * Runs the verifiers, drained before the round is destroyed
+       */
+      QThreadPool _verify_pool;
+
     private slots:
       void OperationFinished();
-      void VerifyShufflesDone();
+      void ShuffleMessagesDone();
+      void VerifyShufflesDone(int idx, bool valid,
+          const QVector<QByteArray> &cleartext);
   };
 
 namespace NeffShufflePrivate {
@@ -289,20 +315,56 @@ namespace NeffShufflePrivate {
       NeffShuffle *_shuffle;
   };
 
+  /**
+   * Verifies a single server's transcript without touching the round, the
+   * verifier of the last transcript also decrypts the cleartext
+   */
   class VerifyShuffles : public QObject, public QRunnable {
     Q_OBJECT
 
     public:
-      VerifyShuffles(NeffShuffle *shuffle) : _shuffle(shuffle) { }
+      /**
+       * Constructor
+       * @param idx the server's index in the subgroup
+       * @param key the local decryption key for the last transcript, else null
+       * @param input the messages the server shuffled
+       * @param keys the keys of the server and the remaining servers
+       * @param transcript the server's transcript
+       * @param cancelled set once the round no longer wants the result
+       */
+      VerifyShuffles(int idx, const QSharedPointer<Crypto::CppDsaPrivateKey> &key,
+          const QVector<QByteArray> &input,
+          const QVector<QSharedPointer<Crypto::AsymmetricKey> > &keys,
+          const QByteArray &transcript,
+          const QSharedPointer<QAtomicInt> &cancelled) :
+        _idx(idx),
+        _key(key),
+        _input(input),
+        _keys(keys),
+        _transcript(transcript),
+        _cancelled(cancelled)
+      {
+      }
 
       virtual ~VerifyShuffles() { }
       virtual void run();
 
     signals:
-      void Finished();
+      /**
+       * Emitted unless cancelled
+       * @param idx the server's index in the subgroup
+       * @param valid true if the transcript is valid
+       * @param cleartext the decrypted output of a valid last transcript
+       */
+      void Finished(int idx, bool valid, const QVector<QByteArray> &cleartext);
 
     private:
-      NeffShuffle *_shuffle;
+      const int _idx;
+      const QSharedPointer<Crypto::CppDsaPrivateKey> _key;
+      const QVector<QByteArray> _input;
+      const QVector<QSharedPointer<Crypto::AsymmetricKey> > _keys;
+      const QByteArray _transcript;
+      const QSharedPointer<QAtomicInt> _cancelled;
   };
 }
 }
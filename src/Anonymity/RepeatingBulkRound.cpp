@@ -13,6 +13,7 @@
 #include "Utils/Serialization.hpp"
 #include "Utils/Timer.hpp"
 #include "Utils/TimerCallback.hpp"
+#include "Utils/Xor.hpp"
 
 #include "RepeatingBulkRound.hpp"
 #include "BulkRound.hpp"
@@ -273,9 +274,7 @@ namespace Anonymity {
     uint size = GetGroup().Count();
 
     QByteArray cleartext(_expected_bulk_size, 0);
-    foreach(QByteArray ciphertext, _messages) {
-      Xor(cleartext, cleartext, ciphertext);
-    }
+    Utils::XorAccumulate(cleartext, _messages.toList());
 
     uint msg_idx = 0;
     for(uint member_idx = 0; member_idx < size; member_idx++) {
@@ -57,7 +57,12 @@ namespace Anonymity {
 
   bool Round::Verify(const Id &from, const QByteArray &data, QByteArray &msg)
   {
-    QSharedPointer<AsymmetricKey> key = GetGroup().GetKey(from);
+    return Verify(GetGroup().GetKey(from), data, msg);
+  }
+
+  bool Round::Verify(const QSharedPointer<AsymmetricKey> &key,
+      const QByteArray &data, QByteArray &msg)
+  {
     if(key.isNull()) {
       qDebug() << "Received malsigned data block, no such peer";
       return false;
@@ -195,6 +195,17 @@ namespace Anonymity {
        */
       bool Verify(const Id &from, const QByteArray &data, QByteArray &msg);
 
+      /**
+       * Verifies that the provided data has a signature block and is properly
+       * signed by key, returning the data block via msg.  Does not touch the
+       * round and hence may be called from worker threads.
+       * @param key the signing peers key
+       * @param data the data + signature blocks
+       * @param msg the data block
+       */
+      static bool Verify(const QSharedPointer<AsymmetricKey> &key,
+          const QByteArray &data, QByteArray &msg);
+
       /**
        * Signs and encrypts a message before broadcasting
        * @param data the message to broadcast
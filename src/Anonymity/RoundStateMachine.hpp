@@ -1,8 +1,15 @@
 #ifndef DISSENT_ANONYMITY_ROUND_STATE_MACHINE_H_GUARD
 #define DISSENT_ANONYMITY_ROUND_STATE_MACHINE_H_GUARD
 
+#include <QtConcurrentMap>
+
 #include "Connections/Id.hpp"
+#include "Crypto/CryptoFactory.hpp"
+#include "Utils/Metrics.hpp"
 #include "Utils/QRunTimeError.hpp"
+#include "Utils/Time.hpp"
+#include "Utils/Timer.hpp"
+#include "Utils/TimerCallback.hpp"
 
 #include "Round.hpp"
 #include "Log.hpp"
@@ -17,6 +24,16 @@ namespace Anonymity {
    * knowledge about cycles.  It seemed better to encapsulate that behavior
    * and construct this instead.
    *
+   * When the CryptoFactory is MultiThreaded, incoming messages are not
+   * verified as they arrive.  Instead they are queued and, once the event
+   * that delivered them completes, the signatures of all queued messages
+   * are checked concurrently and the messages are dispatched in arrival
+   * order.  Messages held for a future state retain their verified payload,
+   * so they are not verified again when replayed.
+   *
+   * The time spent in each state and each phase is recorded in the
+   * dissent_round_state_seconds and dissent_round_phase_seconds metrics.
+   *
    * @TODO Make a RoundStateMachineImpl for inheritance purposes, so classes
    * can properly implement the necessary behaviors for RoundStateMachine.
    */
@@ -36,14 +53,23 @@ namespace Anonymity {
       RoundStateMachine(T *round) :
         _round(round),
         _phase(0),
-        _cycle_state(-1)
+        _cycle_state(-1),
+        _verify_queued(false),
+        _verifying(false),
+        _state_start(Utils::Time::GetInstance().MSecsSinceEpoch()),
+        _phase_start(_state_start)
       {
       }
 
       /**
        * Destructor, I don't think that this class should be extended
        */
-      ~RoundStateMachine() {}
+      ~RoundStateMachine()
+      {
+        if(_verify_queued) {
+          _verify_event.Stop();
+        }
+      }
 
       /**
        * Returns the State to a string
@@ -111,8 +137,13 @@ namespace Anonymity {
       void StateComplete(int state = -1)
       {
         _round->BeforeStateTransition(); 
-        Log tmp = _next_state_log;
-        _next_state_log = Log();
+        QList<Message> tmp = _next_state_log;
+        _next_state_log.clear();
+
+        qint64 now = Utils::Time::GetInstance().MSecsSinceEpoch();
+        StateMetric(GetCurrentState()->GetState()).Observe(
+            (now - _state_start) * 1000);
+        _state_start = now;
 
         if((_cycle_state == GetCurrentState()->GetState()) && (state == -1)) {
           qDebug() << "In" << _round->ToString() << "ending phase";
@@ -121,6 +152,8 @@ namespace Anonymity {
           }
           _log = Log();
           IncrementPhase();
+          PhaseMetric().Observe((now - _phase_start) * 1000);
+          _phase_start = now;
           qDebug() << "In" << _round->ToString() << "starting phase";
         }
 
@@ -138,9 +171,8 @@ namespace Anonymity {
 
         (_round->*GetCurrentState()->GetTransitionCallback())();
 
-        for(int idx = 0; idx < tmp.Count(); idx++) {
-          QPair<QByteArray, Id> entry = tmp.At(idx);
-          ProcessData(entry.second, entry.first);
+        foreach(const Message &msg, tmp) {
+          DispatchMessage(msg);
         }
       }
 
@@ -152,19 +184,25 @@ namespace Anonymity {
        */
       void ProcessData(const Id &from, const QByteArray &data)
       {
-        _log.Append(data, from);
-        try {
-          ProcessDataBase(from, data);
-        } catch (QRunTimeError &err) {
-          qWarning() << _round->GetGroup().GetIndex(_round->GetLocalId()) <<
-            _round->GetLocalId() << "received a message from" <<
-            _round->GetGroup().GetIndex(from) << from << "in" <<
-            _round->GetRoundId() << "in state" <<
-            StateToString(GetCurrentState()->GetState()) <<
-            "causing the following exception:" << err.What();
-          _log.Pop();
+        Message msg(from, data, _round->GetGroup().GetKey(from));
+
+        if(CryptoFactory::GetInstance().GetThreadingType() ==
+            CryptoFactory::SingleThreaded)
+        {
+          VerifyMessage(msg);
+          DispatchMessage(msg);
           return;
         }
+
+        _pending.append(msg);
+        if(_verify_queued || _verifying) {
+          return;
+        }
+
+        _verify_queued = true;
+        Utils::TimerCallback *cb = new Utils::TimerMethod<RoundStateMachine<T>, int>(
+            this, &RoundStateMachine<T>::VerifyPending, 0);
+        _verify_event = Utils::Timer::GetInstance().QueueCallback(cb, 0);
       }
 
       /**
@@ -190,6 +228,93 @@ namespace Anonymity {
       void ToggleLog() { _log.ToggleEnabled(); }
 
     private:
+      typedef Crypto::AsymmetricKey AsymmetricKey;
+      typedef Crypto::CryptoFactory CryptoFactory;
+
+      /**
+       * An incoming message along with the result of its verification
+       */
+      class Message {
+        public:
+          Message() : verified(false) {}
+
+          Message(const Id &from, const QByteArray &data,
+              const QSharedPointer<AsymmetricKey> &key) :
+            from(from), data(data), key(key), verified(false)
+          {
+          }
+
+          Id from;
+          QByteArray data;
+          QSharedPointer<AsymmetricKey> key;
+          QByteArray payload;
+          bool verified;
+      };
+
+      /**
+       * Checks the signature on a message, storing the payload, safe to call
+       * from worker threads
+       * @param msg the message to verify
+       */
+      static void VerifyMessage(Message &msg)
+      {
+        msg.verified = T::Verify(msg.key, msg.data, msg.payload);
+      }
+
+      /**
+       * Verifies all queued messages concurrently and then dispatches them in
+       * the order they arrived.  Messages that arrive while dispatching are
+       * appended to the queue and handled by the same loop.
+       */
+      void VerifyPending(const int &)
+      {
+        _verify_queued = false;
+        if(_verifying) {
+          return;
+        }
+
+        // Keep the round alive should one of the handlers stop it
+        QSharedPointer<Round> round = _round->GetSharedPointer();
+        _verifying = true;
+
+        while(!_pending.isEmpty() && !_round->Stopped()) {
+          QList<Message> batch = _pending;
+          _pending.clear();
+          QtConcurrent::blockingMap(batch, &RoundStateMachine<T>::VerifyMessage);
+
+          foreach(const Message &msg, batch) {
+            if(_round->Stopped()) {
+              break;
+            }
+            DispatchMessage(msg);
+          }
+        }
+
+        _pending.clear();
+        _verifying = false;
+      }
+
+      /**
+       * Logs and handles a verified message, catching any exceptions
+       * @param msg the message
+       */
+      void DispatchMessage(const Message &msg)
+      {
+        _log.Append(msg.data, msg.from);
+        try {
+          ProcessDataBase(msg);
+        } catch (QRunTimeError &err) {
+          qWarning() << _round->GetGroup().GetIndex(_round->GetLocalId()) <<
+            _round->GetLocalId() << "received a message from" <<
+            _round->GetGroup().GetIndex(msg.from) << msg.from << "in" <<
+            _round->GetRoundId() << "in state" <<
+            StateToString(GetCurrentState()->GetState()) <<
+            "causing the following exception:" << err.What();
+          _log.Pop();
+          return;
+        }
+      }
+
       /**
        * An internal immutable state handler
        */
@@ -231,6 +356,42 @@ namespace Anonymity {
           TransitionCallback _callback;
       };
 
+      /**
+       * Returns the label identifying the round's type in metrics
+       */
+      QString RoundLabel() const
+      {
+        QString name = QString(_round->metaObject()->className()).section("::", -1);
+        return Utils::Metrics::Label("round", name);
+      }
+
+      /**
+       * Returns the histogram of the time spent in a state
+       */
+      const Utils::Metrics::Histogram &StateMetric(int state)
+      {
+        if(!_state_metrics.contains(state)) {
+          _state_metrics[state] = Utils::Metrics::GetHistogram(
+              "dissent_round_state_seconds", "Time spent in a round state",
+              RoundLabel() + "," + Utils::Metrics::Label("state",
+                StateToString(state)));
+        }
+        return _state_metrics[state];
+      }
+
+      /**
+       * Returns the histogram of the time spent in a phase
+       */
+      const Utils::Metrics::Histogram &PhaseMetric()
+      {
+        if(!_phase_metric.IsValid()) {
+          _phase_metric = Utils::Metrics::GetHistogram(
+              "dissent_round_phase_seconds", "Time spent in a round phase",
+              RoundLabel());
+        }
+        return _phase_metric;
+      }
+
       /**
        * Returns the current state
        */
@@ -260,17 +421,15 @@ namespace Anonymity {
       /**
        * Does the actual hard work for processing data, this is split since the
        * ProcessData is more used to catch exceptions and handle logging.
-       * @param from the sending member
-       * @param data the data sent
+       * @param msg the message, having already been verified
        */
-      void ProcessDataBase(const Id &from, const QByteArray &data)
+      void ProcessDataBase(const Message &msg)
       {
-        QByteArray payload;
-        if(!_round->Verify(from, data, payload)) {
+        if(!msg.verified) {
           throw QRunTimeError("Invalid signature or data");
         }
         
-        QDataStream stream(payload);
+        QDataStream stream(msg.payload);
 
         int mtype;
         QByteArray round_id;
@@ -305,11 +464,11 @@ namespace Anonymity {
             (_phase < phase))
         {
           _log.Pop();
-          _next_state_log.Append(data, from);
+          _next_state_log.append(msg);
           return;
         }
 
-        (_round->*GetCurrentState()->GetMessageHandler())(from, stream);
+        (_round->*GetCurrentState()->GetMessageHandler())(msg.from, stream);
       }
 
       QHash<int, bool> _valid_message_types;
@@ -319,12 +478,22 @@ namespace Anonymity {
       QSharedPointer<State> _current_sm_state;
 
       Log _log;
-      Log _next_state_log;
+      QList<Message> _next_state_log;
 
       T *_round;
 
       int _phase;
       int _cycle_state;
+
+      QList<Message> _pending;
+      Utils::TimerEvent _verify_event;
+      bool _verify_queued;
+      bool _verifying;
+
+      qint64 _state_start;
+      qint64 _phase_start;
+      QHash<int, Utils::Metrics::Histogram> _state_metrics;
+      Utils::Metrics::Histogram _phase_metric;
   };
 
   template <typename T> void RoundStateMachine<T>::AddState(int state,
@@ -1,5 +1,7 @@
 #include <algorithm>
 
+#include <QThread>
+
 #include "Connections/Connection.hpp"
 #include "Connections/ConnectionManager.hpp"
 #include "Connections/ConnectionTable.hpp"
@@ -28,8 +30,11 @@ namespace Sessions {
     _network(network),
     _session(session),
     _round_idx(0),
-    _auth(auth)
+    _auth(auth),
+    _next_verification(0)
   {
+    _verify_pool.setMaxThreadCount(QThread::idealThreadCount());
+
 #ifdef NO_SESSION_MANAGER
     _network->Register("SM::Prepared", this, "HandlePrepared");
     _network->Register("SM::ChallengeRequest", this, "HandleChallengeRequest");
@@ -59,6 +64,7 @@ namespace Sessions {
     // into a partially decomposed SessionLeaderManager
     QObject::disconnect(this, 0, 0, 0);
     Stop();
+    _verify_pool.waitForDone();
   }
 
   void SessionLeader::OnStart()
@@ -127,7 +133,61 @@ namespace Sessions {
       return;
     }
 
-    QPair<bool, PublicIdentity> auth = _auth->VerifyResponse(sender_id, cresponse);
+    if(!_auth->CanCheckConcurrently()) {
+      FinishChallengeResponse(request,
+          _auth->VerifyResponse(sender_id, cresponse));
+      return;
+    }
+
+    if(_pending_verifications.count() >= MaxPendingVerifications) {
+      qDebug() << "Too many pending verifications, deferring" << sender_id;
+      request.Failed(Response::Other,
+          "Unable to register at this time, try again later.");
+      return;
+    }
+
+    if(!_auth->BeginResponse(sender_id, cresponse)) {
+      qDebug() << "Failed to authenticate.";
+      request.Failed(Response::InvalidInput, "Failed to authenticate.");
+      return;
+    }
+
+    int idx = _next_verification++;
+    QSharedPointer<PendingVerification> pending(
+        new PendingVerification(request, sender_id, cresponse));
+    _pending_verifications[idx] = pending;
+
+    SessionLeaderPrivate::VerifyChallenge *verifier =
+      new SessionLeaderPrivate::VerifyChallenge(_auth, idx, pending);
+    QObject::connect(verifier, SIGNAL(Finished(int)),
+        this, SLOT(HandleChallengeVerified(int)));
+    _verify_pool.start(verifier);
+  }
+
+  void SessionLeader::HandleChallengeVerified(int idx)
+  {
+    QSharedPointer<PendingVerification> pending =
+      _pending_verifications.take(idx);
+    if(!pending) {
+      return;
+    }
+
+    _auth->EndResponse(pending->member, pending->response,
+        pending->result.first);
+
+    if(!Started()) {
+      qDebug() << "Verified a registration message when not started.";
+      pending->request.Failed(Response::InvalidInput,
+          "SessionLeader not started");
+      return;
+    }
+
+    FinishChallengeResponse(pending->request, pending->result);
+  }
+
+  void SessionLeader::FinishChallengeResponse(const Request &request,
+      const QPair<bool, PublicIdentity> &auth)
+  {
     if(!auth.first) {
       qDebug() << "Failed to authenticate.";
       request.Failed(Response::InvalidInput, "Failed to authenticate.");
@@ -402,5 +462,14 @@ namespace Sessions {
     _unprepared_peers.remove(id);
   }
 }
+
+namespace SessionLeaderPrivate {
+  void VerifyChallenge::run()
+  {
+    _pending->result = _auth->CheckResponse(_pending->member,
+        _pending->response);
+    emit Finished(_idx);
+  }
+}
 }
 }
@@ -5,7 +5,9 @@
 #include <QHash>
 #include <QObject>
 #include <QQueue>
+#include <QRunnable>
 #include <QSet>
+#include <QThreadPool>
 
 #include "Anonymity/Round.hpp"
 #include "Connections/Id.hpp"
@@ -37,6 +39,10 @@ namespace Messaging {
 
 namespace Anonymity {
 namespace Sessions {
+namespace SessionLeaderPrivate {
+  class VerifyChallenge;
+}
+
   /**
    * Maintains a (variable) set of peers (group) which is actively
    * participating in anonymous exchanges (rounds).
@@ -144,6 +150,12 @@ namespace Sessions {
 
       static bool EnableLogOffMonitor;
 
+      /**
+       * The most challenge responses verified or waiting for verification at
+       * once, further responses are asked to try again later
+       */
+      static const int MaxPendingVerifications = 1024;
+
       inline const Id &GetSessionId() const { return _session->GetSessionId(); }
 
     signals:
@@ -246,6 +258,33 @@ namespace Sessions {
       bool AllowRegistration(const QSharedPointer<ISender> &from,
           const PublicIdentity &ident);
 
+      /**
+       * Registers a member whose challenge response has been verified
+       * @param request the challenge response
+       * @param auth the result of the verification
+       */
+      void FinishChallengeResponse(const Request &request,
+          const QPair<bool, PublicIdentity> &auth);
+
+      /**
+       * A challenge response handed to _verify_pool
+       */
+      class PendingVerification {
+        public:
+          PendingVerification(const Request &request, const Id &member,
+              const QVariant &response) :
+            request(request), member(member), response(response)
+          {
+          }
+
+          Request request;
+          Id member;
+          QVariant response;
+          QPair<bool, PublicIdentity> result;
+      };
+
+      friend class SessionLeaderPrivate::VerifyChallenge;
+
       Group _group;
       const PrivateIdentity _ident;
       QSharedPointer<Network> _network;
@@ -267,6 +306,13 @@ namespace Sessions {
       QSharedPointer<Identity::Authentication::IAuthenticator> _auth;
       QHash <Id, PublicIdentity> _registered;
 
+      /**
+       * Verifies challenge responses when the authenticator allows it
+       */
+      QThreadPool _verify_pool;
+      QHash<int, QSharedPointer<PendingVerification> > _pending_verifications;
+      int _next_verification;
+
     private slots:
       /**
        * Called when a new connection is created
@@ -283,6 +329,48 @@ namespace Sessions {
        * Called when a round has finished
        */
       virtual void HandleRoundFinished();
+
+      /**
+       * Called when a challenge response has been verified
+       * @param idx the verification's index into _pending_verifications
+       */
+      void HandleChallengeVerified(int idx);
+  };
+
+namespace SessionLeaderPrivate {
+  /**
+   * Verifies a challenge response off of the main thread
+   */
+  class VerifyChallenge : public QObject, public QRunnable {
+    Q_OBJECT
+
+    public:
+      /**
+       * Constructor
+       * @param auth the authenticator
+       * @param idx the verification's index
+       * @param pending the response and storage for the result
+       */
+      VerifyChallenge(
+          const QSharedPointer<Identity::Authentication::IAuthenticator> &auth,
+          int idx,
+          const QSharedPointer<SessionLeader::PendingVerification> &pending) :
+        _auth(auth),
+        _idx(idx),
+        _pending(pending)
+      {
+      }
+
+      virtual ~VerifyChallenge() { }
+      virtual void run();
+
+    signals:
+      void Finished(int idx);
+
+    private:
+      QSharedPointer<Identity::Authentication::IAuthenticator> _auth;
+      int _idx;
+      QSharedPointer<SessionLeader::PendingVerification> _pending;
   };
 }
 }
@@ -38,14 +38,29 @@ int main(int argc, char **argv)
     CryptoFactory::GetInstance().SetThreading(CryptoFactory::MultiThreaded);
   }
 
+  if(settings.TimerWheel) {
+    Timer::GetInstance().SetQueueType(Timer::WheelQueue);
+  }
+
+  CSBulkRound::SetPipelineDepth(settings.PipelineDepth);
+  CSBulkRound::SetPadVersion(settings.PadVersion);
+  ClientCiphertextPool::SetDefaultMaxDepth(settings.BlogDropPoolDepth);
+  ClientCiphertextPool::SetDefaultMaxMemory(settings.BlogDropPoolMemory);
+  SocksConnection::SetSymmetricAuthentication(settings.TunnelMacs);
+
   CryptoFactory::GetInstance().SetLibrary(CryptoFactory::CryptoPP);
 
+  CryptoFactory::HashName hash;
+  CryptoFactory::ParseHashName(settings.HashFunction, hash);
+  CryptoFactory::GetInstance().SetHash(hash);
+
   Library *lib = CryptoFactory::GetInstance().GetLibrary();
 
   Group group(QVector<PublicIdentity>(), Id(settings.LeaderId),
       settings.SubgroupPolicy);
 
   QList<QSharedPointer<Node> > nodes;
+  QList<QSharedPointer<NodeThread> > node_threads;
 
   QSharedPointer<ISink> default_sink(new DummySink());
   QSharedPointer<ISink> app_sink = default_sink;
@@ -86,9 +101,17 @@ int main(int argc, char **argv)
       dh = QSharedPointer<DiffieHellman>(lib->GenerateDiffieHellman(id));
     }
 
-    nodes.append(create(PrivateIdentity(local_id, key, key, dh, super_peer),
-          group, local, remote, (idx == 0 ? app_sink : default_sink),
-          settings.SessionType, settings.AuthMode, keys));
+    PrivateIdentity ident(local_id, key, key, dh, super_peer);
+    if(settings.NodeThreads && idx > 0) {
+      // The application services only use the first node
+      node_threads.append(QSharedPointer<NodeThread>(new NodeThread(create,
+              ident, group, local, remote, default_sink, settings.SessionType,
+              settings.AuthMode, keys)));
+    } else {
+      nodes.append(create(ident, group, local, remote,
+            (idx == 0 ? app_sink : default_sink), settings.SessionType,
+            settings.AuthMode, keys));
+    }
     local[0] = AddressFactory::GetInstance().CreateAny(local[0].GetType());
   }
 
@@ -129,6 +152,9 @@ int main(int argc, char **argv)
       QSharedPointer<SendMessageService> send_message_sp(new SendMessageService(nodes[0]->GetSessionManager()));
       ws->AddRoute(HttpRequest::METHOD_HTTP_POST, "/session/send", send_message_sp);
 
+      QSharedPointer<MetricsService> metrics_sp(new MetricsService());
+      ws->AddRoute(HttpRequest::METHOD_HTTP_GET, "/metrics", metrics_sp);
+
       ws->Start();
     }
     
@@ -145,6 +171,9 @@ int main(int argc, char **argv)
     if(settings.ExitTunnel) {
       tun_exit.reset(new ExitTunnel(nodes[0]->GetSessionManager(),
             nodes[0]->GetNetwork(), settings.ExitTunnelProxyUrl));
+      tun_exit->SetCompression(settings.TunnelCompression);
+      tun_exit->SetDownstreamRate(settings.ExitTunnelRate);
+      tun_exit->SetConnectionPool(settings.ExitTunnelPool);
 
       QObject::connect(signal_sink.data(), SIGNAL(IncomingData(const QByteArray&)),
           tun_exit.data(), SLOT(SessionData(const QByteArray&)));
@@ -159,5 +188,10 @@ int main(int argc, char **argv)
     node->GetOverlay()->Start();
   }
 
+  foreach(QSharedPointer<NodeThread> node_thread, node_threads) {
+    QObject::connect(&qca, SIGNAL(aboutToQuit()), node_thread.data(), SLOT(Stop()));
+    node_thread->start();
+  }
+
   return QCoreApplication::exec();
 }
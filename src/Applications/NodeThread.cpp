@@ -0,0 +1,82 @@
+#include <QDebug>
+#include <QMutexLocker>
+
+#include "NodeThread.hpp"
+
+namespace Dissent {
+namespace Applications {
+  NodeThread::NodeThread(Node::CreateNode create,
+      const Node::PrivateIdentity &ident,
+      const Node::Group &group,
+      const QList<Address> &local,
+      const QList<Address> &remote,
+      const QSharedPointer<Node::ISink> &sink,
+      SessionFactory::SessionType session,
+      AuthFactory::AuthType auth,
+      const QSharedPointer<Node::KeyShare> &keys) :
+    _create(create),
+    _ident(ident),
+    _group(group),
+    _local(local),
+    _remote(remote),
+    _sink(sink),
+    _session(session),
+    _auth(auth),
+    _keys(keys),
+    _queue_type(Utils::Timer::GetInstance().GetQueueType()),
+    _overlay(0),
+    _stopping(false)
+  {
+  }
+
+  NodeThread::~NodeThread()
+  {
+    Stop();
+    if(!wait(StopTimeout)) {
+      qWarning() << "Node" << _ident.GetLocalId() << "did not disconnect in time";
+      quit();
+      wait();
+    }
+  }
+
+  void NodeThread::Stop()
+  {
+    QMutexLocker locker(&_lock);
+    _stopping = true;
+    if(_overlay) {
+      QMetaObject::invokeMethod(_overlay, "CallStop", Qt::QueuedConnection);
+    }
+  }
+
+  void NodeThread::run()
+  {
+    Utils::Timer::GetInstance().SetQueueType(_queue_type);
+
+    QSharedPointer<Node> node = _create(_ident, _group, _local, _remote,
+        _sink, _session, _auth, _keys);
+    QSharedPointer<Node::BaseOverlay> overlay = node->GetOverlay();
+    connect(overlay.data(), SIGNAL(Disconnected()), this, SLOT(quit()),
+        Qt::DirectConnection);
+
+    {
+      QMutexLocker locker(&_lock);
+      if(_stopping) {
+        return;
+      }
+      _overlay = overlay.data();
+    }
+
+    overlay->Start();
+    exec();
+
+    {
+      QMutexLocker locker(&_lock);
+      _overlay = 0;
+    }
+
+    node.clear();
+    overlay.clear();
+    Utils::Timer::GetInstance().Clear();
+  }
+}
+}
@@ -0,0 +1,79 @@
+#ifndef DISSENT_APPLICATIONS_NODE_THREAD_H_GUARD
+#define DISSENT_APPLICATIONS_NODE_THREAD_H_GUARD
+
+#include <QMutex>
+#include <QThread>
+
+#include "Utils/Timer.hpp"
+
+#include "Node.hpp"
+
+namespace Dissent {
+namespace Applications {
+  /**
+   * Runs a Node on a thread of its own. The node is created, started and
+   * destroyed inside the thread, so its objects are bound to the thread's
+   * event loop and schedule through the thread's Timer. Nodes only share
+   * the CryptoFactory and its worker pool with the rest of the process.
+   */
+  class NodeThread : public QThread {
+    Q_OBJECT
+
+    public:
+      typedef Transports::Address Address;
+
+      /**
+       * Milliseconds to wait for the node to disconnect when stopping
+       */
+      static const int StopTimeout = 5000;
+
+      /**
+       * Constructor, the parameters are those of Node::CreateNode
+       */
+      explicit NodeThread(Node::CreateNode create,
+          const Node::PrivateIdentity &ident,
+          const Node::Group &group,
+          const QList<Address> &local,
+          const QList<Address> &remote,
+          const QSharedPointer<Node::ISink> &sink,
+          SessionFactory::SessionType session,
+          AuthFactory::AuthType auth,
+          const QSharedPointer<Node::KeyShare> &keys);
+
+      /**
+       * Destructor, stops the node and waits for the thread to exit
+       */
+      virtual ~NodeThread();
+
+    public slots:
+      /**
+       * Asks the node to disconnect, the thread exits once it has
+       */
+      void Stop();
+
+    protected:
+      virtual void run();
+
+    private:
+      Node::CreateNode _create;
+      Node::PrivateIdentity _ident;
+      Node::Group _group;
+      QList<Address> _local;
+      QList<Address> _remote;
+      QSharedPointer<Node::ISink> _sink;
+      SessionFactory::SessionType _session;
+      AuthFactory::AuthType _auth;
+      QSharedPointer<Node::KeyShare> _keys;
+      Utils::Timer::QueueType _queue_type;
+
+      /**
+       * Guards the overlay, which is only set while the node runs
+       */
+      QMutex _lock;
+      Node::BaseOverlay *_overlay;
+      bool _stopping;
+  };
+}
+}
+
+#endif
@@ -1,8 +1,12 @@
+#include "Crypto/BlogDrop/ClientCiphertextPool.hpp"
+#include "Crypto/CryptoFactory.hpp"
 #include "Utils/Logging.hpp"
 
 #include "AuthFactory.hpp"
 #include "Settings.hpp"
 
+using Dissent::Crypto::BlogDrop::ClientCiphertextPool;
+using Dissent::Crypto::CryptoFactory;
 using Dissent::Utils::Logging;
 
 namespace Dissent {
@@ -56,6 +60,20 @@ namespace Applications {
     Console = _settings->value(Param<Params::Console>(), false).toBool();
     ExitTunnel = _settings->value(Param<Params::ExitTunnel>(), false).toBool();
     Multithreading = _settings->value(Param<Params::Multithreading>(), false).toBool();
+    TimerWheel = _settings->value(Param<Params::TimerWheel>(), false).toBool();
+    HashFunction = _settings->value(Param<Params::HashFunction>(),
+        CryptoFactory::HashNameToString(CryptoFactory::Sha1)).toString();
+    PipelineDepth = _settings->value(Param<Params::PipelineDepth>(), 1).toInt();
+    PadVersion = _settings->value(Param<Params::PadVersion>(), 2).toInt();
+    BlogDropPoolDepth = _settings->value(Param<Params::BlogDropPoolDepth>(),
+        ClientCiphertextPool::DEFAULT_MAX_DEPTH).toInt();
+    BlogDropPoolMemory = _settings->value(Param<Params::BlogDropPoolMemory>(),
+        ClientCiphertextPool::DEFAULT_MAX_MEMORY).toInt();
+    TunnelMacs = _settings->value(Param<Params::TunnelMacs>(), false).toBool();
+    TunnelCompression = _settings->value(Param<Params::TunnelCompression>(), false).toBool();
+    ExitTunnelRate = _settings->value(Param<Params::ExitTunnelRate>(), 0).toInt();
+    ExitTunnelPool = _settings->value(Param<Params::ExitTunnelPool>(), 0).toInt();
+    NodeThreads = _settings->value(Param<Params::NodeThreads>(), false).toBool();
 
     WebServerUrl = TryParseUrl(_settings->value(Param<Params::WebServerUrl>()).toString(), "http");
     WebServer = WebServerUrl != QUrl();
@@ -84,6 +102,9 @@ namespace Applications {
       Log = _settings->value(Param<Params::Log>()).toString().toLower();
     }
 
+    LogMaxSize = _settings->value(Param<Params::LogMaxSize>(), 0).toLongLong();
+    LogMaxAge = _settings->value(Param<Params::LogMaxAge>(), 0).toInt();
+
     if(actions) {
       if(Log == "stderr") {
         Logging::UseStderr();
@@ -92,7 +113,7 @@ namespace Applications {
       } else if(Log.isEmpty()) {
         Logging::Disable();
       } else {
-        Logging::UseFile(Log);
+        Logging::UseFile(Log, LogMaxSize, LogMaxAge);
       }
     }
 
@@ -170,6 +191,52 @@ namespace Applications {
       return false;
     }
 
+    CryptoFactory::HashName hash;
+    if(!CryptoFactory::ParseHashName(HashFunction, hash)) {
+      _reason = "Invalid hash_function: " + HashFunction;
+      return false;
+    }
+
+    if(PipelineDepth < 1) {
+      _reason = "Invalid pipeline_depth: " + QString::number(PipelineDepth);
+      return false;
+    }
+
+    if(PadVersion < 1 || PadVersion > 2) {
+      _reason = "Invalid pad_version: " + QString::number(PadVersion);
+      return false;
+    }
+
+    if(BlogDropPoolDepth < 0) {
+      _reason = "Invalid blogdrop_pool_depth: " + QString::number(BlogDropPoolDepth);
+      return false;
+    }
+
+    if(BlogDropPoolMemory < 0) {
+      _reason = "Invalid blogdrop_pool_memory: " + QString::number(BlogDropPoolMemory);
+      return false;
+    }
+
+    if(ExitTunnelRate < 0) {
+      _reason = "Invalid exit_tunnel_rate: " + QString::number(ExitTunnelRate);
+      return false;
+    }
+
+    if(ExitTunnelPool < 0) {
+      _reason = "Invalid exit_tunnel_pool: " + QString::number(ExitTunnelPool);
+      return false;
+    }
+
+    if(NodeThreads) {
+      foreach(const QUrl &url, LocalEndPoints) {
+        // Buffer edges call directly into their peer's objects
+        if(url.scheme() == "buffer") {
+          _reason = "node_threads cannot be used with buffer endpoints";
+          return false;
+        }
+      }
+    }
+
     return true;
   }
 
@@ -249,7 +316,20 @@ namespace Applications {
     _settings->setValue(Param<Params::Console>(), Console);
     _settings->setValue(Param<Params::AuthMode>(), AuthMode);
     _settings->setValue(Param<Params::Log>(), Log);
+    _settings->setValue(Param<Params::LogMaxSize>(), LogMaxSize);
+    _settings->setValue(Param<Params::LogMaxAge>(), LogMaxAge);
     _settings->setValue(Param<Params::Multithreading>(), Multithreading);
+    _settings->setValue(Param<Params::TimerWheel>(), TimerWheel);
+    _settings->setValue(Param<Params::HashFunction>(), HashFunction);
+    _settings->setValue(Param<Params::PipelineDepth>(), PipelineDepth);
+    _settings->setValue(Param<Params::PadVersion>(), PadVersion);
+    _settings->setValue(Param<Params::BlogDropPoolDepth>(), BlogDropPoolDepth);
+    _settings->setValue(Param<Params::BlogDropPoolMemory>(), BlogDropPoolMemory);
+    _settings->setValue(Param<Params::TunnelMacs>(), TunnelMacs);
+    _settings->setValue(Param<Params::TunnelCompression>(), TunnelCompression);
+    _settings->setValue(Param<Params::ExitTunnelRate>(), ExitTunnelRate);
+    _settings->setValue(Param<Params::ExitTunnelPool>(), ExitTunnelPool);
+    _settings->setValue(Param<Params::NodeThreads>(), NodeThreads);
     QVariantList local_ids;
     foreach(const Id &id, LocalIds) {
       local_ids.append(id.ToString());
@@ -336,6 +416,14 @@ namespace Applications {
         "logging mechanism: stderr, stdout, or a file path",
         QxtCommandOptions::ValueRequired);
 
+    options->add(Param<Params::LogMaxSize>(),
+        "rotate the log file after this many bytes",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::LogMaxAge>(),
+        "rotate the log file after this many seconds",
+        QxtCommandOptions::ValueRequired);
+
     options->add(Param<Params::Console>(),
         "enable console",
         QxtCommandOptions::NoValue);
@@ -360,6 +448,50 @@ namespace Applications {
         "enables multithreading",
         QxtCommandOptions::NoValue);
 
+    options->add(Param<Params::TimerWheel>(),
+        "stores timer events in a timing wheel",
+        QxtCommandOptions::NoValue);
+
+    options->add(Param<Params::HashFunction>(),
+        "hash function: sha1, sha256, or blake2b",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::PipelineDepth>(),
+        "phases a CSBulkRound fixes its slot layout ahead",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::PadVersion>(),
+        "CSBulkRound pad generator: 1 original, 2 seekable counter-mode",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::BlogDropPoolDepth>(),
+        "ciphertexts worth of elements a BlogDrop client computes ahead",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::BlogDropPoolMemory>(),
+        "bytes a BlogDrop client may hold in precomputed elements",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::TunnelMacs>(),
+        "authenticates entry tunnel packets with MACs",
+        QxtCommandOptions::NoValue);
+
+    options->add(Param<Params::TunnelCompression>(),
+        "compresses exit tunnel response data",
+        QxtCommandOptions::NoValue);
+
+    options->add(Param<Params::ExitTunnelRate>(),
+        "bytes per second sent downstream by the exit tunnel, 0 for no limit",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::ExitTunnelPool>(),
+        "destinations the exit tunnel keeps a warm connection to",
+        QxtCommandOptions::ValueRequired);
+
+    options->add(Param<Params::NodeThreads>(),
+        "runs each local node on its own thread",
+        QxtCommandOptions::NoValue);
+
     options->add(Param<Params::LocalId>(),
         "160-bit base64 local id",
         QxtCommandOptions::ValueRequired | QxtCommandOptions::AllowMultiple);
@@ -92,6 +92,16 @@ namespace Applications {
        */
       QString Log;
 
+      /**
+       * Rotate the log file once it reaches this many bytes, 0 to disable
+       */
+      qint64 LogMaxSize;
+
+      /**
+       * Rotate the log file once it is this many seconds old, 0 to disable
+       */
+      int LogMaxAge;
+
       /**
        * Provide a Console UI
        */
@@ -133,6 +143,68 @@ namespace Applications {
        */
       bool Multithreading;
 
+      /**
+       * Store timer events in a timing wheel rather than a heap
+       */
+      bool TimerWheel;
+
+      /**
+       * Hash function used by the protocols: sha1, sha256, or blake2b, all
+       * members of a group must agree on it
+       */
+      QString HashFunction;
+
+      /**
+       * Number of phases a CSBulkRound cleartext fixes the slot layout
+       * ahead, 1 for lock-step phases
+       */
+      int PipelineDepth;
+
+      /**
+       * Generator CSBulkRound draws pads from: 1 for the original generator,
+       * 2 for the seekable counter-mode generator
+       */
+      int PadVersion;
+
+      /**
+       * Ciphertexts, or phases, worth of elements a BlogDrop client
+       * computes ahead, 0 to disable
+       */
+      int BlogDropPoolDepth;
+
+      /**
+       * Upper bound in bytes on the elements a BlogDrop client computes
+       * ahead
+       */
+      int BlogDropPoolMemory;
+
+      /**
+       * Entry tunnel connections agree on a key with the exit and
+       * authenticate their packets with MACs rather than signatures
+       */
+      bool TunnelMacs;
+
+      /**
+       * The exit tunnel compresses TCP response data
+       */
+      bool TunnelCompression;
+
+      /**
+       * Bytes per second the exit tunnel sends downstream, 0 for no limit
+       */
+      int ExitTunnelRate;
+
+      /**
+       * Recently used destinations the exit tunnel keeps a warm connection
+       * to, 0 to disable
+       */
+      int ExitTunnelPool;
+
+      /**
+       * Run every local node after the first on a thread of its own
+       */
+      bool NodeThreads;
+
       /**
        * The id for the (first) local node, other nodes will be random
        */
@@ -175,12 +247,25 @@ namespace Applications {
           "auth_mode",
           "session_type",
           "log",
+          "log_max_size",
+          "log_max_age",
           "console",
           "web_server_url",
           "entry_tunnel_url",
           "exit_tunnel",
           "exit_tunnel_proxy_url",
           "multithreading",
+          "timer_wheel",
+          "hash_function",
+          "pipeline_depth",
+          "pad_version",
+          "blogdrop_pool_depth",
+          "blogdrop_pool_memory",
+          "tunnel_macs",
+          "tunnel_compression",
+          "exit_tunnel_rate",
+          "exit_tunnel_pool",
+          "node_threads",
           "local_id",
           "leader_id",
           "subgroup_policy",
@@ -201,12 +286,25 @@ namespace Applications {
             AuthMode,
             SessionType,
             Log,
+            LogMaxSize,
+            LogMaxAge,
             Console,
             WebServerUrl,
             EntryTunnelUrl,
             ExitTunnel,
             ExitTunnelProxyUrl,
             Multithreading,
+            TimerWheel,
+            HashFunction,
+            PipelineDepth,
+            PadVersion,
+            BlogDropPoolDepth,
+            BlogDropPoolMemory,
+            TunnelMacs,
+            TunnelCompression,
+            ExitTunnelRate,
+            ExitTunnelPool,
+            NodeThreads,
             LocalId,
             LeaderId,
             SubgroupPolicy,
@@ -1,3 +1,4 @@
+#include "Messaging/Envelope.hpp"
 #include "Messaging/RequestHandler.hpp"
 #include "Messaging/RpcHandler.hpp"
 #include "Transports/AddressFactory.hpp"
@@ -9,6 +10,7 @@
 
 namespace Dissent {
 using Transports::AddressFactory;
+using Messaging::Envelope;
 using Messaging::RequestHandler;
 
 namespace Connections {
@@ -162,6 +164,7 @@ namespace Connections {
     QSharedPointer<EdgeListener> el = _edge_factory.GetEdgeListener(type);
     request["persistent"] = el->GetAddress().ToString();
     request["version"] = VERSION;
+    request["wire"] = Envelope::Version;
 
     _rpc->SendRequest(edge, "CM::Inquire", request, _inquired);
   }
@@ -247,7 +250,17 @@ namespace Connections {
 
     Id rem_id(brem_id);
 
-    request.Respond(_local_id.GetByteArray());
+    // Peers that do not advertise an envelope version expect only our id
+    int wire = qMin(data.value("wire").toInt(), int(Envelope::Version));
+    edge->SetWireVersion(wire);
+    if(wire > 0) {
+      QVariantHash response;
+      response["peer_id"] = _local_id.GetByteArray();
+      response["wire"] = Envelope::Version;
+      request.Respond(response);
+    } else {
+      request.Respond(_local_id.GetByteArray());
+    }
 
     QString saddr = data.value("persistent").toString();
     Address addr = AddressFactory::GetInstance().CreateAddress(saddr);
@@ -273,7 +286,16 @@ namespace Connections {
       return;
     }
 
-    QByteArray brem_id = response.GetData().toByteArray();
+    QByteArray brem_id;
+    if(response.GetData().type() == QVariant::Hash) {
+      QVariantHash data = response.GetData().toHash();
+      brem_id = data.value("peer_id").toByteArray();
+      edge->SetWireVersion(qMin(data.value("wire").toInt(),
+            int(Envelope::Version)));
+    } else {
+      brem_id = response.GetData().toByteArray();
+    }
+
     if(brem_id.isEmpty()) {
       qWarning() << "Invalid ConnectionEstablished, no id";
       return;
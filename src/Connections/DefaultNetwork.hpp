@@ -5,6 +5,7 @@
 #include <QSharedPointer>
 #include <QVariant>
 
+#include "Messaging/Envelope.hpp"
 #include "Messaging/RpcHandler.hpp"
 
 #include "Connection.hpp"
@@ -48,6 +49,7 @@ namespace Connections {
       inline virtual void SetMethod(const QString &method)
       {
         _method = method;
+        UpdateEnvelope();
       }
 
       /**
@@ -58,6 +60,7 @@ namespace Connections {
       inline virtual void SetHeaders(const QVariantHash &headers)
       {
         _headers = headers;
+        UpdateEnvelope();
       }
  
       /**
@@ -192,6 +195,14 @@ namespace Connections {
       inline void Send(const QSharedPointer<ISender> &to,
           const QByteArray &data)
       {
+        if(!_envelope.isEmpty()) {
+          QSharedPointer<Connection> con = to.dynamicCast<Connection>();
+          if(con && con->GetEdge()->GetWireVersion() > 0) {
+            to->Send(_envelope + data);
+            return;
+          }
+        }
+
         QVariantHash msg(_headers);
         msg["data"] = data;
         _rpc->SendNotification(to, _method, msg);
@@ -203,10 +214,25 @@ namespace Connections {
       }
 
     private:
+      /**
+       * Rebuilds the envelope header shared by all messages sent via Send
+       */
+      inline void UpdateEnvelope()
+      {
+        _envelope = Messaging::Envelope::BuildHeader(
+            Messaging::Envelope::GetMethodId(_method), _headers);
+      }
+
       QSharedPointer<ConnectionManager> _cm;
       QSharedPointer<RpcHandler> _rpc;
       QVariantHash _headers;
       QString _method;
+
+      /**
+       * Envelope header for Send, empty if the method or headers cannot be
+       * expressed as an envelope
+       */
+      QByteArray _envelope;
   };
 }
 }
@@ -41,7 +41,7 @@ namespace Connections {
     msg["data"] = data;
 
     _rpc->SendNotification(_forwarder, "REL::Data", msg);
-    Sent();
+    Sent(data.size());
   }
 
   void RelayEdge::PushData(const QByteArray &data)
@@ -1,9 +1,94 @@
 
+#include <QDataStream>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QThread>
+
+#include "Utils/Arena.hpp"
+
 #include "AbstractGroup.hpp"
 
 namespace Dissent {
 namespace Crypto {
 namespace AbstractGroup {
+namespace {
+  /**
+   * Approximate memory budget for cached tables, a table for a 2048-bit
+   * IntegerGroup takes about 2 MB. Server keys change every round, so the
+   * least recently used tables are dropped first.
+   */
+  const qint64 FIXED_BASE_CACHE_BYTES = 32 * 1024 * 1024;
+
+  /**
+   * Ids for distinct group parameters, consulted once per group instance
+   */
+  QMutex group_id_lock;
+  QHash<QByteArray, int> group_ids;
+
+  /**
+   * Group id, the thread for groups that are not thread safe, and the
+   * base's bytes
+   */
+  typedef QPair<QPair<int, QThread *>, QByteArray> FixedBaseKey;
+
+  /**
+   * A cached table and the group copy that evaluates it
+   */
+  class FixedBaseEntry {
+    public:
+      FixedBaseEntry(const QSharedPointer<const AbstractGroup> &group,
+          const QSharedPointer<const FixedBaseTable> &table, qint64 bytes) :
+        group(group),
+        table(table),
+        bytes(bytes),
+        last_used(0)
+      {
+      }
+
+      const QSharedPointer<const AbstractGroup> group;
+      const QSharedPointer<const FixedBaseTable> table;
+      const qint64 bytes;
+
+      /**
+       * Updated by lookups under the shared lock
+       */
+      QAtomicInt last_used;
+  };
+
+  QReadWriteLock fixed_base_lock;
+  QHash<FixedBaseKey, QSharedPointer<FixedBaseEntry> > fixed_base_cache;
+  qint64 fixed_base_bytes = 0;
+  QAtomicInt fixed_base_clock;
+
+  /**
+   * Drops the least recently used table, the write lock must be held
+   */
+  void EvictFixedBase()
+  {
+    // Ages are taken modulo 2^32 so the clock may wrap
+    const quint32 now = quint32(fixed_base_clock.fetchAndAddRelaxed(0));
+    QHash<FixedBaseKey, QSharedPointer<FixedBaseEntry> >::iterator oldest =
+      fixed_base_cache.end();
+    quint32 oldest_age = 0;
+
+    QHash<FixedBaseKey, QSharedPointer<FixedBaseEntry> >::iterator it;
+    for(it = fixed_base_cache.begin(); it != fixed_base_cache.end(); ++it) {
+      quint32 age = now - quint32(it.value()->last_used.fetchAndAddRelaxed(0));
+      if(oldest == fixed_base_cache.end() || age > oldest_age) {
+        oldest = it;
+        oldest_age = age;
+      }
+    }
+
+    if(oldest != fixed_base_cache.end()) {
+      fixed_base_bytes -= oldest.value()->bytes;
+      fixed_base_cache.erase(oldest);
+    }
+  }
+}
 
     Element AbstractGroup::HashIntoElement(const QByteArray &to_hash) const
     {
@@ -15,6 +100,109 @@ namespace AbstractGroup {
       return EncodeBytes(bytes);
     }
 
+    Element AbstractGroup::MultiExponentiate(const QList<Element> &bases,
+        const QList<Integer> &exps) const
+    {
+      Q_ASSERT(bases.count() == exps.count());
+
+      Element out = GetIdentity();
+      int idx = 0;
+      for(; idx + 1 < bases.count(); idx += 2) {
+        out = Multiply(out, CascadeExponentiate(bases[idx], exps[idx],
+              bases[idx + 1], exps[idx + 1]));
+      }
+
+      if(idx < bases.count()) {
+        out = Multiply(out, Exponentiate(bases[idx], exps[idx]));
+      }
+      return out;
+    }
+
+    FixedBase AbstractGroup::GetFixedBase(const Element &base) const
+    {
+      // Groups with identical parameters, even separate instances,
+      // share tables
+      QThread *thread = IsThreadSafe() ? 0 : QThread::currentThread();
+      const QByteArray bytes = ElementToByteArray(base);
+      const FixedBaseKey key(qMakePair(GetGroupId(), thread), bytes);
+
+      {
+        QReadLocker locker(&fixed_base_lock);
+        QSharedPointer<FixedBaseEntry> entry = fixed_base_cache.value(key);
+        if(entry) {
+          entry->last_used.fetchAndStoreRelaxed(
+              fixed_base_clock.fetchAndAddRelaxed(1));
+          return FixedBase(entry->group, entry->table);
+        }
+      }
+
+      // The table, its base and the group copy outlive any arena the caller
+      // is in. Build outside of the lock, racing threads at worst duplicate
+      // work.
+      QSharedPointer<FixedBaseEntry> entry;
+      {
+        Utils::NoArena no_arena;
+        QSharedPointer<const AbstractGroup> group = Copy();
+        QSharedPointer<const FixedBaseTable> table =
+          group->PrecomputeBase(group->ElementFromByteArray(bytes));
+        entry = QSharedPointer<FixedBaseEntry>(new FixedBaseEntry(group, table,
+              qint64(table->GetElementCount()) * BytesPerElement()));
+      }
+
+      if(entry->bytes > FIXED_BASE_CACHE_BYTES) {
+        return FixedBase(entry->group, entry->table);
+      }
+
+      QWriteLocker locker(&fixed_base_lock);
+      QSharedPointer<FixedBaseEntry> existing = fixed_base_cache.value(key);
+      if(existing) {
+        return FixedBase(existing->group, existing->table);
+      }
+
+      while(fixed_base_bytes + entry->bytes > FIXED_BASE_CACHE_BYTES) {
+        EvictFixedBase();
+      }
+
+      entry->last_used.fetchAndStoreRelaxed(fixed_base_clock.fetchAndAddRelaxed(1));
+      fixed_base_cache[key] = entry;
+      fixed_base_bytes += entry->bytes;
+      return FixedBase(entry->group, entry->table);
+    }
+
+    int AbstractGroup::GetGroupId() const
+    {
+      int id = _group_id;
+      if(id) {
+        return id;
+      }
+
+      // The backend name keeps identical parameters in different formats
+      // apart
+      QByteArray params;
+      QDataStream stream(&params, QIODevice::WriteOnly);
+      stream << ToString() << GetByteArray();
+
+      QMutexLocker locker(&group_id_lock);
+      id = group_ids.value(params);
+      if(!id) {
+        id = group_ids.count() + 1;
+        group_ids[params] = id;
+      }
+      _group_id = id;
+      return id;
+    }
+
+    QSharedPointer<FixedBaseTable> AbstractGroup::PrecomputeBase(const Element &base) const
+    {
+      return QSharedPointer<FixedBaseTable>(new FixedBaseTable(base));
+    }
+
+    Element AbstractGroup::ExponentiateFixed(const FixedBaseTable &table,
+        const Integer &exp) const
+    {
+      return Exponentiate(table.GetBase(), exp);
+    }
+
 }
 }
 }
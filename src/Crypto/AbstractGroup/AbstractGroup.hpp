@@ -1,10 +1,12 @@
 #ifndef DISSENT_CRYPTO_ABSTRACT_GROUP_ABSTRACT_GROUP_H_GUARD
 #define DISSENT_CRYPTO_ABSTRACT_GROUP_ABSTRACT_GROUP_H_GUARD
 
+#include <QAtomicInt>
 #include <QString>
 
 #include "Crypto/Integer.hpp"
 #include "Element.hpp"
+#include "FixedBase.hpp"
 
 namespace Dissent {
 namespace Crypto {
@@ -36,7 +38,7 @@ namespace AbstractGroup {
       /**
        * Constructor
        */
-      AbstractGroup() {}
+      AbstractGroup() : _group_id(0) {}
 
       /**
        * Destructor
@@ -48,6 +50,12 @@ namespace AbstractGroup {
        */
       virtual QSharedPointer<AbstractGroup> Copy() const = 0;
 
+      /**
+       * Returns true if the group's const methods may be called from many
+       * threads at once, otherwise each thread should use its own Copy()
+       */
+      virtual bool IsThreadSafe() const { return true; }
+
       /**
        * The group operation. For integers, this is multiplication, for
        * elliptic curves it's point addition.
@@ -75,6 +83,46 @@ namespace AbstractGroup {
       virtual Element CascadeExponentiate(const Element &a1, const Integer &e1,
           const Element &a2, const Integer &e2) const = 0;
 
+      /**
+       * Compute the product of bases[i]^exps[i]. For many bases this
+       * can be done much faster than separate exponentiations, as the
+       * squarings are shared. The default uses CascadeExponentiate on
+       * pairs of bases.
+       * @param bases the bases
+       * @param exps the exponents, one per base
+       */
+      virtual Element MultiExponentiate(const QList<Element> &bases,
+          const QList<Integer> &exps) const;
+
+      /**
+       * Returns a handle for computing powers of a base that is used
+       * many times, e.g., the generator or a server public key. The
+       * table built by PrecomputeBase is cached by group and base, so
+       * calling this once per round or per proof is cheap, lookups take
+       * only a shared lock and never serialize the group. The least
+       * recently used tables are dropped once the cache exceeds its
+       * memory budget.
+       * @param base the fixed base
+       */
+      FixedBase GetFixedBase(const Element &base) const;
+
+      /**
+       * Precompute a table of powers of base for use with
+       * ExponentiateFixed. The default table holds only the base.
+       * Prefer GetFixedBase, which caches the result.
+       * @param base the fixed base
+       */
+      virtual QSharedPointer<FixedBaseTable> PrecomputeBase(const Element &base) const;
+
+      /**
+       * Compute base^exp using a table returned by PrecomputeBase.
+       * The default falls back to Exponentiate.
+       * @param table the precomputed table for base
+       * @param exp exponent
+       */
+      virtual Element ExponentiateFixed(const FixedBaseTable &table,
+          const Integer &exp) const;
+
       /**
        * Compute b such that ab is the group identity
        * @param a element to invert
@@ -187,7 +235,14 @@ namespace AbstractGroup {
       virtual int GetSecurityParameter() const = 0;
 
     private:
+      /**
+       * Returns a small id shared by all groups with this group's
+       * parameters, assigned on first use and then kept by the group
+       * and its copies
+       */
+      int GetGroupId() const;
 
+      mutable QAtomicInt _group_id;
   };
 
 }
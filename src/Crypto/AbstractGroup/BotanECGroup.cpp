@@ -63,6 +63,54 @@ namespace AbstractGroup {
                             GetPoint(a2), ToBotanInt(e2))));
   }
 
+  namespace {
+    /**
+     * Point addition, the group operation for WindowTable
+     */
+    class BotanECAdd {
+      public:
+        inline Botan::PointGFp operator()(const Botan::PointGFp &a,
+            const Botan::PointGFp &b) const
+        {
+          return a + b;
+        }
+    };
+  }
+
+  QSharedPointer<FixedBaseTable> BotanECGroup::PrecomputeBase(const Element &base) const
+  {
+    QSharedPointer<WindowTable<Botan::PointGFp> > table(
+        new WindowTable<Botan::PointGFp>(base, _q.GetBitCount()));
+    table->Build(GetPoint(base), BotanECAdd());
+    return table;
+  }
+
+  Element BotanECGroup::ExponentiateFixed(const FixedBaseTable &table,
+      const Integer &exp) const
+  {
+    const WindowTable<Botan::PointGFp> *wtable =
+      dynamic_cast<const WindowTable<Botan::PointGFp> *>(&table);
+
+    Botan::PointGFp out(_curve);
+    if(wtable && wtable->Evaluate(exp, BotanECAdd(), out)) {
+      return Element(new BotanECElementData(out));
+    }
+    return Exponentiate(table.GetBase(), exp);
+  }
+
+  Element BotanECGroup::MultiExponentiate(const QList<Element> &bases,
+      const QList<Integer> &exps) const
+  {
+    QVector<Botan::PointGFp> points;
+    foreach(const Element &base, bases) {
+      points.append(GetPoint(base));
+    }
+
+    MultiExponentiation<Botan::PointGFp, BotanECAdd> multi(BotanECAdd(),
+        Botan::PointGFp(_curve));
+    return Element(new BotanECElementData(multi.Compute(points, ReduceExponents(exps, _q))));
+  }
+
   Element BotanECGroup::Inverse(const Element &a) const
   {
     return Element(new BotanECElementData(GetPoint(a).negate()));
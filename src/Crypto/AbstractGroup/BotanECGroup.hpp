@@ -57,6 +57,12 @@ namespace AbstractGroup {
        */
       virtual QSharedPointer<AbstractGroup> Copy() const;
 
+      /**
+       * Botan keeps arithmetic workspace inside its points, so elements of
+       * this group must not be shared between threads
+       */
+      virtual bool IsThreadSafe() const { return false; }
+
       /**
        * Add two elliptic curve points
        * @param a first operand 
@@ -82,6 +88,28 @@ namespace AbstractGroup {
       virtual Element CascadeExponentiate(const Element &a1, const Integer &e1,
           const Element &a2, const Integer &e2) const;
 
+      /**
+       * Precompute a windowed table of multiples of the base point
+       * @param base the fixed base
+       */
+      virtual QSharedPointer<FixedBaseTable> PrecomputeBase(const Element &base) const;
+
+      /**
+       * Compute exp * base using a table returned by PrecomputeBase
+       * @param table the precomputed table for base
+       * @param exp exponent
+       */
+      virtual Element ExponentiateFixed(const FixedBaseTable &table,
+          const Integer &exp) const;
+
+      /**
+       * Compute the sum of exps[i] * bases[i] using MultiExponentiation
+       * @param bases the bases
+       * @param exps the exponents, one per base
+       */
+      virtual Element MultiExponentiate(const QList<Element> &bases,
+          const QList<Integer> &exps) const;
+
       /**
        * Compute b such that a+b = O (identity)
        * @param a element to invert
@@ -1,4 +1,5 @@
 
+#include <QMutexLocker>
 #include <cryptopp/nbtheory.h>
 
 #include "CppECElementData.hpp"
@@ -25,6 +26,42 @@ namespace AbstractGroup {
       Q_ASSERT(ToCryptoInt(p) == _curve.FieldSize());
     };
 
+  CppECGroup::CppECGroup(const CppECGroup &other) :
+      AbstractGroup(),
+      _curve(other._curve),
+      _q(other._q),
+      _g(other._g),
+      _field_bytes(other._field_bytes)
+  {
+  }
+
+  CppECGroup::~CppECGroup()
+  {
+    qDeleteAll(_curves);
+  }
+
+  CppECGroup::Curve::Curve(const CppECGroup *group) :
+    _group(group),
+    _curve(0)
+  {
+    {
+      QMutexLocker locker(&_group->_curves_lock);
+      if(!_group->_curves.isEmpty()) {
+        _curve = _group->_curves.takeLast();
+      }
+    }
+
+    if(!_curve) {
+      _curve = new CryptoPP::ECP(_group->_curve);
+    }
+  }
+
+  CppECGroup::Curve::~Curve()
+  {
+    QMutexLocker locker(&_group->_curves_lock);
+    _group->_curves.append(_curve);
+  }
+
   QSharedPointer<AbstractGroup> CppECGroup::Copy() const
   {
     return QSharedPointer<CppECGroup>(new CppECGroup(*this));
@@ -41,12 +78,14 @@ namespace AbstractGroup {
 
   Element CppECGroup::Multiply(const Element &a, const Element &b) const
   {
-    return Element(new CppECElementData(_curve.Add(GetPoint(a), GetPoint(b))));
+    Curve curve(this);
+    return Element(new CppECElementData(curve->Add(GetPoint(a), GetPoint(b))));
   }
 
   Element CppECGroup::Exponentiate(const Element &a, const Integer &exp) const
   {
-    return Element(new CppECElementData(_curve.Multiply(ToCryptoInt(exp), GetPoint(a))));
+    Curve curve(this);
+    return Element(new CppECElementData(curve->Multiply(ToCryptoInt(exp), GetPoint(a))));
   }
   
   Element CppECGroup::CascadeExponentiate(const Element &a1, const Integer &e1,
@@ -54,9 +93,10 @@ namespace AbstractGroup {
   {
     // For some reason, this is 50% faster than Crypto++'s native
     // CascadeMultiply
-    return Element(new CppECElementData(_curve.Add(
-            _curve.Multiply(ToCryptoInt(e1), GetPoint(a1)),
-            _curve.Multiply(ToCryptoInt(e2), GetPoint(a2)))));
+    Curve curve(this);
+    return Element(new CppECElementData(curve->Add(
+            curve->Multiply(ToCryptoInt(e1), GetPoint(a1)),
+            curve->Multiply(ToCryptoInt(e2), GetPoint(a2)))));
    
     /*
     return Element(new CppECElementData(_curve.CascadeMultiply(
@@ -66,9 +106,66 @@ namespace AbstractGroup {
     
   }
 
+  namespace {
+    /**
+     * Point addition, the group operation for WindowTable
+     */
+    class CppECAdd {
+      public:
+        explicit CppECAdd(const CryptoPP::ECP &curve) : _curve(curve) {}
+
+        inline CryptoPP::ECPPoint operator()(const CryptoPP::ECPPoint &a,
+            const CryptoPP::ECPPoint &b) const
+        {
+          return _curve.Add(a, b);
+        }
+
+      private:
+        const CryptoPP::ECP &_curve;
+    };
+  }
+
+  QSharedPointer<FixedBaseTable> CppECGroup::PrecomputeBase(const Element &base) const
+  {
+    QSharedPointer<WindowTable<CryptoPP::ECPPoint> > table(
+        new WindowTable<CryptoPP::ECPPoint>(base, _q.GetBitCount()));
+    Curve curve(this);
+    table->Build(GetPoint(base), CppECAdd(*curve));
+    return table;
+  }
+
+  Element CppECGroup::ExponentiateFixed(const FixedBaseTable &table,
+      const Integer &exp) const
+  {
+    const WindowTable<CryptoPP::ECPPoint> *wtable =
+      dynamic_cast<const WindowTable<CryptoPP::ECPPoint> *>(&table);
+
+    Curve curve(this);
+    CryptoPP::ECPPoint out;
+    if(wtable && wtable->Evaluate(exp, CppECAdd(*curve), out)) {
+      return Element(new CppECElementData(out));
+    }
+    return Exponentiate(table.GetBase(), exp);
+  }
+
+  Element CppECGroup::MultiExponentiate(const QList<Element> &bases,
+      const QList<Integer> &exps) const
+  {
+    QVector<CryptoPP::ECPPoint> points;
+    foreach(const Element &base, bases) {
+      points.append(GetPoint(base));
+    }
+
+    Curve curve(this);
+    MultiExponentiation<CryptoPP::ECPPoint, CppECAdd> multi(CppECAdd(*curve),
+        CryptoPP::ECPPoint());
+    return Element(new CppECElementData(multi.Compute(points, ReduceExponents(exps, _q))));
+  }
+
   Element CppECGroup::Inverse(const Element &a) const
   {
-    return Element(new CppECElementData(_curve.Inverse(GetPoint(a))));
+    Curve curve(this);
+    return Element(new CppECElementData(curve->Inverse(GetPoint(a))));
   }
   
   QByteArray CppECGroup::ElementToByteArray(const Element &a) const
@@ -81,8 +178,9 @@ namespace AbstractGroup {
   
   Element CppECGroup::ElementFromByteArray(const QByteArray &bytes) const 
   { 
+    Curve curve(this);
     CryptoPP::ECPPoint point;
-    _curve.DecodePoint(point, 
+    curve->DecodePoint(point, 
         (const unsigned char*)(bytes.constData()), 
         bytes.count());
     return Element(new CppECElementData(point));
@@ -90,7 +188,12 @@ namespace AbstractGroup {
 
   bool CppECGroup::IsElement(const Element &a) const 
   {
-    return IsIdentity(a) || _curve.VerifyPoint(GetPoint(a));
+    if(IsIdentity(a)) {
+      return true;
+    }
+
+    Curve curve(this);
+    return curve->VerifyPoint(GetPoint(a));
   }
 
   bool CppECGroup::IsIdentity(const Element &a) const 
@@ -1,6 +1,8 @@
 #ifndef DISSENT_CRYPTO_ABSTRACT_GROUP_CPP_EC_GROUP_H_GUARD
 #define DISSENT_CRYPTO_ABSTRACT_GROUP_CPP_EC_GROUP_H_GUARD
 
+#include <QList>
+#include <QMutex>
 #include <QSharedPointer>
 
 #include "Crypto/CppIntegerData.hpp"
@@ -38,10 +40,15 @@ namespace AbstractGroup {
        */
       static QSharedPointer<CppECGroup> GetGroup(ECParams::CurveName name);
 
+      /**
+       * Copy constructor, the copy has its own curves
+       */
+      CppECGroup(const CppECGroup &other);
+
       /**
        * Destructor
        */
-      virtual ~CppECGroup() {}
+      virtual ~CppECGroup();
 
       /**
        * Return a pointer to a copy of this group
@@ -73,6 +80,28 @@ namespace AbstractGroup {
       virtual Element CascadeExponentiate(const Element &a1, const Integer &e1,
           const Element &a2, const Integer &e2) const;
 
+      /**
+       * Precompute a windowed table of multiples of the base point
+       * @param base the fixed base
+       */
+      virtual QSharedPointer<FixedBaseTable> PrecomputeBase(const Element &base) const;
+
+      /**
+       * Compute exp * base using a table returned by PrecomputeBase
+       * @param table the precomputed table for base
+       * @param exp exponent
+       */
+      virtual Element ExponentiateFixed(const FixedBaseTable &table,
+          const Integer &exp) const;
+
+      /**
+       * Compute the sum of exps[i] * bases[i] using MultiExponentiation
+       * @param bases the bases
+       * @param exps the exponents, one per base
+       */
+      virtual Element MultiExponentiate(const QList<Element> &bases,
+          const QList<Integer> &exps) const;
+
       /**
        * Compute b such that a+b = O (identity)
        * @param a element to invert
@@ -225,6 +254,31 @@ namespace AbstractGroup {
        */
       bool SolveForY(const CryptoPP::Integer &x, Element &point) const;
 
+      /**
+       * CryptoPP::ECP keeps scratch space in the curve and its field, so
+       * arithmetic is done on a copy of _curve borrowed from the group for
+       * the lifetime of a Curve.  This keeps the group safe to share
+       * between threads.
+       */
+      class Curve {
+        public:
+          explicit Curve(const CppECGroup *group);
+          ~Curve();
+
+          inline const CryptoPP::ECP *operator->() const { return _curve; }
+          inline const CryptoPP::ECP &operator*() const { return *_curve; }
+
+        private:
+          const CppECGroup *_group;
+          CryptoPP::ECP *_curve;
+
+          Curve(const Curve &);
+          Curve &operator=(const Curve &);
+      };
+
+      /**
+       * Only used for reading the curve's parameters
+       */
       CryptoPP::ECP _curve;
       Integer _q;
       CryptoPP::ECPPoint _g;
@@ -236,6 +290,10 @@ namespace AbstractGroup {
       static const int _k_bytes = 1;
       static const int _k = (1 << (_k_bytes*8));
 
+      mutable QMutex _curves_lock;
+      mutable QList<CryptoPP::ECP *> _curves;
+
+      CppECGroup &operator=(const CppECGroup &);
   };
 
 }
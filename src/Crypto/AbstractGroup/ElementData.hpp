@@ -3,15 +3,18 @@
 
 #include <QSharedData>
 
+#include "Utils/Arena.hpp"
+
 namespace Dissent {
 namespace Crypto {
 namespace AbstractGroup {
 
   /**
    * This is an abstract base class holding data for
-   * group elements
+   * group elements, allocated from the thread's Utils::Arena if
+   * there is one
    */
-  class ElementData : public QSharedData {
+  class ElementData : public QSharedData, public Utils::ArenaAllocated {
     public:
     
       /**
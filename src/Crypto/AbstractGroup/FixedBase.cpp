@@ -0,0 +1,15 @@
+#include "AbstractGroup.hpp"
+#include "FixedBase.hpp"
+
+namespace Dissent {
+namespace Crypto {
+namespace AbstractGroup {
+
+  Element FixedBase::Exponentiate(const Integer &exp) const
+  {
+    return _group->ExponentiateFixed(*_table, exp);
+  }
+
+}
+}
+}
@@ -0,0 +1,206 @@
+#ifndef DISSENT_CRYPTO_ABSTRACT_GROUP_FIXED_BASE_H_GUARD
+#define DISSENT_CRYPTO_ABSTRACT_GROUP_FIXED_BASE_H_GUARD
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include "Crypto/Integer.hpp"
+#include "Element.hpp"
+#include "MultiExponentiation.hpp"
+
+namespace Dissent {
+namespace Crypto {
+namespace AbstractGroup {
+
+  class AbstractGroup;
+
+  /**
+   * Precomputed data for exponentiating a single fixed base.
+   * Groups that do not support precomputation return one of these
+   * holding only the base, in which case exponentiation falls
+   * back to AbstractGroup::Exponentiate.
+   */
+  class FixedBaseTable {
+
+    public:
+
+      /**
+       * Constructor
+       * @param base the fixed base
+       */
+      explicit FixedBaseTable(const Element &base) : _base(base) {}
+
+      /**
+       * Destructor
+       */
+      virtual ~FixedBaseTable() {}
+
+      /**
+       * Returns the fixed base
+       */
+      inline Element GetBase() const { return _base; }
+
+      /**
+       * Returns the number of group elements held, used to bound the
+       * memory of cached tables
+       */
+      virtual int GetElementCount() const { return 1; }
+
+    private:
+
+      Element _base;
+  };
+
+  /**
+   * A fixed-base windowed exponentiation table. For a window width w,
+   * entry (i, d) holds base^(d * 2^(w*i)) for d in [1, 2^w), so that
+   * base^e is the product of one entry per nonzero w-bit digit of e.
+   * This replaces the squarings of a regular exponentiation with a
+   * table lookup, costing roughly bits/w group operations.
+   *
+   * T is the backend's native element type and the Combine functor,
+   * T operator()(const T &, const T &), is the group operation.
+   */
+  template<typename T> class WindowTable : public FixedBaseTable {
+
+    public:
+
+      /**
+       * Constructor
+       * @param base the fixed base
+       * @param bits the largest exponent bit count served by the table,
+       *        larger exponents fall back to the group
+       */
+      WindowTable(const Element &base, int bits) :
+        FixedBaseTable(base),
+        _width(WindowWidth(bits)),
+        _windows((bits + _width - 1) / _width)
+      {
+      }
+
+      /**
+       * Fills in the table
+       * @param base the fixed base in the backend's representation
+       * @param combine the group operation
+       */
+      template<typename Combine> void Build(const T &base, const Combine &combine)
+      {
+        const int digits = (1 << _width) - 1;
+        _table.clear();
+        _table.reserve(_windows * digits);
+
+        T step = base;
+        for(int window = 0; window < _windows; window++) {
+          // step = base^(2^(w*window))
+          T current = step;
+          _table.append(current);
+          for(int digit = 2; digit <= digits; digit++) {
+            current = combine(current, step);
+            _table.append(current);
+          }
+
+          if(window + 1 < _windows) {
+            step = combine(current, step);
+          }
+        }
+      }
+
+      /**
+       * Computes base^exp from the table
+       * @param exp the exponent
+       * @param combine the group operation
+       * @param out set to base^exp on success
+       * @returns false if exp is zero, negative or larger than the table,
+       *          in which case the caller should fall back to a regular
+       *          exponentiation
+       */
+      template<typename Combine> bool Evaluate(const Integer &exp,
+          const Combine &combine, T &out) const
+      {
+        if(_table.isEmpty() || exp <= 0 || exp.GetBitCount() > (_width * _windows)) {
+          return false;
+        }
+
+        const QByteArray bytes = exp.GetByteArray();
+        const int digits = (1 << _width) - 1;
+        bool found = false;
+
+        for(int window = 0; window < _windows; window++) {
+          int digit = GetExponentDigit(bytes, window * _width, _width);
+          if(digit == 0) {
+            continue;
+          }
+
+          const T &entry = _table[window * digits + digit - 1];
+          if(found) {
+            out = combine(out, entry);
+          } else {
+            out = entry;
+            found = true;
+          }
+        }
+
+        return found;
+      }
+
+      virtual int GetElementCount() const { return _table.count() + 1; }
+
+    private:
+
+      /**
+       * Wider windows mean fewer operations per exponentiation, but the
+       * table grows as 2^w / w, so large exponents use a narrower window
+       */
+      inline static int WindowWidth(int bits)
+      {
+        return (bits > 512) ? 4 : 5;
+      }
+
+      const int _width;
+      const int _windows;
+      QVector<T> _table;
+  };
+
+  /**
+   * A handle for repeatedly exponentiating a fixed base, see
+   * AbstractGroup::GetFixedBase. The handle shares ownership of a copy of
+   * the group that created it, so it may outlive that group.
+   */
+  class FixedBase {
+
+    public:
+
+      /**
+       * Constructor
+       * @param group a group with the base's parameters
+       * @param table the precomputed table for the base
+       */
+      FixedBase(const QSharedPointer<const AbstractGroup> &group,
+          const QSharedPointer<const FixedBaseTable> &table) :
+        _group(group),
+        _table(table)
+      {
+      }
+
+      /**
+       * Returns base^exp
+       * @param exp the exponent
+       */
+      Element Exponentiate(const Integer &exp) const;
+
+      /**
+       * Returns the fixed base
+       */
+      inline Element GetBase() const { return _table->GetBase(); }
+
+    private:
+
+      QSharedPointer<const AbstractGroup> _group;
+      QSharedPointer<const FixedBaseTable> _table;
+  };
+
+}
+}
+}
+
+#endif
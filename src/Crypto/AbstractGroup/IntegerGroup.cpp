@@ -187,6 +187,57 @@ namespace AbstractGroup {
           _p.PowCascade(GetInteger(a1), e1, GetInteger(a2), e2)));
   }
 
+  namespace {
+    /**
+     * Multiplication mod p, the group operation for WindowTable
+     */
+    class IntegerMultiply {
+      public:
+        explicit IntegerMultiply(const Integer &p) : _p(p) {}
+
+        inline Integer operator()(const Integer &a, const Integer &b) const
+        {
+          return a.MultiplyMod(b, _p);
+        }
+
+      private:
+        const Integer _p;
+    };
+  }
+
+  QSharedPointer<FixedBaseTable> IntegerGroup::PrecomputeBase(const Element &base) const
+  {
+    QSharedPointer<WindowTable<Integer> > table(
+        new WindowTable<Integer>(base, _q.GetBitCount()));
+    table->Build(GetInteger(base), IntegerMultiply(_p));
+    return table;
+  }
+
+  Element IntegerGroup::ExponentiateFixed(const FixedBaseTable &table,
+      const Integer &exp) const
+  {
+    const WindowTable<Integer> *wtable =
+      dynamic_cast<const WindowTable<Integer> *>(&table);
+
+    Integer out;
+    if(wtable && wtable->Evaluate(exp, IntegerMultiply(_p), out)) {
+      return Element(new IntegerElementData(out));
+    }
+    return Exponentiate(table.GetBase(), exp);
+  }
+
+  Element IntegerGroup::MultiExponentiate(const QList<Element> &bases,
+      const QList<Integer> &exps) const
+  {
+    QVector<Integer> ints;
+    foreach(const Element &base, bases) {
+      ints.append(GetInteger(base));
+    }
+
+    MultiExponentiation<Integer, IntegerMultiply> multi(IntegerMultiply(_p), Integer(1));
+    return Element(new IntegerElementData(multi.Compute(ints, ReduceExponents(exps, _q))));
+  }
+
   Element IntegerGroup::Inverse(const Element &a) const
   {
     return Element(new IntegerElementData(GetInteger(a).ModInverse(_p)));
@@ -86,6 +86,29 @@ namespace AbstractGroup {
       virtual Element CascadeExponentiate(const Element &a1, const Integer &e1,
           const Element &a2, const Integer &e2) const;
 
+      /**
+       * Precompute a windowed table of powers of base mod p
+       * @param base the fixed base
+       */
+      virtual QSharedPointer<FixedBaseTable> PrecomputeBase(const Element &base) const;
+
+      /**
+       * Compute base^exp using a table returned by PrecomputeBase
+       * @param table the precomputed table for base
+       * @param exp exponent
+       */
+      virtual Element ExponentiateFixed(const FixedBaseTable &table,
+          const Integer &exp) const;
+
+      /**
+       * Compute the product of bases[i]^exps[i] mod p using
+       * MultiExponentiation
+       * @param bases the bases
+       * @param exps the exponents, one per base
+       */
+      virtual Element MultiExponentiate(const QList<Element> &bases,
+          const QList<Integer> &exps) const;
+
       /**
        * Compute b such that ab = 1
        * @param a element to invert
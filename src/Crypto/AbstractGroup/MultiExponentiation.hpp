@@ -0,0 +1,255 @@
+#ifndef DISSENT_CRYPTO_ABSTRACT_GROUP_MULTI_EXPONENTIATION_H_GUARD
+#define DISSENT_CRYPTO_ABSTRACT_GROUP_MULTI_EXPONENTIATION_H_GUARD
+
+#include <QList>
+#include <QVector>
+
+#include "Crypto/Integer.hpp"
+
+namespace Dissent {
+namespace Crypto {
+namespace AbstractGroup {
+
+  /**
+   * Returns width bits of a non-negative exponent starting at bit offset
+   * @param bytes the exponent's big-endian magnitude, i.e.,
+   *        Integer::GetByteArray
+   * @param offset the index of the least significant bit of the digit
+   * @param width the number of bits in the digit
+   */
+  inline int GetExponentDigit(const QByteArray &bytes, int offset, int width)
+  {
+    const int count = bytes.size();
+    int digit = 0;
+    for(int bit = 0; bit < width; bit++) {
+      int pos = offset + bit;
+      int idx = count - 1 - (pos / 8);
+      if(idx < 0) {
+        break;
+      }
+
+      if(static_cast<unsigned char>(bytes[idx]) & (1 << (pos % 8))) {
+        digit |= (1 << bit);
+      }
+    }
+    return digit;
+  }
+
+  /**
+   * Maps each exponent into [0, order), multi-exponentiation only
+   * handles non-negative exponents
+   * @param exps the exponents
+   * @param order the order of the group
+   */
+  inline QList<Integer> ReduceExponents(const QList<Integer> &exps, const Integer &order)
+  {
+    QList<Integer> out;
+    foreach(const Integer &exp, exps) {
+      if(exp < 0 || exp >= order) {
+        Integer reduced = exp % order;
+        if(reduced < 0) {
+          reduced += order;
+        }
+        out.append(reduced);
+      } else {
+        out.append(exp);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Computes products of powers, prod_i bases[i]^exps[i], over a
+   * backend's native element type T sharing the squarings between
+   * all of the bases. Small inputs use Straus' interleaved windows,
+   * a table of 2^w - 1 powers per base and one pass over the exponent
+   * bits. Large inputs use Pippenger's bucket method, which for each
+   * c-bit window adds every base into one of 2^c - 1 buckets and then
+   * combines the buckets with about 2^(c+1) operations, costing
+   * roughly bits * (n + 2^(c+1)) / c operations rather than n * bits.
+   *
+   * The Combine functor, T operator()(const T &, const T &), is the
+   * group operation and must also handle combining a value with itself.
+   */
+  template<typename T, typename Combine> class MultiExponentiation {
+
+    public:
+
+      /**
+       * Constructor
+       * @param combine the group operation
+       * @param identity the group identity, returned for empty products
+       */
+      MultiExponentiation(const Combine &combine, const T &identity) :
+        _combine(combine),
+        _identity(identity)
+      {
+      }
+
+      /**
+       * Returns prod_i bases[i]^exps[i]
+       * @param bases the bases
+       * @param exps non-negative exponents, one per base
+       */
+      T Compute(const QVector<T> &bases, const QList<Integer> &exps) const
+      {
+        Q_ASSERT(bases.count() == exps.count());
+
+        QList<QByteArray> bytes;
+        int bits = 0;
+        foreach(const Integer &exp, exps) {
+          Q_ASSERT(exp >= 0);
+          bytes.append(exp.GetByteArray());
+          bits = qMax(bits, exp.GetBitCount());
+        }
+
+        if(bits == 0) {
+          return _identity;
+        }
+
+        if(bases.count() < PIPPENGER_THRESHOLD) {
+          return Straus(bases, bytes, bits);
+        }
+        return Pippenger(bases, bytes, bits);
+      }
+
+    private:
+
+      /**
+       * Number of bases at which the bucket method overtakes
+       * interleaved windows
+       */
+      static const int PIPPENGER_THRESHOLD = 128;
+
+      /**
+       * Window width for interleaved windows
+       */
+      static const int STRAUS_WIDTH = 4;
+
+      /**
+       * acc = acc * value, where acc may not have been set yet
+       */
+      inline void Accumulate(T &acc, bool &set, const T &value) const
+      {
+        if(set) {
+          acc = _combine(acc, value);
+        } else {
+          acc = value;
+          set = true;
+        }
+      }
+
+      /**
+       * acc = acc^(2^width)
+       */
+      inline void Square(T &acc, bool set, int width) const
+      {
+        if(!set) {
+          return;
+        }
+
+        for(int idx = 0; idx < width; idx++) {
+          acc = _combine(acc, acc);
+        }
+      }
+
+      T Straus(const QVector<T> &bases, const QList<QByteArray> &bytes,
+          int bits) const
+      {
+        const int width = STRAUS_WIDTH;
+        const int digits = (1 << width) - 1;
+        const int count = bases.count();
+
+        // table[i * digits + d - 1] = bases[i]^d
+        QVector<T> table;
+        table.reserve(count * digits);
+        for(int idx = 0; idx < count; idx++) {
+          T current = bases[idx];
+          table.append(current);
+          for(int digit = 2; digit <= digits; digit++) {
+            current = _combine(current, bases[idx]);
+            table.append(current);
+          }
+        }
+
+        T acc;
+        bool set = false;
+        for(int window = (bits - 1) / width; window >= 0; window--) {
+          Square(acc, set, width);
+          for(int idx = 0; idx < count; idx++) {
+            int digit = GetExponentDigit(bytes[idx], window * width, width);
+            if(digit) {
+              Accumulate(acc, set, table[idx * digits + digit - 1]);
+            }
+          }
+        }
+
+        return set ? acc : _identity;
+      }
+
+      T Pippenger(const QVector<T> &bases, const QList<QByteArray> &bytes,
+          int bits) const
+      {
+        const int width = PippengerWidth(bases.count());
+        const int buckets = (1 << width) - 1;
+        const int count = bases.count();
+
+        QVector<T> bucket(buckets);
+        QVector<bool> bucket_set(buckets);
+
+        T acc;
+        bool set = false;
+        for(int window = (bits - 1) / width; window >= 0; window--) {
+          Square(acc, set, width);
+
+          bucket_set.fill(false);
+          for(int idx = 0; idx < count; idx++) {
+            int digit = GetExponentDigit(bytes[idx], window * width, width);
+            if(digit) {
+              bool in_bucket = bucket_set[digit - 1];
+              Accumulate(bucket[digit - 1], in_bucket, bases[idx]);
+              bucket_set[digit - 1] = true;
+            }
+          }
+
+          // sum_d bucket[d]^d, as a running product from the top bucket
+          T running, window_sum;
+          bool running_set = false, window_set = false;
+          for(int digit = buckets; digit > 0; digit--) {
+            if(bucket_set[digit - 1]) {
+              Accumulate(running, running_set, bucket[digit - 1]);
+            }
+            if(running_set) {
+              Accumulate(window_sum, window_set, running);
+            }
+          }
+
+          if(window_set) {
+            Accumulate(acc, set, window_sum);
+          }
+        }
+
+        return set ? acc : _identity;
+      }
+
+      /**
+       * Bucket width minimizing (n + 2^(c+1)) / c, roughly log2(n) - 2
+       */
+      inline static int PippengerWidth(int count)
+      {
+        int log = 0;
+        while((1 << (log + 1)) <= count) {
+          log++;
+        }
+        return qBound(4, log - 2, 16);
+      }
+
+      const Combine _combine;
+      const T _identity;
+  };
+
+}
+}
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define DISSENT_CRYPTO_ABSTRACT_GROUP_OPEN_EC_ELEMENT_DATA_H_GUARD
 
 #include <openssl/ec.h>
+#include "Crypto/OpenBnContext.hpp"
 #include "ElementData.hpp"
 
 namespace Dissent {
@@ -18,13 +19,12 @@ namespace AbstractGroup {
 
       /**
        * Constructor -- We are responsible for freeing
-       * the point, but NOT the group or ctx.
+       * the point, but NOT the group.
        * @param point elliptic curve point
        * @param group elliptic curve group
-       * @param ctx BIGNUM context
        */
-      OpenECElementData(EC_POINT *point, EC_GROUP *group, BN_CTX *ctx) : 
-        _point(point), _group(group), _ctx(ctx) {}
+      OpenECElementData(EC_POINT *point, EC_GROUP *group) : 
+        _point(point), _group(group) {}
 
       /**
        * Destructor
@@ -40,7 +40,8 @@ namespace AbstractGroup {
        */
       virtual bool operator==(const ElementData *other) const
       {
-        return !EC_POINT_cmp(_group, _point, GetPoint(other), _ctx);
+        return !EC_POINT_cmp(_group, _point, GetPoint(other),
+            OpenBnContext::GetContext());
       }
 
       /**
@@ -64,7 +65,6 @@ namespace AbstractGroup {
 
       EC_POINT *_point;
       EC_GROUP *_group;
-      BN_CTX *_ctx;
   };
 
 }
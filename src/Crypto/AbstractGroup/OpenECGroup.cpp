@@ -1,3 +1,4 @@
+#include "Crypto/OpenBnContext.hpp"
 #include "OpenECElementData.hpp"
 #include "OpenECGroup.hpp"
 
@@ -19,7 +20,7 @@ namespace AbstractGroup {
       _generator(EC_POINT_new(_data->group)), 
       _field_bytes(BN_num_bytes(_p)-1)
     {
-      CHECK_CALL(_data->ctx);
+      BN_CTX *ctx = OpenBnContext::GetContext();
       CHECK_CALL(_data->group);
 
       CHECK_CALL(BN_zero(_zero));
@@ -32,20 +33,20 @@ namespace AbstractGroup {
       */
 
       // Prepare montgomery multiplication mod p
-      CHECK_CALL(BN_MONT_CTX_set(_data->mont, _p, _data->ctx));
+      CHECK_CALL(BN_MONT_CTX_set(_data->mont, _p, ctx));
 
       // Initialize group
-      CHECK_CALL(EC_GROUP_set_curve_GFp(_data->group, _p, _a, _b, _data->ctx));
+      CHECK_CALL(EC_GROUP_set_curve_GFp(_data->group, _p, _a, _b, ctx));
 
       // affine coordinates are the "normal" (x,y) pairs
       CHECK_CALL(EC_POINT_set_affine_coordinates_GFp(_data->group, 
-            _generator, _gx, _gy, _data->ctx));
+            _generator, _gx, _gy, ctx));
 
       // Cofactor of our curves are always 1
       CHECK_CALL(EC_GROUP_set_generator(_data->group, _generator, _q, _one));
 
       // Precomupte factors of generator
-      CHECK_CALL(EC_GROUP_precompute_mult(_data->group, _data->ctx));
+      CHECK_CALL(EC_GROUP_precompute_mult(_data->group, ctx));
     };
 
   QSharedPointer<OpenECGroup> OpenECGroup::NewGroup(const Integer &p_in, 
@@ -120,17 +121,19 @@ namespace AbstractGroup {
 
   Element OpenECGroup::Multiply(const Element &a, const Element &b) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     EC_POINT *r = EC_POINT_new(_data->group);
     CHECK_CALL(r);
 
     // r = a + b
-    CHECK_CALL(EC_POINT_add(_data->group, r, GetPoint(a), GetPoint(b), _data->ctx));
+    CHECK_CALL(EC_POINT_add(_data->group, r, GetPoint(a), GetPoint(b), ctx));
 
     return NewElement(r);
   }
 
   Element OpenECGroup::Exponentiate(const Element &a, const Integer &exp) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     EC_POINT *r = EC_POINT_new(_data->group);
     CHECK_CALL(r);
 
@@ -143,16 +146,125 @@ namespace AbstractGroup {
     ps[0] = GetPoint(a);
     ms[0] = tmp;
 
-    CHECK_CALL(EC_POINTs_mul(_data->group, r, _zero, 1, ps, ms, _data->ctx));
+    CHECK_CALL(EC_POINTs_mul(_data->group, r, _zero, 1, ps, ms, ctx));
 
     BN_clear_free(tmp);
 
     return NewElement(r);
   }
   
+  namespace {
+    /**
+     * Point addition, the group operation for WindowTable
+     */
+    class OpenECAdd {
+      public:
+        explicit OpenECAdd(const OpenECGroup *group) : _group(group) {}
+
+        inline Element operator()(const Element &a, const Element &b) const
+        {
+          return _group->Multiply(a, b);
+        }
+
+      private:
+        const OpenECGroup *_group;
+    };
+
+    /**
+     * Marks the generator, whose multiples OpenSSL precomputes itself
+     */
+    class OpenECGeneratorTable : public FixedBaseTable {
+      public:
+        explicit OpenECGeneratorTable(const Element &base) :
+          FixedBaseTable(base)
+        {
+        }
+    };
+  }
+
+  QSharedPointer<FixedBaseTable> OpenECGroup::PrecomputeBase(const Element &base) const
+  {
+    BN_CTX *ctx = OpenBnContext::GetContext();
+    if(!EC_POINT_cmp(_data->group, GetPoint(base), _generator, ctx)) {
+      return QSharedPointer<FixedBaseTable>(new OpenECGeneratorTable(base));
+    }
+
+    QSharedPointer<WindowTable<Element> > table(
+        new WindowTable<Element>(base, BN_num_bits(_q)));
+    table->Build(base, OpenECAdd(this));
+    return table;
+  }
+
+  Element OpenECGroup::ExponentiateFixed(const FixedBaseTable &table,
+      const Integer &exp) const
+  {
+    BN_CTX *ctx = OpenBnContext::GetContext();
+    if(dynamic_cast<const OpenECGeneratorTable *>(&table)) {
+      EC_POINT *r = EC_POINT_new(_data->group);
+      CHECK_CALL(r);
+
+      BIGNUM *tmp = BN_new();
+      GetInteger(tmp, exp);
+
+      // Uses the generator table built in the constructor
+      CHECK_CALL(EC_POINT_mul(_data->group, r, tmp, NULL, NULL, ctx));
+
+      BN_clear_free(tmp);
+      return NewElement(r);
+    }
+
+    const WindowTable<Element> *wtable =
+      dynamic_cast<const WindowTable<Element> *>(&table);
+
+    Element out;
+    if(wtable && wtable->Evaluate(exp, OpenECAdd(this), out)) {
+      // Table entries may belong to another instance of this curve
+      EC_POINT *r = EC_POINT_dup(GetPoint(out), _data->group);
+      CHECK_CALL(r);
+      return NewElement(r);
+    }
+    return Exponentiate(table.GetBase(), exp);
+  }
+
+  Element OpenECGroup::MultiExponentiate(const QList<Element> &bases,
+      const QList<Integer> &exps) const
+  {
+    BN_CTX *ctx = OpenBnContext::GetContext();
+    Q_ASSERT(bases.count() == exps.count());
+
+    const int count = bases.count();
+    if(count == 0) {
+      return GetIdentity();
+    }
+
+    QVector<const EC_POINT *> ps(count);
+    QVector<const BIGNUM *> ms(count);
+
+    for(int idx = 0; idx < count; idx++) {
+      BIGNUM *tmp = BN_new();
+      GetInteger(tmp, exps[idx]);
+
+      ps[idx] = GetPoint(bases[idx]);
+      ms[idx] = tmp;
+    }
+
+    EC_POINT *r = EC_POINT_new(_data->group);
+    CHECK_CALL(r);
+
+    CHECK_CALL(EC_POINTs_mul(_data->group, r, NULL, count,
+          ps.data(), ms.data(), ctx));
+
+    for(int idx = 0; idx < count; idx++) {
+      BN_clear_free(const_cast<BIGNUM *>(ms[idx]));
+    }
+
+    return NewElement(r);
+  }
+
   Element OpenECGroup::CascadeExponentiate(const Element &a1, const Integer &e1,
       const Element &a2, const Integer &e2) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     EC_POINT *r = EC_POINT_new(_data->group);
     CHECK_CALL(r);
 
@@ -170,7 +282,7 @@ namespace AbstractGroup {
     ms[0] = tmp1;
     ms[1] = tmp2;
 
-    CHECK_CALL(EC_POINTs_mul(_data->group, r, _zero, 2, ps, ms, _data->ctx));
+    CHECK_CALL(EC_POINTs_mul(_data->group, r, _zero, 2, ps, ms, ctx));
 
     BN_clear_free(tmp1);
     BN_clear_free(tmp2);
@@ -179,41 +291,44 @@ namespace AbstractGroup {
 
   Element OpenECGroup::Inverse(const Element &a) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     EC_POINT *r = EC_POINT_dup(GetPoint(a), _data->group);
     CHECK_CALL(r);
 
-    CHECK_CALL(EC_POINT_invert(_data->group, r, _data->ctx));
+    CHECK_CALL(EC_POINT_invert(_data->group, r, ctx));
     return NewElement(r);
   }
   
   QByteArray OpenECGroup::ElementToByteArray(const Element &a) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     // Get number of bytes requires to hold point
     const unsigned int nbytes = EC_POINT_point2oct(_data->group, GetPoint(a),
-      POINT_CONVERSION_COMPRESSED, NULL, 0, _data->ctx);
+      POINT_CONVERSION_COMPRESSED, NULL, 0, ctx);
     QByteArray out(nbytes, 0);
 
     CHECK_CALL(EC_POINT_point2oct(_data->group, GetPoint(a),
-      POINT_CONVERSION_COMPRESSED, (unsigned char*)out.data(), out.count(), _data->ctx));
+      POINT_CONVERSION_COMPRESSED, (unsigned char*)out.data(), out.count(), ctx));
     return out;
   }
   
   Element OpenECGroup::ElementFromByteArray(const QByteArray &bytes) const 
   { 
+    BN_CTX *ctx = OpenBnContext::GetContext();
     EC_POINT *point;
 
     CHECK_CALL(_data->group);
-    CHECK_CALL(_data->ctx);
 
     CHECK_CALL(point = EC_POINT_new(_data->group));
     CHECK_CALL(EC_POINT_oct2point(_data->group, point, 
-          (const unsigned char*)bytes.constData(), bytes.count(), _data->ctx));
+          (const unsigned char*)bytes.constData(), bytes.count(), ctx));
     return NewElement(point);
   }
 
   bool OpenECGroup::IsElement(const Element &a) const 
   {
-    return EC_POINT_is_on_curve(_data->group, GetPoint(a), _data->ctx);
+    BN_CTX *ctx = OpenBnContext::GetContext();
+    return EC_POINT_is_on_curve(_data->group, GetPoint(a), ctx);
   }
 
   bool OpenECGroup::IsIdentity(const Element &a) const 
@@ -268,6 +383,7 @@ namespace AbstractGroup {
       
     CHECK_CALL(BN_cmp(r, _p) < 0);
 
+    BN_CTX *ctx = OpenBnContext::GetContext();
     EC_POINT *point = EC_POINT_new(_data->group);
 
     // Shift r left by one byte and then flip the
@@ -276,10 +392,10 @@ namespace AbstractGroup {
     bool success = false;
     for(int i=0; i<(1<<8); i++) {
       // x = rk + i mod p
-      CHECK_CALL(BN_mod_add(r, r, _one, _p, _data->ctx));
+      CHECK_CALL(BN_mod_add(r, r, _one, _p, ctx));
 
-      if(EC_POINT_set_compressed_coordinates_GFp(_data->group, point, r, 1, _data->ctx)
-          && EC_POINT_is_on_curve(_data->group, point, _data->ctx)) {
+      if(EC_POINT_set_compressed_coordinates_GFp(_data->group, point, r, 1, ctx)
+          && EC_POINT_is_on_curve(_data->group, point, ctx)) {
         success = true;
         break;
       } 
@@ -297,9 +413,10 @@ namespace AbstractGroup {
  
   bool OpenECGroup::DecodeBytes(const Element &a, QByteArray &out) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     BIGNUM *x = BN_new();
     BIGNUM *y = BN_new();
-    if(!EC_POINT_get_affine_coordinates_GFp(_data->group, GetPoint(a), x, y, _data->ctx))
+    if(!EC_POINT_get_affine_coordinates_GFp(_data->group, GetPoint(a), x, y, ctx))
       return false;
 
     // shift off padding byte
@@ -331,7 +448,8 @@ namespace AbstractGroup {
 
   bool OpenECGroup::IsProbablyValid() const
   {
-    return EC_GROUP_check(_data->group, _data->ctx);
+    BN_CTX *ctx = OpenBnContext::GetContext();
+    return EC_GROUP_check(_data->group, ctx);
   }
 
   QByteArray OpenECGroup::GetByteArray() const
@@ -356,9 +474,10 @@ namespace AbstractGroup {
 
   void OpenECGroup::GetCoordinates(const Element &a, Integer &x_out, Integer &y_out) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     BIGNUM *x = BN_new();
     BIGNUM *y = BN_new();
-    CHECK_CALL(EC_POINT_get_affine_coordinates_GFp(_data->group, GetPoint(a), x, y, _data->ctx));
+    CHECK_CALL(EC_POINT_get_affine_coordinates_GFp(_data->group, GetPoint(a), x, y, ctx));
 
     char *x_char = BN_bn2hex(x);
     char *y_char = BN_bn2hex(y);
@@ -375,17 +494,18 @@ namespace AbstractGroup {
 
   int OpenECGroup::FastModMul(BIGNUM *r, const BIGNUM *a, const BIGNUM *b) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     BIGNUM *tmp0 = BN_new();
     BIGNUM *tmp1 = BN_new();
 
     // Convert a and b to montgomery rep mod p
-    CHECK_CALL(BN_to_montgomery(tmp0, a, _data->mont, _data->ctx));
-    CHECK_CALL(BN_to_montgomery(tmp1, b, _data->mont, _data->ctx));
+    CHECK_CALL(BN_to_montgomery(tmp0, a, _data->mont, ctx));
+    CHECK_CALL(BN_to_montgomery(tmp1, b, _data->mont, ctx));
 
     // tmp = a*b
-    CHECK_CALL(BN_mod_mul_montgomery(tmp0, tmp0, tmp1, _data->mont, _data->ctx));
+    CHECK_CALL(BN_mod_mul_montgomery(tmp0, tmp0, tmp1, _data->mont, ctx));
 
-    int ret = BN_from_montgomery(r, tmp0, _data->mont, _data->ctx);
+    int ret = BN_from_montgomery(r, tmp0, _data->mont, ctx);
 
     BN_clear_free(tmp0);
     BN_clear_free(tmp1);
@@ -418,6 +538,7 @@ namespace AbstractGroup {
 
   Element OpenECGroup::ElementFromCoordinates(const Integer &x_in, const Integer &y_in) const
   {
+    BN_CTX *ctx = OpenBnContext::GetContext();
     BIGNUM *x = BN_new();
     BIGNUM *y = BN_new();
 
@@ -427,7 +548,7 @@ namespace AbstractGroup {
     EC_POINT *point = EC_POINT_new(_data->group);
 
     CHECK_CALL(EC_POINT_set_affine_coordinates_GFp(_data->group, 
-          point, x, y, _data->ctx));
+          point, x, y, ctx));
 
     BN_clear_free(x);
     BN_clear_free(y);
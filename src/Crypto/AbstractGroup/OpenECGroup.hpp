@@ -97,6 +97,31 @@ namespace AbstractGroup {
       virtual Element CascadeExponentiate(const Element &a1, const Integer &e1,
           const Element &a2, const Integer &e2) const;
 
+      /**
+       * Precompute a windowed table of multiples of the base point.
+       * The generator needs no table of its own, OpenSSL already
+       * keeps one (see EC_GROUP_precompute_mult)
+       * @param base the fixed base
+       */
+      virtual QSharedPointer<FixedBaseTable> PrecomputeBase(const Element &base) const;
+
+      /**
+       * Compute exp * base using a table returned by PrecomputeBase
+       * @param table the precomputed table for base
+       * @param exp exponent
+       */
+      virtual Element ExponentiateFixed(const FixedBaseTable &table,
+          const Integer &exp) const;
+
+      /**
+       * Compute the sum of exps[i] * bases[i] using OpenSSL's
+       * interleaved wNAF multiplication
+       * @param bases the bases
+       * @param exps the exponents, one per base
+       */
+      virtual Element MultiExponentiate(const QList<Element> &bases,
+          const QList<Integer> &exps) const;
+
       /**
        * Compute b such that a+b = O (identity)
        * @param a element to invert
@@ -247,7 +272,7 @@ namespace AbstractGroup {
 
       inline Element NewElement(EC_POINT *e) const 
       {
-        return Element(new OpenECElementData(e, _data->group, _data->ctx)); 
+        return Element(new OpenECElementData(e, _data->group)); 
       }
 
       /**
@@ -264,38 +289,35 @@ namespace AbstractGroup {
       int FastModMul(BIGNUM *r, const BIGNUM *a, const BIGNUM *b) const;
 
       /**
-       * These are members of the class that will change
+       * OpenSSL state owned by the group, read-only once the group is
+       * constructed.  Scratch space comes from the calling thread's
+       * BN_CTX, see OpenBnContext, so the group may be shared by threads.
        */
       class MutableData {
         public:
           MutableData(bool is_nist_curve) :
-            ctx(BN_CTX_new()),
             mont(BN_MONT_CTX_new()),
             group(EC_GROUP_new(
                   is_nist_curve ? EC_GFp_nist_method() : EC_GFp_mont_method())) 
           {
-            CHECK_CALL(ctx);
             CHECK_CALL(mont);
             CHECK_CALL(group);
           }
 
           MutableData(const MutableData &other) :
-            ctx(BN_CTX_new()),
             mont(BN_MONT_CTX_new()),
             group(EC_GROUP_dup(other.group))
           {
-            CHECK_CALL(ctx);
             CHECK_CALL(mont);
             CHECK_CALL(group);
+            CHECK_CALL(BN_MONT_CTX_copy(mont, other.mont));
           }
 
           ~MutableData() {
             EC_GROUP_clear_free(group);
             BN_MONT_CTX_free(mont);
-            BN_CTX_free(ctx);
           }
 
-          BN_CTX *ctx;
           BN_MONT_CTX *mont;
           EC_GROUP *group;
       };
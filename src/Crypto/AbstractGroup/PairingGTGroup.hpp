@@ -34,6 +34,12 @@ namespace AbstractGroup {
        */
       virtual QSharedPointer<AbstractGroup> Copy() const;
 
+      /**
+       * PBC makes no thread-safety guarantees, so each thread should use its
+       * own copy
+       */
+      virtual bool IsThreadSafe() const { return false; }
+
       /**
        * Multiply two points
        * @param a first operand 
@@ -0,0 +1,441 @@
+#include <string.h>
+#include <QPair>
+#include <QtAlgorithms>
+#include <QtEndian>
+
+#include "Blake2bHash.hpp"
+
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define DISSENT_BLAKE2B_AVX2
+#include <immintrin.h>
+#endif
+
+namespace Dissent {
+namespace Crypto {
+namespace {
+  /**
+   * Inputs compressed at once by ComputeHashes
+   */
+  const int LANES = 4;
+
+  const quint64 IV[8] = {
+    Q_UINT64_C(0x6a09e667f3bcc908), Q_UINT64_C(0xbb67ae8584caa73b),
+    Q_UINT64_C(0x3c6ef372fe94f82b), Q_UINT64_C(0xa54ff53a5f1d36f1),
+    Q_UINT64_C(0x510e527fade682d1), Q_UINT64_C(0x9b05688c2b3e6c1f),
+    Q_UINT64_C(0x1f83d9abfb41bd6b), Q_UINT64_C(0x5be0cd19137e2179)
+  };
+
+  const uchar SIGMA[12][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+  };
+
+  inline quint64 Load64(const uchar *src)
+  {
+    return qFromLittleEndian<quint64>(src);
+  }
+
+  inline void Store64(uchar *dst, quint64 value)
+  {
+    qToLittleEndian<quint64>(value, dst);
+  }
+
+  inline quint64 Rotr(quint64 value, int bits)
+  {
+    return (value >> bits) | (value << (64 - bits));
+  }
+
+  inline void Mix(quint64 *v, int a, int b, int c, int d, quint64 x, quint64 y)
+  {
+    v[a] = v[a] + v[b] + x;
+    v[d] = Rotr(v[d] ^ v[a], 32);
+    v[c] = v[c] + v[d];
+    v[b] = Rotr(v[b] ^ v[c], 24);
+    v[a] = v[a] + v[b] + y;
+    v[d] = Rotr(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = Rotr(v[b] ^ v[c], 63);
+  }
+
+  /**
+   * Compresses the message words m into the state h
+   * @param h the chaining state
+   * @param m the block as little endian words
+   * @param counter bytes hashed so far, including this block
+   * @param last whether this is the final block
+   */
+  void Compress(quint64 *h, const quint64 *m, quint64 counter, bool last)
+  {
+    quint64 v[16];
+    for(int idx = 0; idx < 8; idx++) {
+      v[idx] = h[idx];
+      v[idx + 8] = IV[idx];
+    }
+    v[12] ^= counter;
+    if(last) {
+      v[14] = ~v[14];
+    }
+
+    for(int round = 0; round < 12; round++) {
+      const uchar *s = SIGMA[round];
+      Mix(v, 0, 4,  8, 12, m[s[0]], m[s[1]]);
+      Mix(v, 1, 5,  9, 13, m[s[2]], m[s[3]]);
+      Mix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+      Mix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+      Mix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+      Mix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+      Mix(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+      Mix(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for(int idx = 0; idx < 8; idx++) {
+      h[idx] ^= v[idx] ^ v[idx + 8];
+    }
+  }
+
+  void CompressBlock(quint64 *h, const uchar *block, quint64 counter,
+      bool last)
+  {
+    quint64 m[16];
+    for(int idx = 0; idx < 16; idx++) {
+      m[idx] = Load64(block + 8 * idx);
+    }
+    Compress(h, m, counter, last);
+  }
+
+  void InitState(quint64 *h, int digest_size)
+  {
+    for(int idx = 0; idx < 8; idx++) {
+      h[idx] = IV[idx];
+    }
+    h[0] ^= Q_UINT64_C(0x01010000) ^ quint64(digest_size);
+  }
+
+  /**
+   * Compresses one block for each of LANES inputs, words are interleaved
+   * by lane, i.e., h[word * LANES + lane]
+   */
+  typedef void (*Compress4Kernel)(quint64 *h, const quint64 *m,
+      const quint64 *counter, bool last);
+
+  void Compress4Scalar(quint64 *h, const quint64 *m, const quint64 *counter,
+      bool last)
+  {
+    for(int lane = 0; lane < LANES; lane++) {
+      quint64 lh[8];
+      quint64 lm[16];
+      for(int idx = 0; idx < 8; idx++) {
+        lh[idx] = h[idx * LANES + lane];
+      }
+      for(int idx = 0; idx < 16; idx++) {
+        lm[idx] = m[idx * LANES + lane];
+      }
+
+      Compress(lh, lm, counter[lane], last);
+
+      for(int idx = 0; idx < 8; idx++) {
+        h[idx * LANES + lane] = lh[idx];
+      }
+    }
+  }
+
+#ifdef DISSENT_BLAKE2B_AVX2
+  /**
+   * Rotations by whole bytes are shuffles, the rest are shifts
+   */
+  __attribute__((target("avx2")))
+  inline void Mix4(__m256i *v, int a, int b, int c, int d, __m256i x,
+      __m256i y, __m256i rotr24, __m256i rotr16)
+  {
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), x);
+    v[d] = _mm256_shuffle_epi32(_mm256_xor_si256(v[d], v[a]),
+        _MM_SHUFFLE(2, 3, 0, 1));
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = _mm256_shuffle_epi8(_mm256_xor_si256(v[b], v[c]), rotr24);
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), y);
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rotr16);
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    __m256i t = _mm256_xor_si256(v[b], v[c]);
+    v[b] = _mm256_or_si256(_mm256_srli_epi64(t, 63), _mm256_add_epi64(t, t));
+  }
+
+  __attribute__((target("avx2")))
+  void Compress4Avx2(quint64 *h, const quint64 *m, const quint64 *counter,
+      bool last)
+  {
+    const __m256i rotr24 = _mm256_setr_epi8(
+        3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+        3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+    const __m256i rotr16 = _mm256_setr_epi8(
+        2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+        2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+
+    __m256i v[16];
+    __m256i w[16];
+    for(int idx = 0; idx < 8; idx++) {
+      v[idx] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+            h + idx * LANES));
+      v[idx + 8] = _mm256_set1_epi64x(IV[idx]);
+    }
+    for(int idx = 0; idx < 16; idx++) {
+      w[idx] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+            m + idx * LANES));
+    }
+
+    v[12] = _mm256_xor_si256(v[12],
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counter)));
+    if(last) {
+      v[14] = _mm256_xor_si256(v[14], _mm256_set1_epi64x(-1));
+    }
+
+    for(int round = 0; round < 12; round++) {
+      const uchar *s = SIGMA[round];
+      Mix4(v, 0, 4,  8, 12, w[s[0]], w[s[1]],
+          rotr24, rotr16);
+      Mix4(v, 1, 5,  9, 13, w[s[2]], w[s[3]],
+          rotr24, rotr16);
+      Mix4(v, 2, 6, 10, 14, w[s[4]], w[s[5]],
+          rotr24, rotr16);
+      Mix4(v, 3, 7, 11, 15, w[s[6]], w[s[7]],
+          rotr24, rotr16);
+      Mix4(v, 0, 5, 10, 15, w[s[8]], w[s[9]],
+          rotr24, rotr16);
+      Mix4(v, 1, 6, 11, 12, w[s[10]], w[s[11]],
+          rotr24, rotr16);
+      Mix4(v, 2, 7,  8, 13, w[s[12]], w[s[13]],
+          rotr24, rotr16);
+      Mix4(v, 3, 4,  9, 14, w[s[14]], w[s[15]],
+          rotr24, rotr16);
+    }
+
+    for(int idx = 0; idx < 8; idx++) {
+      __m256i *dst = reinterpret_cast<__m256i *>(h + idx * LANES);
+      __m256i hv = _mm256_loadu_si256(dst);
+      hv = _mm256_xor_si256(hv, _mm256_xor_si256(v[idx], v[idx + 8]));
+      _mm256_storeu_si256(dst, hv);
+    }
+  }
+#endif
+
+  /**
+   * Chooses the widest batch kernel supported by the running processor
+   */
+  class KernelSelection {
+    public:
+      KernelSelection()
+      {
+#ifdef DISSENT_BLAKE2B_AVX2
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) {
+          name = "avx2";
+          kernel = &Compress4Avx2;
+          return;
+        }
+#endif
+        name = "scalar";
+        kernel = &Compress4Scalar;
+      }
+
+      const char *name;
+      Compress4Kernel kernel;
+  };
+
+  inline const KernelSelection &GetSelection()
+  {
+    static KernelSelection selection;
+    return selection;
+  }
+
+  inline int BlockCount(const QByteArray &data)
+  {
+    return data.isEmpty() ? 1 :
+      (data.size() + Blake2bHash::BlockSize - 1) / Blake2bHash::BlockSize;
+  }
+
+  QByteArray Digest(const quint64 *h, int stride, int digest_size)
+  {
+    uchar bytes[64];
+    for(int idx = 0; idx < 8; idx++) {
+      Store64(bytes + 8 * idx, h[idx * stride]);
+    }
+    return QByteArray(reinterpret_cast<const char *>(bytes), digest_size);
+  }
+
+  /**
+   * Hashes a single input with its own state
+   */
+  QByteArray HashSingle(const QByteArray &data, int digest_size)
+  {
+    quint64 h[8];
+    InitState(h, digest_size);
+
+    int blocks = BlockCount(data);
+    uchar padded[Blake2bHash::BlockSize];
+    for(int block = 0; block < blocks; block++) {
+      int offset = block * Blake2bHash::BlockSize;
+      int length = qMin(int(Blake2bHash::BlockSize), data.size() - offset);
+      const uchar *src = reinterpret_cast<const uchar *>(
+          data.constData() + offset);
+      if(length < Blake2bHash::BlockSize) {
+        memset(padded, 0, Blake2bHash::BlockSize);
+        memcpy(padded, src, length);
+        src = padded;
+      }
+      CompressBlock(h, src, offset + length, block == blocks - 1);
+    }
+
+    return Digest(h, 1, digest_size);
+  }
+
+  /**
+   * Hashes LANES inputs with the same number of blocks in lock step
+   */
+  void HashLanes(const QByteArray **inputs, int blocks, int digest_size,
+      QByteArray **outputs)
+  {
+    Compress4Kernel kernel = GetSelection().kernel;
+
+    quint64 h[8 * LANES];
+    quint64 m[16 * LANES];
+    quint64 counter[LANES];
+
+    quint64 init[8];
+    InitState(init, digest_size);
+    for(int idx = 0; idx < 8; idx++) {
+      for(int lane = 0; lane < LANES; lane++) {
+        h[idx * LANES + lane] = init[idx];
+      }
+    }
+
+    uchar padded[Blake2bHash::BlockSize];
+    for(int block = 0; block < blocks; block++) {
+      int offset = block * Blake2bHash::BlockSize;
+      for(int lane = 0; lane < LANES; lane++) {
+        const QByteArray &input = *inputs[lane];
+        int length = qMin(int(Blake2bHash::BlockSize), input.size() - offset);
+        const uchar *src = reinterpret_cast<const uchar *>(
+            input.constData() + offset);
+        if(length < Blake2bHash::BlockSize) {
+          memset(padded, 0, Blake2bHash::BlockSize);
+          memcpy(padded, src, length);
+          src = padded;
+        }
+
+        for(int idx = 0; idx < 16; idx++) {
+          m[idx * LANES + lane] = Load64(src + 8 * idx);
+        }
+        counter[lane] = offset + length;
+      }
+
+      kernel(h, m, counter, block == blocks - 1);
+    }
+
+    for(int lane = 0; lane < LANES; lane++) {
+      *outputs[lane] = Digest(h + lane, LANES, digest_size);
+    }
+  }
+}
+
+  Blake2bHash::Blake2bHash(int digest_size) :
+    _digest_size(qBound(1, digest_size, 64))
+  {
+    Restart();
+  }
+
+  void Blake2bHash::Restart()
+  {
+    InitState(_state, _digest_size);
+    _counter = 0;
+    _buffer.clear();
+  }
+
+  void Blake2bHash::Update(const QByteArray &data)
+  {
+    _buffer.append(data);
+
+    // Hold back at least one byte, the final block is compressed last
+    int offset = 0;
+    const uchar *src = reinterpret_cast<const uchar *>(_buffer.constData());
+    for(; _buffer.size() - offset > BlockSize; offset += BlockSize) {
+      _counter += BlockSize;
+      CompressBlock(_state, src + offset, _counter, false);
+    }
+    _buffer.remove(0, offset);
+  }
+
+  QByteArray Blake2bHash::ComputeHash()
+  {
+    uchar block[BlockSize];
+    memset(block, 0, BlockSize);
+    memcpy(block, _buffer.constData(), _buffer.size());
+    _counter += _buffer.size();
+    CompressBlock(_state, block, _counter, true);
+
+    QByteArray hash = Digest(_state, 1, _digest_size);
+    Restart();
+    return hash;
+  }
+
+  QByteArray Blake2bHash::ComputeHash(const QByteArray &data)
+  {
+    Restart();
+    Update(data);
+    return ComputeHash();
+  }
+
+  QVector<QByteArray> Blake2bHash::ComputeHashes(
+      const QVector<QByteArray> &data)
+  {
+    QVector<QByteArray> hashes(data.count());
+
+    // Lanes advance in lock step, so inputs are batched by block count
+    QVector<QPair<int, int> > order(data.count());
+    for(int idx = 0; idx < data.count(); idx++) {
+      order[idx] = QPair<int, int>(BlockCount(data[idx]), idx);
+    }
+    qSort(order);
+
+    int start = 0;
+    while(start < order.count()) {
+      int blocks = order[start].first;
+      int end = start;
+      while(end < order.count() && order[end].first == blocks) {
+        end++;
+      }
+
+      for(; start + LANES <= end; start += LANES) {
+        const QByteArray *inputs[LANES];
+        QByteArray *outputs[LANES];
+        for(int lane = 0; lane < LANES; lane++) {
+          inputs[lane] = &data[order[start + lane].second];
+          outputs[lane] = &hashes[order[start + lane].second];
+        }
+        HashLanes(inputs, blocks, _digest_size, outputs);
+      }
+
+      for(; start < end; start++) {
+        int idx = order[start].second;
+        hashes[idx] = HashSingle(data[idx], _digest_size);
+      }
+    }
+
+    return hashes;
+  }
+
+  QString Blake2bHash::BatchKernelName()
+  {
+    return QString(GetSelection().name);
+  }
+}
+}
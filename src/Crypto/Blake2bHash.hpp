@@ -0,0 +1,75 @@
+#ifndef DISSENT_CRYPTO_BLAKE2B_HASH_H_GUARD
+#define DISSENT_CRYPTO_BLAKE2B_HASH_H_GUARD
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "Hash.hpp"
+
+namespace Dissent {
+namespace Crypto {
+  /**
+   * BLAKE2b (RFC 7693), unkeyed. ComputeHashes compresses four inputs at a
+   * time, one per 64-bit lane of an AVX2 register when the processor has
+   * it, so many short inputs, such as per client seeds, cost little more
+   * than one.
+   */
+  class Blake2bHash : public Hash {
+    public:
+      /**
+       * Output size in bytes unless told otherwise, as SHA-256
+       */
+      static const int DefaultDigestSize = 32;
+
+      /**
+       * Bytes compressed at a time
+       */
+      static const int BlockSize = 128;
+
+      /**
+       * Constructor
+       * @param digest_size output size in bytes, between 1 and 64
+       */
+      explicit Blake2bHash(int digest_size = DefaultDigestSize);
+
+      /**
+       * Destructor
+       */
+      virtual ~Blake2bHash() {}
+
+      inline virtual int GetDigestSize() { return _digest_size; }
+      inline virtual int GetBlockSize() const { return BlockSize; }
+      virtual void Restart();
+      virtual void Update(const QByteArray &data);
+      virtual QByteArray ComputeHash();
+      virtual QByteArray ComputeHash(const QByteArray &data);
+
+      /**
+       * Calculates the hash of each input independently, unlike other
+       * hashes any input given to Update is kept rather than restarted
+       * @param data the inputs to hash
+       */
+      virtual QVector<QByteArray> ComputeHashes(const QVector<QByteArray> &data);
+
+      /**
+       * Returns the name of the kernel used by ComputeHashes, i.e.,
+       * "avx2" or "scalar"
+       */
+      static QString BatchKernelName();
+
+    private:
+      int _digest_size;
+      quint64 _state[8];
+      quint64 _counter;
+
+      /**
+       * Input not yet compressed, the last block is held back until
+       * ComputeHash as it is compressed differently
+       */
+      QByteArray _buffer;
+  };
+}
+}
+
+#endif
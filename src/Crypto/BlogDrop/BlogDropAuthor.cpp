@@ -33,7 +33,7 @@ namespace BlogDrop {
     if(data.count()) data = data.mid(can_fit);
 
     QSharedPointer<ClientCiphertext> c = CiphertextFactory::CreateClientCiphertext(
-        GetParameters(), GetServerKeys(), GetAuthorKey());
+        GetParameters(), GetServerKeys(), GetAuthorKey(), GetPool());
     c->SetAuthorProof(GetPhase(), GetClientKey(), _author_priv, m);
     out = c->GetByteArray();
 
@@ -15,13 +15,15 @@ namespace BlogDrop {
     _params(params),
     _client_priv(client_priv),
     _server_pks(server_pks),
-    _author_pub(author_pub)
+    _author_pub(author_pub),
+    _pool(new ClientCiphertextPool(params, client_priv, server_pks, author_pub))
   {
   }
 
   QByteArray BlogDropClient::GenerateCoverCiphertext() 
   {
-    QSharedPointer<ClientCiphertext> c = CiphertextFactory::CreateClientCiphertext(_params, _server_pks, _author_pub);
+    QSharedPointer<ClientCiphertext> c = CiphertextFactory::CreateClientCiphertext(
+        _params, _server_pks, _author_pub, _pool);
     c->SetProof(GetPhase(), _client_priv);
     return c->GetByteArray();
   }
@@ -3,6 +3,7 @@
 
 #include <QSharedPointer>
 
+#include "ClientCiphertextPool.hpp"
 #include "Parameters.hpp"
 #include "Plaintext.hpp"
 #include "PrivateKey.hpp"
@@ -38,6 +39,17 @@ namespace BlogDrop {
        */
       QByteArray GenerateCoverCiphertext();
 
+      /**
+       * Precompute values for the ciphertext of the current phase, call
+       * once the number of elements for the phase is known
+       */
+      inline void Precompute() { _pool->StartFill(_phase); }
+
+      /**
+       * Returns the pool of precomputed ciphertext values
+       */
+      inline QSharedPointer<ClientCiphertextPool> GetPool() const { return _pool; }
+
       inline QSharedPointer<Parameters> GetParameters() const { return _params; }
 
       inline void NextPhase() { _phase++; }
@@ -57,6 +69,7 @@ namespace BlogDrop {
       QSharedPointer<const PrivateKey> _client_priv;
       QSharedPointer<const PublicKeySet> _server_pks;
       QSharedPointer<const PublicKey> _author_pub;
+      QSharedPointer<ClientCiphertextPool> _pool;
   };
 }
 }
@@ -19,6 +19,8 @@ namespace BlogDrop {
 
     public:
 
+      typedef Dissent::Crypto::AbstractGroup::Element Element;
+
       /**
        * Constructor: Initialize a BlogDrop client bin
        * @param params Group parameters
@@ -94,7 +96,8 @@ namespace BlogDrop {
           const QList<QSharedPointer<const PublicKey> > &pubs);
 
       /**
-       * Reveal plaintext for a BlogDrop bin
+       * Reveal plaintext for a BlogDrop bin, combining the ciphertexts
+       * in parallel when multithreaded
        * @param out the returned plaintext
        */
       bool RevealPlaintext(QByteArray &out) const; 
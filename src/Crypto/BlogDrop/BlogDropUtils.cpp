@@ -78,8 +78,8 @@ namespace BlogDrop {
 
     // e(server_pks, tau)
     const Integer exp = GetPhaseHash(params, author_pk, phase, element_idx);
-    const Element tau = params->GetKeyGroup()->Exponentiate(
-        params->GetKeyGroup()->GetGenerator(), exp);
+    const Element tau = params->GetKeyGroup()->GetFixedBase(
+        params->GetKeyGroup()->GetGenerator()).Exponentiate(exp);
 
     Element base = params->ApplyPairing(prod_pks->GetElement(), tau);
     //qDebug() << "Base" << phase << element_idx << params->GetKeyGroup()->ElementToByteArray(prod_pks->GetElement()).toHex();
@@ -12,8 +12,10 @@ namespace BlogDrop {
 
   ChangingGenClientCiphertext::ChangingGenClientCiphertext(const QSharedPointer<const Parameters> params, 
       const QSharedPointer<const PublicKeySet> server_pks,
-      const QSharedPointer<const PublicKey> author_pub) :
-    ClientCiphertext(params, server_pks, author_pub, params->GetNElements())
+      const QSharedPointer<const PublicKey> author_pub,
+      const QSharedPointer<ClientCiphertextPool> pool) :
+    ClientCiphertext(params, server_pks, author_pub, params->GetNElements()),
+    _pool(pool)
   {
   }
 
@@ -47,7 +49,20 @@ namespace BlogDrop {
   void ChangingGenClientCiphertext::InitCiphertext(int phase, 
       const QSharedPointer<const PrivateKey> client_priv) 
   {
-    for(int i=0; i<GetNElements(); i++) { 
+    QList<ClientCiphertextPool::GeneratorElement> gens;
+    if(_pool) {
+      gens = _pool->TakeGeneratorElements(_params, phase, client_priv,
+          GetNElements());
+      _pool->AddMisses(GetNElements() - gens.count());
+    }
+
+    // Pooled generators also serve the proof in InitializeLists
+    for(int i=0; i<gens.count(); i++) {
+      _cache[i] = gens[i].generator;
+      _elements.append(gens[i].element);
+    }
+
+    for(int i=gens.count(); i<GetNElements(); i++) { 
       Element base = ComputeAndCacheGenerator(_cache, _server_pks, GetAuthorKey(), phase, i); 
       _elements.append(_params->GetMessageGroup()->Exponentiate(base, client_priv->GetInteger())); 
     }
@@ -94,7 +109,7 @@ namespace BlogDrop {
     QList<Element> ts;
 
     Integer v_auth = _params->GetKeyGroup()->RandomExponent();
-    ts.append(_params->GetKeyGroup()->Exponentiate(gs[0], v_auth));
+    ts.append(_params->GetKeyGroup()->GetFixedBase(gs[0]).Exponentiate(v_auth));
 
     ts.append(_params->GetKeyGroup()->CascadeExponentiate(ys[1], w, gs[1], v));
     for(int i=0; i<GetNElements(); i++) { 
@@ -148,7 +163,7 @@ namespace BlogDrop {
     Integer v_auth = _params->GetKeyGroup()->RandomExponent();
     ts.append(_params->GetKeyGroup()->CascadeExponentiate(ys[0], w, gs[0], v_auth));
 
-    ts.append(_params->GetKeyGroup()->Exponentiate(gs[1], v));
+    ts.append(_params->GetKeyGroup()->GetFixedBase(gs[1]).Exponentiate(v));
     for(int i=0; i<GetNElements(); i++) {
       ts.append(_params->GetMessageGroup()->Exponentiate(gs[i+2], v));
     }
@@ -5,6 +5,7 @@
 #include "Crypto/AbstractGroup/Element.hpp"
 
 #include "ClientCiphertext.hpp"
+#include "ClientCiphertextPool.hpp"
 
 namespace Dissent {
 namespace Crypto {
@@ -38,10 +39,13 @@ namespace BlogDrop {
        * @param params Group parameters
        * @param server_pks Server public keys
        * @param author_pub author public key
+       * @param pool precomputed generators and elements to draw from first
        */
       explicit ChangingGenClientCiphertext(const QSharedPointer<const Parameters> params, 
           const QSharedPointer<const PublicKeySet> server_pks,
-          const QSharedPointer<const PublicKey> author_pub);
+          const QSharedPointer<const PublicKey> author_pub,
+          const QSharedPointer<ClientCiphertextPool> pool = 
+            QSharedPointer<ClientCiphertextPool>());
 
       /**
        * Constructor: Initialize a ciphertext from a serialized bytearray
@@ -122,6 +126,7 @@ namespace BlogDrop {
       void InitCiphertext(int phase, const QSharedPointer<const PrivateKey> priv);
 
       QHash<int, Element> _cache;
+      QSharedPointer<ClientCiphertextPool> _pool;
       Integer _challenge_1;
       Integer _challenge_2;
       Integer _response_1;
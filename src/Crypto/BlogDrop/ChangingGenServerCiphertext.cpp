@@ -62,7 +62,7 @@ namespace BlogDrop {
 
 
     // t0 = g0^v
-    ts.append(_params->GetKeyGroup()->Exponentiate(gs[0], v));
+    ts.append(_params->GetKeyGroup()->GetFixedBase(gs[0]).Exponentiate(v));
 
     for(int i=0; i<_n_elms; i++) {
       // t(i) = g(i)^-v
@@ -112,13 +112,10 @@ namespace BlogDrop {
     ts.append(_params->GetKeyGroup()->CascadeExponentiate(gs[0], _response, ys[0], _challenge));
 
     for(int i=0; i<_n_elms; i++) {
-      // t(i) = g(i)^-r * y(i)^c
-      Element ti = _params->GetMessageGroup()->Exponentiate(gs[i+1], _response);
-      ti = _params->GetMessageGroup()->Inverse(ti);
-
-      Element ti_tmp = _params->GetMessageGroup()->Exponentiate(ys[i+1], _challenge);
-      ti = _params->GetMessageGroup()->Multiply(ti, ti_tmp);
-      ts.append(ti); 
+      // t(i) = (g(i)^-1)^r * y(i)^c
+      const Element g_inv = _params->GetMessageGroup()->Inverse(gs[i+1]);
+      ts.append(_params->GetMessageGroup()->CascadeExponentiate(g_inv, _response,
+            ys[i+1], _challenge));
     }
 
     Integer tmp = BlogDropUtils::Commit(_params, gs, ys, ts);
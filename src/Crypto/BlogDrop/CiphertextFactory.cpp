@@ -17,12 +17,22 @@ namespace BlogDrop {
       const QSharedPointer<const Parameters> params, 
       const QSharedPointer<const PublicKeySet> server_pks,
       const QSharedPointer<const PublicKey> author_pub)
+  {
+    return CreateClientCiphertext(params, server_pks, author_pub,
+        QSharedPointer<ClientCiphertextPool>());
+  }
+
+  QSharedPointer<ClientCiphertext> CiphertextFactory::CreateClientCiphertext(
+      const QSharedPointer<const Parameters> params, 
+      const QSharedPointer<const PublicKeySet> server_pks,
+      const QSharedPointer<const PublicKey> author_pub,
+      const QSharedPointer<ClientCiphertextPool> pool)
   {
     QSharedPointer<ClientCiphertext> c;
     switch(params->GetProofType()) {
       case Parameters::ProofType_ElGamal:
         c = QSharedPointer<ClientCiphertext>(new ElGamalClientCiphertext(
-              params, server_pks, author_pub));
+              params, server_pks, author_pub, pool));
         break;
 
       case Parameters::ProofType_Pairing:
@@ -32,7 +42,7 @@ namespace BlogDrop {
 
       case Parameters::ProofType_HashingGenerator:
         c = QSharedPointer<ClientCiphertext>(new HashingGenClientCiphertext(
-              params, server_pks, author_pub));
+              params, server_pks, author_pub, pool));
         break;
 
       case Parameters::ProofType_Xor:
@@ -2,6 +2,7 @@
 #define DISSENT_CRYPTO_BLOGDROP_CIPHERTEXT_FACTORY_H_GUARD
 
 #include "ClientCiphertext.hpp"
+#include "ClientCiphertextPool.hpp"
 #include "Parameters.hpp"
 #include "PrivateKey.hpp"
 #include "PublicKey.hpp"
@@ -38,6 +39,20 @@ namespace BlogDrop {
           const QSharedPointer<const PublicKeySet> server_pks,
           const QSharedPointer<const PublicKey> author_pub);
 
+      /**
+       * Create a new client cover ciphertext, drawing precomputed values
+       * from a pool when the proof type supports it
+       * @param params BlogDrop parameters
+       * @param server_pks server public keys
+       * @param author_pub author public key
+       * @param pool the client's precomputation pool
+       */
+      static QSharedPointer<ClientCiphertext> CreateClientCiphertext(
+          const QSharedPointer<const Parameters> params, 
+          const QSharedPointer<const PublicKeySet> server_pks,
+          const QSharedPointer<const PublicKey> author_pub,
+          const QSharedPointer<ClientCiphertextPool> pool);
+
       /**
        * Unserialize a client ciphertext
        * @param params BlogDrop parameters
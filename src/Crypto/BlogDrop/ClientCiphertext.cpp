@@ -1,5 +1,6 @@
 
 #include <QtCore>
+#include <QtConcurrentMap>
 
 #include "Crypto/CryptoFactory.hpp"
 
@@ -11,6 +12,55 @@ namespace Dissent {
 namespace Crypto {
 namespace BlogDrop {
 
+namespace {
+  /**
+   * A run of ciphertexts verified by one worker.  Either the parameters
+   * and keys are shared with the caller or the chunk has its own copy of
+   * the parameters and rebuilds the keys from their serialized form.
+   */
+  struct VerifyChunk {
+    QSharedPointer<const Parameters> params;
+    QSharedPointer<const PublicKeySet> server_pk_set;
+    QSharedPointer<const PublicKey> author_pk;
+    QList<QSharedPointer<const PublicKey> > pubs;
+
+    QByteArray server_pk_set_bytes;
+    QByteArray author_pk_bytes;
+    QList<QByteArray> pub_bytes;
+
+    int phase;
+    QList<QByteArray> ciphertexts;
+
+    /* list[idx] = parsed ciphertext or null if its proof failed */
+    QList<QSharedPointer<const ClientCiphertext> > verified;
+  };
+
+  void VerifyChunkProofs(VerifyChunk &chunk)
+  {
+    if(!chunk.server_pk_set) {
+      chunk.server_pk_set = QSharedPointer<const PublicKeySet>(
+          new PublicKeySet(chunk.params, chunk.server_pk_set_bytes));
+      chunk.author_pk = QSharedPointer<const PublicKey>(
+          new PublicKey(chunk.params, chunk.author_pk_bytes));
+      foreach(const QByteArray &pub, chunk.pub_bytes) {
+        chunk.pubs.append(QSharedPointer<const PublicKey>(
+              new PublicKey(chunk.params, pub)));
+      }
+    }
+
+    for(int idx = 0; idx < chunk.ciphertexts.count(); idx++) {
+      QSharedPointer<const ClientCiphertext> c = CiphertextFactory::CreateClientCiphertext(
+          chunk.params, chunk.server_pk_set, chunk.author_pk, chunk.ciphertexts[idx]);
+
+      if(c->VerifyProof(chunk.phase, chunk.pubs[idx])) {
+        chunk.verified.append(c);
+      } else {
+        chunk.verified.append(QSharedPointer<const ClientCiphertext>());
+      }
+    }
+  }
+}
+
   ClientCiphertext::ClientCiphertext(const QSharedPointer<const Parameters> params, 
       const QSharedPointer<const PublicKeySet> server_pks,
       const QSharedPointer<const PublicKey> author_pub,
@@ -53,29 +103,52 @@ namespace BlogDrop {
       }
 
     } else if(tt == CryptoFactory::MultiThreaded) {
-      QList<QSharedPointer<MapData> > ms;
-
-      // Unpack each ciphertext copying parameters to
-      // avoid shared data. Each thread must have its
-      // own Parameters object.
-      for(int client_idx=0; client_idx<c.count(); client_idx++) {
-        QSharedPointer<MapData> m(new MapData());
-        m->params = new Parameters(*params);
-        m->server_pk_set = server_pk_set->GetByteArray();
-        m->author_pk = author_pk->GetByteArray();
-        m->client_pk = pubs[client_idx]->GetByteArray();
-        m->ciphertext = c[client_idx];
-        m->phase = phase;
-        ms.append(m);
+      QList<VerifyChunk> chunks;
+      int workers = qMax(1, qMin(QThread::idealThreadCount(), c.count()));
+      int per_chunk = c.count() / workers + (c.count() % workers ? 1 : 0);
+
+      // Thread-safe parameters and keys are shared by every worker, others
+      // are rebuilt once per chunk from a single serialization
+      const bool shared = params->IsThreadSafe();
+      QByteArray server_pk_set_bytes, author_pk_bytes;
+      if(!shared) {
+        server_pk_set_bytes = server_pk_set->GetByteArray();
+        author_pk_bytes = author_pk->GetByteArray();
       }
 
-      QList<bool> valid_list = QtConcurrent::blockingMapped(ms, VerifyOnce);
+      for(int start = 0; start < c.count(); start += per_chunk) {
+        VerifyChunk chunk;
+        chunk.phase = phase;
+        chunk.ciphertexts = c.mid(start, per_chunk);
+
+        if(shared) {
+          chunk.params = params;
+          chunk.server_pk_set = server_pk_set;
+          chunk.author_pk = author_pk;
+          chunk.pubs = pubs.mid(start, per_chunk);
+        } else {
+          chunk.params = QSharedPointer<const Parameters>(new Parameters(*params));
+          chunk.server_pk_set_bytes = server_pk_set_bytes;
+          chunk.author_pk_bytes = author_pk_bytes;
+          for(int idx = start; idx < qMin(start + per_chunk, c.count()); idx++) {
+            chunk.pub_bytes.append(pubs[idx]->GetByteArray());
+          }
+        }
+
+        chunks.append(chunk);
+      }
 
-      for(int client_idx=0; client_idx<valid_list.count(); client_idx++) {
-        if(valid_list[client_idx]) {
-          c_out.append(CiphertextFactory::CreateClientCiphertext(
-                  params, server_pk_set, author_pk, c[client_idx]));
-          pubs_out.append(pubs[client_idx]);
+      QtConcurrent::blockingMap(chunks, VerifyChunkProofs);
+
+      // Keep the ciphertexts parsed by the workers
+      int client_idx = 0;
+      foreach(const VerifyChunk &chunk, chunks) {
+        foreach(const QSharedPointer<const ClientCiphertext> &ctext, chunk.verified) {
+          if(ctext) {
+            c_out.append(ctext);
+            pubs_out.append(pubs[client_idx]);
+          }
+          client_idx++;
         }
       }
 
@@ -84,19 +157,6 @@ namespace BlogDrop {
     }
   }
 
-  bool ClientCiphertext::VerifyOnce(QSharedPointer<MapData> m)
-  {
-    QSharedPointer<const Parameters> params(m->params);
-    QSharedPointer<const PublicKeySet> server_pk_set(new PublicKeySet(params, m->server_pk_set));
-    QSharedPointer<const PublicKey> author_pk(new PublicKey(params, m->author_pk));
-    QSharedPointer<const PublicKey> client_pk(new PublicKey(params, m->client_pk));
-
-    QSharedPointer<const ClientCiphertext> c = CiphertextFactory::CreateClientCiphertext(params, server_pk_set,
-        author_pk, m->ciphertext);
-
-    return c->VerifyProof(m->phase, client_pk);
-  }
-
 }
 }
 }
@@ -24,16 +24,6 @@ namespace BlogDrop {
 
       typedef Dissent::Crypto::AbstractGroup::Element Element;
 
-      class MapData {
-        public: 
-          Parameters *params;
-          QByteArray server_pk_set;
-          QByteArray author_pk;
-          QByteArray client_pk;
-          QByteArray ciphertext;
-          int phase;
-      }; 
-
       /**
        * Constructor: Initialize a ciphertext with a fresh
        * one-time public key
@@ -86,7 +76,9 @@ namespace BlogDrop {
 
       /**
        * Verify a set of proofs. Uses threading if available, so this might
-       * be much faster than verifying each proof in turn
+       * be much faster than verifying each proof in turn.  Each ciphertext
+       * is parsed once and the parsed ciphertexts with valid proofs are
+       * returned in c_out.
        */
       static void VerifyProofs(
           const QSharedPointer<const Parameters> params,
@@ -131,11 +123,6 @@ namespace BlogDrop {
       QSharedPointer<const PublicKeySet> _server_pks;
       QSharedPointer<const PublicKey> _author_pub;
       const int _n_elms;
-
-    private:
-
-      static bool VerifyOnce(QSharedPointer<MapData> m);
-
   };
 
 }
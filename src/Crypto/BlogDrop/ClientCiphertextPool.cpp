@@ -0,0 +1,322 @@
+#include <QAtomicInt>
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+#include "Crypto/CryptoFactory.hpp"
+#include "Utils/Metrics.hpp"
+
+#include "BlogDropUtils.hpp"
+#include "ClientCiphertextPool.hpp"
+
+namespace Dissent {
+namespace Crypto {
+namespace BlogDrop {
+
+namespace {
+  QAtomicInt default_max_depth(ClientCiphertextPool::DEFAULT_MAX_DEPTH);
+  QAtomicInt default_max_memory(ClientCiphertextPool::DEFAULT_MAX_MEMORY);
+
+  void CountHits(int count)
+  {
+    static const Utils::Metrics::Counter hits = Utils::Metrics::GetCounter(
+        "dissent_blogdrop_pool_elements_total",
+        "BlogDrop client ciphertext elements by whether they were pooled",
+        Utils::Metrics::Label("result", "hit"));
+    hits.Add(count);
+  }
+
+  void CountMisses(int count)
+  {
+    static const Utils::Metrics::Counter misses = Utils::Metrics::GetCounter(
+        "dissent_blogdrop_pool_elements_total",
+        "BlogDrop client ciphertext elements by whether they were pooled",
+        Utils::Metrics::Label("result", "miss"));
+    misses.Add(count);
+  }
+
+  bool IsPooled(const QSharedPointer<const Parameters> &params)
+  {
+    return params->GetProofType() == Parameters::ProofType_ElGamal ||
+      params->GetProofType() == Parameters::ProofType_HashingGenerator;
+  }
+
+  /**
+   * An estimate of the memory held by one pooled element: the serialized
+   * size of two elements and an exponent
+   */
+  int EntryBytes(const QSharedPointer<const Parameters> &params)
+  {
+    const QSharedPointer<const Crypto::AbstractGroup::AbstractGroup> group =
+      params->GetMessageGroup();
+    return 2 * group->ElementToByteArray(group->GetGenerator()).count() +
+      params->GetKeyGroup()->GetOrder().GetByteCount();
+  }
+}
+
+  ClientCiphertextPool::ClientCiphertextPool(const QSharedPointer<const Parameters> params,
+      const QSharedPointer<const PrivateKey> client_priv,
+      const QSharedPointer<const PublicKeySet> server_pks,
+      const QSharedPointer<const PublicKey> author_pub) :
+    _params(params),
+    _client_priv(client_priv),
+    _server_pks(server_pks),
+    _author_pub(author_pub),
+    _pooled(IsPooled(params)),
+    _entry_bytes(_pooled ? EntryBytes(params) : 1),
+    _phase(0),
+    _n_elms(0),
+    _max_depth(GetDefaultMaxDepth()),
+    _max_memory(GetDefaultMaxMemory()),
+    _hits(0),
+    _misses(0),
+    _stopping(false),
+    _running(false)
+  {
+  }
+
+  ClientCiphertextPool::~ClientCiphertextPool()
+  {
+    {
+      QMutexLocker locker(&_lock);
+      _stopping = true;
+    }
+    WaitForFill();
+  }
+
+  void ClientCiphertextPool::StartFill(int phase)
+  {
+    if(!_pooled) {
+      return;
+    }
+
+    // Only this thread modifies the parameters, so reading them is safe
+    const QByteArray key = _params->GetByteArray();
+
+    {
+      QMutexLocker locker(&_lock);
+      _phase = phase;
+
+      if(key != _fill_key) {
+        // Generators depend on every parameter, including the element count
+        _fill_params = QSharedPointer<const Parameters>(new Parameters(*_params));
+        _fill_key = key;
+        _n_elms = _fill_params->GetNElements();
+        _generators.clear();
+      }
+
+      while(!_generators.isEmpty() && _generators.begin().key() < phase) {
+        _generators.erase(_generators.begin());
+      }
+
+      // A running fill picks up the new phase on its next element
+      if(_running || Held() >= Capacity()) {
+        return;
+      }
+      _running = true;
+    }
+
+    if(_params->IsThreadSafe() && CryptoFactory::GetInstance().GetThreadingType() ==
+        CryptoFactory::MultiThreaded)
+    {
+      _filling = QtConcurrent::run(this, &ClientCiphertextPool::Fill);
+    } else {
+      Fill();
+    }
+  }
+
+  void ClientCiphertextPool::WaitForFill()
+  {
+    _filling.waitForFinished();
+  }
+
+  void ClientCiphertextPool::Fill()
+  {
+    // Never reads _params, which the round may modify meanwhile
+    QSharedPointer<const Parameters> params;
+    int phase = 0;
+    int element_idx = 0;
+
+    if(!NextSlot(params, phase, element_idx)) {
+      return;
+    }
+
+    if(params->GetProofType() == Parameters::ProofType_ElGamal) {
+      // Copies of the parameters share the same groups
+      const AbstractGroup::FixedBase server_pk =
+        params->GetMessageGroup()->GetFixedBase(_server_pks->GetElement());
+
+      do {
+        OneTimeKey key;
+        key.priv = QSharedPointer<const PrivateKey>(new PrivateKey(params));
+        key.pub = QSharedPointer<const PublicKey>(new PublicKey(key.priv));
+        key.element = server_pk.Exponentiate(key.priv->GetInteger());
+
+        QMutexLocker locker(&_lock);
+        _keys.append(key);
+      } while(NextSlot(params, phase, element_idx));
+    } else {
+      do {
+        GeneratorElement gen;
+        gen.generator = BlogDropUtils::GetHashedGenerator(params, _author_pub,
+            phase, element_idx);
+        gen.element = params->GetMessageGroup()->Exponentiate(gen.generator,
+            _client_priv->GetInteger());
+
+        // The parameters or phase may have changed in the meantime
+        QMutexLocker locker(&_lock);
+        if(params == _fill_params && phase >= _phase &&
+            _generators.value(phase).count() == element_idx)
+        {
+          _generators[phase].append(gen);
+        }
+      } while(NextSlot(params, phase, element_idx));
+    }
+  }
+
+  bool ClientCiphertextPool::NextSlot(QSharedPointer<const Parameters> &params,
+      int &phase, int &element_idx)
+  {
+    QMutexLocker locker(&_lock);
+    if(!_stopping && Held() < Capacity()) {
+      params = _fill_params;
+      if(params->GetProofType() == Parameters::ProofType_ElGamal) {
+        return true;
+      }
+
+      for(int offset = 0; offset < _max_depth; offset++) {
+        const int count = _generators.value(_phase + offset).count();
+        if(count < _n_elms) {
+          phase = _phase + offset;
+          element_idx = count;
+          return true;
+        }
+      }
+    }
+
+    _running = false;
+    return false;
+  }
+
+  QList<ClientCiphertextPool::OneTimeKey> ClientCiphertextPool::TakeOneTimeKeys(int count)
+  {
+    QMutexLocker locker(&_lock);
+    QList<OneTimeKey> keys = _keys.mid(0, count);
+    _keys = _keys.mid(keys.count());
+    _hits += keys.count();
+    CountHits(keys.count());
+    return keys;
+  }
+
+  QList<ClientCiphertextPool::GeneratorElement> ClientCiphertextPool::TakeGeneratorElements(
+      const QSharedPointer<const Parameters> params, int phase,
+      const QSharedPointer<const PrivateKey> client_priv, int count)
+  {
+    const QByteArray key = params->GetByteArray();
+
+    QMutexLocker locker(&_lock);
+    while(!_generators.isEmpty() && _generators.begin().key() < phase) {
+      _generators.erase(_generators.begin());
+    }
+
+    QList<GeneratorElement> gens;
+    if(key == _fill_key && client_priv->GetInteger() == _client_priv->GetInteger()) {
+      gens = _generators.take(phase).mid(0, count);
+    }
+    _hits += gens.count();
+    CountHits(gens.count());
+    return gens;
+  }
+
+  void ClientCiphertextPool::AddMisses(int count)
+  {
+    QMutexLocker locker(&_lock);
+    _misses += count;
+    CountMisses(count);
+  }
+
+  void ClientCiphertextPool::SetMaxDepth(int depth)
+  {
+    QMutexLocker locker(&_lock);
+    _max_depth = depth;
+  }
+
+  int ClientCiphertextPool::GetMaxDepth() const
+  {
+    QMutexLocker locker(&_lock);
+    return _max_depth;
+  }
+
+  void ClientCiphertextPool::SetMaxMemory(int bytes)
+  {
+    QMutexLocker locker(&_lock);
+    _max_memory = bytes;
+  }
+
+  int ClientCiphertextPool::GetMaxMemory() const
+  {
+    QMutexLocker locker(&_lock);
+    return _max_memory;
+  }
+
+  void ClientCiphertextPool::SetDefaultMaxDepth(int depth)
+  {
+    default_max_depth.fetchAndStoreRelaxed(depth);
+  }
+
+  int ClientCiphertextPool::GetDefaultMaxDepth()
+  {
+    return default_max_depth;
+  }
+
+  void ClientCiphertextPool::SetDefaultMaxMemory(int bytes)
+  {
+    default_max_memory.fetchAndStoreRelaxed(bytes);
+  }
+
+  int ClientCiphertextPool::GetDefaultMaxMemory()
+  {
+    return default_max_memory;
+  }
+
+  int ClientCiphertextPool::Count() const
+  {
+    QMutexLocker locker(&_lock);
+    return Held();
+  }
+
+  int ClientCiphertextPool::GetHits() const
+  {
+    QMutexLocker locker(&_lock);
+    return _hits;
+  }
+
+  int ClientCiphertextPool::GetMisses() const
+  {
+    QMutexLocker locker(&_lock);
+    return _misses;
+  }
+
+  void ClientCiphertextPool::ResetCounters()
+  {
+    QMutexLocker locker(&_lock);
+    _hits = 0;
+    _misses = 0;
+  }
+
+  int ClientCiphertextPool::Capacity() const
+  {
+    return qMin(_max_depth * _n_elms, _max_memory / _entry_bytes);
+  }
+
+  int ClientCiphertextPool::Held() const
+  {
+    int held = _keys.count();
+    foreach(const QList<GeneratorElement> &gens, _generators) {
+      held += gens.count();
+    }
+    return held;
+  }
+
+}
+}
+}
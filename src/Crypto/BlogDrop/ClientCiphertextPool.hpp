@@ -0,0 +1,261 @@
+#ifndef DISSENT_CRYPTO_BLOGDROP_CLIENT_CIPHERTEXT_POOL_H_GUARD
+#define DISSENT_CRYPTO_BLOGDROP_CLIENT_CIPHERTEXT_POOL_H_GUARD
+
+#include <QFuture>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include "Parameters.hpp"
+#include "PrivateKey.hpp"
+#include "PublicKey.hpp"
+#include "PublicKeySet.hpp"
+
+namespace Dissent {
+namespace Crypto {
+namespace BlogDrop {
+
+  /**
+   * Values that a BlogDrop client needs to build its ciphertexts, computed
+   * ahead of time (in the background when the group allows it) during the
+   * idle time between phases.
+   *
+   * For ElGamal ciphertexts the pool holds one-time key pairs along with
+   * the element (prod_server_pks)^priv, these do not depend on the phase.
+   * For hashing generator ciphertexts the pool holds, for upcoming phases,
+   * each element's generator g_i and the element g_i^client_priv.
+   *
+   * Ciphertexts take what is available and compute the rest themselves,
+   * every element taken counts as a hit and every element computed by the
+   * ciphertext as a miss.  Other proof types are not pooled.
+   *
+   * Rounds change the number of elements in the parameters between
+   * phases, so a fill works from a copy of the parameters taken by
+   * StartFill and hashing generator elements are only handed to
+   * ciphertexts whose parameters serialize the same.
+   */
+  class ClientCiphertextPool {
+
+    public:
+
+      typedef Dissent::Crypto::AbstractGroup::Element Element;
+
+      /**
+       * A precomputed ElGamal ciphertext element
+       */
+      class OneTimeKey {
+        public:
+          QSharedPointer<const PrivateKey> priv;
+          QSharedPointer<const PublicKey> pub;
+          Element element;
+      };
+
+      /**
+       * A precomputed hashing generator ciphertext element
+       */
+      class GeneratorElement {
+        public:
+          Element generator;
+          Element element;
+      };
+
+      /**
+       * Constructor
+       * @param params Group parameters
+       * @param client_priv client private key
+       * @param server_pks Server public keys
+       * @param author_pub author public key
+       */
+      explicit ClientCiphertextPool(const QSharedPointer<const Parameters> params,
+          const QSharedPointer<const PrivateKey> client_priv,
+          const QSharedPointer<const PublicKeySet> server_pks,
+          const QSharedPointer<const PublicKey> author_pub);
+
+      /**
+       * Destructor, waits for a background fill to stop
+       */
+      ~ClientCiphertextPool();
+
+      /**
+       * Fills the pool for ciphertexts starting at phase.  When the
+       * parameters are thread safe and threading is enabled the values are
+       * computed in the background and this returns immediately, otherwise
+       * they are computed before returning.  Must be called from the thread
+       * that modifies the parameters.
+       * @param phase the next phase for which a ciphertext will be built
+       */
+      void StartFill(int phase);
+
+      /**
+       * Blocks until a background fill has finished
+       */
+      void WaitForFill();
+
+      /**
+       * Removes up to count precomputed ElGamal elements from the pool
+       * @param count the number of elements wanted
+       * @returns the elements taken, possibly fewer than count
+       */
+      QList<OneTimeKey> TakeOneTimeKeys(int count);
+
+      /**
+       * Removes up to count precomputed hashing generator elements for the
+       * given parameters, phase and client key from the pool, stale phases
+       * are dropped
+       * @param params the parameters of the ciphertext
+       * @param phase the phase of the ciphertext
+       * @param client_priv the key the elements must have been computed with
+       * @param count the number of elements wanted
+       * @returns the elements taken for element indexes 0, 1, ...
+       */
+      QList<GeneratorElement> TakeGeneratorElements(
+          const QSharedPointer<const Parameters> params, int phase,
+          const QSharedPointer<const PrivateKey> client_priv, int count);
+
+      /**
+       * Records elements a ciphertext had to compute itself
+       * @param count the number of elements
+       */
+      void AddMisses(int count);
+
+      /**
+       * Sets how far ahead the pool computes: the number of ciphertexts
+       * worth of ElGamal elements or the number of upcoming phases of
+       * hashing generator elements
+       * @param depth the depth, 0 disables precomputation
+       */
+      void SetMaxDepth(int depth);
+
+      /**
+       * Returns the maximum depth
+       */
+      int GetMaxDepth() const;
+
+      /**
+       * Sets an upper bound on the estimated memory used by the pool
+       * @param bytes the bound in bytes
+       */
+      void SetMaxMemory(int bytes);
+
+      /**
+       * Returns the upper bound on memory in bytes
+       */
+      int GetMaxMemory() const;
+
+      /**
+       * Returns the number of pooled elements currently held
+       */
+      int Count() const;
+
+      /**
+       * Returns the number of elements taken from the pool
+       */
+      int GetHits() const;
+
+      /**
+       * Returns the number of elements ciphertexts had to compute
+       */
+      int GetMisses() const;
+
+      /**
+       * Resets the hit and miss counters
+       */
+      void ResetCounters();
+
+      /**
+       * Sets the depth given to pools constructed afterwards
+       * @param depth the depth, 0 disables precomputation
+       */
+      static void SetDefaultMaxDepth(int depth);
+
+      /**
+       * Returns the depth given to new pools
+       */
+      static int GetDefaultMaxDepth();
+
+      /**
+       * Sets the memory bound given to pools constructed afterwards
+       * @param bytes the bound in bytes
+       */
+      static void SetDefaultMaxMemory(int bytes);
+
+      /**
+       * Returns the memory bound given to new pools
+       */
+      static int GetDefaultMaxMemory();
+
+      /**
+       * Default number of ciphertexts or phases computed ahead
+       */
+      static const int DEFAULT_MAX_DEPTH = 1;
+
+      /**
+       * Default bound on memory in bytes
+       */
+      static const int DEFAULT_MAX_MEMORY = 4 * 1024 * 1024;
+
+    private:
+      /**
+       * Computes values until the pool is full or the target phase moves
+       */
+      void Fill();
+
+      /**
+       * Finds the next value to compute, the phase and element index only
+       * apply to hashing generator elements
+       * @param params set to the parameters to compute with
+       * @returns false, and marks the fill as finished, if the pool is full
+       */
+      bool NextSlot(QSharedPointer<const Parameters> &params, int &phase,
+          int &element_idx);
+
+      /**
+       * Returns the maximum number of pooled elements, must be called with
+       * the lock held
+       */
+      int Capacity() const;
+
+      /**
+       * Returns the number of pooled elements, must be called with the lock
+       * held
+       */
+      int Held() const;
+
+      const QSharedPointer<const Parameters> _params;
+      const QSharedPointer<const PrivateKey> _client_priv;
+      const QSharedPointer<const PublicKeySet> _server_pks;
+      const QSharedPointer<const PublicKey> _author_pub;
+      const bool _pooled;
+      const int _entry_bytes;
+
+      mutable QMutex _lock;
+      QSharedPointer<const Parameters> _fill_params;
+      QByteArray _fill_key;
+      QList<OneTimeKey> _keys;
+      QMap<int, QList<GeneratorElement> > _generators;
+      int _phase;
+      int _n_elms;
+      int _max_depth;
+      int _max_memory;
+      int _hits;
+      int _misses;
+      bool _stopping;
+      bool _running;
+      QFuture<void> _filling;
+
+      /**
+       * No copying
+       */
+      ClientCiphertextPool(const ClientCiphertextPool &);
+
+      /**
+       * No copying
+       */
+      ClientCiphertextPool &operator=(const ClientCiphertextPool &);
+  };
+}
+}
+}
+
+#endif
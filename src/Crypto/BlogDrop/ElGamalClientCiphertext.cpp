@@ -2,6 +2,7 @@
 #include <QtCore>
 
 #include "Crypto/CryptoFactory.hpp"
+#include "Utils/Arena.hpp"
 
 #include "BlogDropUtils.hpp"
 #include "ElGamalClientCiphertext.hpp"
@@ -12,16 +13,35 @@ namespace BlogDrop {
 
   ElGamalClientCiphertext::ElGamalClientCiphertext(const QSharedPointer<const Parameters> params, 
       const QSharedPointer<const PublicKeySet> server_pks,
-      const QSharedPointer<const PublicKey> author_pub) :
+      const QSharedPointer<const PublicKey> author_pub,
+      const QSharedPointer<ClientCiphertextPool> pool) :
     ClientCiphertext(params, server_pks, author_pub, params->GetNElements())
   {
-    for(int i=0; i<_n_elms; i++) { 
+    QList<ClientCiphertextPool::OneTimeKey> keys;
+    if(pool) {
+      keys = pool->TakeOneTimeKeys(_n_elms);
+      pool->AddMisses(_n_elms - keys.count());
+    }
+
+    foreach(const ClientCiphertextPool::OneTimeKey &key, keys) {
+      _one_time_privs.append(key.priv);
+      _one_time_pubs.append(key.pub);
+      _elements.append(key.element);
+    }
+
+    if(keys.count() == _n_elms) {
+      return;
+    }
+
+    const AbstractGroup::FixedBase server_pk = 
+      _params->GetMessageGroup()->GetFixedBase(_server_pks->GetElement());
+
+    for(int i=keys.count(); i<_n_elms; i++) { 
       QSharedPointer<const PrivateKey> priv(new PrivateKey(_params));
       QSharedPointer<const PublicKey> pub(new PublicKey(priv));
       _one_time_privs.append(priv);
       _one_time_pubs.append(pub);
-      _elements.append(_params->GetMessageGroup()->Exponentiate(_server_pks->GetElement(),
-          _one_time_privs[i]->GetInteger())); 
+      _elements.append(server_pk.Exponentiate(_one_time_privs[i]->GetInteger())); 
     }
   }
 
@@ -108,7 +128,7 @@ namespace BlogDrop {
     QList<Integer> vs;
 
     Integer v_auth = _params->GetKeyGroup()->RandomExponent();
-    ts.append(_params->GetKeyGroup()->Exponentiate(gs[0], v_auth));
+    ts.append(_params->GetKeyGroup()->GetFixedBase(gs[0]).Exponentiate(v_auth));
 
     for(int i=0; i<(2*_n_elms); i++) { 
       Integer v = _params->GetMessageGroup()->RandomExponent();
@@ -134,6 +154,9 @@ namespace BlogDrop {
 
   void ElGamalClientCiphertext::SetProof(int /*phase*/, const QSharedPointer<const PrivateKey>)
   {
+    // The proof's intermediate Elements and Integers are drawn from an arena
+    Utils::Arena arena;
+
     const Element g_key = _params->GetKeyGroup()->GetGenerator();
     const Integer q = _params->GetGroupOrder();
 
@@ -166,10 +189,14 @@ namespace BlogDrop {
       vs.append(_params->GetKeyGroup()->RandomExponent());
     }
 
+    // g(i) and g'(i) are the same for every i
+    const AbstractGroup::FixedBase g_base = _params->GetKeyGroup()->GetFixedBase(gs[1]);
+    const AbstractGroup::FixedBase pk_base = _params->GetMessageGroup()->GetFixedBase(gs[2]);
+
     int v_idx = 0;
     for(int i=1; i<(1+(2*_n_elms)); i++) {
-      ts.append(_params->GetKeyGroup()->Exponentiate(gs[i], vs[v_idx])); i++;
-      ts.append(_params->GetMessageGroup()->Exponentiate(gs[i], vs[v_idx]));
+      ts.append(g_base.Exponentiate(vs[v_idx])); i++;
+      ts.append(pk_base.Exponentiate(vs[v_idx]));
 
       v_idx++;
     }
@@ -208,6 +235,7 @@ namespace BlogDrop {
       }
     }
 
+    Utils::Arena arena;
     const Element g_key = _params->GetKeyGroup()->GetGenerator();
     const Integer q = _params->GetGroupOrder();
 
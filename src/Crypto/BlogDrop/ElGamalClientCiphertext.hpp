@@ -2,6 +2,7 @@
 #define DISSENT_CRYPTO_BLOGDROP_EL_GAMAL_CLIENT_CIPHERTEXT_H_GUARD
 
 #include "ClientCiphertext.hpp"
+#include "ClientCiphertextPool.hpp"
 
 namespace Dissent {
 namespace Crypto {
@@ -36,10 +37,13 @@ namespace BlogDrop {
        * @param params Group parameters
        * @param server_pks Server public keys
        * @param author_pub author public key
+       * @param pool precomputed one-time keys to draw from first
        */
       explicit ElGamalClientCiphertext(const QSharedPointer<const Parameters> params, 
           const QSharedPointer<const PublicKeySet> server_pks,
-          const QSharedPointer<const PublicKey> author_pub);
+          const QSharedPointer<const PublicKey> author_pub,
+          const QSharedPointer<ClientCiphertextPool> pool = 
+            QSharedPointer<ClientCiphertextPool>());
 
       /**
        * Constructor: Initialize a ciphertext from a serialized bytearray
@@ -80,7 +80,7 @@ namespace BlogDrop {
     QList<Element> ts;
 
     // t0 = g0^v
-    ts.append(_params->GetKeyGroup()->Exponentiate(g_key, v));
+    ts.append(_params->GetKeyGroup()->GetFixedBase(g_key).Exponentiate(v));
 
     for(int i=0; i<_n_elms; i++) {
       // t(i) = g(i)^-v
@@ -146,13 +146,10 @@ namespace BlogDrop {
         pub->GetElement(), _challenge));
 
     for(int i=0; i<_n_elms; i++) {
-      // t(i) = g(i)^-r * y(i)^c
-      Element ti = _params->GetMessageGroup()->Exponentiate(
-          _client_pks[i]->GetElement(), _response);
-      ti = _params->GetMessageGroup()->Inverse(ti);
-      Element ti_tmp = _params->GetMessageGroup()->Exponentiate(_elements[i], _challenge);
-      ti = _params->GetMessageGroup()->Multiply(ti, ti_tmp);
-      ts.append(ti); 
+      // t(i) = (g(i)^-1)^r * y(i)^c
+      const Element g_inv = _params->GetMessageGroup()->Inverse(_client_pks[i]->GetElement());
+      ts.append(_params->GetMessageGroup()->CascadeExponentiate(g_inv, _response,
+            _elements[i], _challenge));
     }
 
     QList<Element> gs;
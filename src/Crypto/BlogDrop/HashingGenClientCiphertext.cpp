@@ -12,8 +12,9 @@ namespace BlogDrop {
 
   HashingGenClientCiphertext::HashingGenClientCiphertext(const QSharedPointer<const Parameters> params, 
       const QSharedPointer<const PublicKeySet> server_pks,
-      const QSharedPointer<const PublicKey> author_pub) :
-    ChangingGenClientCiphertext(params, server_pks, author_pub)
+      const QSharedPointer<const PublicKey> author_pub,
+      const QSharedPointer<ClientCiphertextPool> pool) :
+    ChangingGenClientCiphertext(params, server_pks, author_pub, pool)
   {
   }
 
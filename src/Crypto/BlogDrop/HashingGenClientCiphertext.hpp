@@ -51,10 +51,13 @@ namespace BlogDrop {
        * @param params Group parameters
        * @param server_pks Server public keys
        * @param author_pub author public key
+       * @param pool precomputed generators and elements to draw from first
        */
       explicit HashingGenClientCiphertext(const QSharedPointer<const Parameters> params, 
           const QSharedPointer<const PublicKeySet> server_pks,
-          const QSharedPointer<const PublicKey> author_pub);
+          const QSharedPointer<const PublicKey> author_pub,
+          const QSharedPointer<ClientCiphertextPool> pool = 
+            QSharedPointer<ClientCiphertextPool>());
 
       /**
        * Constructor: Initialize a ciphertext from a serialized bytearray
@@ -119,10 +119,20 @@ namespace Dissent {
           virtual ~Parameters() {}
 
           /**
-           * Copy constructor
+           * Copy constructor, the copy has its own copies of the groups
            */
           Parameters(const Parameters &p);
 
+          /**
+           * Returns true if both groups are thread safe, in which case a
+           * Parameters object may be shared by many threads as long as
+           * none of them modifies it
+           */
+          inline bool IsThreadSafe() const
+          {
+            return _key_group->IsThreadSafe() && _msg_group->IsThreadSafe();
+          }
+
           /**
            * Get the group that contains the public key elements 
            */
@@ -1,10 +1,59 @@
 
+#include <QtConcurrentMap>
+#include <QThread>
+#include <QVector>
+
+#include "Crypto/CryptoFactory.hpp"
 #include "Plaintext.hpp"
 
 namespace Dissent {
 namespace Crypto {
 namespace BlogDrop {
 
+namespace {
+  typedef Dissent::Crypto::AbstractGroup::Element Element;
+
+  /**
+   * The running product of a run of ciphertexts, unless they are thread
+   * safe the parameters are private to the product so that it can be
+   * computed on any thread
+   */
+  struct PartialProduct {
+    QSharedPointer<const Parameters> params;
+    const QList<QList<Element> > *cs;
+    int start;
+    int end;
+    QList<Element> product;
+  };
+
+  struct ProductPair {
+    PartialProduct *left;
+    const PartialProduct *right;
+  };
+
+  void Combine(const QSharedPointer<const Parameters> &params,
+      QList<Element> &product, const QList<Element> &c)
+  {
+    Q_ASSERT(product.count() == c.count());
+    for(int i=0; i<product.count(); i++) {
+      product[i] = params->GetMessageGroup()->Multiply(product[i], c[i]);
+    }
+  }
+
+  void ComputePartial(PartialProduct &partial)
+  {
+    partial.product = partial.cs->at(partial.start);
+    for(int idx=partial.start+1; idx<partial.end; idx++) {
+      Combine(partial.params, partial.product, partial.cs->at(idx));
+    }
+  }
+
+  void CombinePair(ProductPair &pair)
+  {
+    Combine(pair.left->params, pair.left->product, pair.right->product);
+  }
+}
+
   Plaintext::Plaintext(const QSharedPointer<const Parameters> params) :
     _params(params)
   {
@@ -54,6 +103,52 @@ namespace BlogDrop {
     }
   }
 
+  void Plaintext::RevealAll(const QList<QList<Element> > &cs)
+  {
+    CryptoFactory::ThreadingType tt =
+      CryptoFactory::GetInstance().GetThreadingType();
+    int workers = qMin(QThread::idealThreadCount(),
+        cs.count() / MIN_CIPHERTEXTS_PER_THREAD);
+
+    if(tt == CryptoFactory::SingleThreaded || workers < 2) {
+      for(int idx=0; idx<cs.count(); idx++) {
+        Reveal(cs[idx]);
+      }
+      return;
+    }
+
+    QVector<PartialProduct> partials;
+    int count = cs.count();
+    int per_chunk = count / workers + (count % workers ? 1 : 0);
+    for(int start = 0; start < count; start += per_chunk) {
+      PartialProduct partial;
+      partial.params = _params->IsThreadSafe() ? _params :
+        QSharedPointer<const Parameters>(new Parameters(*_params));
+      partial.cs = &cs;
+      partial.start = start;
+      partial.end = qMin(start + per_chunk, count);
+      partials.append(partial);
+    }
+
+    QtConcurrent::blockingMap(partials, ComputePartial);
+
+    // Fold the upper half onto the lower half until one product remains,
+    // every pair at a level touches distinct partials
+    for(int width = partials.count(); width > 1; width = (width + 1) / 2) {
+      QList<ProductPair> pairs;
+      int half = width / 2;
+      for(int idx = 0; idx < half; idx++) {
+        ProductPair pair;
+        pair.left = &partials[idx];
+        pair.right = &partials[width - half + idx];
+        pairs.append(pair);
+      }
+      QtConcurrent::blockingMap(pairs, CombinePair);
+    }
+
+    Reveal(partials[0].product);
+  }
+
 }
 }
 }
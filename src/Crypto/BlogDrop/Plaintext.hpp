@@ -64,6 +64,20 @@ namespace BlogDrop {
        */
       void Reveal(const QList<Element> &c);
 
+      /**
+       * Reveal a plaintext by combining the elements of many ciphertexts.
+       * When multithreaded, contiguous runs of ciphertexts are combined in
+       * parallel and the partial products are then combined pairwise in a
+       * tree.
+       * @param cs the ciphertext elements to combine
+       */
+      void RevealAll(const QList<QList<Element> > &cs);
+
+      /**
+       * The fewest ciphertexts worth handing to a separate thread
+       */
+      static const int MIN_CIPHERTEXTS_PER_THREAD = 4;
+
     private:
 
       const QSharedPointer<const Parameters> _params;
@@ -13,15 +13,15 @@ namespace BlogDrop {
 
   PublicKey::PublicKey(const QSharedPointer<const PrivateKey> key) :
     _params(key->GetParameters()),
-    _public_key(_params->GetKeyGroup()->Exponentiate(
-          _params->GetKeyGroup()->GetGenerator(), key->GetInteger()))
+    _public_key(_params->GetKeyGroup()->GetFixedBase(
+          _params->GetKeyGroup()->GetGenerator()).Exponentiate(key->GetInteger()))
   {
   }
   
   PublicKey::PublicKey(const PrivateKey &key) :
     _params(key.GetParameters()),
-    _public_key(_params->GetKeyGroup()->Exponentiate(
-          _params->GetKeyGroup()->GetGenerator(), key.GetInteger()))
+    _public_key(_params->GetKeyGroup()->GetFixedBase(
+          _params->GetKeyGroup()->GetGenerator()).Exponentiate(key.GetInteger()))
   {
   }
 
@@ -45,8 +45,8 @@ namespace BlogDrop {
     const Integer v = _params->GetKeyGroup()->RandomExponent();
 
     // t = g^v
-    const Element t = _params->GetKeyGroup()->Exponentiate(
-        _params->GetKeyGroup()->GetGenerator(), v);
+    const Element t = _params->GetKeyGroup()->GetFixedBase(
+        _params->GetKeyGroup()->GetGenerator()).Exponentiate(v);
 
     // c = H(g, y, t)
     const Integer c = BlogDropUtils::Commit(_params, 
@@ -12,6 +12,63 @@ namespace Dissent {
 namespace Crypto {
 namespace BlogDrop {
 
+namespace {
+  /**
+   * A run of server ciphertexts verified by one worker.  Either the
+   * parameters, keys and client ciphertexts are shared with the caller or
+   * the chunk has its own copy of the parameters and rebuilds the rest from
+   * their serialized form.
+   */
+  struct VerifyChunk {
+    QSharedPointer<const Parameters> params;
+    QSharedPointer<const PublicKeySet> client_pk_set;
+    QSharedPointer<const PublicKey> author_pk;
+    QList<QSharedPointer<const ClientCiphertext> > client_ctexts;
+    QList<QSharedPointer<const PublicKey> > pubs;
+
+    QByteArray client_pk_set_bytes;
+    QByteArray author_pk_bytes;
+    QList<QByteArray> client_ctext_bytes;
+    QList<QByteArray> pub_bytes;
+
+    int phase;
+    QList<QByteArray> ciphertexts;
+
+    /* list[idx] = parsed ciphertext or null if its proof failed */
+    QList<QSharedPointer<const ServerCiphertext> > verified;
+  };
+
+  void VerifyChunkProofs(VerifyChunk &chunk)
+  {
+    if(!chunk.client_pk_set) {
+      chunk.client_pk_set = QSharedPointer<const PublicKeySet>(
+          new PublicKeySet(chunk.params, chunk.client_pk_set_bytes));
+      chunk.author_pk = QSharedPointer<const PublicKey>(
+          new PublicKey(chunk.params, chunk.author_pk_bytes));
+      foreach(const QByteArray &ctext, chunk.client_ctext_bytes) {
+        chunk.client_ctexts.append(CiphertextFactory::CreateClientCiphertext(
+              chunk.params, chunk.client_pk_set, chunk.author_pk, ctext));
+      }
+      foreach(const QByteArray &pub, chunk.pub_bytes) {
+        chunk.pubs.append(QSharedPointer<const PublicKey>(
+              new PublicKey(chunk.params, pub)));
+      }
+    }
+
+    for(int idx = 0; idx < chunk.ciphertexts.count(); idx++) {
+      QSharedPointer<const ServerCiphertext> s = CiphertextFactory::CreateServerCiphertext(
+          chunk.params, chunk.client_pk_set, chunk.author_pk,
+          chunk.client_ctexts, chunk.ciphertexts[idx]);
+
+      if(s->VerifyProof(chunk.phase, chunk.pubs[idx])) {
+        chunk.verified.append(s);
+      } else {
+        chunk.verified.append(QSharedPointer<const ServerCiphertext>());
+      }
+    }
+  }
+}
+
   ServerCiphertext::ServerCiphertext(const QSharedPointer<const Parameters> params,
       const QSharedPointer<const PublicKey> author_pub, 
       int n_elms) :
@@ -50,40 +107,56 @@ namespace BlogDrop {
       }
 
     } else if(tt == CryptoFactory::MultiThreaded) {
-
-      QList<QByteArray> ctext_bytes;
-      for(int i=0; i<client_ctexts.count(); i++) {
-        ctext_bytes.append(client_ctexts[i]->GetByteArray());
+      QList<VerifyChunk> chunks;
+      int workers = qMax(1, qMin(QThread::idealThreadCount(), c.count()));
+      int per_chunk = c.count() / workers + (c.count() % workers ? 1 : 0);
+
+      // Thread-safe parameters, keys and client ciphertexts are shared by
+      // every worker, others are rebuilt once per chunk from a single
+      // serialization
+      const bool shared = params->IsThreadSafe();
+      QByteArray client_pk_set_bytes, author_pk_bytes;
+      QList<QByteArray> client_ctext_bytes;
+      if(!shared) {
+        client_pk_set_bytes = server_pk_set->GetByteArray();
+        author_pk_bytes = author_pk->GetByteArray();
+        for(int i=0; i<client_ctexts.count(); i++) {
+          client_ctext_bytes.append(client_ctexts[i]->GetByteArray());
+        }
       }
 
-      QList<QSharedPointer<MapData> > ms;
-
-      // Unpack each ciphertext copying parameters to
-      // avoid shared data
-      for(int server_idx=0; server_idx<c.count(); server_idx++) {
-        QSharedPointer<MapData> m(new MapData());
-        m->params = new Parameters(*params);
-
-        QByteArray mine;
-        QDataStream stream(&mine, QIODevice::WriteOnly);
-        stream << ctext_bytes;
-
-        m->client_ciphertext_list = mine;
-        m->server_pk_set = server_pk_set->GetByteArray();
-        m->author_pk = author_pk->GetByteArray();
-        m->server_pk = pubs[server_idx]->GetByteArray();
-        m->server_ciphertext = c[server_idx];
-        m->phase = phase;
+      for(int start = 0; start < c.count(); start += per_chunk) {
+        VerifyChunk chunk;
+        chunk.phase = phase;
+        chunk.ciphertexts = c.mid(start, per_chunk);
+
+        if(shared) {
+          chunk.params = params;
+          chunk.client_pk_set = server_pk_set;
+          chunk.author_pk = author_pk;
+          chunk.client_ctexts = client_ctexts;
+          chunk.pubs = pubs.mid(start, per_chunk);
+        } else {
+          chunk.params = QSharedPointer<const Parameters>(new Parameters(*params));
+          chunk.client_pk_set_bytes = client_pk_set_bytes;
+          chunk.author_pk_bytes = author_pk_bytes;
+          chunk.client_ctext_bytes = client_ctext_bytes;
+          for(int idx = start; idx < qMin(start + per_chunk, c.count()); idx++) {
+            chunk.pub_bytes.append(pubs[idx]->GetByteArray());
+          }
+        }
 
-        ms.append(m);
+        chunks.append(chunk);
       }
 
-      QList<bool> valid_list = QtConcurrent::blockingMapped(ms, VerifyOnce);
+      QtConcurrent::blockingMap(chunks, VerifyChunkProofs);
 
-      for(int server_idx=0; server_idx<valid_list.count(); server_idx++) {
-        if(valid_list[server_idx]) {
-          c_out.append(CiphertextFactory::CreateServerCiphertext(
-              params, server_pk_set, author_pk, client_ctexts, c[server_idx]));
+      // Keep the ciphertexts parsed by the workers
+      foreach(const VerifyChunk &chunk, chunks) {
+        foreach(const QSharedPointer<const ServerCiphertext> &ctext, chunk.verified) {
+          if(ctext) {
+            c_out.append(ctext);
+          }
         }
       }
 
@@ -92,28 +165,6 @@ namespace BlogDrop {
     }
   }
 
-  bool ServerCiphertext::VerifyOnce(QSharedPointer<MapData> m)
-  {
-    QSharedPointer<const Parameters> params(m->params);
-
-    QSharedPointer<const PublicKeySet> server_pk_set(new PublicKeySet(params, m->server_pk_set));
-    QSharedPointer<const PublicKey> author_pk(new PublicKey(params, m->author_pk)); 
-    QSharedPointer<const PublicKey> server_pk(new PublicKey(params, m->server_pk)); 
-
-    QList<QByteArray> client_ctexts_raw;
-    QDataStream stream(m->client_ciphertext_list);
-    stream >> client_ctexts_raw;
-
-    QList<QSharedPointer<const ClientCiphertext> > client_ctexts;
-    for(int i=0; i<client_ctexts_raw.count(); i++) {
-      client_ctexts.append(CiphertextFactory::CreateClientCiphertext(
-            params, server_pk_set, author_pk, client_ctexts_raw[i]));
-    }
-
-    QSharedPointer<const ServerCiphertext> s = CiphertextFactory::CreateServerCiphertext(
-              params, server_pk_set, author_pk, client_ctexts, m->server_ciphertext);
-    return s->VerifyProof(m->phase, server_pk);
-  }
 }
 }
 }
@@ -0,0 +1,58 @@
+#include <limits.h>
+#include <string.h>
+
+#include "CppCtrRandom.hpp"
+
+namespace Dissent {
+namespace Crypto {
+  CppCtrRandom::CppCtrRandom(const QByteArray &seed, uint index)
+  {
+    QByteArray key(seed);
+    key.resize(CryptoPP::AES::DEFAULT_KEYLENGTH);
+    if(seed.size() < key.size()) {
+      memset(key.data() + seed.size(), 0, key.size() - seed.size());
+    }
+
+    QByteArray iv(CryptoPP::AES::BLOCKSIZE, 0);
+    _cipher.SetKeyWithIV(reinterpret_cast<const byte *>(key.constData()),
+        key.size(), reinterpret_cast<const byte *>(iv.constData()));
+
+    if(index) {
+      Seek(index);
+    }
+  }
+
+  int CppCtrRandom::GetInt(int min, int max)
+  {
+    if(max <= min) {
+      return min;
+    }
+
+    uint range = uint(max) - uint(min);
+    uint limit = UINT_MAX - (UINT_MAX % range);
+    QByteArray block(4, 0);
+    uint value;
+    do {
+      GenerateBlock(block);
+      memcpy(&value, block.constData(), 4);
+    } while(value >= limit);
+
+    return min + int(value % range);
+  }
+
+  void CppCtrRandom::GenerateBlock(QByteArray &data)
+  {
+    byte *out = reinterpret_cast<byte *>(data.data());
+    memset(out, 0, data.size());
+    _cipher.ProcessString(out, data.size());
+    IncrementByteCount(data.size());
+  }
+
+  bool CppCtrRandom::Seek(qint64 offset)
+  {
+    _cipher.Seek(offset);
+    SetByteCount(offset);
+    return true;
+  }
+}
+}
@@ -0,0 +1,53 @@
+#ifndef DISSENT_CRYPTO_CPP_CTR_RANDOM_H_GUARD
+#define DISSENT_CRYPTO_CPP_CTR_RANDOM_H_GUARD
+
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+
+#include "Utils/Random.hpp"
+
+namespace Dissent {
+namespace Crypto {
+  /**
+   * Deterministic random number generator producing the AES-CTR keystream
+   * for a given seed.  Unlike CppRandom, any offset of the output can be
+   * reached in constant time via Seek.
+   */
+  class CppCtrRandom : public Utils::Random {
+    public:
+      /**
+       * Constructor
+       * @param seed the AES key, padded or truncated to OptimalSeedSize
+       * @param index initial byte offset into the keystream
+       */
+      explicit CppCtrRandom(const QByteArray &seed, uint index = 0);
+
+      /**
+       * Destructor
+       */
+      virtual ~CppCtrRandom() {}
+
+      /**
+       * Returns the optimal seed size, less than will provide suboptimal
+       * results and greater than will be compressed into the chosen seed.
+       */
+      static uint OptimalSeedSize() { return CryptoPP::AES::DEFAULT_KEYLENGTH; }
+
+      virtual int GetInt(int min = 0, int max = RAND_MAX);
+      virtual void GenerateBlock(QByteArray &data);
+
+      /**
+       * Moves to the given byte offset of the keystream
+       * @param offset the absolute offset
+       */
+      virtual bool Seek(qint64 offset);
+
+      virtual bool IsSeekable() const { return true; }
+
+    private:
+      CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption _cipher;
+  };
+}
+}
+
+#endif
@@ -1,8 +1,10 @@
 #include "CppDsaPrivateKey.hpp"
 #include "CppIntegerData.hpp"
 #include "CppRandom.hpp"
+#include "Utils/Metrics.hpp"
 
 using namespace CryptoPP;
+using Dissent::Utils::Metrics;
 
 namespace Dissent {
 namespace Crypto {
@@ -96,6 +98,10 @@ namespace Crypto {
       return QByteArray();
     }
 
+    static const Metrics::Histogram metric = Metrics::GetHistogram(
+        "dissent_crypto_seconds", "Time spent in crypto operations",
+        Metrics::Label("op", "sign") + "," + Metrics::Label("key", "Dsa"));
+    Metrics::ScopedTimer timer(metric);
     KeyBase::Signer signer(*GetDsaPrivateKey());
     QByteArray sig(signer.MaxSignatureLength(), 0);
     AutoSeededX917RNG<DES_EDE3> rng;
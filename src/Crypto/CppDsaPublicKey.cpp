@@ -3,8 +3,10 @@
 #include "CppDsaPrivateKey.hpp"
 #include "CppIntegerData.hpp"
 #include "CppRandom.hpp"
+#include "Utils/Metrics.hpp"
 
 using namespace CryptoPP;
+using Dissent::Utils::Metrics;
 
 namespace Dissent {
 namespace Crypto {
@@ -120,6 +122,10 @@ namespace Crypto {
       return false;
     }
 
+    static const Metrics::Histogram metric = Metrics::GetHistogram(
+        "dissent_crypto_seconds", "Time spent in crypto operations",
+        Metrics::Label("op", "verify") + "," + Metrics::Label("key", "Dsa"));
+    Metrics::ScopedTimer timer(metric);
     KeyBase::Verifier verifier(*GetDsaPublicKey());
     return verifier.VerifyMessage(reinterpret_cast<const byte *>(data.data()),
         data.size(), reinterpret_cast<const byte *>(sig.data()), sig.size());
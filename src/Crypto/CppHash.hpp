@@ -2,6 +2,7 @@
 #define DISSENT_CRYPTO_CPP_HASH_H_GUARD
 
 #include <QByteArray>
+#include <QScopedPointer>
 
 #include <cryptopp/sha.h>
 
@@ -10,22 +11,34 @@
 namespace Dissent {
 namespace Crypto {
   /**
-   * Hash wrapper for CryptoPP::SHA1
+   * Hash wrapper for CryptoPP hash functions, SHA-1 unless told otherwise
    */
   class CppHash : public Hash {
     public:
+      /**
+       * Constructs a SHA-1 hash
+       */
+      CppHash() : _hash(new CryptoPP::SHA1()) {}
+
+      /**
+       * Constructs a hash around a CryptoPP hash function
+       * @param hash the hash function, owned by this object
+       */
+      explicit CppHash(CryptoPP::HashTransformation *hash) : _hash(hash) {}
+
       /**
        * Destructor
        */
       virtual ~CppHash() {}
 
-      inline virtual int GetDigestSize() { return sha1.DigestSize(); }
+      inline virtual int GetDigestSize() { return _hash->DigestSize(); }
+      inline virtual int GetBlockSize() const { return _hash->OptimalBlockSize(); }
       virtual void Restart();
       virtual void Update(const QByteArray &data);
       virtual QByteArray ComputeHash();
       virtual QByteArray ComputeHash(const QByteArray &data);
     private:
-      CryptoPP::SHA1 sha1;
+      QScopedPointer<CryptoPP::HashTransformation> _hash;
   };
 }
 }
@@ -1,13 +1,16 @@
 #ifndef DISSENT_CRYPTO_CPP_LIBRARY_H_GUARD
 #define DISSENT_CRYPTO_CPP_LIBRARY_H_GUARD
 
+#include "Blake2bHash.hpp"
 #include "CppDiffieHellman.hpp"
 #include "CppHash.hpp"
 #include "CppIntegerData.hpp"
+#include "CppCtrRandom.hpp"
 #include "CppRandom.hpp"
 #include "CppPrivateKey.hpp"
 #include "CppPublicKey.hpp"
 
+#include "CryptoFactory.hpp"
 #include "Library.hpp"
 
 namespace Dissent {
@@ -83,17 +86,33 @@ namespace Crypto {
         return new CppRandom(seed, index);
       }
 
+      /**
+       * Returns a deterministic counter-mode random number generator
+       */
+      inline virtual Dissent::Utils::Random *GetSeekableRandomNumberGenerator(
+          const QByteArray &seed, uint index)
+      {
+        return new CppCtrRandom(seed, index);
+      }
+
       inline virtual uint RngOptimalSeedSize()
       {
         return CppRandom::OptimalSeedSize();
       }
 
       /**
-       * Returns a hash algorithm
+       * Returns the hash algorithm chosen in the CryptoFactory
        */
       inline virtual Hash *GetHashAlgorithm() 
       {
-        return new CppHash();
+        switch(CryptoFactory::GetInstance().GetHashName()) {
+          case CryptoFactory::Sha256:
+            return new CppHash(new CryptoPP::SHA256());
+          case CryptoFactory::Blake2b:
+            return new Blake2bHash();
+          default:
+            return new CppHash();
+        }
       }
 
       /**
@@ -1,13 +1,372 @@
 #include <QDataStream>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include "CppDsaPrivateKey.hpp"
 #include "CppDsaPublicKey.hpp"
 #include "CppHash.hpp"
 #include "CppNeffShuffle.hpp"
 #include "CppRandom.hpp"
+#include "CryptoFactory.hpp"
+
+#include "Utils/Arena.hpp"
+
+#include "Crypto/AbstractGroup/FixedBase.hpp"
+#include "Crypto/AbstractGroup/IntegerElementData.hpp"
+#include "Crypto/AbstractGroup/MultiExponentiation.hpp"
 
 namespace Dissent {
 namespace Crypto {
+namespace {
+  /**
+   * Multiplication mod p, the group operation for WindowTable
+   */
+  class MultiplyMod {
+    public:
+      explicit MultiplyMod(const Integer &modulus) : _modulus(modulus) {}
+
+      inline Integer operator()(const Integer &a, const Integer &b) const
+      {
+        return a.MultiplyMod(b, _modulus);
+      }
+
+    private:
+      const Integer _modulus;
+  };
+
+  /**
+   * Powers of a fixed base mod p for exponents in the DSA subgroup,
+   * using a table sized to the subgroup rather than the modulus
+   */
+  class FixedPow {
+    public:
+      FixedPow(const Integer &base, const Integer &modulus, const Integer &subgroup) :
+        _base(base),
+        _multiply(modulus),
+        _modulus(modulus),
+        _table(AbstractGroup::Element(new AbstractGroup::IntegerElementData(base)),
+            subgroup.GetBitCount())
+      {
+        _table.Build(base, _multiply);
+      }
+
+      Integer Pow(const Integer &exp) const
+      {
+        Integer out;
+        if(_table.Evaluate(exp, _multiply, out)) {
+          return out;
+        }
+        return _base.Pow(exp, _modulus);
+      }
+
+    private:
+      const Integer _base;
+      const MultiplyMod _multiply;
+      const Integer _modulus;
+      AbstractGroup::WindowTable<Integer> _table;
+  };
+
+  /**
+   * Products of powers mod p
+   */
+  typedef AbstractGroup::MultiExponentiation<Integer, MultiplyMod> MultiPow;
+
+  /**
+   * A range of indexes over which a verification step is evaluated
+   */
+  template<typename Step> class StepChunk {
+    public:
+      const Step *step;
+      int start;
+      int end;
+      bool valid;
+  };
+
+  template<typename Step> void EvaluateChunk(StepChunk<Step> &chunk)
+  {
+    for(int idx = chunk.start; chunk.valid && idx < chunk.end; idx++) {
+      chunk.valid = (*chunk.step)(idx);
+    }
+  }
+
+  /**
+   * Evaluates step(idx) for every idx in [0, count), split across the
+   * thread pool when threading is enabled.  Steps must only write to the
+   * entries they are given.
+   * @returns true if every evaluation returned true
+   */
+  template<typename Step> bool ForEachIndex(const Step &step, int count)
+  {
+    int workers = 1;
+    if(CryptoFactory::GetInstance().GetThreadingType() ==
+        CryptoFactory::MultiThreaded)
+    {
+      workers = qMax(1, qMin(QThread::idealThreadCount(), count));
+    }
+
+    if(workers == 1) {
+      for(int idx = 0; idx < count; idx++) {
+        if(!step(idx)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    int per_chunk = count / workers + (count % workers ? 1 : 0);
+    QList<StepChunk<Step> > chunks;
+    for(int start = 0; start < count; start += per_chunk) {
+      StepChunk<Step> chunk;
+      chunk.step = &step;
+      chunk.start = start;
+      chunk.end = qMin(count, start + per_chunk);
+      chunk.valid = true;
+      chunks.append(chunk);
+    }
+
+    QtConcurrent::blockingMap(chunks, EvaluateChunk<Step>);
+
+    foreach(const StepChunk<Step> &chunk, chunks) {
+      if(!chunk.valid) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Checks that both halves of input pair idx are in the group
+   */
+  class InputCheck {
+    public:
+      InputCheck(const CppDsaPublicKey &key, const QVector<Integer> &X,
+          const QVector<Integer> &Y) :
+        _key(key), _X(X.constData()), _Y(Y.constData())
+      {
+      }
+
+      bool operator()(int idx) const
+      {
+        if(!_key.InGroup(_X[idx])) {
+          qCritical() << "Shared" << idx << "not within group";
+          return false;
+        }
+        if(!_key.InGroup(_Y[idx])) {
+          qCritical() << "Encrypted" << idx << "not within group";
+          return false;
+        }
+        return true;
+      }
+
+    private:
+      const CppDsaPublicKey &_key;
+      const Integer *_X;
+      const Integer *_Y;
+  };
+
+  /**
+   * B[idx] = g^p[idx] / U[idx]
+   */
+  class ComputeB {
+    public:
+      ComputeB(const FixedPow &g_pow, const Integer &modulus,
+          const QVector<Integer> &p, const QVector<Integer> &U,
+          QVector<Integer> &B) :
+        _g_pow(g_pow), _modulus(modulus),
+        _p(p.constData()), _U(U.constData()), _B(B.data())
+      {
+      }
+
+      bool operator()(int idx) const
+      {
+        _B[idx] = (_g_pow.Pow(_p[idx]) * _U[idx].ModInverse(_modulus)) % _modulus;
+        return true;
+      }
+
+    private:
+      const FixedPow &_g_pow;
+      const Integer _modulus;
+      const Integer *_p;
+      const Integer *_U;
+      Integer *_B;
+  };
+
+  /**
+   * R_t[idx] = A[idx] * B[idx]^lambda * g^-t and
+   * S_t[idx] = C[idx] * D[idx]^lambda * Gamma^-t
+   */
+  class ComputeRS {
+    public:
+      ComputeRS(const Integer &modulus, const Integer &lambda,
+          const Integer &U_, const Integer &W_,
+          const QVector<Integer> &A, const QVector<Integer> &B,
+          const QVector<Integer> &C, const QVector<Integer> &D,
+          QVector<Integer> &R_t, QVector<Integer> &S_t) :
+        _modulus(modulus), _lambda(lambda), _U_(U_), _W_(W_),
+        _A(A.constData()), _B(B.constData()), _C(C.constData()),
+        _D(D.constData()), _R_t(R_t.data()), _S_t(S_t.data())
+      {
+      }
+
+      bool operator()(int idx) const
+      {
+        Integer R = (_A[idx] * _B[idx].Pow(_lambda, _modulus)) % _modulus;
+        _R_t[idx] = (R * _U_) % _modulus;
+
+        Integer S = (_C[idx] * _D[idx].Pow(_lambda, _modulus)) % _modulus;
+        _S_t[idx] = (S * _W_) % _modulus;
+        return true;
+      }
+
+    private:
+      const Integer _modulus;
+      const Integer _lambda;
+      const Integer _U_;
+      const Integer _W_;
+      const Integer *_A;
+      const Integer *_B;
+      const Integer *_C;
+      const Integer *_D;
+      Integer *_R_t;
+      Integer *_S_t;
+  };
+
+  /**
+   * Checks Theta[idx] of the SimpleKShuffle, idx in [0, 2k)
+   */
+  class ThetaCheck {
+    public:
+      ThetaCheck(const FixedPow &g_pow, const FixedPow &gamma_pow,
+          const Integer &modulus, const Integer &subgroup, const Integer &c,
+          const QVector<Integer> &Theta, const QVector<Integer> &alpha,
+          const QVector<Integer> &R_t, const QVector<Integer> &S_t) :
+        _g_pow(g_pow), _gamma_pow(gamma_pow),
+        _modulus(modulus), _subgroup(subgroup), _c(c), _k(R_t.size()),
+        _Theta(Theta.constData()), _alpha(alpha.constData()),
+        _R_t(R_t.constData()), _S_t(S_t.constData())
+      {
+      }
+
+      bool operator()(int idx) const
+      {
+        Integer expected;
+        if(idx == 0) {
+          expected = (_R_t[0].Pow(_c, _modulus) *
+              _S_t[0].Pow(_subgroup - _alpha[0], _modulus)) % _modulus;
+        } else if(idx < _k) {
+          expected = (_R_t[idx].Pow(_alpha[idx - 1], _modulus) *
+              _S_t[idx].Pow(_subgroup - _alpha[idx], _modulus)) % _modulus;
+        } else if(idx < 2 * _k - 1) {
+          expected = (_gamma_pow.Pow(_alpha[idx - 1]) *
+              _g_pow.Pow(_subgroup - _alpha[idx])) % _modulus;
+        } else {
+          expected = (_gamma_pow.Pow(_alpha[2 * _k - 2]) *
+              _g_pow.Pow(_subgroup - _c)) % _modulus;
+        }
+
+        if(_Theta[idx] != expected) {
+          qDebug().nospace() << "Failed Theta[" << idx <<"] check";
+          return false;
+        }
+        return true;
+      }
+
+    private:
+      const FixedPow &_g_pow;
+      const FixedPow &_gamma_pow;
+      const Integer _modulus;
+      const Integer _subgroup;
+      const Integer _c;
+      const int _k;
+      const Integer *_Theta;
+      const Integer *_alpha;
+      const Integer *_R_t;
+      const Integer *_S_t;
+  };
+
+  /**
+   * Checks Gamma^sigma[idx] = W[idx] * D[idx]
+   */
+  class SigmaCheck {
+    public:
+      SigmaCheck(const FixedPow &gamma_pow, const Integer &modulus,
+          const QVector<Integer> &sigma, const QVector<Integer> &W,
+          const QVector<Integer> &D) :
+        _gamma_pow(gamma_pow), _modulus(modulus),
+        _sigma(sigma.constData()), _W(W.constData()), _D(D.constData())
+      {
+      }
+
+      bool operator()(int idx) const
+      {
+        if(_gamma_pow.Pow(_sigma[idx]) != ((_W[idx] * _D[idx]) % _modulus)) {
+          qDebug().nospace() << "Failed sigma[" << idx << "] check";
+          return false;
+        }
+        return true;
+      }
+
+    private:
+      const FixedPow &_gamma_pow;
+      const Integer _modulus;
+      const Integer *_sigma;
+      const Integer *_W;
+      const Integer *_D;
+  };
+
+  /**
+   * Checks the proof that decrypted[idx] is a decryption of
+   * shuffle_output[idx], c holds the challenge for each index
+   */
+  class DecryptionCheck {
+    public:
+      DecryptionCheck(const Integer &modulus,
+          const QVector<QByteArray> &shuffle_output,
+          const QVector<QByteArray> &decrypted,
+          const QVector<QPair<Integer, Integer> > &decryption_proof,
+          const QVector<Integer> &c) :
+        _modulus(modulus),
+        _shuffle_output(shuffle_output.constData()),
+        _decrypted(decrypted.constData()),
+        _decryption_proof(decryption_proof.constData()),
+        _c(c.constData())
+      {
+      }
+
+      bool operator()(int idx) const
+      {
+        QDataStream tstream_in(_shuffle_output[idx]);
+        Integer shared_in, secret_in;
+        tstream_in >> shared_in >> secret_in;
+
+        QDataStream tstream_out(_decrypted[idx]);
+        Integer shared_out, secret_out;
+        tstream_out >> shared_out >> secret_out;
+
+        Integer pair = (secret_in * secret_out.ModInverse(_modulus)) % _modulus;
+        Integer T = _decryption_proof[idx].first;
+        Integer s = _decryption_proof[idx].second;
+        if(shared_in != shared_out) {
+          qDebug() << "Decryption error";
+          return false;
+        }
+
+        if(shared_out.Pow(s, _modulus) != ((T * pair.Pow(_c[idx], _modulus)) % _modulus)) {
+          qDebug() << "Invalid decryption proof";
+          return false;
+        }
+        return true;
+      }
+
+    private:
+      const Integer _modulus;
+      const QByteArray *_shuffle_output;
+      const QByteArray *_decrypted;
+      const QPair<Integer, Integer> *_decryption_proof;
+      const Integer *_c;
+  };
+}
+
   bool CppNeffShuffle::Shuffle(const QVector<QByteArray> &input,
       const QSharedPointer<AsymmetricKey> &private_key,
       const QVector<QSharedPointer<AsymmetricKey> > &remaining_keys,
@@ -20,6 +379,9 @@ namespace Crypto {
       return false;
     }
 
+    // The many intermediate Integers are drawn from an arena
+    Utils::Arena arena;
+
     // Setup
     int k = input.size();
     QVector<Integer> X, Y;
@@ -46,6 +408,11 @@ namespace Crypto {
       h = (h * tkey->GetPublicElement()) % modulus;
     }
 
+    // The generator and the combined public key are each a base for
+    // several exponentiations per input
+    const FixedPow g_pow(generator, modulus, subgroup);
+    const FixedPow h_pow(h, modulus, subgroup);
+
     // Non-interactive setup
     proof.clear();
     QDataStream stream(&proof, QIODevice::WriteOnly);
@@ -69,11 +436,11 @@ namespace Crypto {
     
     for(int idx = 0; idx < k; idx++) {
       Integer X_bar_l = (X[idx] *
-          generator.Pow(beta[idx], modulus)) % modulus;
+          g_pow.Pow(beta[idx])) % modulus;
       X_bar.append(X_bar_l);
 
       Integer Y_bar_l = (Y[idx] *
-          h.Pow(beta[idx], modulus)) % modulus;
+          h_pow.Pow(beta[idx])) % modulus;
       Y_bar.append(Y_bar_l);
 
       QByteArray toutput;
@@ -114,26 +481,31 @@ namespace Crypto {
 
     // Part 1 -- Generation of initial shares
 
-    Integer Gamma = generator.Pow(gamma, modulus);
+    Integer Gamma = g_pow.Pow(gamma);
     QVector<Integer> A, C, U, W;
     for(int idx = 0; idx < k; idx++) {
-      A.append(generator.Pow(a[idx], modulus));
-      U.append(generator.Pow(u[idx], modulus));
-      W.append(generator.Pow((gamma * w[idx]) % subgroup, modulus));
+      A.append(g_pow.Pow(a[idx]));
+      U.append(g_pow.Pow(u[idx]));
+      W.append(g_pow.Pow((gamma * w[idx]) % subgroup));
     }
 
     for(int idx = 0; idx < k; idx++) {
       C.append(A[pi[idx]].Pow(gamma, modulus));
     }
 
-    Integer delta_sum = tau_0, x_multi = 1, y_multi = 1;
+    Integer delta_sum = tau_0;
+    QList<Integer> multi_exps;
     for(int idx = 0; idx < k; idx++) {
       delta_sum = (delta_sum + w[idx] * beta[pi[idx]]) % subgroup;
-      x_multi = (x_multi * X[idx].Pow((w[inv_pi[idx]] - u[idx]) % subgroup, modulus)) % modulus;
-      y_multi = (y_multi * Y[idx].Pow((w[inv_pi[idx]] - u[idx]) % subgroup, modulus)) % modulus;
+      multi_exps.append((w[inv_pi[idx]] - u[idx]) % subgroup);
     }
-    Integer Delta_0 = (generator.Pow(delta_sum, modulus) * x_multi) % modulus;
-    Integer Delta_1 = (h.Pow(delta_sum, modulus) * y_multi) % modulus;
+    multi_exps = AbstractGroup::ReduceExponents(multi_exps, subgroup);
+
+    const MultiPow multi(MultiplyMod(modulus), Integer(1));
+    Integer x_multi = multi.Compute(X, multi_exps);
+    Integer y_multi = multi.Compute(Y, multi_exps);
+    Integer Delta_0 = (g_pow.Pow(delta_sum) * x_multi) % modulus;
+    Integer Delta_1 = (h_pow.Pow(delta_sum) * y_multi) % modulus;
 
     stream << output << Gamma << A << C << U << W << Delta_0 << Delta_1;
 
@@ -145,7 +517,7 @@ namespace Crypto {
     QVector<Integer> p, B;
     for(int idx = 0; idx < k; idx++) {
       p.append(rand.GetInteger(2, subgroup));
-      B.append((generator.Pow(p[idx], modulus) *
+      B.append((g_pow.Pow(p[idx]) *
             U[idx].ModInverse(modulus)) % modulus);
     }
 
@@ -158,7 +530,7 @@ namespace Crypto {
 
     for(int idx = 0; idx < k; idx++) {
       d.append((gamma * b[pi[idx]]) % subgroup);
-      D.append(generator.Pow(d[idx], modulus));
+      D.append(g_pow.Pow(d[idx]));
     }
 
     stream << D;
@@ -213,16 +585,16 @@ namespace Crypto {
     }
 
     QVector<Integer> Theta;
-    Theta.append(generator.Pow(subgroup - (theta[0] * s_t[0]) % subgroup, modulus));
+    Theta.append(g_pow.Pow(subgroup - (theta[0] * s_t[0]) % subgroup));
     for(int idx = 1; idx < k; idx++) {
-      Theta.append(generator.Pow((theta[idx - 1] * r_t[idx] - theta[idx] * s_t[idx]) % subgroup, modulus));
+      Theta.append(g_pow.Pow((theta[idx - 1] * r_t[idx] - theta[idx] * s_t[idx]) % subgroup));
     }
 
     for(int idx = k; idx < (2 * k - 1); idx++) {
-      Theta.append(generator.Pow((gamma * theta[idx - 1] - theta[idx]) % subgroup, modulus));
+      Theta.append(g_pow.Pow((gamma * theta[idx - 1] - theta[idx]) % subgroup));
     }
 
-    Theta.append(generator.Pow((gamma * theta[2 * k - 2]) % subgroup, modulus));
+    Theta.append(g_pow.Pow((gamma * theta[2 * k - 2]) % subgroup));
 
     stream << Theta;
 
@@ -300,6 +672,7 @@ namespace Crypto {
       return false;
     }
 
+    Utils::Arena arena;
     int k = input.size();
     Integer modulus = pkey->GetModulus();
     Integer subgroup = pkey->GetSubgroup();
@@ -323,20 +696,16 @@ namespace Crypto {
       QDataStream tstream(input[idx]);
       Integer shared, enc;
       tstream >> shared >> enc;
-
-      if(!pkey->InGroup(shared)) {
-        qCritical() << "Shared" << idx << "not within group";
-        return false;
-      }
-      if(!pkey->InGroup(enc)) {
-        qCritical() << "Encrypted" << idx << "not within group";
-        return false;
-      }
-
       X.append(shared);
       Y.append(enc);
     }
 
+    if(!ForEachIndex(InputCheck(*pkey, X, Y), k)) {
+      return false;
+    }
+
+    const FixedPow g_pow(generator, modulus, subgroup);
+
     // Non-interactive setup
     QDataStream ostream(input_proof);
     QByteArray proof;
@@ -363,6 +732,9 @@ namespace Crypto {
     }
     istream << shuffle_output << Gamma << A << C << U << W << Delta_0 << Delta_1;
 
+    // Gamma is a base for roughly 2k exponentiations
+    const FixedPow gamma_pow(Gamma, modulus, subgroup);
+
     QVector<Integer> X_bar, Y_bar;
     for(int idx = 0; idx < input.size(); idx++) {
       if(idx > 0 && shuffle_output[idx - 1] > shuffle_output[idx]) {
@@ -377,17 +749,26 @@ namespace Crypto {
       Y_bar.append(enc);
     }
 
+    // The outputs are batched into iota_0 and iota_1 with the inputs
+    if(!ForEachIndex(InputCheck(*pkey, X_bar, Y_bar), k)) {
+      return false;
+    }
+
     // Part 2 -- Non-Interactive Verifier
     hash.Update(base_seed);
     cseed = hash.ComputeHash(proof);
     rand = CppRandom(cseed);
 
-    QVector<Integer> p, B;
+    if(U.size() != k) {
+      qDebug() << "U is incorrect length:" << U.size();
+      return false;
+    }
+
+    QVector<Integer> p, B(k);
     for(int idx = 0; idx < k; idx++) {
       p.append(rand.GetInteger(2, subgroup));
-      B.append((generator.Pow(p[idx], modulus) *
-            U[idx].ModInverse(modulus)) % modulus);
     }
+    ForEachIndex(ComputeB(g_pow, modulus, p, U, B), k);
 
     // Part 3 -- Prover
 
@@ -410,6 +791,10 @@ namespace Crypto {
     QVector<Integer> sigma;
 
     ostream >> tau >> sigma;
+    if(sigma.size() != k) {
+      qDebug() << "Sigma is incorrect length:" << sigma.size();
+      return false;
+    }
     istream << tau << sigma;
 
     // Part 6 -- SimpleKShuffle (R, S, G, Gamma)
@@ -451,69 +836,43 @@ namespace Crypto {
 
     // Part 6.5 - Verifier
 
-    QVector<Integer> R, S, R_t, S_t;
-    Integer U_ = generator.Pow(subgroup - t, modulus);
-    Integer W_ = Gamma.Pow(subgroup - t, modulus);
-
-    for(int idx = 0; idx < k; idx++) {
-      R.append((A[idx] * B[idx].Pow(lambda, modulus)) % modulus);
-      R_t.append((R[idx] * U_) % modulus);
-
-      S.append((C[idx] * D[idx].Pow(lambda, modulus)) % modulus);
-      S_t.append((S[idx] * W_) % modulus);
-    }
-
-    if(Theta[0] !=
-        ((R_t[0].Pow(c, modulus) *
-         S_t[0].Pow(subgroup - alpha[0], modulus)) % modulus))
+    if(A.size() != k || C.size() != k || D.size() != k || W.size() != k ||
+        alpha.size() != 2 * k - 1)
     {
-      qDebug() << "Failed Theta[0] check";
+      qDebug() << "Invalid proof lengths";
       return false;
     }
 
-    for(int idx = 1; idx < k; idx++) {
-      if(Theta[idx] !=
-          ((R_t[idx].Pow(alpha[idx - 1], modulus) *
-            S_t[idx].Pow(subgroup - alpha[idx], modulus)) % modulus))
-      {
-        qDebug().nospace() << "Failed Theta[" << idx <<"] check";
-        return false;
-      }
-    }
-
-    for(int idx = k; idx < 2 * k - 1; idx++) {
-      if(Theta[idx] !=
-          ((Gamma.Pow(alpha[idx - 1], modulus) *
-            generator.Pow(subgroup - alpha[idx], modulus)) % modulus))
-      {
-        qDebug().nospace() << "Failed Theta[" << idx <<"] check";
-        return false;
-      }
-    }
+    // The checks below are independent per index and are split across cores
+    QVector<Integer> R_t(k), S_t(k);
+    Integer U_ = g_pow.Pow(subgroup - t);
+    Integer W_ = gamma_pow.Pow(subgroup - t);
+    ForEachIndex(ComputeRS(modulus, lambda, U_, W_, A, B, C, D, R_t, S_t), k);
 
-    if(Theta[2 * k - 1] !=
-        ((Gamma.Pow(alpha[2 * k - 2], modulus) *
-          generator.Pow(subgroup - c, modulus)) % modulus))
+    if(!ForEachIndex(ThetaCheck(g_pow, gamma_pow, modulus, subgroup, c,
+            Theta, alpha, R_t, S_t), 2 * k))
     {
-      qDebug().nospace() << "Failed Theta[" << (2 * k - 1) <<"] check";
       return false;
     }
 
     // Part 7 -- Verifier
 
-    Integer iota_0 = 1, iota_1 = 1;
+    // iota_0 = prod X_bar[i]^sigma[i] * X[i]^-p[i], likewise iota_1 over Y
+    QList<Integer> iota_exps = sigma.toList();
     for(int idx = 0; idx < k; idx++) {
-      iota_0 = (iota_0 * X_bar[idx].Pow(sigma[idx], modulus) *
-          X[idx].Pow(subgroup - p[idx], modulus)) % modulus;
-      iota_1 = (iota_1 * Y_bar[idx].Pow(sigma[idx], modulus) *
-          Y[idx].Pow(subgroup - p[idx], modulus)) % modulus;
-      if(Gamma.Pow(sigma[idx], modulus) != ((W[idx] * D[idx]) % modulus)) {
-        qDebug().nospace() << "Failed sigma[" << idx << "] check";
-        return false;
-      }
+      iota_exps.append(subgroup - p[idx]);
     }
+    iota_exps = AbstractGroup::ReduceExponents(iota_exps, subgroup);
 
-    if(iota_0 != ((Delta_0 * generator.Pow(tau, modulus)) % modulus)) {
+    const MultiPow multi(MultiplyMod(modulus), Integer(1));
+    Integer iota_0 = multi.Compute(X_bar + X, iota_exps);
+    Integer iota_1 = multi.Compute(Y_bar + Y, iota_exps);
+
+    if(!ForEachIndex(SigmaCheck(gamma_pow, modulus, sigma, W, D), k)) {
+      return false;
+    }
+
+    if(iota_0 != ((Delta_0 * g_pow.Pow(tau)) % modulus)) {
       qDebug() << "Failed Iota_0 check";
       return false;
     }
@@ -542,28 +901,50 @@ namespace Crypto {
     cseed = hash.ComputeHash(proof);
     rand = CppRandom(cseed);
 
+    // The challenges come from a single stream, draw them before checking
+    QVector<Integer> decryption_c;
     for(int idx = 0; idx < k; idx++) {
-      QDataStream tstream_in(shuffle_output[idx]);
-      Integer shared_in, secret_in;
-      tstream_in >> shared_in >> secret_in;
+      decryption_c.append(rand.GetInteger(2, subgroup));
+    }
 
-      QDataStream tstream_out(decrypted[idx]);
-      Integer shared_out, secret_out;
-      tstream_out >> shared_out >> secret_out;
+    if(!ForEachIndex(DecryptionCheck(modulus, shuffle_output, decrypted,
+            decryption_proof, decryption_c), k))
+    {
+      return false;
+    }
 
-      Integer pair = (secret_in * secret_out.ModInverse(modulus)) % modulus;
-      Integer T = decryption_proof[idx].first;
-      Integer s = decryption_proof[idx].second;
-      Integer c = rand.GetInteger(2, subgroup);
-      if(shared_in != shared_out) {
-        qDebug() << "Decryption error";
-        return false;
-      }
+    output = decrypted;
+    return true;
+  }
 
-      if(shared_out.Pow(s, modulus) != ((T * pair.Pow(c, modulus)) % modulus)) {
-        qDebug() << "Invalid decryption proof";
-        return false;
-      }
+  bool CppNeffShuffle::GetOutput(const QByteArray &input_proof,
+      QVector<QByteArray> &output)
+  {
+    QDataStream ostream(input_proof);
+
+    QVector<QByteArray> shuffle_output;
+    Integer Gamma;
+    QVector<Integer> A, C, U, W;
+    Integer Delta_0, Delta_1;
+    ostream >> shuffle_output >> Gamma >> A >> C >> U >> W >> Delta_0 >> Delta_1;
+
+    QVector<Integer> D;
+    Integer tau;
+    QVector<Integer> sigma, Theta, alpha;
+    ostream >> D >> tau >> sigma >> Theta >> alpha;
+
+    QVector<QByteArray> decrypted;
+    QVector<QPair<Integer, Integer> > decryption_proof;
+    ostream >> decrypted >> decryption_proof;
+
+    if(ostream.status() != QDataStream::Ok) {
+      qDebug() << "Unable to parse transcript";
+      return false;
+    }
+
+    if(decrypted.size() != shuffle_output.size()) {
+      qDebug() << "Decrypted size != shuffled size";
+      return false;
     }
 
     output = decrypted;
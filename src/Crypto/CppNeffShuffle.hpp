@@ -42,6 +42,17 @@ namespace Crypto {
           const QVector<QSharedPointer<AsymmetricKey> > &keys,
           const QByteArray &input_proof,
           QVector<QByteArray> &output);
+
+      /**
+       * Extracts the shuffled and decrypted messages claimed by a transcript
+       * without verifying it, so the next shuffler may begin while the
+       * transcript is verified.
+       * @param input_proof a transcript produced by Shuffle
+       * @param output the claimed shuffled and decrypted messages
+       * @returns false if the transcript cannot be parsed
+       */
+      static bool GetOutput(const QByteArray &input_proof,
+          QVector<QByteArray> &output);
   };
 }
 }
@@ -1,7 +1,9 @@
 #include "CppPrivateKey.hpp"
 #include "CppRandom.hpp"
+#include "Utils/Metrics.hpp"
 
 using namespace CryptoPP;
+using Dissent::Utils::Metrics;
 
 namespace Dissent {
 namespace Crypto {
@@ -47,6 +49,10 @@ namespace Crypto {
       return QByteArray();
     }
 
+    static const Metrics::Histogram metric = Metrics::GetHistogram(
+        "dissent_crypto_seconds", "Time spent in crypto operations",
+        Metrics::Label("op", "sign") + "," + Metrics::Label("key", "Rsa"));
+    Metrics::ScopedTimer timer(metric);
     const RSA::PrivateKey &private_key = *_private_key;
     RSASS<PKCS1v15, SHA>::Signer signer(private_key);
     QByteArray sig(signer.MaxSignatureLength(), 0);
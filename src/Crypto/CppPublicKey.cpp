@@ -1,8 +1,10 @@
 #include "CppPublicKey.hpp"
 #include "CppPrivateKey.hpp"
 #include "CppRandom.hpp"
+#include "Utils/Metrics.hpp"
 
 using namespace CryptoPP;
+using Dissent::Utils::Metrics;
 
 namespace Dissent {
 namespace Crypto {
@@ -102,6 +104,10 @@ namespace Crypto {
       return false;
     }
 
+    static const Metrics::Histogram metric = Metrics::GetHistogram(
+        "dissent_crypto_seconds", "Time spent in crypto operations",
+        Metrics::Label("op", "verify") + "," + Metrics::Label("key", "Rsa"));
+    Metrics::ScopedTimer timer(metric);
     const RSA::PublicKey &public_key = *_public_key;
     RSASS<PKCS1v15, SHA>::Verifier verifier(public_key);
     return verifier.VerifyMessage(reinterpret_cast<const byte *>(data.data()),
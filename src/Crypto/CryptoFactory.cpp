@@ -1,4 +1,6 @@
+#include <QCoreApplication>
 #include <QDebug>
+#include <QThread>
 
 #include "CppLibrary.hpp"
 #include "CppDsaLibrary.hpp"
@@ -20,12 +22,22 @@ namespace Crypto {
     _onion(new OnionEncryptor()),
     _library_name(CryptoPP),
     _threading_type(SingleThreaded),
+    _hash_name(Sha1),
     _previous(0)
   {
   }
 
+  void CryptoFactory::CheckThread()
+  {
+    QCoreApplication *app = QCoreApplication::instance();
+    if(app && QThread::currentThread() != app->thread()) {
+      qWarning() << "CryptoFactory configured outside of the application thread";
+    }
+  }
+
   void CryptoFactory::SetThreading(ThreadingType type)
   {
+    CheckThread();
     _threading_type = type;
     switch(type) {
       case MultiThreaded:
@@ -40,8 +52,49 @@ namespace Crypto {
     }
   }
 
+  void CryptoFactory::SetHash(HashName type)
+  {
+    CheckThread();
+    switch(type) {
+      case Sha1:
+      case Sha256:
+      case Blake2b:
+        _hash_name = type;
+        break;
+      default:
+        qCritical() << "Invalid hash type:" << type;
+        _hash_name = Sha1;
+    }
+  }
+
+  bool CryptoFactory::ParseHashName(const QString &name, HashName &hash)
+  {
+    for(int idx = Sha1; idx <= Blake2b; idx++) {
+      if(name == HashNameToString(static_cast<HashName>(idx))) {
+        hash = static_cast<HashName>(idx);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  QString CryptoFactory::HashNameToString(HashName hash)
+  {
+    switch(hash) {
+      case Sha1:
+        return "sha1";
+      case Sha256:
+        return "sha256";
+      case Blake2b:
+        return "blake2b";
+      default:
+        return QString();
+    }
+  }
+
   void CryptoFactory::SetLibrary(LibraryName type)
   {
+    CheckThread();
     if(_previous != 0) {
       AsymmetricKey::DefaultKeySize = std::min(_previous,
           AsymmetricKey::DefaultKeySize);
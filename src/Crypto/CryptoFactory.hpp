@@ -2,11 +2,18 @@
 #define DISSENT_CRYPTO_CRYPTO_FACTORY_H_GUARD
 
 #include <QScopedPointer>
+#include <QString>
 #include "OnionEncryptor.hpp"
 #include "Library.hpp"
 
 namespace Dissent {
 namespace Crypto {
+  /**
+   * Process-wide choice of crypto library and onion encryptor. The
+   * libraries only construct objects and keep no state of their own, so
+   * every thread shares them; the factory must therefore be configured
+   * on the application thread before node threads start.
+   */
   class CryptoFactory {
     public:
       enum ThreadingType {
@@ -21,6 +28,12 @@ namespace Crypto {
         Null
       };
 
+      enum HashName {
+        Sha1,
+        Sha256,
+        Blake2b
+      };
+
       /**
        * Returns a reference to the singleton
        */
@@ -46,6 +59,32 @@ namespace Crypto {
        */
       inline LibraryName GetLibraryName() { return _library_name; }
 
+      /**
+       * Sets the hash function returned by the CryptoPP based libraries,
+       * all members of a group must agree on it
+       */
+      void SetHash(HashName type);
+
+      /**
+       * Returns the current hash function name
+       */
+      inline HashName GetHashName() { return _hash_name; }
+
+      /**
+       * Converts a hash function's configuration name, i.e., "sha1",
+       * "sha256", or "blake2b"
+       * @param name the name
+       * @param hash set to the hash function when the name is known
+       * @returns false if the name is unknown
+       */
+      static bool ParseHashName(const QString &name, HashName &hash);
+
+      /**
+       * Returns the configuration name of a hash function
+       * @param hash the hash function
+       */
+      static QString HashNameToString(HashName hash);
+
       /**
        * Return the Onion Encryptor
        */
@@ -72,12 +111,18 @@ namespace Crypto {
        */
       explicit CryptoFactory(); 
 
+      /**
+       * Warns when the factory is changed while node threads may be using it
+       */
+      void CheckThread();
+
       /**
        * No copying of singleton objects
        */
       Q_DISABLE_COPY(CryptoFactory)
       LibraryName _library_name;
       ThreadingType _threading_type;
+      HashName _hash_name;
       int _previous;
   };
 }
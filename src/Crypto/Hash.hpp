@@ -2,6 +2,7 @@
 #define DISSENT_CRYPTO_HASH_H_GUARD
 
 #include <QByteArray>
+#include <QVector>
 
 namespace Dissent {
 namespace Crypto {
@@ -16,10 +17,16 @@ namespace Crypto {
       virtual ~Hash() {}
 
       /**
-       * Returns the blocksize of the underlying hash function
+       * Returns the size of the digest in bytes
        */
       virtual int GetDigestSize() = 0;
 
+      /**
+       * Returns the number of bytes the underlying hash function compresses
+       * at a time, as needed by HMAC
+       */
+      virtual int GetBlockSize() const = 0;
+
       /**
        * Restarts the state of the hash object
        */
@@ -41,6 +48,20 @@ namespace Crypto {
        * @param data the data to hash
        */
       virtual QByteArray ComputeHash(const QByteArray &data) = 0;
+
+      /**
+       * Restarts the hash object and calculates the hash of each input
+       * independently, implementations may hash several inputs at once
+       * @param data the inputs to hash
+       */
+      virtual QVector<QByteArray> ComputeHashes(const QVector<QByteArray> &data)
+      {
+        QVector<QByteArray> hashes(data.count());
+        for(int idx = 0; idx < data.count(); idx++) {
+          hashes[idx] = ComputeHash(data[idx]);
+        }
+        return hashes;
+      }
   };
 }
 }
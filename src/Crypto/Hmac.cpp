@@ -0,0 +1,49 @@
+#include "CryptoFactory.hpp"
+#include "Hmac.hpp"
+#include "Library.hpp"
+
+namespace Dissent {
+namespace Crypto {
+  Hmac::Hmac(const QByteArray &key) :
+    _hash(CryptoFactory::GetInstance().GetLibrary()->GetHashAlgorithm())
+  {
+    const int block_size = _hash->GetBlockSize();
+    QByteArray block = key.size() > block_size ? _hash->ComputeHash(key) : key;
+    block.append(QByteArray(block_size - block.size(), 0));
+
+    _inner_pad = block;
+    _outer_pad = block;
+    for(int idx = 0; idx < block_size; idx++) {
+      _inner_pad[idx] = _inner_pad[idx] ^ 0x36;
+      _outer_pad[idx] = _outer_pad[idx] ^ 0x5c;
+    }
+  }
+
+  QByteArray Hmac::ComputeMac(const QByteArray &data)
+  {
+    _hash->Restart();
+    _hash->Update(_inner_pad);
+    _hash->Update(data);
+    QByteArray inner = _hash->ComputeHash();
+
+    _hash->Restart();
+    _hash->Update(_outer_pad);
+    _hash->Update(inner);
+    return _hash->ComputeHash();
+  }
+
+  bool Hmac::VerifyMac(const QByteArray &data, const QByteArray &mac)
+  {
+    QByteArray expected = ComputeMac(data);
+    if(expected.size() != mac.size()) {
+      return false;
+    }
+
+    char diff = 0;
+    for(int idx = 0; idx < expected.size(); idx++) {
+      diff |= expected[idx] ^ mac[idx];
+    }
+    return diff == 0;
+  }
+}
+}
@@ -0,0 +1,56 @@
+#ifndef DISSENT_CRYPTO_HMAC_H_GUARD
+#define DISSENT_CRYPTO_HMAC_H_GUARD
+
+#include <QByteArray>
+#include <QScopedPointer>
+
+#include "Hash.hpp"
+
+namespace Dissent {
+namespace Crypto {
+  /**
+   * Keyed-hash message authentication code (RFC 2104) built on the current
+   * library's hash algorithm
+   */
+  class Hmac {
+    public:
+      /**
+       * Constructor
+       * @param key the secret key, keys longer than the hash's block are
+       * hashed
+       */
+      explicit Hmac(const QByteArray &key);
+
+      /**
+       * Returns the MAC of the given data
+       * @param data the data to authenticate
+       */
+      QByteArray ComputeMac(const QByteArray &data);
+
+      /**
+       * Returns true if mac is the MAC of the given data, the comparison
+       * takes the same time wherever the two differ
+       * @param data the authenticated data
+       * @param mac the MAC to check
+       */
+      bool VerifyMac(const QByteArray &data, const QByteArray &mac);
+
+    private:
+      QScopedPointer<Hash> _hash;
+      QByteArray _inner_pad;
+      QByteArray _outer_pad;
+
+      /**
+       * No copying
+       */
+      Hmac(const Hmac &);
+
+      /**
+       * No copying
+       */
+      Hmac &operator=(const Hmac &);
+  };
+}
+}
+
+#endif
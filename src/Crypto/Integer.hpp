@@ -4,6 +4,8 @@
 #include <QByteArray>
 #include <QString>
 
+#include "Utils/Metrics.hpp"
+
 #include "CryptoFactory.hpp"
 #include "IntegerData.hpp"
 
@@ -165,6 +167,11 @@ namespace Crypto {
        */
       Integer Pow(const Integer &pow, const Integer &mod) const
       {
+        static const Utils::Metrics::Histogram metric = Utils::Metrics::GetHistogram(
+            "dissent_crypto_seconds", "Time spent in crypto operations",
+            Utils::Metrics::Label("op", "pow") + "," +
+            Utils::Metrics::Label("key", "Integer"));
+        Utils::Metrics::ScopedTimer timer(metric);
         return Integer(_data->Pow(pow._data.constData(), mod._data.constData()));
       }
 
@@ -180,6 +187,11 @@ namespace Crypto {
       Integer PowCascade(const Integer &x1, const Integer &e1,
           const Integer &x2, const Integer &e2) const
       {
+        static const Utils::Metrics::Histogram metric = Utils::Metrics::GetHistogram(
+            "dissent_crypto_seconds", "Time spent in crypto operations",
+            Utils::Metrics::Label("op", "pow_cascade") + "," +
+            Utils::Metrics::Label("key", "Integer"));
+        Utils::Metrics::ScopedTimer timer(metric);
         return Integer(_data->PowCascade(x1._data.constData(), e1._data.constData(),
             x2._data.constData(), e2._data.constData()));
       }
@@ -1,23 +1,34 @@
 #ifndef DISSENT_CRYPTO_INTEGER_DATA_H_GUARD
 #define DISSENT_CRYPTO_INTEGER_DATA_H_GUARD
 
+#include <QAtomicInt>
 #include <QSharedData>
 #include <QByteArray>
 #include <QString>
+#include <QThread>
 
+#include "../Utils/Arena.hpp"
 #include "../Utils/Utils.hpp"
 
 namespace Dissent {
 namespace Crypto {
   /**
-   * "Big" IntegerData wrapper
+   * "Big" IntegerData wrapper, allocated from the thread's Utils::Arena if
+   * there is one.  The byte array, canonical and string representations are
+   * generated lazily, at most once, so shared values, such as group
+   * parameters and public keys, may be serialized from several threads.
    */
-  class IntegerData : public QSharedData {
+  class IntegerData : public QSharedData, public Utils::ArenaAllocated {
     public:
       /**
        * Base constructor
        */
-      explicit IntegerData() {}
+      explicit IntegerData() :
+        _byte_array_state(Empty),
+        _canonical_state(Empty),
+        _string_state(Empty)
+      {
+      }
 
       /**
        * Destructor
@@ -29,10 +40,7 @@ namespace Crypto {
        */
       const QByteArray &GetByteArray() const
       {
-        if(_byte_array.isEmpty()) {
-          IntegerData *cfree_this = const_cast<IntegerData *>(this);
-          cfree_this->GenerateByteArray();
-        }
+        Prime(_byte_array_state, &IntegerData::GenerateByteArray);
         return _byte_array;
       }
 
@@ -41,10 +49,7 @@ namespace Crypto {
        */
       const QByteArray &GetCanonicalRep() const
       {
-        if(_canonical.isEmpty()) {
-          IntegerData *cfree_this = const_cast<IntegerData *>(this);
-          cfree_this->GenerateCanonicalRep();
-        }
+        Prime(_canonical_state, &IntegerData::GenerateCanonicalRep);
         return _canonical;
       }
 
@@ -53,10 +58,7 @@ namespace Crypto {
        */
       const QString &ToString() const
       {
-        if(_string.isEmpty()) {
-          IntegerData *cfree_this = const_cast<IntegerData *>(this);
-          cfree_this->_string = Utils::ToUrlSafeBase64(GetByteArray());
-        }
+        Prime(_string_state, &IntegerData::GenerateString);
         return _string;
       }
 
@@ -220,17 +222,66 @@ namespace Crypto {
       virtual void GenerateCanonicalRep() = 0;
       void SetByteArray(const QByteArray &byte_array) { _byte_array = byte_array; }
       void SetCanonicalRep(const QByteArray &canonical) { _canonical = canonical; }
+
+      /**
+       * Drops the cached representations, only call this while the data is
+       * not shared, i.e., when it is being modified
+       */
       void Reset()
       {
         _byte_array.clear();
         _canonical.clear();
         _string.clear();
+        _byte_array_state = Empty;
+        _canonical_state = Empty;
+        _string_state = Empty;
       }
 
     private:
+      /**
+       * States of a lazily generated representation
+       */
+      enum CacheState {
+        Empty = 0,
+        Generating,
+        Ready
+      };
+
+      void GenerateString()
+      {
+        _string = Utils::ToUrlSafeBase64(GetByteArray());
+      }
+
+      /**
+       * Ensures that generate has been called exactly once since the last
+       * Reset, threads that lose the race wait for the winner to finish
+       * @param state the representation's CacheState
+       * @param generate fills in the representation
+       */
+      void Prime(QAtomicInt &state, void (IntegerData::*generate)()) const
+      {
+        if(state.testAndSetAcquire(Ready, Ready)) {
+          return;
+        }
+
+        if(state.testAndSetAcquire(Empty, Generating)) {
+          IntegerData *cfree_this = const_cast<IntegerData *>(this);
+          (cfree_this->*generate)();
+          state.fetchAndStoreRelease(Ready);
+          return;
+        }
+
+        while(!state.testAndSetAcquire(Ready, Ready)) {
+          QThread::yieldCurrentThread();
+        }
+      }
+
       QByteArray _byte_array;
       QByteArray _canonical;
       QString _string;
+      mutable QAtomicInt _byte_array_state;
+      mutable QAtomicInt _canonical_state;
+      mutable QAtomicInt _string_state;
   };
 }
 }
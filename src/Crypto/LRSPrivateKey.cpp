@@ -1,9 +1,12 @@
+#include "Utils/Metrics.hpp"
 #include "Utils/Random.hpp"
 
 #include "CppDsaPrivateKey.hpp"
 #include "CppHash.hpp"
 #include "LRSPrivateKey.hpp"
 
+using Dissent::Utils::Metrics;
+
 namespace Dissent {
 namespace Crypto {
   LRSPrivateKey::LRSPrivateKey(
@@ -57,6 +60,11 @@ namespace Crypto {
    */
   QByteArray LRSPrivateKey::Sign(const QByteArray &data) const
   {
+    static const Metrics::Histogram metric = Metrics::GetHistogram(
+        "dissent_crypto_seconds", "Time spent in crypto operations",
+        Metrics::Label("op", "sign") + "," + Metrics::Label("key", "Lrs"));
+    Metrics::ScopedTimer timer(metric);
+
     CppHash hash;
 
     hash.Update(GetGroupGenerator().GetByteArray());
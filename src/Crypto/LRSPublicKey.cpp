@@ -1,9 +1,28 @@
+#include "Utils/Metrics.hpp"
+
 #include "CppDsaPublicKey.hpp"
 #include "CppHash.hpp"
 #include "LRSPublicKey.hpp"
 
+using Dissent::Utils::Metrics;
+
 namespace Dissent {
 namespace Crypto {
+namespace {
+  class MultiplyMod {
+    public:
+      explicit MultiplyMod(const Integer &p) : _p(p) {}
+
+      inline Integer operator()(const Integer &a, const Integer &b) const
+      {
+        return a.MultiplyMod(b, _p);
+      }
+
+    private:
+      const Integer _p;
+  };
+}
+
   LRSPublicKey::LRSPublicKey(
       const QVector<QSharedPointer<AsymmetricKey> > &public_keys,
       const QByteArray &linkage_context) :
@@ -72,6 +91,12 @@ namespace Crypto {
     }
 
     _keys.append(dsa->GetPublicElement());
+    if(IsPrecomputed()) {
+      _keys.last().GetByteArray();
+      if(_key_tables.count() < MaxKeyTables) {
+        _key_tables.append(BuildTable(_keys.last()));
+      }
+    }
     return true;
   }
 
@@ -83,6 +108,63 @@ namespace Crypto {
 
     QByteArray hlc = hash.ComputeHash();
     _group_gen = GetGenerator().Pow(Integer(hlc) % GetSubgroup(), GetModulus());
+    _group_gen.GetByteArray();
+    if(IsPrecomputed()) {
+      _group_gen_table = BuildTable(_group_gen);
+    }
+  }
+
+  void LRSPublicKey::PrimeEncodings() const
+  {
+    _generator.GetByteArray();
+    _group_gen.GetByteArray();
+    _modulus.GetByteArray();
+    _subgroup.GetByteArray();
+    for(int idx = 0; idx < _keys.count(); idx++) {
+      _keys[idx].GetByteArray();
+    }
+  }
+
+  void LRSPublicKey::Precompute()
+  {
+    PrimeEncodings();
+
+    _generator_table = BuildTable(GetGenerator());
+    _group_gen_table = BuildTable(GetGroupGenerator());
+
+    _key_tables.clear();
+    for(int idx = 0; idx < _keys.count() && idx < MaxKeyTables; idx++) {
+      _key_tables.append(BuildTable(_keys[idx]));
+    }
+  }
+
+  QSharedPointer<const LRSPublicKey::Table> LRSPublicKey::BuildTable(
+      const Integer &base) const
+  {
+    // The table is used without an AbstractGroup, so it holds no Element
+    QSharedPointer<Table> table(new Table(AbstractGroup::Element(),
+          GetSubgroup().GetBitCount()));
+    table->Build(base, MultiplyMod(GetModulus()));
+    return table;
+  }
+
+  Integer LRSPublicKey::Commit(const Table *base_table, const Integer &base,
+      const Integer &exp0, const Table *key_table, const Integer &key,
+      const Integer &exp1) const
+  {
+    MultiplyMod multiply(GetModulus());
+    Integer base_pow, key_pow;
+    bool have_base = base_table && base_table->Evaluate(exp0, multiply, base_pow);
+    bool have_key = key_table && key_table->Evaluate(exp1, multiply, key_pow);
+
+    if(have_base && have_key) {
+      return base_pow.MultiplyMod(key_pow, GetModulus());
+    } else if(have_base) {
+      return base_pow.MultiplyMod(key.Pow(exp1, GetModulus()), GetModulus());
+    } else if(have_key) {
+      return base.Pow(exp0, GetModulus()).MultiplyMod(key_pow, GetModulus());
+    }
+    return GetModulus().PowCascade(base, exp0, key, exp1);
   }
 
   /**
@@ -114,20 +196,44 @@ namespace Crypto {
       return false;
     }
 
+    static const Metrics::Histogram metric = Metrics::GetHistogram(
+        "dissent_crypto_seconds", "Time spent in crypto operations",
+        Metrics::Label("op", "verify") + "," + Metrics::Label("key", "Lrs"));
+    Metrics::ScopedTimer timer(metric);
+
+    // Reads _group_gen in place, Precompute has already serialized it
     CppHash hash;
-    hash.Update(GetGroupGenerator().GetByteArray());
+    hash.Update(_group_gen.GetByteArray());
     hash.Update(sig.GetTag().GetByteArray());
     hash.Update(data);
     QByteArray precompute = hash.ComputeHash();
 
     Integer tcommit = sig.GetCommit1();
+    const Integer tag = sig.GetTag();
+
+    // The tag is combined with every key, it must lie in the subgroup
+    if(tag >= GetModulus() ||
+        tag.Pow(GetSubgroup(), GetModulus()) != Integer(1))
+    {
+      qDebug() << "Tag not in subgroup";
+      return false;
+    }
+
+    // The tag is raised to a new power for every ring member
+    QSharedPointer<const Table> tag_table;
+    if(_keys.count() >= TagTableThreshold) {
+      tag_table = BuildTable(tag);
+    }
+
+    for(int idx = 0; idx < _keys.count(); idx++) {
+      const Integer s = sig.GetSignature(idx);
+      const Table *key_table = idx < _key_tables.count() ?
+        _key_tables[idx].data() : 0;
 
-    QVector<Integer> keys = GetKeys();
-    for(int idx = 0; idx < keys.count(); idx++) {
-      Integer z_p = (GetGenerator().Pow(sig.GetSignature(idx), GetModulus()) *
-          _keys[idx].Pow(tcommit, GetModulus())) % GetModulus();
-      Integer z_pp = (GetGroupGenerator().Pow(sig.GetSignature(idx), GetModulus()) *
-          sig.GetTag().Pow(tcommit, GetModulus())) % GetModulus();
+      Integer z_p = Commit(_generator_table.data(), _generator, s,
+          key_table, _keys[idx], tcommit);
+      Integer z_pp = Commit(_group_gen_table.data(), _group_gen, s,
+          tag_table.data(), tag, tcommit);
 
       hash.Update(precompute);
       hash.Update(z_p.GetByteArray());
@@ -2,7 +2,10 @@
 #define DISSENT_CRYPTO_LRS_PUBLIC_KEY_H_GUARD
 
 #include <QByteArray>
+#include <QSharedPointer>
+#include <QVector>
 
+#include "AbstractGroup/FixedBase.hpp"
 #include "AsymmetricKey.hpp"
 #include "Integer.hpp"
 #include "LRSSignature.hpp"
@@ -10,10 +13,25 @@
 namespace Dissent {
 namespace Crypto {
   /**
-   * Can be used to verify linkable ring signatures
+   * Can be used to verify linkable ring signatures. Verifiers checking many
+   * signatures should call Precompute, after which the generator, the
+   * group generator, and up to MaxKeyTables ring keys are exponentiated
+   * from fixed-base tables. Verify is safe to call concurrently, but not
+   * alongside AddKey, SetLinkageContext, or Precompute.
    */
   class LRSPublicKey : public AsymmetricKey {
     public:
+      /**
+       * Ring keys given a fixed-base table, each table takes roughly
+       * 1000 integers the size of the modulus
+       */
+      static const int MaxKeyTables = 128;
+
+      /**
+       * Rings at least this large build a table for the signature's tag
+       * during verification
+       */
+      static const int TagTableThreshold = 16;
 
       explicit LRSPublicKey(
           const QVector<QSharedPointer<AsymmetricKey> > &public_keys,
@@ -150,6 +168,17 @@ namespace Crypto {
        */
       virtual void SetLinkageContext(const QByteArray &linkage_context);
 
+      /**
+       * Builds the fixed-base tables used by Verify, keys added later are
+       * given tables as well
+       */
+      void Precompute();
+
+      /**
+       * Returns true if Precompute has been called
+       */
+      bool IsPrecomputed() const { return !_generator_table.isNull(); }
+
       /**
        * Returns the ordered set of keys (public component)
        */
@@ -188,7 +217,38 @@ namespace Crypto {
       void SetInvalid() { _valid = false; }
 
     private:
+      typedef AbstractGroup::WindowTable<Integer> Table;
+
+      /**
+       * Returns a fixed-base table for a base, exponents are at most the
+       * size of the subgroup
+       */
+      QSharedPointer<const Table> BuildTable(const Integer &base) const;
+
+      /**
+       * Generates the cached byte arrays of the values Verify serializes or
+       * exponentiates, so that concurrent Verify calls only read them
+       */
+      void PrimeEncodings() const;
+
+      /**
+       * Returns (base^exp0 * key^exp1) mod p, using tables where available
+       * and a cascaded exponentiation otherwise
+       * @param base_table the table for base or 0
+       * @param base the first base
+       * @param exp0 the first exponent
+       * @param key_table the table for key or 0
+       * @param key the second base
+       * @param exp1 the second exponent
+       */
+      Integer Commit(const Table *base_table, const Integer &base,
+          const Integer &exp0, const Table *key_table, const Integer &key,
+          const Integer &exp1) const;
+
       QVector<Integer> _keys;
+      QSharedPointer<const Table> _generator_table;
+      QSharedPointer<const Table> _group_gen_table;
+      QVector<QSharedPointer<const Table> > _key_tables;
       Integer _generator;
       Integer _modulus;
       Integer _subgroup;
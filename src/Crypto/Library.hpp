@@ -57,6 +57,16 @@ namespace Crypto {
       virtual Utils::Random *GetRandomNumberGenerator(
           const QByteArray &seed = QByteArray(), uint index = 0) = 0;
 
+      /**
+       * Returns a deterministic random number generator that, where the
+       * library provides one, supports Seek so any offset of its output can
+       * be regenerated cheaply, callers check IsSeekable
+       * @param seed the seed for the rng
+       * @param index initial byte offset into the output
+       */
+      virtual Utils::Random *GetSeekableRandomNumberGenerator(
+          const QByteArray &seed, uint index = 0) = 0;
+
       /**
        * Returns the optimal seed size for the RNG
        */
@@ -1,4 +1,7 @@
 #include "NullDiffieHellman.hpp"
+#include "Utils/SimulatedCpu.hpp"
+
+using Dissent::Utils::SimulatedCpu;
 
 namespace Dissent {
 namespace Crypto {
@@ -24,6 +27,7 @@ namespace Crypto {
 
   QByteArray NullDiffieHellman::GetSharedSecret(const QByteArray &remote_pub) const
   {
+    SimulatedCpu::Charge(SimulatedCpu::KeyExchange);
     int size = std::min(_key.size(), remote_pub.size());
     QByteArray shared(size, 0);
     for(int idx = 0; idx < size; idx++) {
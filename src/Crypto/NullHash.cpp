@@ -1,6 +1,9 @@
 #include "NullHash.hpp"
 #include <QHash>
 #include "Utils/Serialization.hpp"
+#include "Utils/SimulatedCpu.hpp"
+
+using Dissent::Utils::SimulatedCpu;
 
 namespace Dissent {
 namespace Crypto {
@@ -21,6 +24,7 @@ namespace Crypto {
 
   QByteArray NullHash::ComputeHash(const QByteArray &data)
   {
+    SimulatedCpu::Charge(SimulatedCpu::Hash, data.size() / 1024 + 1);
     QByteArray hash(GetDigestSize(), 0);
     Dissent::Utils::Serialization::WriteInt(qHash(data), hash, 0);
     _current = QByteArray();
@@ -17,6 +17,11 @@ namespace Crypto {
       virtual ~NullHash() {}
 
       inline virtual int GetDigestSize() { return sizeof(uint); }
+
+      /**
+       * Has no blocks, reports SHA-1's so HMAC keys are padded alike
+       */
+      inline virtual int GetBlockSize() const { return 64; }
       virtual void Restart();
       virtual void Update(const QByteArray &data);
       virtual QByteArray ComputeHash();
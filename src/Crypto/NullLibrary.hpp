@@ -83,6 +83,16 @@ namespace Crypto {
         return new Utils::Random(seed, index);
       }
 
+      /**
+       * Returns the same lightweight generator as GetRandomNumberGenerator,
+       * it does not support Seek
+       */
+      inline virtual Utils::Random *GetSeekableRandomNumberGenerator(
+          const QByteArray &seed, uint index)
+      {
+        return new Utils::Random(seed, index);
+      }
+
       inline virtual uint RngOptimalSeedSize()
       {
         return Utils::Random::OptimalSeedSize();
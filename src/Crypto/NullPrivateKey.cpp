@@ -1,7 +1,10 @@
 #include "NullPrivateKey.hpp"
 #include "Utils/Serialization.hpp"
+#include "Utils/SimulatedCpu.hpp"
 #include <QHash>
 
+using Dissent::Utils::SimulatedCpu;
+
 namespace Dissent {
 namespace Crypto {
   uint NullPrivateKey::_current_key = 0;
@@ -50,6 +53,7 @@ namespace Crypto {
       return QByteArray();
     }
 
+    SimulatedCpu::Charge(SimulatedCpu::Sign);
     QByteArray sig(8, 0);
     Dissent::Utils::Serialization::WriteUInt(_key_id, sig, 0);
     Dissent::Utils::Serialization::WriteUInt(qHash(data), sig, 4);
@@ -62,6 +66,7 @@ namespace Crypto {
       return QByteArray();
     }
 
+    SimulatedCpu::Charge(SimulatedCpu::Decrypt);
     uint key_id = Dissent::Utils::Serialization::ReadInt(data, 0);
     if(key_id != _key_id) {
       return QByteArray();
@@ -1,7 +1,10 @@
 #include "NullPublicKey.hpp"
 #include "Utils/Serialization.hpp"
+#include "Utils/SimulatedCpu.hpp"
 #include <QHash>
 
+using Dissent::Utils::SimulatedCpu;
+
 namespace Dissent {
 namespace Crypto {
   uint NullPublicKey::_unique = 0;
@@ -99,6 +102,7 @@ namespace Crypto {
       return false;
     }
 
+    SimulatedCpu::Charge(SimulatedCpu::Verify);
     uint key_id = Dissent::Utils::Serialization::ReadInt(sig, 0);
     uint hash = Dissent::Utils::Serialization::ReadInt(sig, 4);
     return hash == qHash(data) && key_id == _key_id;
@@ -110,6 +114,7 @@ namespace Crypto {
       return QByteArray();
     }
 
+    SimulatedCpu::Charge(SimulatedCpu::Encrypt);
     QByteArray base(8, 0);
     Dissent::Utils::Serialization::WriteUInt(_key_id, base, 0);
     Dissent::Utils::Serialization::WriteUInt(_unique++, base, 4);
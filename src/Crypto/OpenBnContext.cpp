@@ -0,0 +1,107 @@
+#include <QByteArray>
+#include <QDebug>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadStorage>
+
+#include "OpenBnContext.hpp"
+
+namespace Dissent {
+namespace Crypto {
+namespace {
+  /**
+   * Frees the thread's BN_CTX when QThreadStorage deletes it
+   */
+  class ThreadContext {
+    public:
+      ThreadContext() : ctx(BN_CTX_new())
+      {
+        if(!ctx) {
+          qFatal("Unable to allocate BN_CTX");
+        }
+      }
+
+      ~ThreadContext()
+      {
+        BN_CTX_free(ctx);
+      }
+
+      BN_CTX *ctx;
+  };
+
+  QThreadStorage<ThreadContext *> &GetThreadContexts()
+  {
+    static QThreadStorage<ThreadContext *> contexts;
+    return contexts;
+  }
+
+  typedef QHash<QByteArray, QSharedPointer<BN_MONT_CTX> > MontgomeryCache;
+
+  MontgomeryCache &GetMontgomeryCache()
+  {
+    static MontgomeryCache cache;
+    return cache;
+  }
+
+  QMutex &GetMontgomeryLock()
+  {
+    static QMutex lock;
+    return lock;
+  }
+}
+
+  BN_CTX *OpenBnContext::GetContext()
+  {
+    QThreadStorage<ThreadContext *> &contexts = GetThreadContexts();
+    if(!contexts.hasLocalData()) {
+      contexts.setLocalData(new ThreadContext());
+    }
+    return contexts.localData()->ctx;
+  }
+
+  QSharedPointer<BN_MONT_CTX> OpenBnContext::GetMontgomery(const BIGNUM *mod)
+  {
+    if(!BN_is_odd(mod)) {
+      return QSharedPointer<BN_MONT_CTX>();
+    }
+
+    QByteArray key(BN_num_bytes(mod), 0);
+    BN_bn2bin(mod, reinterpret_cast<unsigned char *>(key.data()));
+
+    MontgomeryCache &cache = GetMontgomeryCache();
+    {
+      QMutexLocker locker(&GetMontgomeryLock());
+      MontgomeryCache::const_iterator it = cache.constFind(key);
+      if(it != cache.constEnd()) {
+        return it.value();
+      }
+    }
+
+    // Set up outside of the lock, racing threads simply keep the first
+    BN_MONT_CTX *mont = BN_MONT_CTX_new();
+    if(!mont || !BN_MONT_CTX_set(mont, mod, GetContext())) {
+      qFatal("Unable to set up BN_MONT_CTX");
+    }
+    QSharedPointer<BN_MONT_CTX> context(mont, BN_MONT_CTX_free);
+
+    QMutexLocker locker(&GetMontgomeryLock());
+    MontgomeryCache::const_iterator it = cache.constFind(key);
+    if(it != cache.constEnd()) {
+      return it.value();
+    }
+
+    if(cache.count() >= MAX_MONTGOMERY) {
+      cache.clear();
+    }
+    cache.insert(key, context);
+    return context;
+  }
+
+  void OpenBnContext::ClearMontgomery()
+  {
+    QMutexLocker locker(&GetMontgomeryLock());
+    GetMontgomeryCache().clear();
+  }
+}
+}
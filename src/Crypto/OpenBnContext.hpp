@@ -0,0 +1,52 @@
+#ifndef DISSENT_CRYPTO_OPEN_BN_CONTEXT_H_GUARD
+#define DISSENT_CRYPTO_OPEN_BN_CONTEXT_H_GUARD
+
+#include <openssl/bn.h>
+
+#include <QSharedPointer>
+
+namespace Dissent {
+namespace Crypto {
+  /**
+   * Scratch space and precomputation shared by OpenIntegerData.  Allocating
+   * a BN_CTX and setting up Montgomery arithmetic are both expensive
+   * relative to a single modular operation, so each thread keeps one BN_CTX
+   * and Montgomery contexts are cached by modulus for all threads.
+   */
+  class OpenBnContext {
+    public:
+      /**
+       * Returns the calling thread's BN_CTX, which is owned by the thread
+       * and freed when it exits
+       */
+      static BN_CTX *GetContext();
+
+      /**
+       * Returns a Montgomery context for the modulus or a null pointer if
+       * the modulus is even.  Contexts are read-only once created and may be
+       * used by several threads at once.
+       * @param mod the modulus
+       */
+      static QSharedPointer<BN_MONT_CTX> GetMontgomery(const BIGNUM *mod);
+
+      /**
+       * Clears the Montgomery context cache
+       */
+      static void ClearMontgomery();
+
+      /**
+       * Maximum number of cached Montgomery contexts, the cache is emptied
+       * when it fills
+       */
+      static const int MAX_MONTGOMERY = 64;
+
+    private:
+      /**
+       * No instances
+       */
+      OpenBnContext() {}
+  };
+}
+}
+
+#endif
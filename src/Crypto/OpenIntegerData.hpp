@@ -4,11 +4,13 @@
 #include <openssl/bn.h>
 #include <string>
 
+#include <QAtomicPointer>
 #include <QByteArray>
 #include <QSharedData>
 
 #include "IntegerData.hpp"
 #include "Integer.hpp"
+#include "OpenBnContext.hpp"
 
 #ifndef CHECK_CALL
 #define CHECK_CALL(a) do { \
@@ -22,7 +24,10 @@
 namespace Dissent {
 namespace Crypto {
   /**
-   * "Big" OpenSSL IntegerData wrapper
+   * "Big" OpenSSL IntegerData wrapper.  Temporaries come from the calling
+   * thread's BN_CTX and exponentiations reuse cached Montgomery contexts,
+   * see OpenBnContext.  An integer used as a modulus keeps its context, so
+   * the shared cache is consulted once per modulus rather than per Pow.
    */
 
   class OpenIntegerData : public IntegerData {
@@ -33,10 +38,10 @@ namespace Crypto {
        * Construct using an int
        * @param value the int value
        */
-      explicit OpenIntegerData(int value = 0)
+      explicit OpenIntegerData(int value = 0) :
+        _mont(0)
       {
         CHECK_CALL(_bignum = BN_new());
-        CHECK_CALL(_ctx = BN_CTX_new());
         CHECK_CALL(BN_set_word(_bignum, value));
       }
 
@@ -44,10 +49,10 @@ namespace Crypto {
        * Construct using an byte array
        * @param value the byte array
        */
-      explicit OpenIntegerData(const QByteArray &byte_array) 
+      explicit OpenIntegerData(const QByteArray &byte_array) :
+        _mont(0)
       {
         CHECK_CALL(_bignum = BN_new());
-        CHECK_CALL(_ctx = BN_CTX_new());
         CHECK_CALL(BN_bin2bn((unsigned const char*)byte_array.constData(),
               byte_array.count(), _bignum));
       }
@@ -56,11 +61,11 @@ namespace Crypto {
        * Construct using a base64 string
        * @param value the string
        */
-      explicit OpenIntegerData(const QString &string)
+      explicit OpenIntegerData(const QString &string) :
+        _mont(0)
       {
         QByteArray byte_array = FromBase64(string);
         CHECK_CALL(_bignum = BN_new());
-        CHECK_CALL(_ctx = BN_CTX_new());
         CHECK_CALL(BN_bin2bn((const unsigned char*)byte_array.constData(), 
               byte_array.count(), _bignum));
       }
@@ -71,7 +76,7 @@ namespace Crypto {
        */
       explicit OpenIntegerData(BIGNUM *bn) : 
         _bignum(bn),
-        _ctx(BN_CTX_new())
+        _mont(0)
       {}
 
       /**
@@ -108,10 +113,8 @@ namespace Crypto {
         CHECK_CALL(diff = BN_new());
         CHECK_CALL(BN_sub(diff, GetBignum(max), GetBignum(min)));
 
-        BN_CTX *ctx;
-        CHECK_CALL(ctx = BN_CTX_new());
-
         if(prime) {
+          BN_CTX *ctx = OpenBnContext::GetContext();
           while(true) {
             CHECK_CALL(BN_rand_range(bn, diff));
             CHECK_CALL(BN_add(bn, bn, GetBignum(min)));
@@ -122,7 +125,6 @@ namespace Crypto {
           CHECK_CALL(BN_add(bn, bn, GetBignum(min)));
         }
 
-        BN_CTX_free(ctx);
         BN_clear_free(diff);
 
         return new OpenIntegerData(bn);
@@ -133,8 +135,8 @@ namespace Crypto {
        */
       virtual ~OpenIntegerData() 
       {
+        ClearMontgomery();
         BN_clear_free(_bignum); 
-        BN_CTX_free(_ctx); 
       }
 
       /**
@@ -142,7 +144,8 @@ namespace Crypto {
        */
       virtual bool IsPrime() const 
       {
-        return BN_is_prime(_bignum, BN_prime_checks, NULL, _ctx, NULL);
+        return BN_is_prime(_bignum, BN_prime_checks, NULL,
+            OpenBnContext::GetContext(), NULL);
       }
 
       /**
@@ -179,12 +182,9 @@ namespace Crypto {
       {
         BIGNUM *bn;
         CHECK_CALL(bn = BN_new());
-        BN_CTX *ctx;
-        CHECK_CALL(ctx = BN_CTX_new());
-
-        CHECK_CALL(BN_mul(bn, _bignum, GetBignum(multiplicand), ctx));
 
-        BN_CTX_free(ctx);
+        CHECK_CALL(BN_mul(bn, _bignum, GetBignum(multiplicand),
+              OpenBnContext::GetContext()));
         return new OpenIntegerData(bn);
       }
 
@@ -197,7 +197,8 @@ namespace Crypto {
         BIGNUM *bn;
         CHECK_CALL(bn = BN_new());
 
-        CHECK_CALL(BN_div(bn, NULL, _bignum, GetBignum(divisor), _ctx));
+        CHECK_CALL(BN_div(bn, NULL, _bignum, GetBignum(divisor),
+              OpenBnContext::GetContext()));
         return new OpenIntegerData(bn);
       }
 
@@ -215,13 +216,20 @@ namespace Crypto {
         BIGNUM *bn;
         CHECK_CALL(bn = BN_new());
 
-        BN_CTX *ctx;
-        CHECK_CALL(ctx = BN_CTX_new());
-
         if(BN_is_negative(GetBignum(pow))) qFatal("Cannot handle negative exponents");
-        CHECK_CALL(BN_mod_exp(bn, _bignum, GetBignum(pow), GetBignum(mod), ctx));
 
-        BN_CTX_free(ctx);
+        const BIGNUM *modulus = GetBignum(mod);
+        BN_CTX *ctx = OpenBnContext::GetContext();
+        QSharedPointer<BN_MONT_CTX> mont = GetMontgomery(mod);
+        if(!mont) {
+          CHECK_CALL(BN_mod_exp(bn, _bignum, GetBignum(pow), modulus, ctx));
+        } else if(BN_num_bits(_bignum) <= BN_BITS2) {
+          CHECK_CALL(BN_mod_exp_mont_word(bn, BN_get_word(_bignum),
+                GetBignum(pow), modulus, ctx, mont.data()));
+        } else {
+          CHECK_CALL(BN_mod_exp_mont(bn, _bignum, GetBignum(pow), modulus,
+                ctx, mont.data()));
+        }
 
         return new OpenIntegerData(bn);
       }
@@ -245,16 +253,22 @@ namespace Crypto {
         Q_ASSERT(!BN_is_negative(GetBignum(e2)));
 
         BIGNUM *bn;
-        BIGNUM *bn2;
         CHECK_CALL(bn = BN_new());
-        CHECK_CALL(bn2 = BN_new());
 
-        BN_CTX *ctx;
-        CHECK_CALL(ctx = BN_CTX_new());
+        BN_CTX *ctx = OpenBnContext::GetContext();
+        QSharedPointer<BN_MONT_CTX> mont = GetMontgomery(this);
+        if(mont) {
+          // Simultaneous exponentiation shares the squarings
+          CHECK_CALL(BN_mod_exp2_mont(bn, GetBignum(x1), GetBignum(e1),
+                GetBignum(x2), GetBignum(e2), _bignum, ctx, mont.data()));
+          return new OpenIntegerData(bn);
+        }
 
-        CHECK_CALL(BN_mod_exp(bn, GetBignum(x1), GetBignum(e1), _bignum, _ctx));
-        CHECK_CALL(BN_mod_exp(bn2, GetBignum(x2), GetBignum(e2), _bignum, _ctx));
-        CHECK_CALL(BN_mod_mul(bn, bn, bn2, _bignum, _ctx));
+        BIGNUM *bn2;
+        CHECK_CALL(bn2 = BN_new());
+        CHECK_CALL(BN_mod_exp(bn, GetBignum(x1), GetBignum(e1), _bignum, ctx));
+        CHECK_CALL(BN_mod_exp(bn2, GetBignum(x2), GetBignum(e2), _bignum, ctx));
+        CHECK_CALL(BN_mod_mul(bn, bn, bn2, _bignum, ctx));
         BN_clear_free(bn2);
         return new OpenIntegerData(bn);
       }
@@ -272,7 +286,8 @@ namespace Crypto {
         BIGNUM *bn;
         CHECK_CALL(bn = BN_new());
 
-        CHECK_CALL(BN_mod_mul(bn, _bignum, GetBignum(other), GetBignum(mod), _ctx));
+        CHECK_CALL(BN_mod_mul(bn, _bignum, GetBignum(other), GetBignum(mod),
+              OpenBnContext::GetContext()));
         return new OpenIntegerData(bn);
       }
 
@@ -288,7 +303,8 @@ namespace Crypto {
         Q_ASSERT(!BN_is_negative(GetBignum(mod)));
         Q_ASSERT(!BN_is_negative(_bignum));
 
-        CHECK_CALL(BN_mod_inverse(bn, _bignum, GetBignum(mod), _ctx));
+        CHECK_CALL(BN_mod_inverse(bn, _bignum, GetBignum(mod),
+              OpenBnContext::GetContext()));
         return new OpenIntegerData(bn);
       }
 
@@ -303,7 +319,8 @@ namespace Crypto {
         BIGNUM *bn;
         CHECK_CALL(bn = BN_new());
 
-        CHECK_CALL(BN_nnmod(bn, _bignum, GetBignum(modulus), _ctx));
+        CHECK_CALL(BN_nnmod(bn, _bignum, GetBignum(modulus),
+              OpenBnContext::GetContext()));
         return new OpenIntegerData(bn);
       }
 
@@ -313,6 +330,7 @@ namespace Crypto {
        */
       virtual void Set(const IntegerData *other)
       {
+        ClearMontgomery();
         CHECK_CALL(BN_copy(_bignum, GetBignum(other)));
       }
 
@@ -322,6 +340,7 @@ namespace Crypto {
        */
       virtual void operator+=(const IntegerData *other)
       {
+        ClearMontgomery();
         CHECK_CALL(BN_add(_bignum, _bignum, GetBignum(other)));
       }
 
@@ -331,6 +350,7 @@ namespace Crypto {
        */
       virtual void operator-=(const IntegerData *other)
       {
+        ClearMontgomery();
         CHECK_CALL(BN_sub(_bignum, _bignum, GetBignum(other)));
       }
 
@@ -445,9 +465,43 @@ namespace Crypto {
       }
 
     private:
-      
+      /**
+       * Returns the Montgomery context for data as a modulus, taken from
+       * OpenBnContext the first time and then kept by data
+       * @param data the modulus
+       */
+      static QSharedPointer<BN_MONT_CTX> GetMontgomery(const IntegerData *data)
+      {
+        const OpenIntegerData *pcdata =
+          dynamic_cast<const OpenIntegerData *>(data);
+        if(!pcdata) {
+          return QSharedPointer<BN_MONT_CTX>();
+        }
+
+        QSharedPointer<BN_MONT_CTX> *mont = pcdata->_mont;
+        if(mont) {
+          return *mont;
+        }
+
+        // Racing threads find the same context, the loser discards its copy
+        mont = new QSharedPointer<BN_MONT_CTX>(
+            OpenBnContext::GetMontgomery(pcdata->_bignum));
+        if(!pcdata->_mont.testAndSetOrdered(0, mont)) {
+          delete mont;
+        }
+        return *pcdata->_mont;
+      }
+
+      /**
+       * Drops the kept Montgomery context, called when the value changes
+       */
+      void ClearMontgomery()
+      {
+        delete _mont.fetchAndStoreOrdered(0);
+      }
+
       BIGNUM *_bignum;
-      BN_CTX *_ctx;
+      mutable QAtomicPointer<QSharedPointer<BN_MONT_CTX> > _mont;
 
   };
 }
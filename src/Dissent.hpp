@@ -24,6 +24,7 @@
 #include "Applications/ConsoleSink.hpp"
 #include "Applications/FileSink.hpp"
 #include "Applications/Node.hpp"
+#include "Applications/NodeThread.hpp"
 #include "Applications/SessionFactory.hpp"
 #include "Applications/Settings.hpp"
 
@@ -49,6 +50,8 @@
 #include "Connections/RelayEdgeListener.hpp"
 
 #include "Crypto/AsymmetricKey.hpp"
+#include "Crypto/Blake2bHash.hpp"
+#include "Crypto/CppCtrRandom.hpp"
 #include "Crypto/CppDiffieHellman.hpp"
 #include "Crypto/CppDsaLibrary.hpp"
 #include "Crypto/CppDsaPrivateKey.hpp"
@@ -64,6 +67,7 @@
 #include "Crypto/DiffieHellman.hpp"
 #include "Crypto/CppHash.hpp"
 #include "Crypto/Hash.hpp"
+#include "Crypto/Hmac.hpp"
 #include "Crypto/Integer.hpp"
 #include "Crypto/IntegerData.hpp"
 #include "Crypto/KeyShare.hpp"
@@ -76,6 +80,7 @@
 #include "Crypto/NullLibrary.hpp"
 #include "Crypto/NullPrivateKey.hpp"
 #include "Crypto/NullPublicKey.hpp"
+#include "Crypto/OpenBnContext.hpp"
 #include "Crypto/OpenIntegerData.hpp"
 #include "Crypto/OpenLibrary.hpp"
 #include "Crypto/OnionEncryptor.hpp"
@@ -92,8 +97,10 @@
 #include "Crypto/AbstractGroup/ECParams.hpp"
 #include "Crypto/AbstractGroup/Element.hpp"
 #include "Crypto/AbstractGroup/ElementData.hpp"
+#include "Crypto/AbstractGroup/FixedBase.hpp"
 #include "Crypto/AbstractGroup/IntegerElementData.hpp"
 #include "Crypto/AbstractGroup/IntegerGroup.hpp"
+#include "Crypto/AbstractGroup/MultiExponentiation.hpp"
 #include "Crypto/AbstractGroup/OpenECElementData.hpp"
 #include "Crypto/AbstractGroup/OpenECGroup.hpp"
 #include "Crypto/AbstractGroup/PairingElementData.hpp"
@@ -108,6 +115,7 @@
 #include "Crypto/BlogDrop/ChangingGenClientCiphertext.hpp"
 #include "Crypto/BlogDrop/ChangingGenServerCiphertext.hpp"
 #include "Crypto/BlogDrop/ClientCiphertext.hpp"
+#include "Crypto/BlogDrop/ClientCiphertextPool.hpp"
 #include "Crypto/BlogDrop/ElGamalClientCiphertext.hpp"
 #include "Crypto/BlogDrop/ElGamalServerCiphertext.hpp"
 #include "Crypto/BlogDrop/HashingGenClientCiphertext.hpp"
@@ -144,6 +152,7 @@
 
 #include "Messaging/BufferSink.hpp"
 #include "Messaging/DummySink.hpp"
+#include "Messaging/Envelope.hpp"
 #include "Messaging/Filter.hpp"
 #include "Messaging/FilterObject.hpp"
 #include "Messaging/GetDataCallback.hpp" 
@@ -175,6 +184,7 @@
 #include "Transports/BufferAddress.hpp"
 #include "Transports/BufferEdge.hpp"
 #include "Transports/BufferEdgeListener.hpp"
+#include "Transports/BufferLinkModel.hpp"
 #include "Transports/Edge.hpp"
 #include "Transports/EdgeFactory.hpp"
 #include "Transports/EdgeListener.hpp"
@@ -183,13 +193,18 @@
 #include "Transports/TcpEdge.hpp"
 #include "Transports/TcpEdgeListener.hpp"
 
+#include "Tunnel/DnsCache.hpp"
+#include "Tunnel/DownstreamScheduler.hpp"
 #include "Tunnel/EntryTunnel.hpp"
 #include "Tunnel/ExitTunnel.hpp"
 #include "Tunnel/SocksConnection.hpp"
 #include "Tunnel/SocksHostAddress.hpp"
+#include "Tunnel/TcpConnectionPool.hpp"
 #include "Tunnel/TunnelConnectionTable.hpp"
 #include "Tunnel/Packets/Packet.hpp"
 #include "Tunnel/Packets/FinishPacket.hpp"
+#include "Tunnel/Packets/KeyAgreementPacket.hpp"
+#include "Tunnel/Packets/TcpAckPacket.hpp"
 #include "Tunnel/Packets/TcpRequestPacket.hpp"
 #include "Tunnel/Packets/UdpRequestPacket.hpp"
 #include "Tunnel/Packets/TcpResponsePacket.hpp"
@@ -197,11 +212,14 @@
 #include "Tunnel/Packets/TcpStartPacket.hpp"
 #include "Tunnel/Packets/UdpStartPacket.hpp"
 
+#include "Utils/Arena.hpp"
 #include "Utils/Logging.hpp"
+#include "Utils/Metrics.hpp"
 #include "Utils/QRunTimeError.hpp"
 #include "Utils/Random.hpp"
 #include "Utils/Serialization.hpp"
 #include "Utils/SignalCounter.hpp"
+#include "Utils/SimulatedCpu.hpp"
 #include "Utils/Sleeper.hpp"
 #include "Utils/StartStop.hpp"
 #include "Utils/StartStopSlots.hpp"
@@ -209,9 +227,11 @@
 #include "Utils/Timer.hpp"
 #include "Utils/TimerCallback.hpp"
 #include "Utils/TimerEvent.hpp"
+#include "Utils/TimerWheel.hpp"
 #include "Utils/Triggerable.hpp"
 #include "Utils/Triple.hpp"
 #include "Utils/Utils.hpp"
+#include "Utils/Xor.hpp"
 
 #include "Web/HttpRequest.hpp"
 #include "Web/HttpResponse.hpp"
@@ -222,6 +242,7 @@
 #include "Web/Services/GetFileService.hpp"
 #include "Web/Services/GetMessagesService.hpp"
 #include "Web/Services/MessageWebService.hpp"
+#include "Web/Services/MetricsService.hpp"
 #include "Web/Services/RoundIdService.hpp"
 #include "Web/Services/SendMessageService.hpp"
 #include "Web/Services/SessionIdService.hpp"
@@ -5,6 +5,7 @@
 #include <QVariant>
 
 #include "Connections/Id.hpp"
+#include "Identity/PublicIdentity.hpp"
 
 namespace Dissent {
 namespace Identity {
@@ -39,6 +40,44 @@ namespace Authentication {
        */
       virtual QPair<bool, PublicIdentity> VerifyResponse(const Id &member,
           const QVariant &data) = 0;
+
+      /**
+       * Returns true if responses can be verified off the caller's thread,
+       * in which case VerifyResponse may be replaced by BeginResponse on
+       * the caller's thread, CheckResponse on any thread, and EndResponse
+       * back on the caller's thread
+       */
+      virtual bool CanCheckConcurrently() const { return false; }
+
+      /**
+       * Performs the inexpensive checks on a response and reserves anything
+       * that must stay unique, such as a linkage tag, until EndResponse
+       * @param member the authenticating member
+       * @param data the response data
+       * @returns false if the response can be rejected immediately
+       */
+      virtual bool BeginResponse(const Id &, const QVariant &) { return true; }
+
+      /**
+       * Performs the expensive checks on a response, must be thread safe
+       * @param member the authenticating member
+       * @param data the response data
+       * @returns returns true and a valid members identity or
+       * false and nothing
+       */
+      virtual QPair<bool, PublicIdentity> CheckResponse(const Id &,
+          const QVariant &) const
+      {
+        return QPair<bool, PublicIdentity>(false, PublicIdentity());
+      }
+
+      /**
+       * Completes a response started with BeginResponse
+       * @param member the authenticating member
+       * @param data the response data
+       * @param valid the result of CheckResponse
+       */
+      virtual void EndResponse(const Id &, const QVariant &, bool) {}
   };
 }
 }
@@ -12,6 +12,7 @@ namespace Authentication {
       const QSharedPointer<LRSPublicKey> &lrs) :
     _lrs(lrs)
   {
+    _lrs->Precompute();
   }
 
   QPair<bool, QVariant> LRSAuthenticator::RequestChallenge(
@@ -22,6 +23,35 @@ namespace Authentication {
 
   QPair<bool, PublicIdentity> LRSAuthenticator::VerifyResponse(
       const Id &member, const QVariant &data)
+  {
+    if(!BeginResponse(member, data)) {
+      return QPair<bool, PublicIdentity>(false, PublicIdentity());
+    }
+
+    QPair<bool, PublicIdentity> result = CheckResponse(member, data);
+    EndResponse(member, data, result.first);
+    return result;
+  }
+
+  bool LRSAuthenticator::BeginResponse(const Id &, const QVariant &data)
+  {
+    QByteArray tag = GetTag(data);
+    if(tag.isEmpty()) {
+      qDebug() << "Received an invalid msg";
+      return false;
+    }
+
+    if(_tags.contains(tag) || _pending_tags.contains(tag)) {
+      qDebug() << "Already registered.";
+      return false;
+    }
+
+    _pending_tags.insert(tag);
+    return true;
+  }
+
+  QPair<bool, PublicIdentity> LRSAuthenticator::CheckResponse(
+      const Id &member, const QVariant &data) const
   {
     QVariantList msg = data.toList();
     if(msg.count() != 2) {
@@ -41,7 +71,6 @@ namespace Authentication {
       return QPair<bool, PublicIdentity>(false, PublicIdentity());
     }
 
-    qDebug() << ident.GetVerificationKey() << ident.GetVerificationKey()->IsValid();
     if(!ident.GetVerificationKey() ||
         !ident.GetVerificationKey()->IsValid())
     {
@@ -54,22 +83,37 @@ namespace Authentication {
       return QPair<bool, PublicIdentity>(false, PublicIdentity());
     }
 
-    LRSSignature lrsig(sig);
-    if(_tags.contains(lrsig.GetTag().GetByteArray())) {
-      qDebug() << "Already registered.";
+    if(!_lrs->Verify(bident, LRSSignature(sig))) {
+      qDebug() << "Invalid signature";
       return QPair<bool, PublicIdentity>(false, PublicIdentity());
     }
 
-    _tags[lrsig.GetTag().GetByteArray()] = true;
+    return QPair<bool, PublicIdentity>(true, ident);
+  }
 
-    if(!_lrs->Verify(bident, lrsig)) {
-      qDebug() << "Invalid signature";
-      return QPair<bool, PublicIdentity>(false, PublicIdentity());
+  void LRSAuthenticator::EndResponse(const Id &, const QVariant &data,
+      bool valid)
+  {
+    QByteArray tag = GetTag(data);
+    _pending_tags.remove(tag);
+    if(valid) {
+      _tags.insert(tag);
     }
+  }
 
-    return QPair<bool, PublicIdentity>(true, ident);
+  QByteArray LRSAuthenticator::GetTag(const QVariant &data)
+  {
+    QVariantList msg = data.toList();
+    if(msg.count() != 2) {
+      return QByteArray();
+    }
+
+    LRSSignature lrsig(msg[1].toByteArray());
+    if(!lrsig.IsValid()) {
+      return QByteArray();
+    }
+    return lrsig.GetTag().GetByteArray();
   }
 }
 }
 }
-
@@ -1,7 +1,8 @@
 #ifndef DISSENT_IDENTITY_LRS_AUTHENTICATOR_GUARD
 #define DISSENT_IDENTITY_LRS_AUTHENTICATOR_GUARD
 
-#include <QHash>
+#include <QByteArray>
+#include <QSet>
 #include <QVariant>
 
 #include "Crypto/LRSPublicKey.hpp"
@@ -25,6 +26,11 @@ namespace Authentication {
    * signed with his private linkable ring signature key,
    * which has the same public elements as the authenticators
    * linkable ring signature verifier.
+   *
+   * Linkage tags are indexed once a signature has been verified and
+   * reserved while one is being verified, so a second registration with
+   * the same tag is rejected before any exponentiation. Signatures can be
+   * verified concurrently through CheckResponse.
    */
   class LRSAuthenticator : public IAuthenticator {
 
@@ -32,7 +38,7 @@ namespace Authentication {
       typedef Crypto::LRSPublicKey LRSPublicKey;
 
       /**
-       * Creates a LRSAuthenticator
+       * Creates a LRSAuthenticator, precomputing the LRS's fixed-base tables
        * @param lrs the verification component for the LRS
        */
       LRSAuthenticator(const QSharedPointer<LRSPublicKey> &lrs);
@@ -56,9 +62,48 @@ namespace Authentication {
       virtual QPair<bool, PublicIdentity> VerifyResponse(const Id &member,
           const QVariant &data);
 
+      virtual bool CanCheckConcurrently() const { return true; }
+
+      /**
+       * Rejects malformed responses and those whose linkage tag is
+       * registered or being verified, otherwise reserves the tag
+       * @param member the authenticating member
+       * @param data the response data
+       */
+      virtual bool BeginResponse(const Id &member, const QVariant &data);
+
+      /**
+       * Verifies the identity and the signature, thread safe
+       * @param member the authenticating member
+       * @param data the response data
+       */
+      virtual QPair<bool, PublicIdentity> CheckResponse(const Id &member,
+          const QVariant &data) const;
+
+      /**
+       * Registers the reserved tag if valid, otherwise releases it
+       * @param member the authenticating member
+       * @param data the response data
+       * @param valid the result of CheckResponse
+       */
+      virtual void EndResponse(const Id &member, const QVariant &data,
+          bool valid);
+
+      /**
+       * Returns the number of registered linkage tags
+       */
+      inline int GetTagCount() const { return _tags.count(); }
+
     private:
+      /**
+       * Returns the linkage tag of a response or an empty array if the
+       * response is malformed
+       */
+      static QByteArray GetTag(const QVariant &data);
+
       QSharedPointer<LRSPublicKey> _lrs;
-      QHash<QByteArray, bool> _tags;
+      QSet<QByteArray> _tags;
+      QSet<QByteArray> _pending_tags;
   };
 }
 }
@@ -1,5 +1,6 @@
 #include "Crypto/CryptoFactory.hpp"
 #include "Crypto/Hash.hpp"
+#include "Utils/Xor.hpp"
 
 #include "FactorProof.hpp"
 #include "SchnorrProof.hpp"
@@ -228,11 +229,7 @@ namespace LRS {
   {
     Q_ASSERT(a.count() == b.count());
     QByteArray out(a.count(), '\0');
- 
-    for(int i=0; i<a.count(); i++) {
-      out[i] = a[i] ^ b[i];
-    }
-
+    Utils::XorBytes(out, a, b);
     return out;
   }
 
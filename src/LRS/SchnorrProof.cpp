@@ -18,7 +18,7 @@ namespace LRS {
     _group(CppECGroup::GetGroup(ECParams::NIST_P192)),
     _context(context),
     _witness(_group->RandomExponent()),
-    _witness_image(_group->Exponentiate(_group->GetGenerator(), _witness)),
+    _witness_image(_group->GetFixedBase(_group->GetGenerator()).Exponentiate(_witness)),
     _tag_generator(_group->HashIntoElement(context)),
     _linkage_tag(_group->Exponentiate(_tag_generator, _witness))
   {
@@ -78,7 +78,7 @@ namespace LRS {
     // v = random integer
     // t = g^v
     _commit_secret = _group->RandomExponent();
-    _commit_1 = _group->Exponentiate(_group->GetGenerator(), _commit_secret);
+    _commit_1 = _group->GetFixedBase(_group->GetGenerator()).Exponentiate(_commit_secret);
     _commit_2 = _group->Exponentiate(_tag_generator, _commit_secret);
 
     SetCommit(CommitBytes(_commit_1, _commit_2));
@@ -129,7 +129,7 @@ namespace LRS {
 
     // fake the first commit
     _commit_1 = _group->Exponentiate(_witness_image, _challenge);
-    const Element tmp_1 = _group->Exponentiate(_group->GetGenerator(), _response);
+    const Element tmp_1 = _group->GetFixedBase(_group->GetGenerator()).Exponentiate(_response);
     // commit = (g^r) * (g^x)^c
     _commit_1 = _group->Multiply(tmp_1, _commit_1);
 
@@ -155,12 +155,21 @@ namespace LRS {
 
   bool SchnorrProof::Verify(bool verify_challenge) const 
   {
+    // Every received element must be in the group before it is
+    // exponentiated and combined
+    if(!(_group->IsElement(_witness_image) && _group->IsElement(_linkage_tag) &&
+          _group->IsElement(_commit_1) && _group->IsElement(_commit_2)))
+    {
+      qDebug() << "Proof element not in group";
+      return false;
+    }
+
     // (g^x)^c
     Element tmp_1 = _group->Exponentiate(_witness_image, _challenge);
     Element tmp_2 = _group->Exponentiate(_linkage_tag, _challenge);
 
     // g^r
-    Element out_1 = _group->Exponentiate(_group->GetGenerator(), _response);
+    Element out_1 = _group->GetFixedBase(_group->GetGenerator()).Exponentiate(_response);
     Element out_2 = _group->Exponentiate(_tag_generator, _response);
 
     // g^{r + cx} -- should equal g^{v}
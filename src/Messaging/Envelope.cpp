@@ -0,0 +1,126 @@
+#include "Envelope.hpp"
+#include "Request.hpp"
+
+namespace Dissent {
+namespace Messaging {
+namespace {
+  /**
+   * Methods with an id, index + 1 is the id.  Ids are part of the wire
+   * format, so new methods may only be appended.
+   */
+  const char *MethodTable[] = {
+    "SM::Data",
+    "LT::TunnelData"
+  };
+
+  const int MethodCount = sizeof(MethodTable) / sizeof(MethodTable[0]);
+}
+
+  const int Envelope::Version;
+
+  int Envelope::GetMethodId(const QString &method)
+  {
+    for(int idx = 0; idx < MethodCount; idx++) {
+      if(method == QLatin1String(MethodTable[idx])) {
+        return idx + 1;
+      }
+    }
+    return -1;
+  }
+
+  QString Envelope::GetMethod(int id)
+  {
+    if(id < 1 || id > MethodCount) {
+      return QString();
+    }
+    return QString(MethodTable[id - 1]);
+  }
+
+  QByteArray Envelope::BuildHeader(int method_id, const QVariantHash &headers)
+  {
+    if(method_id < 1 || method_id > 0xFFFF) {
+      return QByteArray();
+    }
+
+    int flags = 0;
+    QByteArray session_id;
+    for(QVariantHash::const_iterator it = headers.begin();
+        it != headers.end(); ++it)
+    {
+      if(it.key() == "session_id") {
+        session_id = it.value().toByteArray();
+        if(session_id.size() > 0xFF) {
+          return QByteArray();
+        }
+        flags |= SessionIdFlag;
+      } else if(it.key() == "bulk") {
+        flags |= BulkFlag;
+        if(it.value().toBool()) {
+          flags |= BulkValueFlag;
+        }
+      } else {
+        return QByteArray();
+      }
+    }
+
+    QByteArray header;
+    header.reserve(MinimumSize + 1 + session_id.size());
+    header.append(static_cast<char>(Marker));
+    header.append(static_cast<char>(Version));
+    header.append(static_cast<char>((method_id >> 8) & 0xFF));
+    header.append(static_cast<char>(method_id & 0xFF));
+    header.append(static_cast<char>(flags));
+    if(flags & SessionIdFlag) {
+      header.append(static_cast<char>(session_id.size()));
+      header.append(session_id);
+    }
+    return header;
+  }
+
+  bool Envelope::Parse(const QByteArray &msg, QVariantList &container)
+  {
+    if(!IsEnvelope(msg)) {
+      return false;
+    }
+
+    const unsigned char *bytes =
+      reinterpret_cast<const unsigned char *>(msg.constData());
+
+    int version = bytes[1];
+    if(version < 1 || version > Version) {
+      return false;
+    }
+
+    QString method = GetMethod((bytes[2] << 8) | bytes[3]);
+    if(method.isEmpty()) {
+      return false;
+    }
+
+    int flags = bytes[4];
+    int offset = MinimumSize;
+
+    QVariantHash headers;
+    if(flags & SessionIdFlag) {
+      if(msg.size() < offset + 1) {
+        return false;
+      }
+
+      int length = bytes[offset++];
+      if(msg.size() < offset + length) {
+        return false;
+      }
+
+      headers["session_id"] = msg.mid(offset, length);
+      offset += length;
+    }
+
+    if(flags & BulkFlag) {
+      headers["bulk"] = (flags & BulkValueFlag) != 0;
+    }
+
+    headers["data"] = msg.mid(offset);
+    container = Request::BuildNotification(NotificationId, method, headers);
+    return true;
+  }
+}
+}
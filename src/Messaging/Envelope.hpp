@@ -0,0 +1,88 @@
+#ifndef DISSENT_MESSAGING_ENVELOPE_H_GUARD
+#define DISSENT_MESSAGING_ENVELOPE_H_GUARD
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+
+namespace Dissent {
+namespace Messaging {
+  /**
+   * A compact binary encoding for the notifications carrying session and
+   * tunnel data, used in place of a QDataStream serialized QVariantList once
+   * both ends of a connection have agreed upon it.  The layout is:
+   *
+   * marker (1 byte) | version (1) | method id (2) | flags (1) |
+   * [session id length (1) | session id] | data
+   *
+   * Legacy messages begin with the big-endian element count of the
+   * QVariantList and hence with a zero byte, so the two formats can always
+   * be told apart.
+   */
+  class Envelope {
+    public:
+      /**
+       * The newest envelope version understood by this implementation
+       */
+      static const int Version = 1;
+
+      /**
+       * Returns the small integer id for a method or -1 if the method has
+       * no id and must be sent using the legacy format
+       * @param method the method name
+       */
+      static int GetMethodId(const QString &method);
+
+      /**
+       * Returns the method name for an id or an empty string if unknown
+       * @param id the method id
+       */
+      static QString GetMethod(int id);
+
+      /**
+       * Builds the part of an envelope preceding the data, the same for all
+       * messages with the same method and headers
+       * @param method_id the method id
+       * @param headers the notification headers, only "session_id" and
+       * "bulk" can be expressed
+       * @returns an empty array if the headers cannot be expressed
+       */
+      static QByteArray BuildHeader(int method_id, const QVariantHash &headers);
+
+      /**
+       * Returns true if the message is an envelope rather than a legacy
+       * QVariantList
+       * @param msg the message
+       */
+      inline static bool IsEnvelope(const QByteArray &msg)
+      {
+        return (msg.size() >= MinimumSize) &&
+          (static_cast<unsigned char>(msg[0]) == Marker);
+      }
+
+      /**
+       * Parses an envelope into the equivalent notification container, see
+       * Request::BuildNotification
+       * @param msg the envelope
+       * @param container set to the notification
+       * @returns false if the envelope is invalid
+       */
+      static bool Parse(const QByteArray &msg, QVariantList &container);
+
+    private:
+      static const unsigned char Marker = 0xDE;
+      static const int MinimumSize = 5;
+
+      static const int SessionIdFlag = 0x1;
+      static const int BulkFlag = 0x2;
+      static const int BulkValueFlag = 0x4;
+
+      /**
+       * The id given to parsed notifications, which carry none
+       */
+      static const int NotificationId = 1;
+  };
+}
+}
+
+#endif
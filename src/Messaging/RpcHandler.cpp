@@ -1,9 +1,11 @@
 #include <QDataStream>
 #include <QVariant>
 
+#include "Utils/Metrics.hpp"
 #include "Utils/Time.hpp"
 #include "Utils/Timer.hpp"
 
+#include "Envelope.hpp"
 #include "RpcHandler.hpp"
 
 namespace Dissent {
@@ -12,6 +14,38 @@ namespace Messaging {
   const QString Request::RequestType = QString("r");
   const QString Response::ResponseType = QString("p");
 
+namespace {
+  using Utils::Metrics;
+
+  const Metrics::Counter &SentCounter(const QString &type)
+  {
+    static const Metrics::Counter requests = Metrics::GetCounter(
+        "dissent_rpc_sent_total", "Rpc messages sent",
+        Metrics::Label("type", "request"));
+    static const Metrics::Counter notifications = Metrics::GetCounter(
+        "dissent_rpc_sent_total", "Rpc messages sent",
+        Metrics::Label("type", "notification"));
+    static const Metrics::Counter responses = Metrics::GetCounter(
+        "dissent_rpc_sent_total", "Rpc messages sent",
+        Metrics::Label("type", "response"));
+
+    if(type == Request::RequestType) {
+      return requests;
+    } else if(type == Request::NotificationType) {
+      return notifications;
+    }
+    return responses;
+  }
+
+  void CountSent(const QString &type, const QByteArray &msg)
+  {
+    static const Metrics::Counter bytes = Metrics::GetCounter(
+        "dissent_rpc_sent_bytes_total", "Bytes of Rpc messages sent");
+    SentCounter(type).Add();
+    bytes.Add(msg.size());
+  }
+}
+
   RpcHandler::RpcHandler() :
     _current_id(1),
     _responder(new RequestResponder())
@@ -40,6 +74,9 @@ namespace Messaging {
     }
 
     qDebug() << "Pushing timeout message";
+    static const Metrics::Counter timeouts = Metrics::GetCounter(
+        "dissent_rpc_timeouts_total", "Rpc requests that timed out");
+    timeouts.Add();
 
     QSharedPointer<RequestState> state = _requests[id];
     _requests.remove(id);
@@ -52,9 +89,20 @@ namespace Messaging {
   void RpcHandler::HandleData(const QSharedPointer<ISender> &from,
       const QByteArray &data)
   {
+    static const Metrics::Counter bytes = Metrics::GetCounter(
+        "dissent_rpc_received_bytes_total", "Bytes of Rpc messages received");
+    bytes.Add(data.size());
+
     QVariantList container;
-    QDataStream stream(data);
-    stream >> container;
+    if(Envelope::IsEnvelope(data)) {
+      if(!Envelope::Parse(data, container)) {
+        qDebug() << "Received an invalid envelope from" << from->ToString();
+        return;
+      }
+    } else {
+      QDataStream stream(data);
+      stream >> container;
+    }
 
     HandleData(from, container);
   }
@@ -67,11 +115,20 @@ namespace Messaging {
     }
     
     QString type = container.at(0).toString();
+    static const Metrics::Counter requests = Metrics::GetCounter(
+        "dissent_rpc_received_total", "Rpc messages received",
+        Metrics::Label("type", "request"));
+    static const Metrics::Counter responses = Metrics::GetCounter(
+        "dissent_rpc_received_total", "Rpc messages received",
+        Metrics::Label("type", "response"));
+
     if(type == Request::RequestType ||
         type == Request::NotificationType)
     {
+      requests.Add();
       HandleRequest(Request(_responder, from, container));
     } else if(type == Response::ResponseType) {
+      responses.Add();
       HandleResponse(Response(from, container));
     } else {
       qDebug() << "Received an unknown Rpc type:" << type;
@@ -139,6 +196,11 @@ namespace Messaging {
       // better equality comparator
     }
 
+    static const Metrics::Histogram latency = Metrics::GetHistogram(
+        "dissent_rpc_request_seconds", "Time from sending an Rpc request to its response");
+    latency.Observe((Utils::Time::GetInstance().MSecsSinceEpoch() -
+          state->GetStartTime()) * 1000);
+
     state->StopTimer();
     _requests.remove(id);
     state->GetResponseHandler()->RequestComplete(response);
@@ -156,6 +218,7 @@ namespace Messaging {
 
     qDebug() << "RpcHandler: Sending notification" << id << "for" << method <<
       "to" << to->ToString();
+    CountSent(Request::NotificationType, msg);
     to->Send(msg);
   }
 
@@ -179,6 +242,7 @@ namespace Messaging {
     stream << container;
     qDebug() << "RpcHandler: Sending request" << id << "for" << method <<
       "to" << to->ToString();
+    CountSent(Request::RequestType, msg);
     to->Send(msg);
     return id;
   }
@@ -191,6 +255,7 @@ namespace Messaging {
     stream << container;
     qDebug() << "RpcHandler: Sending response" << request.GetId() <<
       "to" << request.GetFrom()->ToString();
+    CountSent(Response::ResponseType, msg);
     request.GetFrom()->Send(msg);
   }
 
@@ -205,6 +270,7 @@ namespace Messaging {
     stream << container;
     qDebug() << "RpcHandler: Sending failed response" << request.GetId() <<
       "to" << request.GetFrom()->ToString();
+    CountSent(Response::ResponseType, msg);
     request.GetFrom()->Send(msg);
   }
 
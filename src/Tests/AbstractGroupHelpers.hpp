@@ -1,6 +1,8 @@
 #ifndef DISSENT_TESTS_ABSTRACT_GROUP_HELPERS_H_GUARD
 #define DISSENT_TESTS_ABSTRACT_GROUP_HELPERS_H_GUARD
 
+#include <QtConcurrentMap>
+
 #include "DissentTest.hpp"
 
 namespace Dissent {
@@ -83,6 +85,73 @@ namespace Tests {
     }
   }
 
+  inline void AbstractGroup_FixedBase(QSharedPointer<AbstractGroup> group)
+  {
+    const Element g = group->GetGenerator();
+    const Element a = group->RandomElement();
+    const FixedBase g_fixed = group->GetFixedBase(g);
+    const FixedBase a_fixed = group->GetFixedBase(a);
+
+    EXPECT_EQ(g, g_fixed.GetBase());
+    EXPECT_EQ(a, a_fixed.GetBase());
+
+    for(int i=0; i<100; i++) {
+      Integer c = group->RandomExponent();
+      EXPECT_EQ(group->Exponentiate(g, c), g_fixed.Exponentiate(c));
+      EXPECT_EQ(group->Exponentiate(a, c), a_fixed.Exponentiate(c));
+    }
+
+    // Edges of the table and exponents that fall back to Exponentiate
+    const Integer q = group->GetOrder();
+    QList<Integer> edges;
+    edges << Integer(0) << Integer(1) << Integer(2) << (q - 1) << q << (q * q);
+
+    foreach(const Integer &c, edges) {
+      EXPECT_EQ(group->Exponentiate(g, c), g_fixed.Exponentiate(c));
+      EXPECT_EQ(group->Exponentiate(a, c), a_fixed.Exponentiate(c));
+    }
+
+    // Tables are shared between instances of the same group
+    QSharedPointer<AbstractGroup> copy = group->Copy();
+    const Integer c = group->RandomExponent();
+    EXPECT_EQ(group->Exponentiate(g, c), copy->GetFixedBase(g).Exponentiate(c));
+
+    // Handles may outlive the group that created them
+    const FixedBase outlived = group->Copy()->GetFixedBase(a);
+    EXPECT_EQ(group->Exponentiate(a, c), outlived.Exponentiate(c));
+  }
+
+  inline void AbstractGroup_MultiExponentiate(QSharedPointer<AbstractGroup> group)
+  {
+    const Integer q = group->GetOrder();
+
+    // Straus below 128 bases, Pippenger above
+    QList<int> counts;
+    counts << 0 << 1 << 2 << 7 << 40 << 150;
+
+    foreach(int count, counts) {
+      QList<Element> bases;
+      QList<Integer> exps;
+      Element expected = group->GetIdentity();
+
+      for(int i=0; i<count; i++) {
+        Element a = group->RandomElement();
+        Integer e = group->RandomExponent();
+        if(i % 10 == 3) {
+          e = 0;
+        } else if(i % 10 == 7) {
+          e = q + e;
+        }
+
+        bases.append(a);
+        exps.append(e);
+        expected = group->Multiply(expected, group->Exponentiate(a, e));
+      }
+
+      EXPECT_EQ(expected, group->MultiExponentiate(bases, exps));
+    }
+  }
+
   inline void AbstractGroup_Serialize(QSharedPointer<AbstractGroup> group)
   {
     for(int i=0; i<100; i++) {
@@ -147,6 +216,129 @@ namespace Tests {
     }
   }
 
+  /**
+   * Operations on a shared group, see AbstractGroup_ThreadSafe
+   */
+  struct AbstractGroup_Operations {
+    const AbstractGroup *group;
+    Element a;
+    Element b;
+    Integer e;
+
+    Element product;
+    Element power;
+    Element cascade;
+    Element parsed;
+    bool valid;
+  };
+
+  inline void AbstractGroup_RunOperations(AbstractGroup_Operations &ops)
+  {
+    const AbstractGroup *group = ops.group;
+    ops.product = group->Multiply(ops.a, ops.b);
+    ops.power = group->Exponentiate(ops.a, ops.e);
+    ops.cascade = group->CascadeExponentiate(ops.a, ops.e, ops.b, ops.e);
+    ops.parsed = group->ElementFromByteArray(group->ElementToByteArray(ops.power));
+    ops.valid = group->IsElement(ops.parsed);
+  }
+
+  inline void AbstractGroup_ThreadSafe(QSharedPointer<AbstractGroup> group)
+  {
+    ASSERT_TRUE(group->IsThreadSafe());
+
+    QList<AbstractGroup_Operations> serial;
+    for(int i=0; i<64; i++) {
+      AbstractGroup_Operations ops;
+      ops.group = group.data();
+      ops.a = group->RandomElement();
+      ops.b = group->RandomElement();
+      ops.e = group->RandomExponent();
+      ops.valid = false;
+      serial.append(ops);
+    }
+
+    QList<AbstractGroup_Operations> parallel = serial;
+    for(int i=0; i<serial.count(); i++) {
+      AbstractGroup_RunOperations(serial[i]);
+    }
+
+    // Every thread uses the same group
+    QtConcurrent::blockingMap(parallel, AbstractGroup_RunOperations);
+
+    for(int i=0; i<serial.count(); i++) {
+      EXPECT_EQ(serial[i].product, parallel[i].product);
+      EXPECT_EQ(serial[i].power, parallel[i].power);
+      EXPECT_EQ(serial[i].cascade, parallel[i].cascade);
+      EXPECT_EQ(serial[i].power, parallel[i].parsed);
+      EXPECT_TRUE(parallel[i].valid);
+    }
+  }
+
+  /**
+   * A digest over values shared with other threads, see
+   * AbstractGroup_SharedHashing
+   */
+  struct AbstractGroup_Hashing {
+    const AbstractGroup *group;
+    Element element;
+    const Integer *integer;
+    QByteArray digest;
+  };
+
+  inline void AbstractGroup_Hash(AbstractGroup_Hashing &hashing)
+  {
+    QScopedPointer<Dissent::Crypto::Hash> hash(
+        Dissent::Crypto::CryptoFactory::GetInstance().GetLibrary()->GetHashAlgorithm());
+    hash->Update(hashing.group->GetByteArray());
+    hash->Update(hashing.group->ElementToByteArray(hashing.element));
+    hash->Update(hashing.integer->GetByteArray());
+    hash->Update(hashing.integer->ToString().toAscii());
+    hashing.digest = hash->ComputeHash();
+  }
+
+  /**
+   * Many threads serializing and hashing the same, not yet serialized,
+   * elements and integers, as parallel proof verification does with
+   * parameters and public keys
+   */
+  inline void AbstractGroup_SharedHashing(QSharedPointer<AbstractGroup> group)
+  {
+    // Integer copies do not share data, Elements do
+    QVector<Integer> shared(16);
+    QVector<Integer> copies(16);
+    QList<AbstractGroup_Hashing> serial;
+    QList<AbstractGroup_Hashing> parallel;
+    for(int i=0; i<shared.count(); i++) {
+      Element element = group->Exponentiate(group->GetGenerator(),
+          group->RandomExponent());
+      shared[i] = group->RandomExponent();
+      copies[i] = shared[i];
+
+      // Equal values that share no cached data with the above
+      AbstractGroup_Hashing hashing;
+      hashing.group = group.data();
+      hashing.element = group->Multiply(element, group->GetIdentity());
+      hashing.integer = &copies[i];
+      serial.append(hashing);
+
+      hashing.element = element;
+      hashing.integer = &shared[i];
+      for(int j=0; j<8; j++) {
+        parallel.append(hashing);
+      }
+    }
+
+    QtConcurrent::blockingMap(parallel, AbstractGroup_Hash);
+
+    for(int i=0; i<serial.count(); i++) {
+      AbstractGroup_Hash(serial[i]);
+    }
+
+    for(int i=0; i<parallel.count(); i++) {
+      EXPECT_EQ(serial[i / 8].digest, parallel[i].digest);
+    }
+  }
+
 }
 }
 
@@ -0,0 +1,67 @@
+#include <QtConcurrentRun>
+#include "DissentTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+  void DestroyIntegers(QList<Integer> *values)
+  {
+    values->clear();
+  }
+
+  TEST(Arena, Allocation)
+  {
+    Arena::ResetCounters();
+    Arena::SetCounting(true);
+
+    Integer outside(5);
+    QList<Integer> survivors;
+    {
+      Arena arena;
+      Integer sum(0);
+      for(int idx = 0; idx < 10000; idx++) {
+        sum += Integer(idx);
+        if(idx % 100 == 0) {
+          survivors.append(sum);
+        }
+      }
+
+      {
+        Arena inner;
+        survivors.append(sum + outside);
+      }
+    }
+
+    Arena::SetCounting(false);
+    EXPECT_LT(0, Arena::GetArenaAllocations());
+    EXPECT_LT(0, Arena::GetBlockAllocations());
+    EXPECT_GT(Arena::GetArenaAllocations(), 10 * Arena::GetBlockAllocations());
+
+    // Survivors keep their blocks alive
+    EXPECT_EQ(101, survivors.count());
+    EXPECT_EQ(Integer(0), survivors[0]);
+    EXPECT_EQ(Integer(5050), survivors[1]);
+    EXPECT_EQ(Integer(49995005), survivors[100]);
+
+    // Including when released by another thread
+    QtConcurrent::run(DestroyIntegers, &survivors).waitForFinished();
+    EXPECT_TRUE(survivors.isEmpty());
+  }
+
+  TEST(Arena, Disabled)
+  {
+    Arena::SetEnabled(false);
+    Arena::ResetCounters();
+    Arena::SetCounting(true);
+    {
+      Arena arena;
+      Integer value = Integer(5) + Integer(6);
+      EXPECT_EQ(Integer(11), value);
+    }
+    Arena::SetCounting(false);
+    Arena::SetEnabled(true);
+
+    EXPECT_EQ(0, Arena::GetArenaAllocations());
+    EXPECT_LT(0, Arena::GetHeapAllocations());
+  }
+}
+}
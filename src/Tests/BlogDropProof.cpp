@@ -765,6 +765,166 @@ namespace Tests {
     cf.SetThreading(tt);
   }
 
+  void PrecomputedEndToEnd(QSharedPointer<const Parameters> params)
+  {
+    const int nservers = 3;
+    const int nclients = 4;
+    const int author_idx = 1;
+
+    QSharedPointer<Parameters> p(new Parameters(*params));
+    const int nelms = p->GetNElements();
+
+    const QSharedPointer<const PrivateKey> author_priv(new PrivateKey(params));
+    const QSharedPointer<const PublicKey> author_pk(new PublicKey(author_priv));
+
+    QList<QSharedPointer<const PublicKey> > server_pks;
+    QList<QSharedPointer<const PrivateKey> > server_sks;
+    for(int i=0; i<nservers; i++) {
+      QSharedPointer<const PrivateKey> priv(new PrivateKey(params));
+      server_sks.append(priv);
+      server_pks.append(QSharedPointer<const PublicKey>(new PublicKey(priv)));
+    }
+    QSharedPointer<const PublicKeySet> server_pk_set(new PublicKeySet(params, server_pks));
+
+    QList<QSharedPointer<const PublicKey> > client_pks;
+    QList<QSharedPointer<const PrivateKey> > client_sks;
+    QList<QSharedPointer<BlogDropClient> > clients;
+    for(int i=0; i<nclients; i++) {
+      QSharedPointer<const PrivateKey> priv(new PrivateKey(params));
+      client_sks.append(priv);
+      client_pks.append(QSharedPointer<const PublicKey>(new PublicKey(priv)));
+      clients.append(QSharedPointer<BlogDropClient>(
+            new BlogDropClient(p, priv, server_pk_set, author_pk)));
+    }
+
+    BlogDropAuthor auth(p, client_sks[author_idx], server_pk_set, author_priv);
+
+    QList<BlogDropServer> servers;
+    for(int i=0; i<nservers; i++) {
+      servers.append(BlogDropServer(p, server_sks[i], server_pk_set, author_pk));
+    }
+
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QScopedPointer<Dissent::Utils::Random> rand(lib->GetRandomNumberGenerator());
+
+    // Two phases with precomputation, the last without
+    for(int phase=0; phase<3; phase++) {
+      const bool precompute = phase < 2;
+      if(precompute) {
+        for(int i=0; i<nclients; i++) {
+          clients[i]->Precompute();
+        }
+        auth.Precompute();
+
+        for(int i=0; i<nclients; i++) {
+          clients[i]->GetPool()->WaitForFill();
+        }
+        auth.GetPool()->WaitForFill();
+        EXPECT_EQ(nelms, auth.GetPool()->Count());
+      }
+
+      auth.GetPool()->ResetCounters();
+
+      QByteArray msg(auth.MaxPlaintextLength(), 0);
+      rand->GenerateBlock(msg);
+
+      QList<QByteArray> ctexts;
+      for(int i=0; i<nclients; i++) {
+        QByteArray c = clients[i]->GenerateCoverCiphertext();
+        if(i == author_idx) {
+          ASSERT_TRUE(auth.GenerateAuthorCiphertext(c, msg));
+        }
+        ctexts.append(c);
+      }
+
+      EXPECT_EQ(precompute ? nelms : 0, auth.GetPool()->GetHits());
+      EXPECT_EQ(precompute ? 0 : nelms, auth.GetPool()->GetMisses());
+      EXPECT_EQ(0, auth.GetPool()->Count());
+
+      QList<QByteArray> s;
+      for(int i=0; i<nservers; i++) {
+        servers[i].AddClientCiphertexts(ctexts, client_pks, true);
+        s.append(servers[i].CloseBin());
+      }
+
+      for(int i=0; i<nservers; i++) {
+        ASSERT_TRUE(servers[i].AddServerCiphertexts(s, server_pks));
+        QByteArray out;
+        EXPECT_TRUE(servers[i].RevealPlaintext(out));
+        EXPECT_EQ(msg, out);
+
+        servers[i].ClearBin();
+        servers[i].NextPhase();
+      }
+
+      for(int i=0; i<nclients; i++) {
+        clients[i]->NextPhase();
+      }
+      auth.NextPhase();
+    }
+  }
+
+  TEST_P(BlogDropProofTest, CppECElGamalPrecomputed) 
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(GetParam());
+
+    PrecomputedEndToEnd(Parameters::Parameters::CppECElGamalProduction());
+
+    cf.SetThreading(tt);
+  }
+
+  TEST_P(BlogDropProofTest, IntegerHashingPrecomputed) 
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(GetParam());
+
+    PrecomputedEndToEnd(Parameters::Parameters::IntegerHashingTesting());
+
+    cf.SetThreading(tt);
+  }
+
+  TEST_P(BlogDropProofTest, PrecomputedParametersChanged)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(GetParam());
+
+    QSharedPointer<const Parameters> params = Parameters::IntegerHashingTesting();
+    QSharedPointer<Parameters> p(new Parameters(*params));
+    const int nelms = p->GetNElements();
+
+    const QSharedPointer<const PrivateKey> author_priv(new PrivateKey(params));
+    const QSharedPointer<const PublicKey> author_pk(new PublicKey(author_priv));
+    const QSharedPointer<const PrivateKey> server_priv(new PrivateKey(params));
+    QList<QSharedPointer<const PublicKey> > server_pks;
+    server_pks.append(QSharedPointer<const PublicKey>(new PublicKey(server_priv)));
+    QSharedPointer<const PublicKeySet> server_pk_set(new PublicKeySet(params, server_pks));
+    const QSharedPointer<const PrivateKey> client_priv(new PrivateKey(params));
+
+    ClientCiphertextPool pool(p, client_priv, server_pk_set, author_pk);
+    pool.StartFill(0);
+
+    // The round resizes the parameters while the pool fills
+    p->SetNElements(nelms + 1);
+    pool.WaitForFill();
+
+    EXPECT_TRUE(pool.TakeGeneratorElements(p, 0, client_priv, nelms + 1).isEmpty());
+
+    p->SetNElements(nelms);
+    EXPECT_EQ(nelms, pool.TakeGeneratorElements(p, 0, client_priv, nelms).count());
+    EXPECT_EQ(nelms, pool.GetHits());
+
+    pool.StartFill(1);
+    pool.WaitForFill();
+    p->SetNElements(nelms + 1);
+    EXPECT_TRUE(pool.TakeGeneratorElements(p, 1, client_priv, nelms + 1).isEmpty());
+
+    cf.SetThreading(tt);
+  }
+
   INSTANTIATE_TEST_CASE_P(BlogDropProof, BlogDropProofTest,
       ::testing::Values(
         CryptoFactory::SingleThreaded,
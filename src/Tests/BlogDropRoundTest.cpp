@@ -70,6 +70,66 @@ namespace Tests {
     cf.SetThreading(tt);
   }
 
+  /**
+   * Every member sends, so that every slot is open and the servers close
+   * and reveal many slots per round
+   */
+  TEST_P(BlogDropRoundTest, AllSendersManaged)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(GetParam());
+
+    ConnectionManager::UseTimer = false;
+    Timer::GetInstance().UseVirtualTime();
+
+    int count = Random::GetInstance().GetInt(TEST_RANGE_MIN, TEST_RANGE_MAX);
+
+    QVector<TestNode *> nodes;
+    Group group;
+    ConstructOverlay(count, nodes, group, Group::ManagedSubgroup);
+    CreateSessions(nodes, group, Id(),
+        SessionCreator(TCreateBlogDropRound_Testing<BlogDropRound>));
+
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QScopedPointer<Dissent::Utils::Random> rand(lib->GetRandomNumberGenerator());
+
+    QList<QByteArray> msgs;
+    for(int idx = 0; idx < count; idx++) {
+      QByteArray msg(128, 0);
+      rand->GenerateBlock(msg);
+      msgs.append(msg);
+      nodes[idx]->session->Send(msg);
+    }
+
+    SignalCounter sc;
+    for(int idx = 0; idx < count; idx++) {
+      QObject::connect(&nodes[idx]->sink, SIGNAL(DataReceived()), &sc, SLOT(Counter()));
+      nodes[idx]->session->Start();
+    }
+
+    qint64 next = Timer::GetInstance().VirtualRun();
+    while(next != -1 && sc.GetCount() < count * count) {
+      Time::GetInstance().IncrementVirtualClock(next);
+      next = Timer::GetInstance().VirtualRun();
+    }
+
+    for(int idx = 0; idx < count; idx++) {
+      ASSERT_EQ(count, nodes[idx]->sink.Count());
+      QList<QByteArray> received;
+      for(int jdx = 0; jdx < count; jdx++) {
+        received.append(nodes[idx]->sink.At(jdx).second);
+      }
+      foreach(const QByteArray &msg, msgs) {
+        EXPECT_TRUE(received.contains(msg));
+      }
+    }
+
+    CleanUp(nodes);
+    ConnectionManager::UseTimer = true;
+    cf.SetThreading(tt);
+  }
+
   INSTANTIATE_TEST_CASE_P(BlogDropRound, BlogDropRoundTest,
       ::testing::Values(
         CryptoFactory::SingleThreaded,
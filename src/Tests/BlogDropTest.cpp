@@ -60,6 +60,39 @@ namespace Tests {
     }
   }
 
+  TEST_P(BlogDropTest, PlaintextRevealAll)
+  {
+    const QSharedPointer<const Parameters> params = GetParam();
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+
+    QList<QList<Element> > cs;
+    for(int i=0; i<37; i++) {
+      QList<Element> c;
+      for(int j=0; j<params->GetNElements(); j++) {
+        c.append(params->GetMessageGroup()->RandomElement());
+      }
+      cs.append(c);
+    }
+
+    Plaintext serial(params);
+    for(int i=0; i<cs.count(); i++) {
+      serial.Reveal(cs[i]);
+    }
+
+    cf.SetThreading(CryptoFactory::SingleThreaded);
+    Plaintext single(params);
+    single.RevealAll(cs);
+    EXPECT_EQ(serial.GetElements(), single.GetElements());
+
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+    Plaintext multi(params);
+    multi.RevealAll(cs);
+    EXPECT_EQ(serial.GetElements(), multi.GetElements());
+
+    cf.SetThreading(tt);
+  }
+
   TEST_P(BlogDropTest, Keys)
   {
     const QSharedPointer<const Parameters> params = GetParam();
@@ -57,5 +57,102 @@ namespace Tests {
       SessionCreator(TCreateBulkRound<badbulk, NeffKeyShuffle>),
       Group::ManagedSubgroup, TBadGuyCB<badbulk>);
   }
+
+  TEST(CSBulkRound, BasicManagedMultithreaded)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+    RoundTest_Basic(SessionCreator(TCreateRound<CSBulkRound>),
+        Group::ManagedSubgroup);
+    cf.SetThreading(tt);
+  }
+
+  TEST(CSBulkRound, BadClientMultithreaded)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+    typedef CSBulkRoundBadClient badbulk;
+    RoundTest_BadGuy(SessionCreator(TCreateBulkRound<CSBulkRound, NeffKeyShuffle>),
+      SessionCreator(TCreateBulkRound<badbulk, NeffKeyShuffle>),
+      Group::ManagedSubgroup, TBadGuyCB<badbulk>);
+    cf.SetThreading(tt);
+  }
+
+  QVector<QSharedPointer<Random> > PadRngs(const QList<QByteArray> &seeds)
+  {
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QVector<QSharedPointer<Random> > rngs;
+    foreach(const QByteArray &seed, seeds) {
+      rngs.append(QSharedPointer<Random>(lib->GetSeekableRandomNumberGenerator(seed)));
+    }
+    return rngs;
+  }
+
+  TEST(CSBulkRound, ParallelPadsMatchSerial)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QSharedPointer<Random> rand(lib->GetRandomNumberGenerator());
+
+    // An uneven count so the chunks differ in size
+    QList<QByteArray> seeds;
+    for(int idx = 0; idx < 13; idx++) {
+      QByteArray seed(lib->RngOptimalSeedSize(), 0);
+      rand->GenerateBlock(seed);
+      seeds.append(seed);
+    }
+    int length = 4099;
+
+    QByteArray expected(length, 0);
+    QByteArray pad(length, 0);
+    foreach(const QSharedPointer<Random> &rng, PadRngs(seeds)) {
+      rng->GenerateBlock(pad);
+      XorBytes(expected, expected, pad);
+    }
+
+    cf.SetThreading(CryptoFactory::SingleThreaded);
+    QByteArray serial = CSBulkRound::XorPads(PadRngs(seeds), length);
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+    QByteArray parallel = CSBulkRound::XorPads(PadRngs(seeds), length);
+    cf.SetThreading(tt);
+
+    EXPECT_EQ(expected, serial);
+    EXPECT_EQ(serial, parallel);
+  }
+
+  TEST(CSBulkRound, BasicManagedPipelined)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+    CSBulkRound::SetPipelineDepth(3);
+    RoundTest_Basic(SessionCreator(TCreateRound<CSBulkRound>),
+        Group::ManagedSubgroup);
+    CSBulkRound::SetPipelineDepth(CSBulkRound::DEFAULT_PIPELINE_DEPTH);
+    cf.SetThreading(tt);
+  }
+
+  TEST(CSBulkRound, BadClientPipelined)
+  {
+    CSBulkRound::SetPipelineDepth(2);
+    typedef CSBulkRoundBadClient badbulk;
+    RoundTest_BadGuy(SessionCreator(TCreateBulkRound<CSBulkRound, NeffKeyShuffle>),
+      SessionCreator(TCreateBulkRound<badbulk, NeffKeyShuffle>),
+      Group::ManagedSubgroup, TBadGuyCB<badbulk>);
+    CSBulkRound::SetPipelineDepth(CSBulkRound::DEFAULT_PIPELINE_DEPTH);
+  }
+
+  TEST(CSBulkRound, BadClientLegacyPads)
+  {
+    CSBulkRound::SetPadVersion(CSBulkRound::PAD_VERSION_LEGACY);
+    typedef CSBulkRoundBadClient badbulk;
+    RoundTest_BadGuy(SessionCreator(TCreateBulkRound<CSBulkRound, NeffKeyShuffle>),
+      SessionCreator(TCreateBulkRound<badbulk, NeffKeyShuffle>),
+      Group::ManagedSubgroup, TBadGuyCB<badbulk>);
+    CSBulkRound::SetPadVersion(CSBulkRound::DEFAULT_PAD_VERSION);
+  }
 }
 }
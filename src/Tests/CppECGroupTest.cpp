@@ -51,6 +51,16 @@ namespace Tests {
     AbstractGroup_Exponentiation(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
   }
 
+  TEST_P(CppECGroupTest, FixedBase)
+  {
+    AbstractGroup_FixedBase(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
+  }
+
+  TEST_P(CppECGroupTest, MultiExponentiate)
+  {
+    AbstractGroup_MultiExponentiate(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
+  }
+
   TEST_P(CppECGroupTest, Serialize)
   {
     AbstractGroup_Serialize(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
@@ -61,6 +71,16 @@ namespace Tests {
     AbstractGroup_Encode(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
   }
 
+  TEST_P(CppECGroupTest, ThreadSafe)
+  {
+    AbstractGroup_ThreadSafe(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
+  }
+
+  TEST_P(CppECGroupTest, SharedHashing)
+  {
+    AbstractGroup_SharedHashing(CppECGroup::GetGroup((ECParams::CurveName)GetParam()));
+  }
+
   INSTANTIATE_TEST_CASE_P(CppECGroupTest, CppECGroupTest,
       ::testing::Range(0, (int)ECParams::INVALID));
 
@@ -0,0 +1,146 @@
+#include "DissentTest.hpp"
+
+#include <QTcpServer>
+
+namespace Dissent {
+namespace Tests {
+  TEST(DnsCache, Expiry)
+  {
+    Time &time = Time::GetInstance();
+    time.UseVirtualTime();
+
+    DnsCache cache;
+    cache.SetTtl(1000, 100);
+
+    QList<QHostAddress> addresses;
+    EXPECT_EQ(DnsCache::Result_Miss, cache.Lookup("example.com", addresses));
+
+    QList<QHostAddress> resolved;
+    resolved.append(QHostAddress("192.0.2.1"));
+    cache.Store("Example.COM", resolved);
+    cache.Store("missing.example.com", QList<QHostAddress>());
+    EXPECT_EQ(2, cache.Count());
+
+    EXPECT_EQ(DnsCache::Result_Hit, cache.Lookup("example.com", addresses));
+    EXPECT_EQ(resolved, addresses);
+    EXPECT_EQ(DnsCache::Result_NegativeHit, cache.Lookup("missing.example.com", addresses));
+
+    time.IncrementVirtualClock(100);
+    EXPECT_EQ(DnsCache::Result_Hit, cache.Lookup("example.com", addresses));
+    EXPECT_EQ(DnsCache::Result_Miss, cache.Lookup("missing.example.com", addresses));
+
+    time.IncrementVirtualClock(900);
+    EXPECT_EQ(DnsCache::Result_Miss, cache.Lookup("example.com", addresses));
+    EXPECT_EQ(0, cache.Count());
+
+    EXPECT_EQ(3, cache.GetHits());
+    EXPECT_EQ(3, cache.GetMisses());
+  }
+
+  TEST(DnsCache, Eviction)
+  {
+    Time &time = Time::GetInstance();
+    time.UseVirtualTime();
+
+    DnsCache cache;
+    cache.SetMaxEntries(2);
+
+    QList<QHostAddress> resolved;
+    resolved.append(QHostAddress("192.0.2.1"));
+    cache.Store("a.example.com", resolved);
+    time.IncrementVirtualClock(10);
+    cache.Store("b.example.com", resolved);
+    time.IncrementVirtualClock(10);
+    cache.Store("c.example.com", resolved);
+    EXPECT_EQ(2, cache.Count());
+
+    QList<QHostAddress> addresses;
+    EXPECT_EQ(DnsCache::Result_Miss, cache.Lookup("a.example.com", addresses));
+    EXPECT_EQ(DnsCache::Result_Hit, cache.Lookup("b.example.com", addresses));
+    EXPECT_EQ(DnsCache::Result_Hit, cache.Lookup("c.example.com", addresses));
+  }
+
+  TEST(DnsCache, Coalescing)
+  {
+    Time &time = Time::GetInstance();
+    time.UseVirtualTime();
+
+    DnsCache cache;
+    SignalCounter sc;
+    QObject::connect(&cache, SIGNAL(Resolved(const QString &, const QList<QHostAddress> &)),
+        &sc, SLOT(Counter()));
+
+    EXPECT_TRUE(cache.Resolve("coalesce.invalid"));
+    EXPECT_FALSE(cache.Resolve("Coalesce.Invalid"));
+    EXPECT_EQ(1, cache.GetCoalesced());
+
+    // Finishing the lookup answers everyone waiting on it once
+    cache.Store("coalesce.invalid", QList<QHostAddress>());
+    EXPECT_EQ(1, sc.GetCount());
+    EXPECT_TRUE(cache.Resolve("coalesce.invalid"));
+    cache.Clear();
+  }
+
+  TEST(TcpConnectionPool, Reuse)
+  {
+    Time &time = Time::GetInstance();
+    time.UseVirtualTime();
+
+    QTcpServer server;
+    ASSERT_TRUE(server.listen(QHostAddress::LocalHost, 0));
+    SocksHostAddress dest0(QHostAddress(QHostAddress::LocalHost), server.serverPort());
+    SocksHostAddress dest1(QByteArray("localhost"), server.serverPort());
+
+    DnsCache dns;
+    TcpConnectionPool pool(QNetworkProxy::NoProxy, dns);
+    EXPECT_FALSE(pool.Take(dest0));
+    EXPECT_EQ(0, pool.GetMisses());
+
+    // A destination is only kept warm once it is used again
+    pool.SetCapacity(1);
+    EXPECT_FALSE(pool.Take(dest0));
+    EXPECT_EQ(0, pool.Count());
+    EXPECT_FALSE(pool.Take(dest0));
+    EXPECT_EQ(1, pool.Count());
+
+    QTcpSocket *socket = pool.Take(dest0);
+    ASSERT_TRUE(socket);
+    EXPECT_EQ(1, pool.GetHits());
+    EXPECT_EQ(2, pool.GetMisses());
+    EXPECT_EQ(1, pool.Count());
+    delete socket;
+
+    // Only the most recently used destination stays warm
+    EXPECT_FALSE(pool.Take(dest1));
+    EXPECT_EQ(0, pool.Count());
+
+    // Host names wait for the cache and connect to its address
+    EXPECT_FALSE(pool.Take(dest1));
+    EXPECT_EQ(0, pool.Count());
+    QList<QHostAddress> resolved;
+    resolved.append(QHostAddress(QHostAddress::LocalHost));
+    dns.Store("localhost", resolved);
+    EXPECT_FALSE(pool.Take(dest1));
+    EXPECT_EQ(1, pool.Count());
+
+    socket = pool.Take(dest1);
+    ASSERT_TRUE(socket);
+    EXPECT_EQ(QHostAddress(QHostAddress::LocalHost).toString(), socket->peerName());
+    delete socket;
+
+    EXPECT_FALSE(pool.Take(dest0));
+    EXPECT_FALSE(pool.Take(dest0));
+    EXPECT_EQ(1, pool.Count());
+    EXPECT_EQ(7, pool.GetMisses());
+
+    // Idle connections expire
+    time.IncrementVirtualClock(TcpConnectionPool::IdleTimeout);
+    EXPECT_FALSE(pool.Take(dest0));
+    EXPECT_EQ(2, pool.GetHits());
+    EXPECT_EQ(8, pool.GetMisses());
+
+    pool.Clear();
+    EXPECT_EQ(0, pool.Count());
+  }
+}
+}
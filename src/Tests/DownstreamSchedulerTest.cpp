@@ -0,0 +1,128 @@
+#include "DissentTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+  namespace {
+    qint64 Total(const QList<DownstreamScheduler::Chunk> &chunks,
+        QAbstractSocket *stream)
+    {
+      qint64 total = 0;
+      foreach(const DownstreamScheduler::Chunk &chunk, chunks) {
+        if(chunk.first == stream) {
+          total += chunk.second.count();
+        }
+      }
+      return total;
+    }
+  }
+
+  TEST(DownstreamScheduler, RoundRobin)
+  {
+    QTcpSocket a, b;
+    DownstreamScheduler scheduler(1000, 1 << 20, 50);
+    scheduler.AddStream(&a);
+    scheduler.AddStream(&b);
+    EXPECT_TRUE(scheduler.IsIdle());
+
+    scheduler.Queue(&a, QByteArray(10000, 'a'));
+    scheduler.Queue(&b, QByteArray(3000, 'b'));
+    EXPECT_FALSE(scheduler.IsIdle());
+
+    // The streams alternate a quantum at a time until b drains
+    QList<DownstreamScheduler::Chunk> chunks = scheduler.Schedule();
+    ASSERT_EQ(13, chunks.count());
+    for(int idx = 0; idx < 6; idx++) {
+      EXPECT_EQ(idx % 2 ? &b : &a, chunks[idx].first);
+      EXPECT_EQ(1000, chunks[idx].second.count());
+    }
+    for(int idx = 6; idx < chunks.count(); idx++) {
+      EXPECT_EQ(&a, chunks[idx].first);
+    }
+
+    EXPECT_EQ(10000, Total(chunks, &a));
+    EXPECT_EQ(3000, Total(chunks, &b));
+    EXPECT_EQ(0, scheduler.Pending(&a));
+    EXPECT_TRUE(scheduler.IsIdle());
+  }
+
+  TEST(DownstreamScheduler, RateLimitedFairness)
+  {
+    Time &time = Time::GetInstance();
+    time.UseVirtualTime();
+
+    // 1500 bytes per interval, so a visit is regularly cut short
+    QTcpSocket a, b;
+    DownstreamScheduler scheduler(1000, 1 << 20, 50);
+    scheduler.SetRate(30000);
+    scheduler.AddStream(&a);
+    scheduler.AddStream(&b);
+    scheduler.Queue(&a, QByteArray(100000, 'a'));
+    scheduler.Queue(&b, QByteArray(100000, 'b'));
+
+    for(int idx = 1; idx <= 40; idx++) {
+      time.IncrementVirtualClock(50);
+      QList<DownstreamScheduler::Chunk> chunks = scheduler.Schedule();
+      EXPECT_EQ(1500, Total(chunks, &a) + Total(chunks, &b));
+      EXPECT_LE(qAbs(scheduler.Sent(&a) - scheduler.Sent(&b)), 1000);
+
+      // The budget is spent until the next refill
+      EXPECT_TRUE(scheduler.Schedule().isEmpty());
+    }
+
+    EXPECT_EQ(40 * 1500, scheduler.Sent(&a) + scheduler.Sent(&b));
+  }
+
+  TEST(DownstreamScheduler, WindowStall)
+  {
+    QTcpSocket a, b;
+    DownstreamScheduler scheduler(1000, 4000, 50);
+    scheduler.AddStream(&a);
+    scheduler.AddStream(&b);
+    EXPECT_EQ(4000, scheduler.GetRoom(&a));
+
+    scheduler.Queue(&a, QByteArray(4000, 'a'));
+    EXPECT_EQ(0, scheduler.GetRoom(&a));
+    EXPECT_EQ(4000, Total(scheduler.Schedule(), &a));
+
+    // Sent but unacknowledged data still fills a's window
+    EXPECT_EQ(0, scheduler.GetRoom(&a));
+
+    // A stalled stream does not hold up the other
+    scheduler.Queue(&b, QByteArray(2000, 'b'));
+    QList<DownstreamScheduler::Chunk> chunks = scheduler.Schedule();
+    EXPECT_EQ(2000, Total(chunks, &b));
+    EXPECT_EQ(0, Total(chunks, &a));
+    EXPECT_EQ(2000, scheduler.GetRoom(&b));
+
+    scheduler.Acknowledge(&a, 1500);
+    EXPECT_EQ(1500, scheduler.GetRoom(&a));
+
+    // Acks are capped at the bytes sent and never move backwards
+    scheduler.Acknowledge(&a, Q_INT64_C(1) << 40);
+    EXPECT_EQ(4000, scheduler.GetRoom(&a));
+    scheduler.Acknowledge(&a, 100);
+    EXPECT_EQ(4000, scheduler.GetRoom(&a));
+
+    scheduler.RemoveStream(&a);
+    EXPECT_FALSE(scheduler.Contains(&a));
+    EXPECT_EQ(0, scheduler.GetRoom(&a));
+  }
+
+  TEST(DownstreamScheduler, LargeRate)
+  {
+    Time &time = Time::GetInstance();
+    time.UseVirtualTime();
+
+    // 100 MB/s * 50 ms does not fit in an int
+    QTcpSocket a;
+    DownstreamScheduler scheduler(ExitTunnel::DownstreamQuantum, 1 << 30, 50);
+    scheduler.SetRate(100 * 1000 * 1000);
+    scheduler.AddStream(&a);
+    scheduler.Queue(&a, QByteArray(6 * 1000 * 1000, 'a'));
+
+    time.IncrementVirtualClock(50);
+    EXPECT_EQ(5 * 1000 * 1000, Total(scheduler.Schedule(), &a));
+    EXPECT_EQ(1000 * 1000, scheduler.Pending(&a));
+  }
+}
+}
@@ -148,6 +148,62 @@ namespace Tests {
     }
   }
 
+  TEST(Crypto, LRSPrecompute)
+  {
+    QSharedPointer<CppDsaPrivateKey> base_key(new CppDsaPrivateKey());
+    Integer generator = base_key->GetGenerator();
+    Integer subgroup = base_key->GetSubgroup();
+    Integer modulus = base_key->GetModulus();
+
+    QVector<QSharedPointer<AsymmetricKey> > priv_keys;
+    QVector<QSharedPointer<AsymmetricKey> > pub_keys;
+
+    // Large enough for Verify to build a table for the linkage tag
+    int count = LRSPublicKey::TagTableThreshold + 2;
+
+    for(int idx = 0; idx < count; idx++) {
+      QSharedPointer<CppDsaPrivateKey> key(
+          new CppDsaPrivateKey(modulus, subgroup, generator));
+      priv_keys.append(key);
+      pub_keys.append(QSharedPointer<AsymmetricKey>(key->GetPublicKey()));
+    }
+
+    CppRandom rng;
+    QByteArray context(1024, 0);
+    rng.GenerateBlock(context);
+
+    LRSPublicKey plain(pub_keys, context);
+    LRSPublicKey precomputed(pub_keys, context);
+    EXPECT_FALSE(precomputed.IsPrecomputed());
+    precomputed.Precompute();
+    EXPECT_TRUE(precomputed.IsPrecomputed());
+
+    QByteArray msg(1500, 0);
+    rng.GenerateBlock(msg);
+
+    for(int idx = 0; idx < count; idx += 5) {
+      LRSPrivateKey lrs(priv_keys[idx], pub_keys, context);
+      QByteArray signature = lrs.Sign(msg);
+      EXPECT_TRUE(plain.Verify(msg, signature));
+      EXPECT_TRUE(precomputed.Verify(msg, signature));
+
+      QByteArray bad_msg = msg;
+      bad_msg[idx] = bad_msg[idx] ^ 1;
+      EXPECT_FALSE(plain.Verify(bad_msg, signature));
+      EXPECT_FALSE(precomputed.Verify(bad_msg, signature));
+
+      // -tag has order 2q, outside the subgroup
+      LRSSignature parsed(signature);
+      QVector<Integer> sigs;
+      for(int jdx = 0; jdx < parsed.SignatureCount(); jdx++) {
+        sigs.append(parsed.GetSignature(jdx));
+      }
+      LRSSignature bad_tag(parsed.GetCommit1(), sigs, modulus - parsed.GetTag());
+      EXPECT_FALSE(plain.Verify(msg, bad_tag));
+      EXPECT_FALSE(precomputed.Verify(msg, bad_tag));
+    }
+  }
+
   TEST(Crypto, NeffShuffle)
   {
     int values = 50;
@@ -198,5 +254,61 @@ namespace Tests {
       EXPECT_TRUE(x.contains(val));
     }
   }
+
+  TEST(Crypto, NeffShuffleMultithreaded)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+
+    int values = 50;
+    int keys = 3;
+
+    QSharedPointer<CppDsaPrivateKey> base_key(new CppDsaPrivateKey());
+    Integer modulus = base_key->GetModulus();
+    Integer generator = base_key->GetGenerator();
+    Integer subgroup = base_key->GetSubgroup();
+
+    QVector<QSharedPointer<CppDsaPrivateKey> > pr_keys;
+    QVector<QSharedPointer<AsymmetricKey> > pub_keys;
+    for(int idx = 0; idx < keys; idx++) {
+      pr_keys.append(QSharedPointer<CppDsaPrivateKey>(new CppDsaPrivateKey(
+              modulus, subgroup, generator)));
+      pub_keys.append(QSharedPointer<AsymmetricKey>(pr_keys.last()->GetPublicKey()));
+    }
+
+    QVector<QByteArray> input;
+    for(int idx = 0; idx < values; idx++) {
+      Integer tmp_val = Integer::GetRandomInteger(0, subgroup);
+      input.append(CppDsaPublicKey::SeriesEncrypt(pub_keys,
+            generator.Pow(tmp_val, modulus).GetByteArray()));
+    }
+
+    CppNeffShuffle shuffle;
+    QVector<QSharedPointer<AsymmetricKey> > npub_keys = pub_keys;
+    npub_keys.pop_front();
+
+    QVector<QByteArray> output;
+    QByteArray proof;
+    EXPECT_TRUE(shuffle.Shuffle(input, pr_keys[0], npub_keys, output, proof));
+
+    // The claimed output is available before verification
+    QVector<QByteArray> claimed;
+    EXPECT_TRUE(CppNeffShuffle::GetOutput(proof, claimed));
+    EXPECT_EQ(output, claimed);
+
+    QVector<QByteArray> verified;
+    EXPECT_TRUE(shuffle.Verify(input, pub_keys, proof, verified));
+    EXPECT_EQ(output, verified);
+
+    // Verifying against the wrong input fails
+    QVector<QByteArray> bad_input = input;
+    bad_input[values / 2] = input[0];
+    EXPECT_FALSE(shuffle.Verify(bad_input, pub_keys, proof, verified));
+
+    EXPECT_FALSE(CppNeffShuffle::GetOutput(proof.left(proof.size() / 2), claimed));
+
+    cf.SetThreading(tt);
+  }
 }
 }
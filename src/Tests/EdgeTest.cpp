@@ -144,5 +144,85 @@ namespace Tests {
     MockExecLoop(sc);
     EXPECT_EQ(sc.GetCount(), 1);
   }
+
+  TEST(EdgeTest, TcpFraming)
+  {
+    Timer::GetInstance().UseRealTime();
+
+    const TcpAddress addr0("127.0.0.1", 0);
+    TcpEdgeListener te0(addr0);
+    MockEdgeHandler meh0(&te0);
+    te0.Start();
+
+    const TcpAddress addr1("127.0.0.1", 0);
+    TcpEdgeListener te1(addr1);
+    MockEdgeHandler meh1(&te1);
+    te1.Start();
+
+    te1.CreateEdgeTo(te0.GetAddress());
+    while(meh0.edge.isNull() || meh1.edge.isNull()) {
+      MockExec();
+    }
+
+    BufferSink sink;
+    meh0.edge->SetSink(&sink);
+
+    // Empty, tiny, and multi-megabyte frames, sent back to back so that they
+    // arrive split across and packed into reads
+    QList<QByteArray> msgs;
+    CppRandom rand;
+    int sizes[] = {0, 1, 7, 4096, 3 * 1024 * 1024 + 5, 0, 100};
+    for(unsigned int idx = 0; idx < sizeof(sizes) / sizeof(int); idx++) {
+      QByteArray msg(sizes[idx], 0);
+      rand.GenerateBlock(msg);
+      msgs.append(msg);
+      meh1.edge->Send(msg);
+    }
+
+    while(sink.Count() < msgs.count()) {
+      MockExec();
+    }
+
+    for(int idx = 0; idx < msgs.count(); idx++) {
+      EXPECT_EQ(msgs[idx], sink.At(idx).second);
+    }
+
+    meh1.edge->Stop("Finished");
+    te0.Stop();
+    te1.Stop();
+  }
+
+  TEST(EdgeTest, TcpOversizedFrame)
+  {
+    Timer::GetInstance().UseRealTime();
+
+    const TcpAddress addr("127.0.0.1", 0);
+    TcpEdgeListener te(addr);
+    MockEdgeHandler meh(&te);
+    te.Start();
+
+    TcpAddress local(te.GetAddress());
+    QTcpSocket socket;
+    socket.connectToHost(local.GetIP(), local.GetPort());
+    while(meh.edge.isNull()) {
+      MockExec();
+    }
+
+    BufferSink sink;
+    meh.edge->SetSink(&sink);
+
+    // Only the header is sent, the edge must not wait for or allocate the
+    // payload
+    QByteArray header(4, 0);
+    Serialization::WriteInt(TcpEdge::MaxFrameLength + 1, header, 0);
+    socket.write(header);
+    while(!meh.edge->Stopped()) {
+      MockExec();
+    }
+
+    EXPECT_EQ(0, sink.Count());
+    socket.abort();
+    te.Stop();
+  }
 }
 }
@@ -0,0 +1,87 @@
+#include "DissentTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+  TEST(Envelope, RoundTrip)
+  {
+    int method_id = Envelope::GetMethodId("SM::Data");
+    EXPECT_GT(method_id, 0);
+    EXPECT_EQ(Envelope::GetMethod(method_id), QString("SM::Data"));
+
+    Id session_id;
+    QVariantHash headers;
+    headers["session_id"] = session_id.GetByteArray();
+    headers["bulk"] = true;
+
+    QByteArray header = Envelope::BuildHeader(method_id, headers);
+    EXPECT_FALSE(header.isEmpty());
+
+    QByteArray data(1024, 0);
+    CppRandom().GenerateBlock(data);
+    QByteArray msg = header + data;
+    EXPECT_TRUE(Envelope::IsEnvelope(msg));
+
+    QVariantList container;
+    EXPECT_TRUE(Envelope::Parse(msg, container));
+    Request request(QSharedPointer<RequestResponder>(),
+        QSharedPointer<ISender>(), container);
+    EXPECT_EQ(request.GetType(), Request::NotificationType);
+    EXPECT_GT(request.GetId(), 0);
+    EXPECT_EQ(request.GetMethod(), QString("SM::Data"));
+
+    QVariantHash parsed = request.GetData().toHash();
+    EXPECT_EQ(parsed.value("session_id").toByteArray(), session_id.GetByteArray());
+    EXPECT_TRUE(parsed.value("bulk").toBool());
+    EXPECT_EQ(parsed.value("data").toByteArray(), data);
+
+    // The same message in the legacy format is larger
+    QVariantHash legacy_data(headers);
+    legacy_data["data"] = data;
+    QByteArray legacy;
+    QDataStream stream(&legacy, QIODevice::WriteOnly);
+    stream << Request::BuildNotification(1, "SM::Data", legacy_data);
+    EXPECT_FALSE(Envelope::IsEnvelope(legacy));
+    EXPECT_LT(msg.size(), legacy.size());
+
+    // Without headers
+    header = Envelope::BuildHeader(Envelope::GetMethodId("LT::TunnelData"),
+        QVariantHash());
+    EXPECT_TRUE(Envelope::Parse(header + data, container));
+    request = Request(QSharedPointer<RequestResponder>(),
+        QSharedPointer<ISender>(), container);
+    EXPECT_EQ(request.GetMethod(), QString("LT::TunnelData"));
+    EXPECT_EQ(request.GetData().toHash().value("data").toByteArray(), data);
+    EXPECT_FALSE(request.GetData().toHash().contains("session_id"));
+  }
+
+  TEST(Envelope, Invalid)
+  {
+    EXPECT_EQ(Envelope::GetMethodId("Unknown::Method"), -1);
+    EXPECT_TRUE(Envelope::BuildHeader(-1, QVariantHash()).isEmpty());
+
+    QVariantHash headers;
+    headers["session_id"] = Id().GetByteArray();
+    headers["other"] = 5;
+    EXPECT_TRUE(Envelope::BuildHeader(Envelope::GetMethodId("SM::Data"),
+          headers).isEmpty());
+
+    headers.remove("other");
+    QByteArray header = Envelope::BuildHeader(Envelope::GetMethodId("SM::Data"),
+        headers);
+    QVariantList container;
+
+    // Truncated session id
+    EXPECT_FALSE(Envelope::Parse(header.left(header.size() - 1), container));
+
+    // Unknown method
+    QByteArray bad_method = header;
+    bad_method[2] = static_cast<char>(0xFF);
+    EXPECT_FALSE(Envelope::Parse(bad_method, container));
+
+    // Future version
+    QByteArray bad_version = header;
+    bad_version[1] = static_cast<char>(Envelope::Version + 1);
+    EXPECT_FALSE(Envelope::Parse(bad_version, container));
+  }
+}
+}
@@ -30,10 +30,132 @@ namespace Tests {
     EXPECT_NE(hash1, hash2);
   }
 
+  void BatchHashTest(Hash *hashalgo)
+  {
+    // Lengths straddle block boundaries and repeat, so inputs both share
+    // and miss batches
+    CppRandom rand;
+    QVector<QByteArray> inputs;
+    for(int idx = 0; idx < 37; idx++) {
+      QByteArray data((idx * 61) % 300, 0);
+      rand.GenerateBlock(data);
+      inputs.append(data);
+    }
+
+    hashalgo->Update(inputs[1]);
+    QVector<QByteArray> hashes = hashalgo->ComputeHashes(inputs);
+    ASSERT_EQ(inputs.count(), hashes.count());
+    for(int idx = 0; idx < inputs.count(); idx++) {
+      EXPECT_EQ(hashalgo->ComputeHash(inputs[idx]), hashes[idx]);
+    }
+
+    EXPECT_TRUE(hashalgo->ComputeHashes(QVector<QByteArray>()).isEmpty());
+  }
+
   TEST(Crypto, CppHashTest)
   {
     QScopedPointer<Hash> hashalgo(new CppHash());
     HashTest(hashalgo.data());
+    BatchHashTest(hashalgo.data());
+  }
+
+  TEST(Crypto, Sha256HashTest)
+  {
+    QScopedPointer<Hash> hashalgo(new CppHash(new CryptoPP::SHA256()));
+    HashTest(hashalgo.data());
+    BatchHashTest(hashalgo.data());
+    EXPECT_EQ(QByteArray::fromHex("ba7816bf8f01cfea414140de5dae2223"
+          "b00361a396177a9cb410ff61f20015ad"), hashalgo->ComputeHash("abc"));
+  }
+
+  TEST(Crypto, Blake2bHashTest)
+  {
+    QScopedPointer<Hash> hashalgo(new Blake2bHash());
+    HashTest(hashalgo.data());
+    BatchHashTest(hashalgo.data());
+
+    // Batches leave the streaming state alone
+    QVector<QByteArray> inputs(5, QByteArray(200, 'a'));
+    hashalgo->Update("ab");
+    hashalgo->ComputeHashes(inputs);
+    hashalgo->Update("c");
+    QByteArray streamed = hashalgo->ComputeHash();
+    EXPECT_EQ(hashalgo->ComputeHash("abc"), streamed);
+
+    // RFC 7693 Appendix A
+    Blake2bHash blake512(64);
+    EXPECT_EQ(QByteArray::fromHex("ba80a53f981c4d0d6a2797b69f12f6e9"
+          "4c212f14685ac4b74b12bb6fdbffa2d17d87c5392aab792dc252d5de4533cc95"
+          "18d38aa8dbf1925ab92386edd4009923"), blake512.ComputeHash("abc"));
+    EXPECT_EQ(QByteArray::fromHex("0e5751c026e543b2e8ab2eb06099daa1"
+          "d1e5df47778f7787faab45cdf12fe3a8"), hashalgo->ComputeHash(""));
+  }
+
+  TEST(Crypto, HashSelection)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::LibraryName lname = cf.GetLibraryName();
+    CryptoFactory::HashName hname = cf.GetHashName();
+
+    cf.SetLibrary(CryptoFactory::CryptoPP);
+    int sizes[] = { 20, 32, 32 };
+    int blocks[] = { 64, 64, 128 };
+    CryptoFactory::HashName names[] = { CryptoFactory::Sha1,
+      CryptoFactory::Sha256, CryptoFactory::Blake2b };
+    for(int idx = 0; idx < 3; idx++) {
+      cf.SetHash(names[idx]);
+      QScopedPointer<Hash> hashalgo(cf.GetLibrary()->GetHashAlgorithm());
+      EXPECT_EQ(sizes[idx], hashalgo->GetDigestSize());
+      EXPECT_EQ(blocks[idx], hashalgo->GetBlockSize());
+
+      CryptoFactory::HashName parsed;
+      ASSERT_TRUE(CryptoFactory::ParseHashName(
+            CryptoFactory::HashNameToString(names[idx]), parsed));
+      EXPECT_EQ(names[idx], parsed);
+    }
+
+    CryptoFactory::HashName parsed;
+    EXPECT_FALSE(CryptoFactory::ParseHashName("md5", parsed));
+
+    cf.SetHash(hname);
+    cf.SetLibrary(lname);
+  }
+
+  TEST(Crypto, HmacTest)
+  {
+    // RFC 2202 HMAC-SHA-1 test cases 1 and 6
+    Hmac mac0(QByteArray(20, 0x0b));
+    QByteArray mac = mac0.ComputeMac("Hi There");
+    EXPECT_EQ(QByteArray::fromHex("b617318655057264e28bc0b6fb378c8ef146be00"), mac);
+    EXPECT_TRUE(mac0.VerifyMac("Hi There", mac));
+    EXPECT_FALSE(mac0.VerifyMac("Hi there", mac));
+    EXPECT_FALSE(mac0.VerifyMac("Hi There", mac.left(10)));
+
+    Hmac mac1(QByteArray(80, char(0xaa)));
+    EXPECT_EQ(QByteArray::fromHex("aa4ae5e15272d00e95705637ce8a3b55ed402112"),
+        mac1.ComputeMac("Test Using Larger Than Block-Size Key - Hash Key First"));
+  }
+
+  TEST(Crypto, HmacBlake2bTest)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::LibraryName lname = cf.GetLibraryName();
+    CryptoFactory::HashName hname = cf.GetHashName();
+    cf.SetLibrary(CryptoFactory::CryptoPP);
+    cf.SetHash(CryptoFactory::Blake2b);
+
+    // Keys are padded to BLAKE2b's 128 byte block
+    Hmac mac0(QByteArray(20, 0x0b));
+    EXPECT_EQ(QByteArray::fromHex("b6996ecae165cdb17a02becfbf442b5d"
+          "ee41c5075ded9a5763185cd68bd261d0"), mac0.ComputeMac("Hi There"));
+
+    Hmac mac1(QByteArray(131, char(0xaa)));
+    EXPECT_EQ(QByteArray::fromHex("8211788e2a5a2113c9297ab147e9e0cf"
+          "0630e83a52f1c7d46241bbe0e1fc7bdc"),
+        mac1.ComputeMac("Test Using Larger Than Block-Size Key - Hash Key First"));
+
+    cf.SetHash(hname);
+    cf.SetLibrary(lname);
   }
 }
 }
@@ -33,6 +33,18 @@ namespace Tests {
     EXPECT_TRUE(count > 30 && count < 70);
   }
 
+  TEST_P(IntegerGroupTest, FixedBase)
+  {
+    const QSharedPointer<IntegerGroup> group = IntegerGroup::GetGroup((IntegerGroup::GroupSize)GetParam());
+    AbstractGroup_FixedBase(group);
+  }
+
+  TEST_P(IntegerGroupTest, MultiExponentiate)
+  {
+    const QSharedPointer<IntegerGroup> group = IntegerGroup::GetGroup((IntegerGroup::GroupSize)GetParam());
+    AbstractGroup_MultiExponentiate(group);
+  }
+
   TEST_P(IntegerGroupTest, Serialize)
   {
     const QSharedPointer<IntegerGroup> group = IntegerGroup::GetGroup((IntegerGroup::GroupSize)GetParam());
@@ -45,6 +57,18 @@ namespace Tests {
     AbstractGroup_Encode(group);
   }
 
+  TEST_P(IntegerGroupTest, ThreadSafe)
+  {
+    const QSharedPointer<IntegerGroup> group = IntegerGroup::GetGroup((IntegerGroup::GroupSize)GetParam());
+    AbstractGroup_ThreadSafe(group);
+  }
+
+  TEST_P(IntegerGroupTest, SharedHashing)
+  {
+    const QSharedPointer<IntegerGroup> group = IntegerGroup::GetGroup((IntegerGroup::GroupSize)GetParam());
+    AbstractGroup_SharedHashing(group);
+  }
+
   INSTANTIATE_TEST_CASE_P(IntegerGroup, IntegerGroupTest,
       ::testing::Range(0, (int)IntegerGroup::INVALID));
 
@@ -1,3 +1,4 @@
+#include <QtConcurrentMap>
 #include "DissentTest.hpp"
 
 namespace Dissent {
@@ -250,6 +251,86 @@ namespace Tests {
     }
   }
 
+  class PowWork {
+    public:
+      Integer base, exp, mod, base2, exp2;
+      QByteArray expected;
+      bool passed;
+  };
+
+  void OpenPowWork(PowWork &work)
+  {
+    Integer result = work.base2 == 0 ? work.base.Pow(work.exp, work.mod) :
+      work.mod.PowCascade(work.base, work.exp, work.base2, work.exp2);
+    work.passed = result.GetByteArray() == work.expected;
+  }
+
+  TEST(Integer, OpenMontgomery)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::LibraryName cname = cf.GetLibraryName();
+
+    // Odd and even moduli, with small and large bases
+    cf.SetLibrary(CryptoFactory::OpenSSL);
+    Integer p = Integer::GetRandomInteger(1024, true);
+    QList<Integer> moduli;
+    moduli << p << p + 1 << p;
+
+    QList<QList<QByteArray> > inputs;
+    for(int idx = 0; idx < 32; idx++) {
+      Integer mod = moduli[idx % moduli.count()];
+      Integer base = (idx % 4 == 0) ? Integer(2) : Integer::GetRandomInteger(0, mod);
+      Integer exp = Integer::GetRandomInteger(0, mod);
+      Integer base2 = (idx % 3 == 0) ? Integer::GetRandomInteger(1, mod) : Integer(0);
+      Integer exp2 = Integer::GetRandomInteger(0, mod);
+      inputs.append(QList<QByteArray>() << base.GetByteArray() <<
+          exp.GetByteArray() << mod.GetByteArray() <<
+          base2.GetByteArray() << exp2.GetByteArray());
+    }
+
+    // Compute the expected results with CryptoPP
+    cf.SetLibrary(CryptoFactory::CryptoPP);
+    QList<QByteArray> expected;
+    foreach(const QList<QByteArray> &input, inputs) {
+      Integer base(input[0]), exp(input[1]), mod(input[2]);
+      Integer base2(input[3]), exp2(input[4]);
+      Integer result = base.Pow(exp, mod);
+      if(base2 != 0) {
+        result = (result * base2.Pow(exp2, mod)) % mod;
+      }
+      expected.append(result.GetByteArray());
+    }
+
+    cf.SetLibrary(CryptoFactory::OpenSSL);
+    QList<PowWork> work;
+    for(int idx = 0; idx < inputs.count(); idx++) {
+      PowWork item;
+      item.base = Integer(inputs[idx][0]);
+      item.exp = Integer(inputs[idx][1]);
+      item.mod = Integer(inputs[idx][2]);
+      item.base2 = Integer(inputs[idx][3]);
+      item.exp2 = Integer(inputs[idx][4]);
+      item.expected = expected[idx];
+      item.passed = false;
+      work.append(item);
+    }
+
+    // Once sequentially, filling the Montgomery cache, then concurrently
+    for(int idx = 0; idx < work.count(); idx++) {
+      OpenPowWork(work[idx]);
+      EXPECT_TRUE(work[idx].passed);
+      work[idx].passed = false;
+    }
+
+    QtConcurrent::blockingMap(work, OpenPowWork);
+    foreach(const PowWork &item, work) {
+      EXPECT_TRUE(item.passed);
+    }
+
+    OpenBnContext::ClearMontgomery();
+    cf.SetLibrary(cname);
+  }
+
   TEST(Integer, OpenModInverse)
   {
     for(int i=0; i<10; i++) {
@@ -0,0 +1,116 @@
+#include <QtConcurrentRun>
+
+#include "DissentTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+  namespace {
+    int CountLines(const QString &filename, const QString &marker)
+    {
+      QFile file(filename);
+      if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return 0;
+      }
+
+      int count = 0;
+      while(!file.atEnd()) {
+        if(QString(file.readLine()).contains(marker)) {
+          count++;
+        }
+      }
+      return count;
+    }
+
+    void RemoveLogs(const QString &filename, int backups)
+    {
+      QFile::remove(filename);
+      for(int idx = 1; idx <= backups + 1; idx++) {
+        QFile::remove(filename + "." + QString::number(idx));
+      }
+    }
+
+    void LogMessages(int count)
+    {
+      for(int idx = 0; idx < count; idx++) {
+        qDebug() << "LoggingSwitch" << idx;
+      }
+    }
+  }
+
+  TEST(Logging, File)
+  {
+    QString filename = "logging_test.log";
+    RemoveLogs(filename, 0);
+
+    Logging::UseFile(filename);
+    for(int idx = 0; idx < 100; idx++) {
+      qDebug() << "LoggingTest" << idx;
+    }
+    qWarning() << "LoggingTest warning";
+    Logging::Flush();
+
+    EXPECT_EQ(CountLines(filename, "LoggingTest"), 101);
+    EXPECT_EQ(CountLines(filename, "Warning - LoggingTest"), 1);
+    EXPECT_EQ(Logging::GetDroppedCount(), 0);
+
+    Logging::UseFile("test.log");
+    RemoveLogs(filename, 0);
+  }
+
+  TEST(Logging, Rotate)
+  {
+    QString filename = "logging_rotate.log";
+    int backups = 2;
+    RemoveLogs(filename, backups);
+
+    Logging::UseFile(filename, 1024, 0, backups);
+    for(int idx = 0; idx < 200; idx++) {
+      qDebug() << "LoggingTest" << idx;
+      if(idx % 10 == 0) {
+        Logging::Flush();
+      }
+    }
+    Logging::Flush();
+
+    EXPECT_TRUE(QFile::exists(filename + ".1"));
+    EXPECT_TRUE(QFile::exists(filename + ".2"));
+    EXPECT_FALSE(QFile::exists(filename + ".3"));
+    EXPECT_LE(QFileInfo(filename + ".1").size(), 2048);
+
+    Logging::UseFile("test.log");
+    RemoveLogs(filename, backups);
+  }
+
+  TEST(Logging, SwitchWhileLogging)
+  {
+    QString filenames[] = { "logging_switch0.log", "logging_switch1.log" };
+    RemoveLogs(filenames[0], 0);
+    RemoveLogs(filenames[1], 0);
+
+    Logging::UseFile(filenames[0]);
+
+    const int threads = 4;
+    const int count = 500;
+    QList<QFuture<void> > futures;
+    for(int idx = 0; idx < threads; idx++) {
+      futures.append(QtConcurrent::run(LogMessages, count));
+    }
+
+    // Every message ends up in one of the files, none in a deleted writer
+    for(int idx = 0; idx < 20; idx++) {
+      Logging::UseFile(filenames[(idx + 1) % 2]);
+    }
+
+    for(int idx = 0; idx < threads; idx++) {
+      futures[idx].waitForFinished();
+    }
+    Logging::UseFile("test.log");
+
+    EXPECT_EQ(threads * count, CountLines(filenames[0], "LoggingSwitch") +
+        CountLines(filenames[1], "LoggingSwitch"));
+
+    RemoveLogs(filenames[0], 0);
+    RemoveLogs(filenames[1], 0);
+  }
+}
+}
@@ -0,0 +1,112 @@
+#include <QDebug>
+#include "DissentTest.hpp"
+#include "WebServicesTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+
+  class CountingThread : public QThread {
+    public:
+      explicit CountingThread(const Metrics::Counter &counter) :
+        counter(counter)
+      {
+      }
+
+      const Metrics::Counter &counter;
+
+    protected:
+      virtual void run()
+      {
+        for(int idx = 0; idx < 1000; idx++) {
+          counter.Add();
+        }
+      }
+  };
+
+  TEST(Metrics, CounterAcrossThreads)
+  {
+    Metrics::Counter counter = Metrics::GetCounter("test_threads_total",
+        "Counted by several threads");
+    ASSERT_TRUE(counter.IsValid());
+
+    counter.Add(5);
+
+    QList<CountingThread *> threads;
+    for(int idx = 0; idx < 4; idx++) {
+      threads.append(new CountingThread(counter));
+      threads.last()->start();
+    }
+
+    // Exited threads are folded into the totals
+    foreach(CountingThread *thread, threads) {
+      thread->wait();
+      delete thread;
+    }
+
+    QString output = Metrics::Scrape();
+    EXPECT_TRUE(output.contains("# TYPE test_threads_total counter\n"));
+    EXPECT_TRUE(output.contains("\ntest_threads_total 4005\n"));
+  }
+
+  TEST(Metrics, SameSeries)
+  {
+    Metrics::Counter c0 = Metrics::GetCounter("test_series_total", "Series",
+        Metrics::Label("kind", "a"));
+    Metrics::Counter c1 = Metrics::GetCounter("test_series_total", "Series",
+        Metrics::Label("kind", "a"));
+    Metrics::Counter c2 = Metrics::GetCounter("test_series_total", "Series",
+        Metrics::Label("kind", "b"));
+
+    c0.Add();
+    c1.Add();
+    c2.Add(7);
+
+    QString output = Metrics::Scrape();
+    EXPECT_TRUE(output.contains("test_series_total{kind=\"a\"} 2\n"));
+    EXPECT_TRUE(output.contains("test_series_total{kind=\"b\"} 7\n"));
+
+    EXPECT_FALSE(Metrics::GetGauge("test_series_total", "Series").IsValid());
+    EXPECT_EQ(QString("k=\"a\\\"b\\\\\""), Metrics::Label("k", "a\"b\\"));
+  }
+
+  TEST(Metrics, GaugeAndHistogram)
+  {
+    Metrics::Gauge gauge = Metrics::GetGauge("test_gauge", "A gauge");
+    gauge.Set(10);
+    gauge.Set(3);
+
+    Metrics::Histogram histogram = Metrics::GetHistogram("test_seconds",
+        "A histogram", Metrics::Label("op", "x"));
+    histogram.Observe(5);
+    histogram.Observe(100);
+    histogram.Observe(20000000);
+
+    QString output = Metrics::Scrape();
+    EXPECT_TRUE(output.contains("\ntest_gauge 3\n"));
+    EXPECT_TRUE(output.contains("# TYPE test_seconds histogram\n"));
+    EXPECT_TRUE(output.contains("test_seconds_bucket{op=\"x\",le=\"1e-05\"} 1\n"));
+    EXPECT_TRUE(output.contains("test_seconds_bucket{op=\"x\",le=\"0.0001\"} 2\n"));
+    EXPECT_TRUE(output.contains("test_seconds_bucket{op=\"x\",le=\"10\"} 2\n"));
+    EXPECT_TRUE(output.contains("test_seconds_bucket{op=\"x\",le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(output.contains("test_seconds_sum{op=\"x\"} 20.000105\n"));
+    EXPECT_TRUE(output.contains("test_seconds_count{op=\"x\"} 3\n"));
+  }
+
+  TEST(Metrics, MetricsService)
+  {
+    Metrics::GetCounter("test_service_total", "Served").Add(2);
+
+    WebServiceTestSink sink;
+    MetricsService ms;
+    QObject::connect(&ms, SIGNAL(FinishedWebRequest(QSharedPointer<WebRequest>, bool)),
+       &sink, SLOT(HandleDoneRequest(QSharedPointer<WebRequest>)));
+
+    QSharedPointer<WebRequest> wrp(new WebRequest(0));
+    ms.Call(wrp);
+    ASSERT_EQ(sink.handled.count(), 1);
+    ASSERT_EQ(HttpResponse::STATUS_OK, sink.handled[0]->GetStatus());
+    EXPECT_TRUE(sink.handled[0]->GetOutputData().toString().contains(
+          "\ntest_service_total 2\n"));
+  }
+}
+}
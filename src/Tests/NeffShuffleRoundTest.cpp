@@ -15,6 +15,16 @@ namespace Tests {
         Group::ManagedSubgroup);
   }
 
+  TEST(NeffShuffle, BasicMultithreaded)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+    cf.SetThreading(CryptoFactory::MultiThreaded);
+    RoundTest_Basic(SessionCreator(TCreateRound<NeffShuffle>),
+        Group::ManagedSubgroup);
+    cf.SetThreading(tt);
+  }
+
   TEST(NeffShuffle, MultiRound)
   {
     RoundTest_MultiRound(SessionCreator(TCreateRound<NeffShuffle>),
@@ -35,7 +35,7 @@ namespace Tests {
     QByteArray sig0("sigsig");
     QByteArray req_data0("reqreqreqreq0000");
 
-    const int payload_len = 4 + sig0.count() + req_data0.count();
+    const int payload_len = 8 + sig0.count() + req_data0.count();
 
     TcpRequestPacket req0(conn0, sig0, req_data0);
 
@@ -44,6 +44,7 @@ namespace Tests {
     EXPECT_EQ(payload_len, req0.GetPayloadLength());
     EXPECT_EQ(sig0, req0.GetSignature());
     EXPECT_EQ(req_data0, req0.GetRequestData());
+    EXPECT_EQ(-1, req0.GetSequence());
 
     QByteArray ser_req0 = req0.ToByteArray();
 
@@ -60,6 +61,112 @@ namespace Tests {
     ASSERT_TRUE(rp);
     EXPECT_EQ(sig0, rp->GetSignature());
     EXPECT_EQ(req_data0, rp->GetRequestData());
+    EXPECT_EQ(-1, rp->GetSequence());
+
+    TcpRequestPacket req1(conn0, sig0, req_data0, 12345);
+    QByteArray ser_req1 = req1.ToByteArray();
+    QSharedPointer<Packet> pp1(Packet::ReadPacket(ser_req1, bytes_read));
+    ASSERT_FALSE(pp1.isNull());
+    rp = dynamic_cast<TcpRequestPacket*>(pp1.data());
+    ASSERT_TRUE(rp);
+    EXPECT_EQ(sig0, rp->GetSignature());
+    EXPECT_EQ(req_data0, rp->GetRequestData());
+    EXPECT_EQ(12345, rp->GetSequence());
+  }
+
+  TEST(Packets, KeyAgreementPacket)
+  {
+    QByteArray conn0("conn0conn0conn0conn0");
+    QByteArray dh_pub("dhdhdhdhdhdhdhdhdhdhdhdhdh");
+
+    KeyAgreementPacket kap0(conn0, dh_pub);
+    EXPECT_EQ(Packet::PacketType_KeyAgreement, kap0.GetType());
+    EXPECT_EQ(dh_pub.count(), kap0.GetPayloadLength());
+
+    QByteArray ser_kap0 = kap0.ToByteArray();
+
+    int bytes_read = 0;
+    QSharedPointer<Packet> pp0(Packet::ReadPacket(ser_kap0, bytes_read));
+
+    ASSERT_FALSE(pp0.isNull());
+    ASSERT_EQ(ser_kap0.count(), bytes_read);
+    EXPECT_EQ(conn0, pp0->GetConnectionId());
+
+    KeyAgreementPacket* kp = dynamic_cast<KeyAgreementPacket*>(pp0.data());
+    ASSERT_TRUE(kp);
+    EXPECT_EQ(dh_pub, kp->GetKeyAgreement());
+  }
+
+  TEST(Packets, TunnelMacAuthentication)
+  {
+    Library *lib = CryptoFactory::GetInstance().GetLibrary();
+    QScopedPointer<AsymmetricKey> signing_key(lib->CreatePrivateKey());
+    QScopedPointer<AsymmetricKey> verif_key(signing_key->GetPublicKey());
+    QScopedPointer<DiffieHellman> dh_key(lib->CreateDiffieHellman());
+
+    QByteArray verif_bytes = verif_key->GetByteArray();
+    QByteArray dh_pub = dh_key->GetPublicComponent();
+    QByteArray sig = signing_key->Sign(TunnelConnectionTable::KeyAgreementBytes(dh_pub));
+
+    UdpStartPacket start(verif_bytes, dh_pub, sig);
+    int bytes_read = 0;
+    QSharedPointer<Packet> pp(Packet::ReadPacket(start.ToByteArray(), bytes_read));
+    UdpStartPacket *sp = dynamic_cast<UdpStartPacket*>(pp.data());
+    ASSERT_TRUE(sp);
+    EXPECT_EQ(verif_bytes, sp->GetVerificationKey());
+    EXPECT_EQ(dh_pub, sp->GetKeyAgreement());
+    EXPECT_EQ(sig, sp->GetSignature());
+
+    TunnelConnectionTable table;
+    QUdpSocket socket;
+    QByteArray cid = sp->GetConnectionId();
+    ASSERT_TRUE(table.SaveConnection(&socket, cid, sp->GetVerificationKey()));
+    EXPECT_FALSE(table.VerifyKeyAgreement(cid, dh_pub, signing_key->Sign(dh_pub)));
+    ASSERT_TRUE(table.VerifyKeyAgreement(cid, sp->GetKeyAgreement(), sp->GetSignature()));
+
+    QByteArray exit_pub = table.AgreeKey(&socket, sp->GetKeyAgreement());
+    ASSERT_FALSE(exit_pub.isEmpty());
+    Hmac mac(dh_key->GetSharedSecret(exit_pub));
+
+    QByteArray data0("datadatadata0");
+    QByteArray data1("datadatadata1");
+    int req = Packet::PacketType_UdpRequest;
+    int ack = Packet::PacketType_TcpAck;
+
+    // Packets sent before the client has the key are signed, unsequenced
+    // and replayed packets fail
+    QByteArray sig0 = signing_key->Sign(
+        TunnelConnectionTable::AuthenticatedBytes(req, 0, data0));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, -1, data0, sig0));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 0, data0, signing_key->Sign(data0)));
+    EXPECT_TRUE(table.VerifyRequest(cid, req, 0, data0, sig0));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 0, data0, sig0));
+
+    QByteArray tag1 = mac.ComputeMac(
+        TunnelConnectionTable::AuthenticatedBytes(req, 1, data1));
+    QByteArray tag2 = mac.ComputeMac(
+        TunnelConnectionTable::AuthenticatedBytes(req, 2, data0));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 1, data0, tag1));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 2, data1, tag1));
+    // A request's MAC does not pass as an ack
+    EXPECT_FALSE(table.VerifyRequest(cid, ack, 1, data1, tag1));
+    EXPECT_TRUE(table.VerifyRequest(cid, req, 1, data1, tag1));
+    // Replays fail
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 1, data1, tag1));
+
+    // Acks are numbered apart from requests
+    QByteArray ack0 = TcpAckPacket::AuthenticatedBytes(1024);
+    QByteArray ack_tag0 = mac.ComputeMac(
+        TunnelConnectionTable::AuthenticatedBytes(ack, 0, ack0));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 0, ack0, ack_tag0));
+    EXPECT_TRUE(table.VerifyRequest(cid, ack, 0, ack0, ack_tag0));
+    EXPECT_FALSE(table.VerifyRequest(cid, ack, 0, ack0, ack_tag0));
+
+    // Once MACs are in use signed packets fail
+    QByteArray sig2 = signing_key->Sign(
+        TunnelConnectionTable::AuthenticatedBytes(req, 2, data0));
+    EXPECT_FALSE(table.VerifyRequest(cid, req, 2, data0, sig2));
+    EXPECT_TRUE(table.VerifyRequest(cid, req, 2, data0, tag2));
   }
 
   TEST(Packets, TcpResponsePacket)
@@ -67,7 +174,7 @@ namespace Tests {
     QByteArray conn0("conn0conn0conn0conn0");
     QByteArray resp_data0("resprespsfasdfasdfwjlhfw213984723948");
 
-    const int payload_len = resp_data0.count();
+    const int payload_len = 1 + resp_data0.count();
 
     TcpResponsePacket resp0(conn0, resp_data0);
 
@@ -89,7 +196,84 @@ namespace Tests {
 
     TcpResponsePacket* rp = dynamic_cast<TcpResponsePacket*>(pp0.data());
     ASSERT_TRUE(rp);
+    EXPECT_FALSE(rp->IsCompressed());
+    EXPECT_EQ(resp_data0, rp->GetResponseData());
+  }
+
+  TEST(Packets, TcpResponsePacketCompressed)
+  {
+    QByteArray conn0("conn0conn0conn0conn0");
+    QByteArray resp_data0(16 * 1024, 'r');
+
+    TcpResponsePacket resp0(conn0, resp_data0, true);
+    EXPECT_TRUE(resp0.IsCompressed());
+    EXPECT_EQ(resp_data0, resp0.GetResponseData());
+    EXPECT_GT(resp_data0.count(), resp0.GetPayloadLength());
+
+    QByteArray ser_resp0 = resp0.ToByteArray();
+
+    int bytes_read = 0;
+    QSharedPointer<Packet> pp0(Packet::ReadPacket(ser_resp0, bytes_read));
+
+    ASSERT_FALSE(pp0.isNull());
+    ASSERT_EQ(ser_resp0.count(), bytes_read);
+    EXPECT_EQ(Packet::PacketType_TcpResponse, pp0->GetType());
+
+    TcpResponsePacket* rp = dynamic_cast<TcpResponsePacket*>(pp0.data());
+    ASSERT_TRUE(rp);
+    EXPECT_TRUE(rp->IsCompressed());
     EXPECT_EQ(resp_data0, rp->GetResponseData());
+
+    // Incompressible data is sent as is
+    QByteArray resp_data1(1024, 0);
+    CppRandom rand;
+    rand.GenerateBlock(resp_data1);
+
+    TcpResponsePacket resp1(conn0, resp_data1, true);
+    EXPECT_FALSE(resp1.IsCompressed());
+    EXPECT_EQ(1 + resp_data1.count(), resp1.GetPayloadLength());
+
+    // A corrupt compressed payload is rejected
+    QByteArray bad = ser_resp0;
+    bad[bad.count() - 1] = bad[bad.count() - 1] ^ 0xff;
+    bad[bad.count() - 2] = bad[bad.count() - 2] ^ 0xff;
+    bytes_read = 0;
+    QSharedPointer<Packet> pp1(Packet::ReadPacket(bad, bytes_read));
+    EXPECT_TRUE(pp1.isNull());
+  }
+
+  TEST(Packets, TcpAckPacket)
+  {
+    QByteArray conn0("conn0conn0conn0conn0");
+    QByteArray sig0("sigsigsigsigsigsig");
+    qint64 acked = 5LL * 1024 * 1024 * 1024;
+
+    TcpAckPacket ack0(conn0, sig0, acked, 7);
+
+    EXPECT_EQ(Packet::PacketType_TcpAck, ack0.GetType());
+    EXPECT_EQ(conn0, ack0.GetConnectionId());
+    EXPECT_EQ(sig0, ack0.GetSignature());
+    EXPECT_EQ(acked, ack0.GetAcked());
+    EXPECT_EQ(7, ack0.GetSequence());
+    EXPECT_EQ(TcpAckPacket::AuthenticatedBytes(acked), ack0.GetAuthenticatedBytes());
+    EXPECT_NE(TcpAckPacket::AuthenticatedBytes(acked),
+        TcpAckPacket::AuthenticatedBytes(acked + 1));
+
+    QByteArray ser_ack0 = ack0.ToByteArray();
+
+    int bytes_read = 0;
+    QSharedPointer<Packet> pp0(Packet::ReadPacket(ser_ack0, bytes_read));
+
+    ASSERT_FALSE(pp0.isNull());
+    ASSERT_EQ(ser_ack0.count(), bytes_read);
+    EXPECT_EQ(Packet::PacketType_TcpAck, pp0->GetType());
+    EXPECT_EQ(conn0, pp0->GetConnectionId());
+
+    TcpAckPacket* ap = dynamic_cast<TcpAckPacket*>(pp0.data());
+    ASSERT_TRUE(ap);
+    EXPECT_EQ(sig0, ap->GetSignature());
+    EXPECT_EQ(acked, ap->GetAcked());
+    EXPECT_EQ(7, ap->GetSequence());
   }
 
   /*
@@ -90,5 +90,40 @@ namespace Tests {
     QScopedPointer<Library> lib(new CppLibrary());
     SeededRandomTest(lib.data());
   }
+
+  TEST(Random, CppCtrRandomSeekTest)
+  {
+    QScopedPointer<Library> lib(new CppLibrary());
+    QScopedPointer<Random> rng(lib->GetRandomNumberGenerator());
+    QByteArray seed(20, 0);
+    rng->GenerateBlock(seed);
+
+    QScopedPointer<Random> rng0(lib->GetSeekableRandomNumberGenerator(seed));
+    EXPECT_TRUE(rng0->IsSeekable());
+    QByteArray stream(4096, 0);
+    rng0->GenerateBlock(stream);
+    EXPECT_NE(stream, QByteArray(4096, 0));
+
+    QScopedPointer<Random> rng1(lib->GetSeekableRandomNumberGenerator(seed));
+    QByteArray msg(7, 0);
+    for(int idx = 0; idx < 20; idx++) {
+      int offset = rng->GetInt(0, stream.size() - msg.size());
+      EXPECT_TRUE(rng1->Seek(offset));
+      EXPECT_EQ(rng1->BytesGenerated(), uint(offset));
+      rng1->GenerateBlock(msg);
+      EXPECT_EQ(msg, stream.mid(offset, msg.size()));
+
+      QScopedPointer<Random> rng2(lib->GetSeekableRandomNumberGenerator(seed, offset));
+      rng2->GenerateBlock(msg);
+      EXPECT_EQ(msg, stream.mid(offset, msg.size()));
+    }
+
+    QScopedPointer<Random> rng3(lib->GetSeekableRandomNumberGenerator(seed));
+    QByteArray piece(3, 0);
+    for(int idx = 0; idx + piece.size() <= stream.size(); idx += piece.size()) {
+      rng3->GenerateBlock(piece);
+      EXPECT_EQ(piece, stream.mid(idx, piece.size()));
+    }
+  }
 }
 }
@@ -45,7 +45,7 @@ namespace Tests {
       "--log" << "stderr" << "--console" <<
       "--web_server_url" << "http://127.0.0.1:8000" <<
       "--entry_tunnel_url" << "tcp://127.0.0.1:8081" <<
-      "--exit_tunnel" << "--multithreading" <<
+      "--exit_tunnel" << "--multithreading" << "--timer_wheel" <<
       "--local_id" << "'HJf+qfK7oZVR3dOqeUQcM8TGeVA='" <<
       "--subgroup_policy" << "ManagedSubgroup" <<
       "--super_peer";
@@ -68,6 +68,7 @@ namespace Tests {
     EXPECT_TRUE(settings2.EntryTunnel);
     EXPECT_TRUE(settings2.ExitTunnel);
     EXPECT_TRUE(settings2.Multithreading);
+    EXPECT_TRUE(settings2.TimerWheel);
     EXPECT_TRUE(settings2.SuperPeer);
   }
 
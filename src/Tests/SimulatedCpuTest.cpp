@@ -0,0 +1,86 @@
+#include "DissentTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+
+  class CpuRecorder {
+    public:
+      QList<int> order;
+
+      void Record(const int &value)
+      {
+        order.append(value);
+        // Each event keeps the node busy for another millisecond
+        SimulatedCpu::Charge(SimulatedCpu::Sign);
+      }
+  };
+
+  TEST(SimulatedCpu, ChargeOutsideEvent)
+  {
+    Timer::GetInstance().UseVirtualTime();
+    qint64 cost = SimulatedCpu::GetCost(SimulatedCpu::Sign);
+    SimulatedCpu::SetEnabled(true);
+    SimulatedCpu::SetCost(SimulatedCpu::Sign, 1000);
+
+    SimulatedCpu::Charge(SimulatedCpu::Sign);
+    EXPECT_EQ(0, SimulatedCpu::Pending());
+    EXPECT_EQ(0, SimulatedCpu::TotalCharged());
+
+    qint64 now = Time::GetInstance().MSecsSinceEpoch() * 1000;
+    SimulatedCpu::Begin(1);
+    SimulatedCpu::Charge(SimulatedCpu::Sign, 2);
+    EXPECT_EQ(2000, SimulatedCpu::Pending());
+    SimulatedCpu::End();
+
+    EXPECT_EQ(0, SimulatedCpu::Pending());
+    EXPECT_EQ(2000, SimulatedCpu::TotalCharged());
+    EXPECT_EQ(now + 2000, SimulatedCpu::BusyUntil(1));
+    EXPECT_EQ(0, SimulatedCpu::BusyUntil(2));
+
+    SimulatedCpu::Charge(SimulatedCpu::Sign);
+    EXPECT_EQ(2000, SimulatedCpu::TotalCharged());
+
+    SimulatedCpu::SetEnabled(false);
+    SimulatedCpu::SetCost(SimulatedCpu::Sign, cost);
+  }
+
+  TEST(SimulatedCpu, RunInArrivalOrder)
+  {
+    Timer &timer = Timer::GetInstance();
+    timer.UseVirtualTime();
+    Time &time = Time::GetInstance();
+    qint64 cost = SimulatedCpu::GetCost(SimulatedCpu::Sign);
+    SimulatedCpu::SetEnabled(true);
+    SimulatedCpu::SetCost(SimulatedCpu::Sign, 1000);
+
+    CpuRecorder recorder;
+
+    // An idle node handles the event at once
+    SimulatedCpu::Run(1, new TimerMethod<CpuRecorder, int>(&recorder,
+          &CpuRecorder::Record, 0));
+    ASSERT_EQ(1, recorder.order.count());
+
+    // The rest wait for the node, in the order they arrived
+    for(int idx = 1; idx < 5; idx++) {
+      SimulatedCpu::Run(1, new TimerMethod<CpuRecorder, int>(&recorder,
+            &CpuRecorder::Record, idx));
+    }
+    EXPECT_EQ(1, recorder.order.count());
+
+    qint64 next = timer.VirtualRun();
+    while(next != -1 && recorder.order.count() < 5) {
+      time.IncrementVirtualClock(next);
+      next = timer.VirtualRun();
+    }
+
+    ASSERT_EQ(5, recorder.order.count());
+    for(int idx = 0; idx < 5; idx++) {
+      EXPECT_EQ(idx, recorder.order[idx]);
+    }
+    EXPECT_EQ(5000, SimulatedCpu::TotalCharged());
+
+    SimulatedCpu::SetEnabled(false);
+    SimulatedCpu::SetCost(SimulatedCpu::Sign, cost);
+  }
+}
+}
@@ -132,6 +132,178 @@ namespace Tests {
     qc2.Stop();
   }
 
+  class OrderTimerCallback {
+    public:
+      QList<int> order;
+
+      void Append(const int &value)
+      {
+        order.append(value);
+      }
+  };
+
+  QList<int> RunRandomSchedule(Timer::QueueType type, int seed)
+  {
+    Timer &timer = Timer::GetInstance();
+    timer.UseVirtualTime();
+    timer.SetQueueType(type);
+
+    OrderTimerCallback otc;
+    QList<TimerEvent> events;
+    qsrand(seed);
+    for(int idx = 0; idx < 2000; idx++) {
+      // Mix near, far and duplicate due times
+      int due = (idx % 3 == 0) ? qrand() % 4 : qrand() % (1 << (idx % 28));
+      int period = (idx % 17 == 0) ? 1000 + qrand() % 100000 : 0;
+      TimerMethod<OrderTimerCallback, int> *cb =
+        new TimerMethod<OrderTimerCallback, int>(&otc,
+            &OrderTimerCallback::Append, idx);
+      events.append(timer.QueueCallback(cb, due, period));
+    }
+
+    for(int idx = 0; idx < events.count(); idx += 5) {
+      events[idx].Stop();
+    }
+
+    Time &time = Time::GetInstance();
+    qint64 next = timer.VirtualRun();
+    while(next != -1 && otc.order.count() < 4000) {
+      time.IncrementVirtualClock(next);
+      next = timer.VirtualRun();
+    }
+
+    foreach(TimerEvent event, events) {
+      event.Stop();
+    }
+    timer.SetQueueType(Timer::HeapQueue);
+    return otc.order;
+  }
+
+  TEST(Time, TimerWheelVirtual)
+  {
+    Timer &timer = Timer::GetInstance();
+    timer.UseVirtualTime();
+    timer.SetQueueType(Timer::WheelQueue);
+    EXPECT_EQ(Timer::WheelQueue, timer.GetQueueType());
+
+    int sleep = 1000*1000;
+    MockTimerCallback mtc = MockTimerCallback(2);
+    TimerMethod<MockTimerCallback, int> *cb0 =
+      new TimerMethod<MockTimerCallback, int>(&mtc, &MockTimerCallback::Set, 6);
+    TimerMethod<MockTimerCallback, int> *cb1 =
+      new TimerMethod<MockTimerCallback, int>(&mtc, &MockTimerCallback::Set, 7);
+    TimerMethod<MockTimerCallback, int> *cb2 =
+      new TimerMethod<MockTimerCallback, int>(&mtc, &MockTimerCallback::Set, 5);
+    TimerEvent qc0 = timer.QueueCallback(cb0, sleep * 3);
+    TimerEvent qc1 = timer.QueueCallback(cb1, sleep * 5);
+    TimerEvent qc2 = timer.QueueCallback(cb2, sleep);
+
+    Time &time = Time::GetInstance();
+    qint64 next = timer.VirtualRun();
+    EXPECT_EQ(sleep, next);
+    EXPECT_EQ(2, mtc.value);
+
+    time.IncrementVirtualClock(next / 2);
+    timer.VirtualRun();
+    EXPECT_EQ(2, mtc.value);
+
+    time.IncrementVirtualClock(next / 2);
+    next = timer.VirtualRun();
+    EXPECT_EQ(5, mtc.value);
+    time.IncrementVirtualClock(next);
+    next = timer.VirtualRun();
+    EXPECT_EQ(6, mtc.value);
+    time.IncrementVirtualClock(next);
+    next = timer.VirtualRun();
+    EXPECT_EQ(7, mtc.value);
+    EXPECT_EQ(-1, next);
+    qc0.Stop();
+    qc1.Stop();
+    qc2.Stop();
+
+    timer.SetQueueType(Timer::HeapQueue);
+  }
+
+  TEST(Time, TimerWheelCancel)
+  {
+    Timer &timer = Timer::GetInstance();
+    timer.UseVirtualTime();
+    timer.SetQueueType(Timer::WheelQueue);
+
+    OrderTimerCallback otc;
+    QList<TimerEvent> events;
+    for(int idx = 0; idx < 1000; idx++) {
+      TimerMethod<OrderTimerCallback, int> *cb =
+        new TimerMethod<OrderTimerCallback, int>(&otc,
+            &OrderTimerCallback::Append, idx);
+      events.append(timer.QueueCallback(cb, 1 + (idx * 7919) % 100000));
+    }
+    EXPECT_EQ(1000, timer.QueuedCount());
+
+    for(int idx = 0; idx < events.count(); idx += 2) {
+      events[idx].Stop();
+    }
+    EXPECT_EQ(500, timer.QueuedCount());
+
+    Time &time = Time::GetInstance();
+    qint64 next = timer.VirtualRun();
+    while(next != -1) {
+      time.IncrementVirtualClock(next);
+      next = timer.VirtualRun();
+    }
+
+    EXPECT_EQ(0, timer.QueuedCount());
+    EXPECT_EQ(500, otc.order.count());
+    foreach(int value, otc.order) {
+      EXPECT_EQ(1, value % 2);
+    }
+
+    timer.SetQueueType(Timer::HeapQueue);
+  }
+
+  TEST(Time, TimerWheelMatchesHeap)
+  {
+    for(int seed = 0; seed < 4; seed++) {
+      QList<int> heap = RunRandomSchedule(Timer::HeapQueue, seed);
+      QList<int> wheel = RunRandomSchedule(Timer::WheelQueue, seed);
+      EXPECT_LE(4000, heap.count());
+      EXPECT_EQ(heap, wheel);
+    }
+  }
+
+  /**
+   * Records the Timer and Random instances seen by another thread
+   */
+  class InstanceThread : public QThread {
+    public:
+      InstanceThread() : timer(0), rand(0), owns_timer(false) {}
+
+      Timer *timer;
+      Random *rand;
+      bool owns_timer;
+
+    protected:
+      virtual void run()
+      {
+        timer = &Timer::GetInstance();
+        rand = &Random::GetInstance();
+        owns_timer = (timer == &Timer::GetInstance()) &&
+          (timer->thread() == QThread::currentThread());
+      }
+  };
+
+  TEST(Time, TimerPerThread)
+  {
+    InstanceThread thread;
+    thread.start();
+    thread.wait();
+
+    EXPECT_TRUE(thread.owns_timer);
+    EXPECT_NE(&Timer::GetInstance(), thread.timer);
+    EXPECT_NE(&Random::GetInstance(), thread.rand);
+    EXPECT_EQ(QThread::currentThread(), Timer::GetInstance().thread());
+  }
+
   TEST(Time, Verify_46_Hack)
   {
     qint64 MSecsPerDay = 86400000;
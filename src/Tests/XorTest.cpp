@@ -0,0 +1,99 @@
+#include "DissentTest.hpp"
+
+namespace Dissent {
+namespace Tests {
+  QByteArray ByteXor(const QByteArray &t1, const QByteArray &t2)
+  {
+    int count = std::min(t1.size(), t2.size());
+    QByteArray out(count, 0);
+    for(int idx = 0; idx < count; idx++) {
+      out[idx] = t1[idx] ^ t2[idx];
+    }
+    return out;
+  }
+
+  TEST(Xor, Lengths)
+  {
+    CppRandom rand;
+    for(int length = 0; length < 300; length++) {
+      QByteArray t1(length, 0);
+      QByteArray t2(length, 0);
+      rand.GenerateBlock(t1);
+      rand.GenerateBlock(t2);
+
+      QByteArray dst(length, 0);
+      XorBytes(dst, t1, t2);
+      EXPECT_EQ(dst, ByteXor(t1, t2));
+    }
+  }
+
+  TEST(Xor, Unaligned)
+  {
+    CppRandom rand;
+    QByteArray t1(1031, 0);
+    QByteArray t2(1031, 0);
+    rand.GenerateBlock(t1);
+    rand.GenerateBlock(t2);
+
+    for(int offset = 0; offset < 7; offset++) {
+      QByteArray s1 = QByteArray::fromRawData(t1.constData() + offset,
+          t1.size() - offset);
+      QByteArray dst(s1.size() + 3, 0);
+      char *out = dst.data() + 3;
+      XorBytes(out, s1.constData(), t2.constData(), s1.size());
+      EXPECT_EQ(dst.mid(3), ByteXor(s1, t2));
+    }
+  }
+
+  TEST(Xor, InPlace)
+  {
+    CppRandom rand;
+    QByteArray t1(4099, 0);
+    QByteArray t2(4099, 0);
+    rand.GenerateBlock(t1);
+    rand.GenerateBlock(t2);
+
+    QByteArray expected = ByteXor(t1, t2);
+    QByteArray shared = t1;
+    XorBytes(shared, shared, t2);
+    EXPECT_EQ(shared, expected);
+    EXPECT_NE(t1, expected);
+  }
+
+  TEST(Xor, MismatchedLengths)
+  {
+    CppRandom rand;
+    QByteArray t1(100, 0);
+    QByteArray t2(60, 0);
+    rand.GenerateBlock(t1);
+    rand.GenerateBlock(t2);
+
+    QByteArray dst(80, 0);
+    XorBytes(dst, t1, t2);
+    EXPECT_EQ(dst.left(60), ByteXor(t1, t2));
+    EXPECT_EQ(dst.mid(60), QByteArray(20, 0));
+  }
+
+  TEST(Xor, Accumulate)
+  {
+    CppRandom rand;
+    QByteArray expected(10000, 0);
+    QList<QByteArray> srcs;
+    for(int idx = 0; idx < 20; idx++) {
+      QByteArray src(9000 + idx * 100, 0);
+      rand.GenerateBlock(src);
+      srcs.append(src);
+      for(int jdx = 0; jdx < std::min(src.size(), expected.size()); jdx++) {
+        expected[jdx] = expected[jdx] ^ src[jdx];
+      }
+    }
+
+    QByteArray dst(10000, 0);
+    XorAccumulate(dst, srcs);
+    EXPECT_EQ(dst, expected);
+
+    XorAccumulate(dst, srcs);
+    EXPECT_EQ(dst, QByteArray(10000, 0));
+  }
+}
+}
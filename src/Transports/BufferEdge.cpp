@@ -1,5 +1,10 @@
+#include "BufferAddress.hpp"
 #include "BufferEdge.hpp"
+#include "Utils/SimulatedCpu.hpp"
+#include "Utils/Time.hpp"
 
+using Dissent::Utils::SimulatedCpu;
+using Dissent::Utils::Time;
 using Dissent::Utils::TimerCallback;
 using Dissent::Utils::Timer;
 using Dissent::Utils::TimerMethodShared;
@@ -7,8 +12,9 @@ using Dissent::Utils::TimerMethodShared;
 namespace Dissent {
 namespace Transports {
   BufferEdge::BufferEdge(const Address &local, const Address &remote,
-      bool outgoing, int delay) :
-    Edge(local, remote, outgoing), Delay(delay)
+      bool outgoing, int delay, qint64 bandwidth) :
+    Edge(local, remote, outgoing), Delay(delay), Bandwidth(bandwidth),
+    _busy_until(0)
   {
   }
 
@@ -37,11 +43,25 @@ namespace Transports {
       return;
     }
 
+    int delay = Delay;
+    if(Bandwidth > 0 || SimulatedCpu::Enabled()) {
+      // The message leaves once the sender has finished the work charged so
+      // far and earlier messages have been transmitted
+      qint64 now = Time::GetInstance().MSecsSinceEpoch() * 1000;
+      qint64 ready = now + SimulatedCpu::Pending();
+      if(Bandwidth > 0) {
+        _busy_until = qMax(_busy_until, ready) +
+          (qint64(data.size()) * 1000000) / Bandwidth;
+        ready = _busy_until;
+      }
+      delay += int((ready - now + 999) / 1000);
+    }
+
     TimerCallback *tm = new TimerMethodShared<BufferEdge, QByteArray>(
         rem_edge.dynamicCast<BufferEdge>(),
         &BufferEdge::DelayedReceive, data);
-    Timer::GetInstance().QueueCallback(tm, Delay);
-    Sent();
+    Timer::GetInstance().QueueCallback(tm, delay);
+    Sent(data.size());
   }
 
   void BufferEdge::DelayedReceive(const QByteArray &data)
@@ -49,7 +69,31 @@ namespace Transports {
     if(Stopped()) {
       return;
     }
+
+    if(!SimulatedCpu::Enabled()) {
+      PushData(GetSharedPointer(), data);
+      return;
+    }
+
+    // A node busy with charged work handles its messages afterwards, in the
+    // order they arrived
+    SimulatedCpu::Run(GetNodeId(), new TimerMethodShared<BufferEdge, QByteArray>(
+          GetSharedPointer().dynamicCast<BufferEdge>(),
+          &BufferEdge::Receive, data));
+  }
+
+  void BufferEdge::Receive(const QByteArray &data)
+  {
+    if(Stopped()) {
+      return;
+    }
+
     PushData(GetSharedPointer(), data);
   }
+
+  int BufferEdge::GetNodeId() const
+  {
+    return static_cast<const BufferAddress &>(GetLocalAddress()).GetId();
+  }
 }
 }
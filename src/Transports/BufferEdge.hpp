@@ -19,9 +19,10 @@ namespace Transports {
        * @param remote the address of the remote point of the edge
        * @param outgoing true if the remote side requested the creation of this edge
        * @param delay latency to the remote side in ms
+       * @param bandwidth bytes per second to the remote side, 0 for unlimited
        */
       explicit BufferEdge(const Address &local, const Address &remote,
-          bool outgoing, int delay = 10);
+          bool outgoing, int delay = 10, qint64 bandwidth = 0);
       
       /**
        * Destructor
@@ -43,6 +44,12 @@ namespace Transports {
        */
       const int Delay;
 
+      /**
+       * Bytes per second sent to the remote peer, messages queue behind each
+       * other when it is exceeded. 0 for unlimited.
+       */
+      const qint64 Bandwidth;
+
     private:
       /**
        * On the receiver side, handle an incoming request after it has been
@@ -51,10 +58,27 @@ namespace Transports {
        */
       void DelayedReceive(const QByteArray &data);
 
+      /**
+       * Handles a message as an event of the SimulatedCpu
+       * @param data the data sent from the remote peer
+       */
+      void Receive(const QByteArray &data);
+
+      /**
+       * The local BufferAddress id, identifies the node to the SimulatedCpu
+       */
+      int GetNodeId() const;
+
       /**
        * The remote edge
        */
       QWeakPointer<BufferEdge> _remote_edge;
+
+      /**
+       * Time in microseconds since the epoch at which the last queued
+       * message has left the edge
+       */
+      qint64 _busy_until;
   };
 }
 }
@@ -7,6 +7,7 @@ using Dissent::Utils::Random;
 namespace Dissent {
 namespace Transports {
   QHash<int, BufferEdgeListener *> BufferEdgeListener::_el_map;
+  QSharedPointer<BufferLinkModel> BufferEdgeListener::_link_model;
 
   BufferEdgeListener::BufferEdgeListener(const BufferAddress &local_address) :
     EdgeListener(local_address), _valid(false)
@@ -77,9 +78,23 @@ namespace Transports {
       return;
     }
 
-    int delay = Dissent::Utils::Random::GetInstance().GetInt(10, 50);
-    BufferEdge *local_edge(new BufferEdge(GetAddress(), remote_el->GetAddress(), true, delay));
-    BufferEdge *remote_edge(new BufferEdge(remote_el->GetAddress(), GetAddress(), false, delay));
+    int local_delay, remote_delay;
+    qint64 local_bw = 0, remote_bw = 0;
+    if(_link_model) {
+      int local_id = static_cast<const BufferAddress &>(GetAddress()).GetId();
+      int remote_id = static_cast<const BufferAddress &>(remote_el->GetAddress()).GetId();
+      local_delay = _link_model->GetLatency(local_id, remote_id);
+      remote_delay = _link_model->GetLatency(remote_id, local_id);
+      local_bw = _link_model->GetBandwidth(local_id, remote_id);
+      remote_bw = _link_model->GetBandwidth(remote_id, local_id);
+    } else {
+      local_delay = remote_delay = Random::GetInstance().GetInt(10, 50);
+    }
+
+    BufferEdge *local_edge(new BufferEdge(GetAddress(),
+          remote_el->GetAddress(), true, local_delay, local_bw));
+    BufferEdge *remote_edge(new BufferEdge(remote_el->GetAddress(),
+          GetAddress(), false, remote_delay, remote_bw));
 
     QSharedPointer<BufferEdge> ledge(local_edge);
     SetSharedPointer(ledge);
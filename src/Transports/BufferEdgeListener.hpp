@@ -2,9 +2,11 @@
 #define DISSENT_TRANSPORTS_BUFFER_EDGE_LISTENER_H_GUARD
 
 #include <QHash>
+#include <QSharedPointer>
 
 #include "BufferAddress.hpp"
 #include "BufferEdge.hpp"
+#include "BufferLinkModel.hpp"
 #include "EdgeListener.hpp"
 
 namespace Dissent {
@@ -24,12 +26,24 @@ namespace Transports {
 
       virtual void CreateEdgeTo(const Address &to);
 
+      /**
+       * Sets the model used for the latency and bandwidth of new edges, when
+       * unset edges have a random latency of 10 to 50 ms and no bandwidth
+       * limit
+       * @param model the link model, a null pointer to unset it
+       */
+      static void SetLinkModel(const QSharedPointer<BufferLinkModel> &model)
+      {
+        _link_model = model;
+      }
+
     protected:
       virtual void OnStart();
       virtual void OnStop();
 
     private:
       static QHash<int, BufferEdgeListener *> _el_map;
+      static QSharedPointer<BufferLinkModel> _link_model;
       bool _valid;
   };
 }
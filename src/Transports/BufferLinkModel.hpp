@@ -0,0 +1,36 @@
+#ifndef DISSENT_TRANSPORTS_BUFFER_LINK_MODEL_H_GUARD
+#define DISSENT_TRANSPORTS_BUFFER_LINK_MODEL_H_GUARD
+
+#include <QtGlobal>
+
+namespace Dissent {
+namespace Transports {
+  /**
+   * Describes the links between BufferEdgeListeners, allowing simulations
+   * to model network topologies. Each direction of a link is described on
+   * its own.
+   */
+  class BufferLinkModel {
+    public:
+      virtual ~BufferLinkModel() {}
+
+      /**
+       * Returns the latency in ms of messages sent from one BufferAddress id
+       * to another
+       * @param from the sender's id
+       * @param to the receiver's id
+       */
+      virtual int GetLatency(int from, int to) = 0;
+
+      /**
+       * Returns the bandwidth in bytes per second available for messages
+       * sent from one BufferAddress id to another, 0 for unlimited
+       * @param from the sender's id
+       * @param to the receiver's id
+       */
+      virtual qint64 GetBandwidth(int from, int to) = 0;
+  };
+}
+}
+
+#endif
@@ -7,7 +7,8 @@ namespace Transports {
     _remote_address(remote),
     _remote_p_addr(remote),
     _outbound(outbound),
-    _last_incoming(Utils::Time::GetInstance().MSecsSinceEpoch())
+    _last_incoming(Utils::Time::GetInstance().MSecsSinceEpoch()),
+    _wire_version(0)
   {
   }
 
@@ -6,6 +6,7 @@
 
 #include "Messaging/ISender.hpp"
 #include "Messaging/SourceObject.hpp"
+#include "Utils/Metrics.hpp"
 #include "Utils/StartStop.hpp"
 #include "Utils/Time.hpp"
 
@@ -93,6 +94,18 @@ namespace Transports {
 
       static QByteArray PingPacket();
 
+      /**
+       * Returns the envelope version agreed upon with the remote peer, 0 if
+       * only the legacy message format may be used, see Messaging::Envelope
+       */
+      inline int GetWireVersion() const { return _wire_version; }
+
+      /**
+       * Sets the envelope version agreed upon with the remote peer
+       * @param version the version
+       */
+      inline void SetWireVersion(int version) { _wire_version = version; }
+
       static const int MaximumInterpacketDelay = 15000;
 
     signals:
@@ -105,6 +118,13 @@ namespace Transports {
       inline virtual void PushData(const QSharedPointer<ISender> &from,
           const QByteArray &data)
       {
+        static const Utils::Metrics::Counter frames = Utils::Metrics::GetCounter(
+            "dissent_edge_received_frames_total", "Messages received on edges");
+        static const Utils::Metrics::Counter bytes = Utils::Metrics::GetCounter(
+            "dissent_edge_received_bytes_total", "Bytes of messages received on edges");
+        frames.Add();
+        bytes.Add(data.size());
+
         _last_incoming = Utils::Time::GetInstance().MSecsSinceEpoch();
         if(data == PingPacket()) {
           return;
@@ -114,8 +134,19 @@ namespace Transports {
         SourceObject::PushData(from, data);
       }
 
-      inline void Sent()
+      /**
+       * Called by subclasses after sending a message
+       * @param size the size of the message
+       */
+      inline void Sent(int size)
       {
+        static const Utils::Metrics::Counter frames = Utils::Metrics::GetCounter(
+            "dissent_edge_sent_frames_total", "Messages sent on edges");
+        static const Utils::Metrics::Counter bytes = Utils::Metrics::GetCounter(
+            "dissent_edge_sent_bytes_total", "Bytes of messages sent on edges");
+        frames.Add();
+        bytes.Add(size);
+
         _last_outgoing = Utils::Time::GetInstance().MSecsSinceEpoch();
       }
 
@@ -142,6 +173,7 @@ namespace Transports {
       bool _outbound;
       qint64 _last_incoming;
       qint64 _last_outgoing;
+      int _wire_version;
   };
 }
 }
@@ -1,7 +1,16 @@
 #include "TcpEdge.hpp"
+#include "Utils/Metrics.hpp"
 #include "Utils/Serialization.hpp"
 #include "Utils/Time.hpp"
 
+// Q_OS_LINUX is only defined once a Qt header has been included
+#if defined(Q_OS_LINUX)
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+using Dissent::Utils::Metrics;
 using Dissent::Utils::Serialization;
 
 namespace Dissent {
@@ -12,7 +21,10 @@ namespace Transports {
       QTcpSocket *socket) :
     Edge(local, remote, outgoing),
     _socket(socket, &QObject::deleteLater),
-    _connected(true)
+    _connected(true),
+    _frame_length(-1),
+    _frame_read(0),
+    _header(4, 0)
   {
     socket->setParent(0);
 
@@ -37,55 +49,146 @@ namespace Transports {
       return;
     }
 
-    QByteArray length(4, 0);
-    Serialization::WriteInt(data.size(), length, 0);
-    if((_socket->write(length) != 4) ||
-        (_socket->write(data) != data.size()) ||
-        (_socket->write(Zero) != 4))
-    {
+    if(!WriteFrame(data)) {
       qCritical() << "Didn't write all data to the socket!!!!!";
     }
-    Sent();
+    Sent(data.size());
+  }
+
+  bool TcpEdge::WriteFrame(const QByteArray &data)
+  {
+    Serialization::WriteInt(data.size(), _header, 0);
+
+    const char *parts[3] = { _header.constData(), data.constData(), Zero.constData() };
+    const qint64 lengths[3] = { 4, data.size(), 4 };
+    qint64 written = 0;
+
+#if defined(Q_OS_LINUX)
+    // Anything already buffered by the socket must go out first
+    int fd = _socket->socketDescriptor();
+    if(fd != -1 && _socket->bytesToWrite() == 0) {
+      struct iovec iov[3];
+      for(int idx = 0; idx < 3; idx++) {
+        iov[idx].iov_base = const_cast<char *>(parts[idx]);
+        iov[idx].iov_len = lengths[idx];
+      }
+
+      struct msghdr msg;
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_iov = iov;
+      msg.msg_iovlen = 3;
+
+      // On failure, e.g., EAGAIN, nothing was sent and the socket's own
+      // write path below takes over, including reporting errors
+      ssize_t res = ::sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+      if(res > 0) {
+        written = res;
+      }
+    }
+#endif
+
+    static const Metrics::Counter wire = Metrics::GetCounter(
+        "dissent_tcp_edge_written_bytes_total",
+        "Bytes written to Tcp edges, including framing");
+    static const Metrics::Counter queued = Metrics::GetCounter(
+        "dissent_tcp_edge_queued_bytes_total",
+        "Bytes written to Tcp edges that the kernel did not accept at once");
+    wire.Add(data.size() + 8);
+    queued.Add(data.size() + 8 - written);
+
+    // Queue whatever the kernel did not accept
+    bool success = true;
+    for(int idx = 0; idx < 3; idx++) {
+      if(written >= lengths[idx]) {
+        written -= lengths[idx];
+        continue;
+      }
+
+      qint64 remaining = lengths[idx] - written;
+      success &= (_socket->write(parts[idx] + written, remaining) == remaining);
+      written = 0;
+    }
+    return success;
+  }
+
+  void TcpEdge::PrepareFrame(int length)
+  {
+    if(_frame.isDetached() && _frame.capacity() >= length) {
+      _frame.resize(length);
+    } else {
+      _frame = QByteArray();
+      _frame.resize(length);
+    }
+    _frame_length = length;
+    _frame_read = 0;
   }
 
   void TcpEdge::Read()
   {
-    int total_length = _socket->bytesAvailable();
     qint64 stime = Utils::Time::GetInstance().MSecsSinceEpoch();
     qint64 ntime = stime;
     bool delay = false;
 
-    while(total_length >= 8 && !delay) {
-      QByteArray length_arr = _socket->peek(4);
-      if(length_arr.isEmpty()) {
-        qCritical() << "Error reading Tcp socket in" << ToString();
-        Stop("Error reading Tcp socket");
-        return;
+    while(!delay) {
+      if(_frame_length < 0) {
+        if(_socket->bytesAvailable() < 4) {
+          break;
+        }
+
+        char header[4];
+        if(_socket->read(header, 4) != 4) {
+          qCritical() << "Error reading Tcp socket in" << ToString();
+          Stop("Error reading Tcp socket");
+          return;
+        }
+
+        int length = Serialization::ReadInt(QByteArray::fromRawData(header, 4), 0);
+        if(length < 0 || length > MaxFrameLength) {
+          qWarning() << "Invalid frame length" << length << "in" << ToString();
+          Stop("Invalid frame length");
+          return;
+        }
+
+        PrepareFrame(length);
       }
 
-      int length = Serialization::ReadInt(length_arr, 0);
-      if(length + 8 > total_length) {
-        break;
-      }
-
-      if(length < 0) {
-        Stop("Error reading Tcp socket");
-        return;
+      // Read the payload straight into the buffer handed to the sink
+      if(_frame_read < _frame_length) {
+        qint64 read = _socket->read(_frame.data() + _frame_read,
+            _frame_length - _frame_read);
+        if(read < 0) {
+          Stop("Error reading Tcp socket");
+          qCritical() << "Error reading Tcp socket in" << ToString();
+          return;
+        }
+
+        _frame_read += read;
+        if(_frame_read < _frame_length) {
+          break;
+        }
       }
 
-      QByteArray msg = _socket->read(length + 8);
-      if(msg.isEmpty()) {
-        Stop("Error reading Tcp socket");
-        qCritical() << "Error reading Tcp socket in" << ToString();
-        return;
+      if(_socket->bytesAvailable() < 4) {
+        break;
       }
 
-      if(Serialization::ReadInt(msg, length + 4) != 0) {
+      char trailer[4];
+      if((_socket->read(trailer, 4) != 4) ||
+          (Serialization::ReadInt(QByteArray::fromRawData(trailer, 4), 0) != 0))
+      {
         qCritical() << "Mismatch on byte array!";
       }
 
-      PushData(GetSharedPointer(), msg.mid(4, length));
-      total_length = _socket->bytesAvailable();
+      static const Metrics::Counter wire = Metrics::GetCounter(
+          "dissent_tcp_edge_read_bytes_total",
+          "Bytes read from Tcp edges, including framing");
+      wire.Add(_frame_length + 8);
+
+      // Hand out a reference, so that a nested Read does not reuse the
+      // buffer while the sink is still processing it
+      _frame_length = -1;
+      QByteArray frame = _frame;
+      PushData(GetSharedPointer(), frame);
       ntime = Utils::Time::GetInstance().MSecsSinceEpoch();
       delay = (ntime - stime) > 1000;
     }
@@ -17,6 +17,12 @@ namespace Transports {
     public:
       static const QByteArray Zero;
 
+      /**
+       * The largest payload accepted from a peer, larger frames close the
+       * edge before anything is allocated for them
+       */
+      static const int MaxFrameLength = 64 * 1024 * 1024;
+
       /**
        * Constructor
        * @param local the local address of the edge
@@ -69,9 +75,45 @@ namespace Transports {
       void Read();
 
     private:
+      /**
+       * Ensures _frame is an unshared buffer of length bytes, reusing the
+       * previous frame's allocation if the sink has released it
+       * @param length the payload length
+       */
+      void PrepareFrame(int length);
+
+      /**
+       * Writes the header, payload, and trailer in a single gathered write
+       * when the socket's write buffer is empty, queueing any remainder
+       * with the socket
+       * @param data the payload
+       */
+      bool WriteFrame(const QByteArray &data);
+
       QSharedPointer<QTcpSocket> _socket;
       bool _connected;
 
+      /**
+       * The payload currently being read, handed directly to the sink once
+       * complete
+       */
+      QByteArray _frame;
+
+      /**
+       * Length of the payload being read or -1 if waiting on a header
+       */
+      int _frame_length;
+
+      /**
+       * Bytes of the payload read so far
+       */
+      int _frame_read;
+
+      /**
+       * Reusable buffer for outgoing frame headers
+       */
+      QByteArray _header;
+
     signals:
       void DelayedRead();
   };
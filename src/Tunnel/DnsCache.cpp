@@ -0,0 +1,127 @@
+#include <QDebug>
+
+#include "Utils/Time.hpp"
+
+#include "DnsCache.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+
+  DnsCache::DnsCache() :
+    _positive_ttl(DefaultPositiveTtl),
+    _negative_ttl(DefaultNegativeTtl),
+    _max_entries(DefaultMaxEntries),
+    _hits(0),
+    _misses(0),
+    _coalesced(0)
+  {
+  }
+
+  DnsCache::~DnsCache()
+  {
+    Clear();
+  }
+
+  DnsCache::Result DnsCache::Lookup(const QString &name, QList<QHostAddress> &addresses)
+  {
+    QString key = name.toLower();
+    QHash<QString, Entry>::iterator it = _entries.find(key);
+    if(it == _entries.end()) {
+      _misses++;
+      return Result_Miss;
+    }
+
+    qint64 now = Dissent::Utils::Time::GetInstance().MSecsSinceEpoch();
+    if(it->expires <= now) {
+      _entries.erase(it);
+      _misses++;
+      return Result_Miss;
+    }
+
+    _hits++;
+    addresses = it->addresses;
+    return addresses.isEmpty() ? Result_NegativeHit : Result_Hit;
+  }
+
+  bool DnsCache::Resolve(const QString &name)
+  {
+    QString key = name.toLower();
+    if(_in_flight.contains(key)) {
+      _coalesced++;
+      return false;
+    }
+
+    int lookup_id = QHostInfo::lookupHost(key, this,
+        SLOT(LookupFinished(const QHostInfo &)));
+    _in_flight[key] = lookup_id;
+    _lookups[lookup_id] = key;
+    return true;
+  }
+
+  void DnsCache::Store(const QString &name, const QList<QHostAddress> &addresses)
+  {
+    QString key = name.toLower();
+    if(_in_flight.contains(key)) {
+      _lookups.remove(_in_flight.take(key));
+    }
+
+    if(!_entries.contains(key)) {
+      while(_max_entries > 0 && _entries.count() >= _max_entries) {
+        Evict();
+      }
+    }
+
+    qint64 now = Dissent::Utils::Time::GetInstance().MSecsSinceEpoch();
+    Entry entry = {addresses, now + (addresses.isEmpty() ? _negative_ttl : _positive_ttl)};
+    _entries[key] = entry;
+
+    emit Resolved(key, addresses);
+  }
+
+  void DnsCache::Clear()
+  {
+    foreach(int lookup_id, _lookups.keys()) {
+      QHostInfo::abortHostLookup(lookup_id);
+    }
+
+    _lookups.clear();
+    _in_flight.clear();
+    _entries.clear();
+  }
+
+  void DnsCache::SetTtl(int positive, int negative)
+  {
+    _positive_ttl = positive;
+    _negative_ttl = negative;
+  }
+
+  void DnsCache::LookupFinished(const QHostInfo &host_info)
+  {
+    if(!_lookups.contains(host_info.lookupId())) {
+      return;
+    }
+
+    QList<QHostAddress> addresses;
+    if(host_info.error() == QHostInfo::NoError) {
+      addresses = host_info.addresses();
+    }
+
+    qDebug() << "DNS resolved" << _lookups[host_info.lookupId()] << addresses.count();
+    Store(_lookups[host_info.lookupId()], addresses);
+  }
+
+  void DnsCache::Evict()
+  {
+    QHash<QString, Entry>::iterator oldest = _entries.begin();
+    for(QHash<QString, Entry>::iterator it = _entries.begin(); it != _entries.end(); it++) {
+      if(it->expires < oldest->expires) {
+        oldest = it;
+      }
+    }
+
+    if(oldest != _entries.end()) {
+      _entries.erase(oldest);
+    }
+  }
+}
+}
@@ -0,0 +1,153 @@
+#ifndef DISSENT_TUNNEL_DNS_CACHE_H_GUARD
+#define DISSENT_TUNNEL_DNS_CACHE_H_GUARD
+
+#include <QHash>
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+namespace Dissent {
+namespace Tunnel {
+
+  /**
+   * Caches host name resolutions for the exit tunnel. Successful lookups
+   * are kept for PositiveTtl and failed lookups for NegativeTtl
+   * milliseconds, QHostInfo does not report the record's own TTL.
+   * Concurrent requests for a name share a single lookup.
+   */
+  class DnsCache : public QObject {
+    Q_OBJECT
+
+    public:
+      typedef enum {
+        Result_Miss = 0,
+        Result_Hit,
+        Result_NegativeHit
+      } Result;
+
+      /**
+       * Default milliseconds a resolved name is cached
+       */
+      static const int DefaultPositiveTtl = 60000;
+
+      /**
+       * Default milliseconds a failed name is cached
+       */
+      static const int DefaultNegativeTtl = 10000;
+
+      /**
+       * Default number of cached names
+       */
+      static const int DefaultMaxEntries = 1024;
+
+      /**
+       * Constructor
+       */
+      DnsCache();
+
+      virtual ~DnsCache();
+
+      /**
+       * Returns the cached resolution of a name
+       * @param name the host name
+       * @param addresses set to the cached addresses on a hit
+       */
+      Result Lookup(const QString &name, QList<QHostAddress> &addresses);
+
+      /**
+       * Starts resolving a name unless a lookup for it is already in
+       * flight, Resolved is emitted when the lookup finishes
+       * @param name the host name
+       * @returns true if a new lookup was started
+       */
+      bool Resolve(const QString &name);
+
+      /**
+       * Caches the resolution of a name, finishing any lookup in flight
+       * and emitting Resolved
+       * @param name the host name
+       * @param addresses the addresses, empty if the lookup failed
+       */
+      void Store(const QString &name, const QList<QHostAddress> &addresses);
+
+      /**
+       * Aborts lookups in flight and drops all entries
+       */
+      void Clear();
+
+      /**
+       * Sets how long entries are cached
+       * @param positive milliseconds for resolved names
+       * @param negative milliseconds for failed names
+       */
+      void SetTtl(int positive, int negative);
+
+      /**
+       * Sets the number of cached names, the entries closest to expiring
+       * are dropped first
+       */
+      inline void SetMaxEntries(int max_entries) { _max_entries = max_entries; }
+
+      /**
+       * Returns the number of cached names
+       */
+      inline int Count() const { return _entries.count(); }
+
+      /**
+       * Returns the number of lookups answered from the cache
+       */
+      inline int GetHits() const { return _hits; }
+
+      /**
+       * Returns the number of lookups not in the cache
+       */
+      inline int GetMisses() const { return _misses; }
+
+      /**
+       * Returns the number of resolutions that joined a lookup in flight
+       */
+      inline int GetCoalesced() const { return _coalesced; }
+
+    signals:
+      /**
+       * Emitted when a name has been resolved
+       * @param name the host name in lower case
+       * @param addresses the addresses, empty if the lookup failed
+       */
+      void Resolved(const QString &name, const QList<QHostAddress> &addresses);
+
+    private slots:
+      void LookupFinished(const QHostInfo &host_info);
+
+    private:
+      /**
+       * Drops the entry closest to expiring
+       */
+      void Evict();
+
+      typedef struct {
+        QList<QHostAddress> addresses;
+        qint64 expires;
+      } Entry;
+
+      QHash<QString, Entry> _entries;
+
+      /**
+       * Names being resolved and their lookup ids
+       */
+      QHash<QString, int> _in_flight;
+      QHash<int, QString> _lookups;
+
+      int _positive_ttl;
+      int _negative_ttl;
+      int _max_entries;
+      int _hits;
+      int _misses;
+      int _coalesced;
+  };
+}
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "Utils/Time.hpp"
+
+#include "DownstreamScheduler.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+
+  DownstreamScheduler::DownstreamScheduler(int quantum, qint64 window,
+      int interval) :
+    _quantum(quantum),
+    _window(window),
+    _interval(interval),
+    _rate(0),
+    _budget(0),
+    _refilled(0)
+  {
+  }
+
+  void DownstreamScheduler::AddStream(QAbstractSocket *stream)
+  {
+    Stream state = {QByteArray(), 0, 0, 0, false};
+    _streams[stream] = state;
+  }
+
+  void DownstreamScheduler::RemoveStream(QAbstractSocket *stream)
+  {
+    _streams.remove(stream);
+    _active.removeAll(stream);
+  }
+
+  void DownstreamScheduler::Clear()
+  {
+    _streams.clear();
+    _active.clear();
+  }
+
+  qint64 DownstreamScheduler::GetRoom(QAbstractSocket *stream) const
+  {
+    if(!_streams.contains(stream)) {
+      return 0;
+    }
+
+    const Stream &state = _streams[stream];
+    return _window - (state.sent + state.pending.count() - state.acked);
+  }
+
+  void DownstreamScheduler::Queue(QAbstractSocket *stream, const QByteArray &data)
+  {
+    if(!_streams.contains(stream) || data.isEmpty()) {
+      return;
+    }
+
+    Stream &state = _streams[stream];
+    if(state.pending.isEmpty()) {
+      _active.append(stream);
+    }
+    state.pending.append(data);
+  }
+
+  void DownstreamScheduler::Acknowledge(QAbstractSocket *stream, qint64 acked)
+  {
+    if(!_streams.contains(stream)) {
+      return;
+    }
+
+    Stream &state = _streams[stream];
+    state.acked = qMax(state.acked, qMin(acked, state.sent));
+  }
+
+  int DownstreamScheduler::Pending(QAbstractSocket *stream) const
+  {
+    return _streams.value(stream).pending.count();
+  }
+
+  qint64 DownstreamScheduler::Sent(QAbstractSocket *stream) const
+  {
+    return _streams.value(stream).sent;
+  }
+
+  QList<DownstreamScheduler::Chunk> DownstreamScheduler::Schedule()
+  {
+    // Calls between refills share the current budget, the product is
+    // taken in 64 bits as rates above 42 MB/s overflow an int
+    if(_rate) {
+      qint64 now = Dissent::Utils::Time::GetInstance().MSecsSinceEpoch();
+      if(now - _refilled >= _interval) {
+        _budget = qMax(qint64(1), qint64(_rate) * _interval / 1000);
+        _refilled = now;
+      }
+    }
+
+    // A stream keeps unspent credit only while it has data
+    QList<Chunk> chunks;
+    while(!_active.isEmpty() && (!_rate || _budget > 0)) {
+      QAbstractSocket *stream = _active.first();
+      Stream &state = _streams[stream];
+      if(!state.visiting) {
+        state.deficit += _quantum;
+        state.visiting = true;
+      }
+
+      while(state.pending.count() && state.deficit > 0 &&
+          (!_rate || _budget > 0))
+      {
+        int length = qMin(state.pending.count(), state.deficit);
+        if(_rate) {
+          length = int(qMin(qint64(length), _budget));
+          _budget -= length;
+        }
+
+        chunks.append(Chunk(stream, state.pending.left(length)));
+        state.pending = state.pending.mid(length);
+        state.sent += length;
+        state.deficit -= length;
+      }
+
+      // Cut short by the budget, the visit resumes after the next refill
+      // rather than sending the stream to the back of the queue
+      if(state.pending.count() && state.deficit > 0) {
+        break;
+      }
+
+      _active.removeFirst();
+      state.visiting = false;
+      if(state.pending.count()) {
+        _active.append(stream);
+      } else {
+        state.deficit = 0;
+      }
+    }
+    return chunks;
+  }
+}
+}
@@ -0,0 +1,128 @@
+#ifndef DISSENT_TUNNEL_DOWNSTREAM_SCHEDULER_H_GUARD
+#define DISSENT_TUNNEL_DOWNSTREAM_SCHEDULER_H_GUARD
+
+#include <QAbstractSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+namespace Dissent {
+namespace Tunnel {
+
+  /**
+   * Orders the exit tunnel's TCP responses. Each stream may have at most a
+   * window of bytes queued or sent but not acknowledged, the owner reads no
+   * more than GetRoom from the stream's socket. Queued data is released in
+   * deficit round-robin order, each visit grants a stream a quantum of
+   * credit, optionally limited to a total rate whose budget is refilled
+   * every interval.
+   */
+  class DownstreamScheduler {
+    public:
+      /**
+       * A stream and the bytes to send for it
+       */
+      typedef QPair<QAbstractSocket *, QByteArray> Chunk;
+
+      /**
+       * Constructor
+       * @param quantum bytes of credit a stream gets per visit
+       * @param window bytes a stream may have queued or unacknowledged
+       * @param interval milliseconds between refills of the rate budget
+       */
+      DownstreamScheduler(int quantum, qint64 window, int interval);
+
+      /**
+       * Limits the total rate at which data is released
+       * @param bytes_per_second the limit, 0 for none
+       */
+      inline void SetRate(int bytes_per_second) { _rate = bytes_per_second; }
+
+      /**
+       * Starts tracking a stream
+       */
+      void AddStream(QAbstractSocket *stream);
+
+      /**
+       * Stops tracking a stream, dropping its queued data
+       */
+      void RemoveStream(QAbstractSocket *stream);
+
+      /**
+       * Stops tracking all streams
+       */
+      void Clear();
+
+      /**
+       * Returns true if the stream is tracked
+       */
+      inline bool Contains(QAbstractSocket *stream) const
+      {
+        return _streams.contains(stream);
+      }
+
+      /**
+       * Returns the bytes the stream may still queue before its window is
+       * full
+       */
+      qint64 GetRoom(QAbstractSocket *stream) const;
+
+      /**
+       * Queues data to be sent for a stream
+       */
+      void Queue(QAbstractSocket *stream, const QByteArray &data);
+
+      /**
+       * Records that the receiver has acknowledged bytes of a stream
+       * @param acked the total bytes acknowledged, capped at those sent
+       */
+      void Acknowledge(QAbstractSocket *stream, qint64 acked);
+
+      /**
+       * Returns the number of bytes queued but not yet released
+       */
+      int Pending(QAbstractSocket *stream) const;
+
+      /**
+       * Returns the total bytes released for a stream
+       */
+      qint64 Sent(QAbstractSocket *stream) const;
+
+      /**
+       * Returns true if no stream has queued data
+       */
+      inline bool IsIdle() const { return _active.isEmpty(); }
+
+      /**
+       * Releases queued data in round-robin order until every stream is
+       * drained or the rate budget for the current interval is spent
+       */
+      QList<Chunk> Schedule();
+
+    private:
+      typedef struct {
+        /** Queued but not yet released */
+        QByteArray pending;
+        /** Total bytes released and acknowledged */
+        qint64 sent;
+        qint64 acked;
+        /** Deficit round-robin credit */
+        int deficit;
+        /** The quantum for the current visit has been granted */
+        bool visiting;
+      } Stream;
+
+      const int _quantum;
+      const qint64 _window;
+      const int _interval;
+      QHash<QAbstractSocket *, Stream> _streams;
+      QList<QAbstractSocket *> _active;
+      int _rate;
+      qint64 _budget;
+      qint64 _refilled;
+  };
+}
+}
+
+#endif
@@ -4,6 +4,8 @@
 
 #include "Tunnel/Packets/Packet.hpp"
 #include "Tunnel/Packets/FinishPacket.hpp"
+#include "Tunnel/Packets/KeyAgreementPacket.hpp"
+#include "Tunnel/Packets/TcpAckPacket.hpp"
 #include "Tunnel/Packets/UdpRequestPacket.hpp"
 #include "Tunnel/Packets/TcpRequestPacket.hpp"
 #include "Tunnel/Packets/UdpResponsePacket.hpp"
@@ -23,14 +25,22 @@ namespace Tunnel {
 
   ExitTunnel::ExitTunnel(SessionManager &sm, const QSharedPointer<Network> &net,
       const QUrl &exit_proxy_url) :
+    _scheduler(DownstreamQuantum, TcpAckPacket::DownstreamWindow,
+        DownstreamInterval),
+    _compression(false),
     _running(false),
     _sm(sm),
     _net(net->Clone()),
     _exit_proxy(exit_proxy_url.isEmpty() ? QNetworkProxy::NoProxy : QNetworkProxy::Socks5Proxy, 
           exit_proxy_url.host(),
-          exit_proxy_url.port())
+          exit_proxy_url.port()),
+    _pool(_exit_proxy, _dns)
   {
     _net->SetMethod("LT::TunnelData");
+    connect(&_dns, SIGNAL(Resolved(const QString &, const QList<QHostAddress> &)),
+        this, SLOT(DnsLookupFinished(const QString &, const QList<QHostAddress> &)));
+    _downstream_timer.setInterval(DownstreamInterval);
+    connect(&_downstream_timer, SIGNAL(timeout()), this, SLOT(SendDownstream()));
   }
 
   ExitTunnel::~ExitTunnel()
@@ -72,9 +82,14 @@ namespace Tunnel {
     }
 
     _tcp_buffers.clear();
+    _scheduler.Clear();
+    _closing.clear();
+    _downstream_timer.stop();
     _table.Clear();
     _tcp_pending_dns.clear();
     _udp_pending_dns.clear();
+    _dns.Clear();
+    _pool.Clear();
     _timers_map.clear();
     _timers.clear();
 
@@ -111,6 +126,15 @@ namespace Tunnel {
     }
     qDebug() << "Socket closed";
 
+    // Responses still queued or held back by the window are sent first,
+    // as long as the entry keeps acknowledging them
+    if(_scheduler.Contains(socket)) {
+      _closing.insert(socket);
+      StartSocketTimer(socket, TcpClosingTimeout);
+      TcpTryFinish(socket);
+      return;
+    }
+
     CloseSocket(socket);
   }
 
@@ -146,16 +170,8 @@ namespace Tunnel {
       qDebug("SOCKS read but no session");
       return;
     }
-  
-    do {
-      QByteArray data = socket->read(64000);
-      qDebug() << "SOCKS Read" << data.count() << "bytes from proxy socket";
-      TcpResponsePacket resp(_table.IdForConnection(socket), data);
-      //GetSession()->Send(resp.ToByteArray());
-      //qDebug() << "SOCKS " << data;
-      SendReply(resp.ToByteArray());
-    } while(socket->bytesAvailable());
 
+    TcpReadSocket(socket);
     qDebug() << "MEM active" << _table.Count();
   }
 
@@ -201,36 +217,33 @@ namespace Tunnel {
     qDebug() << "MEM active" << _table.Count();
   }
 
-  void ExitTunnel::TcpDnsLookupFinished(const QHostInfo &host_info)
+  void ExitTunnel::DnsLookupFinished(const QString &name,
+      const QList<QHostAddress> &addresses)
   {
-    TcpPendingDnsData value = _tcp_pending_dns[host_info.lookupId()];
-    _tcp_pending_dns.remove(host_info.lookupId());
-
-    bool okay = (host_info.error() == QHostInfo::NoError) && host_info.addresses().count();
-
-    qDebug() << "SOCKS hostname" << host_info.hostName() << "resolved:" << okay;
-    if(okay && _table.ContainsConnection(value.socket)) {
-      qDebug() << "SOCKS connecting to hostname" << host_info.hostName();
-      value.socket->connectToHost(host_info.addresses()[0], value.port);
-    } else {
-      qDebug() << "SOCKS aborting failed or closed connection:" << host_info.hostName();
-      //CloseSocket(value.socket);
+    bool okay = addresses.count();
+    qDebug() << "SOCKS hostname" << name << "resolved:" << okay;
+
+    QList<TcpPendingDnsData> tcp_values = _tcp_pending_dns.values(name);
+    _tcp_pending_dns.remove(name);
+    foreach(const TcpPendingDnsData &value, tcp_values) {
+      if(okay && _table.ContainsConnection(value.socket)) {
+        qDebug() << "SOCKS connecting to hostname" << name;
+        value.socket->connectToHost(addresses[0], value.port);
+      } else {
+        qDebug() << "SOCKS aborting failed or closed connection:" << name;
+        //CloseSocket(value.socket);
+      }
     }
-  }
-
-  void ExitTunnel::UdpDnsLookupFinished(const QHostInfo &host_info)
-  {
-    UdpPendingDnsData value = _udp_pending_dns[host_info.lookupId()];
-    _udp_pending_dns.remove(host_info.lookupId());
-
-    bool okay = (host_info.error() == QHostInfo::NoError) && host_info.addresses().count();
 
-    qDebug() << "SOCKS UDP hostname" << host_info.hostName() << "resolved:" << okay;
-    if(okay && _table.ContainsConnection(value.socket)) {
-      qDebug() << "SOCKS Write data" << value.datagram.count();
-      value.socket->writeDatagram(value.datagram, host_info.addresses()[0], value.port);
-    } else {
-      CloseSocket(value.socket);
+    QList<UdpPendingDnsData> udp_values = _udp_pending_dns.values(name);
+    _udp_pending_dns.remove(name);
+    foreach(const UdpPendingDnsData &value, udp_values) {
+      if(okay && _table.ContainsConnection(value.socket)) {
+        qDebug() << "SOCKS Write data" << value.datagram.count();
+        value.socket->writeDatagram(value.datagram, addresses[0], value.port);
+      } else {
+        CloseSocket(value.socket);
+      }
     }
   }
 
@@ -244,24 +257,52 @@ namespace Tunnel {
     qWarning() << "Socket error: " << qPrintable(socket->errorString());
   }
 
-  void ExitTunnel::UdpTimeout()
+  void ExitTunnel::SocketTimeout()
   {
     QTimer* timer = qobject_cast<QTimer*>(sender());
     if(!timer) {
-      qWarning("SOCKS Illegal call to UdpTimeout()");
+      qWarning("SOCKS Illegal call to SocketTimeout()");
       return;
     }
 
     if(!_timers_map.contains(timer)) {
-      qWarning("SOCKS Unknown timer sent UdpTimeout()");
+      qWarning("SOCKS Unknown timer sent SocketTimeout()");
       return;
     }
 
-    qDebug() << "SOCKS UDP connection timeout";
+    qDebug() << "SOCKS connection timeout";
     CloseSocket(_timers_map[timer]);
   }
  
 
+  void ExitTunnel::SendDownstream()
+  {
+    // Retry on the timer until a round is available
+    if(!CheckSession()) {
+      if(!_scheduler.IsIdle() && !_downstream_timer.isActive()) {
+        _downstream_timer.start();
+      }
+      return;
+    }
+
+    QList<DownstreamScheduler::Chunk> chunks = _scheduler.Schedule();
+    foreach(const DownstreamScheduler::Chunk &chunk, chunks) {
+      SendReply(TcpResponsePacket(_table.IdForConnection(chunk.first),
+            chunk.second, _compression).ToByteArray());
+    }
+
+    // Closing sockets may have just drained
+    foreach(const DownstreamScheduler::Chunk &chunk, chunks) {
+      TcpTryFinish(chunk.first);
+    }
+
+    if(_scheduler.IsIdle()) {
+      _downstream_timer.stop();
+    } else if(!_downstream_timer.isActive()) {
+      _downstream_timer.start();
+    }
+  }
+
   /******************
    * Private Methods
    */
@@ -282,6 +323,8 @@ namespace Tunnel {
 
     _table.ConnectionClosed(socket); 
     _tcp_buffers.remove(socket);
+    _scheduler.RemoveStream(socket);
+    _closing.remove(socket);
     if(_timers.contains(socket)) {
       _timers_map.remove(_timers[socket].data());
     }
@@ -339,6 +382,11 @@ namespace Tunnel {
       case Packet::PacketType_Finish:
         HandleFinish(pp);
         return;
+      case Packet::PacketType_KeyAgreement:
+        return;
+      case Packet::PacketType_TcpAck:
+        TcpHandleAck(pp);
+        return;
       default:
         qWarning() << "SOCKS Unknown packet type" << ptype;
     }
@@ -349,12 +397,27 @@ namespace Tunnel {
     TcpStartPacket *sp = dynamic_cast<TcpStartPacket*>(packet.data());
     if(!sp) return;
 
-    QTcpSocket* socket = new QTcpSocket(this);
-    socket->setProxy(_exit_proxy);
+    // A warm connection skips the upstream handshake
+    QTcpSocket* socket = _pool.Take(sp->GetHostName());
+    bool pooled = socket;
+    if(pooled) {
+      socket->setParent(this);
+    } else {
+      socket = new QTcpSocket(this);
+      socket->setProxy(_exit_proxy);
+    }
 
     // Check the verification key
-    if(!_table.SaveConnection(socket, sp->GetConnectionId(), sp->GetVerificationKey())) return;
+    if(!_table.SaveConnection(socket, sp->GetConnectionId(), sp->GetVerificationKey())) {
+      delete socket;
+      return;
+    }
     _tcp_buffers[socket] = QByteArray();
+    AgreeKey(socket, sp->GetKeyAgreement(), sp->GetSignature());
+
+    _scheduler.AddStream(socket);
+    // Leave data beyond the window in the kernel, pushing back on the sender
+    socket->setReadBufferSize(TcpAckPacket::DownstreamWindow);
 
     connect(socket, SIGNAL(readyRead()), this, SLOT(TcpReadFromProxy()));
     connect(socket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), this,
@@ -365,6 +428,14 @@ namespace Tunnel {
 
     qDebug() << "SOCKS Creating connection" << sp->GetConnectionId();
 
+    if(pooled) {
+      qDebug() << "SOCKS Using pooled connection to" << sp->GetHostName().ToString();
+      if(socket->bytesAvailable()) {
+        TcpReadSocket(socket);
+      }
+      return;
+    }
+
     bool proxy_does_lookups = (socket->proxy().capabilities() & QNetworkProxy::HostNameLookupCapability);
     qDebug() << "Direct" << proxy_does_lookups;
 
@@ -376,11 +447,20 @@ namespace Tunnel {
         socket->connectToHost(sp->GetHostName().GetName(), sp->GetHostName().GetPort());
       } else {
         // Resolve hostname, then connect to IP address
-        qDebug() << "SOCKS Hostname" << sp->GetHostName().GetName();
-        int lookup_id = QHostInfo::lookupHost(sp->GetHostName().GetName(), 
-            this, SLOT(TcpDnsLookupFinished(const QHostInfo &)));
-        TcpPendingDnsData dns_data = {socket, sp->GetHostName().GetPort()};
-        _tcp_pending_dns[lookup_id] = dns_data;
+        QString name = QString(sp->GetHostName().GetName()).toLower();
+        qDebug() << "SOCKS Hostname" << name;
+
+        QList<QHostAddress> addresses;
+        DnsCache::Result result = _dns.Lookup(name, addresses);
+        if(result == DnsCache::Result_Hit) {
+          socket->connectToHost(addresses[0], sp->GetHostName().GetPort());
+        } else if(result == DnsCache::Result_NegativeHit) {
+          qDebug() << "SOCKS aborting connection to unresolvable" << name;
+        } else {
+          TcpPendingDnsData dns_data = {socket, sp->GetHostName().GetPort()};
+          _tcp_pending_dns.insert(name, dns_data);
+          _dns.Resolve(name);
+        }
       }
     } else {
       // Connect directly to IP address
@@ -401,6 +481,7 @@ namespace Tunnel {
 
     // Check the verification key
     if(!_table.SaveConnection(socket, sp->GetConnectionId(), sp->GetVerificationKey())) return;
+    AgreeKey(socket, sp->GetKeyAgreement(), sp->GetSignature());
 
     connect(socket, SIGNAL(readyRead()), this, SLOT(UdpReadFromProxy()));
     connect(socket, SIGNAL(disconnected()), this, SLOT(DiscardProxy()));
@@ -408,15 +489,33 @@ namespace Tunnel {
         SLOT(HandleError(QAbstractSocket::SocketError)));
 
     // Destroy the socket after a timeout 
-    _timers[socket] = QSharedPointer<QTimer>(new QTimer(this));
-    _timers_map[_timers[socket].data()] = socket;
-    _timers[socket]->setInterval(UdpSocketTimeout);
-    connect(_timers[socket].data(), SIGNAL(timeout()), this, SLOT(UdpTimeout()));
-    _timers[socket]->start();
+    StartSocketTimer(socket, UdpSocketTimeout);
 
     qDebug() << "SOCKS Creating UDP connection" << sp->GetConnectionId();
   }
 
+  void ExitTunnel::AgreeKey(QAbstractSocket *socket, const QByteArray &dh_pub,
+      const QByteArray &sig)
+  {
+    if(dh_pub.isEmpty()) {
+      return;
+    }
+
+    QByteArray cid = _table.IdForConnection(socket);
+    if(!_table.VerifyKeyAgreement(cid, dh_pub, sig)) {
+      qWarning() << "SOCKS Key agreement signature failed CID" << cid;
+      return;
+    }
+
+    QByteArray local_pub = _table.AgreeKey(socket, dh_pub);
+    if(local_pub.isEmpty()) {
+      qWarning() << "SOCKS Invalid key agreement CID" << cid;
+      return;
+    }
+
+    SendReply(KeyAgreementPacket(cid, local_pub).ToByteArray());
+  }
+
   void ExitTunnel::TcpHandleRequest(QSharedPointer<Packet> packet)
   {
     TcpRequestPacket *req = dynamic_cast<TcpRequestPacket*>(packet.data());
@@ -438,8 +537,7 @@ namespace Tunnel {
 
     QByteArray data = req->GetRequestData();
     QByteArray sig = req->GetSignature();
-    qDebug() << "SOCKS VERIFY SIGB" << sig;
-    if(!_table.VerifyConnectionBytes(cid, data, sig)) {
+    if(!_table.VerifyRequest(cid, req->GetType(), req->GetSequence(), data, sig)) {
       qWarning() << "SOCKS Verification failed sig:" << sig.count() << "data:" << data.count() << "CID" << cid; 
       return;
     }
@@ -473,9 +571,8 @@ namespace Tunnel {
     QByteArray sig = req->GetSignature();
     QByteArray data = req->GetRequestData();
 
-    qDebug() << "SOCKS VERIFY SIGB" << sig;
     QByteArray to_verify = peer.ToString().toAscii() + data;
-    if(!_table.VerifyConnectionBytes(cid, to_verify, sig)) {
+    if(!_table.VerifyRequest(cid, req->GetType(), req->GetSequence(), to_verify, sig)) {
       qWarning() << "SOCKS Verification failed sig:" << sig.count() << "data:" << data.count() << "CID" << cid; 
       return;
     }
@@ -484,11 +581,20 @@ namespace Tunnel {
     _timers[socket]->start();
 
     if(req->GetHostName().IsHostName()) {
-      qDebug() << "SOCKS UDP Hostname" << req->GetHostName().GetName();
-      int lookup_id = QHostInfo::lookupHost(req->GetHostName().GetName(), 
-          this, SLOT(TcpDnsLookupFinished(const QHostInfo &)));
-      UdpPendingDnsData dns_data = {socket, req->GetHostName().GetPort(), data};
-      _udp_pending_dns[lookup_id] = dns_data;
+      QString name = QString(req->GetHostName().GetName()).toLower();
+      qDebug() << "SOCKS UDP Hostname" << name;
+
+      QList<QHostAddress> addresses;
+      DnsCache::Result result = _dns.Lookup(name, addresses);
+      if(result == DnsCache::Result_Hit) {
+        socket->writeDatagram(data, addresses[0], req->GetHostName().GetPort());
+      } else if(result == DnsCache::Result_NegativeHit) {
+        CloseSocket(socket);
+      } else {
+        UdpPendingDnsData dns_data = {socket, req->GetHostName().GetPort(), data};
+        _udp_pending_dns.insert(name, dns_data);
+        _dns.Resolve(name);
+      }
     } else {
       qDebug() << "SOCKS UDP writeDatagram " << req->GetHostName().GetAddress() <<":" 
         << req->GetHostName().GetPort() << (req->GetHostName().IsHostName() ? "DNS" : "Address");
@@ -498,6 +604,83 @@ namespace Tunnel {
     qDebug() << "SOCKS MEM active" << _table.Count();
   }
 
+  void ExitTunnel::TcpHandleAck(QSharedPointer<Packet> packet)
+  {
+    TcpAckPacket *ack = dynamic_cast<TcpAckPacket*>(packet.data());
+    if(!ack) return;
+
+    QByteArray cid = ack->GetConnectionId();
+    if(!_table.ContainsId(cid)) {
+      qDebug() << "SOCKS Ignoring ack packet for other relay" << cid;
+      return;
+    }
+
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(_table.ConnectionForId(cid));
+    if(!socket || !_scheduler.Contains(socket)) {
+      qWarning() << "Could not cast to QTcpSocket";      
+      return;
+    }
+
+    if(!_table.VerifyRequest(cid, ack->GetType(), ack->GetSequence(),
+          ack->GetAuthenticatedBytes(), ack->GetSignature()))
+    {
+      qWarning() << "SOCKS Ack verification failed CID" << cid; 
+      return;
+    }
+
+    _scheduler.Acknowledge(socket, ack->GetAcked());
+    if(_closing.contains(socket)) {
+      _timers[socket]->start();
+    }
+    TcpReadSocket(socket);
+    TcpTryFinish(socket);
+  }
+
+  void ExitTunnel::TcpReadSocket(QTcpSocket *socket)
+  {
+    qint64 room = _scheduler.GetRoom(socket);
+    if(room <= 0 || !socket->bytesAvailable()) {
+      return;
+    }
+
+    QByteArray data = socket->read(room);
+    qDebug() << "SOCKS Read" << data.count() << "bytes from proxy socket";
+    _scheduler.Queue(socket, data);
+    ScheduleDownstream();
+  }
+
+  void ExitTunnel::TcpTryFinish(QAbstractSocket *socket)
+  {
+    if(!_closing.contains(socket)) {
+      return;
+    }
+
+    if(!_scheduler.Pending(socket) && !socket->bytesAvailable()) {
+      CloseSocket(socket);
+    }
+  }
+
+  void ExitTunnel::StartSocketTimer(QAbstractSocket *socket, int timeout)
+  {
+    if(!_timers.contains(socket)) {
+      _timers[socket] = QSharedPointer<QTimer>(new QTimer(this));
+      _timers_map[_timers[socket].data()] = socket;
+      connect(_timers[socket].data(), SIGNAL(timeout()), this, SLOT(SocketTimeout()));
+    }
+
+    _timers[socket]->setInterval(timeout);
+    _timers[socket]->start();
+  }
+
+  void ExitTunnel::ScheduleDownstream()
+  {
+    // A running timer sends with the next budget
+    if(_downstream_timer.isActive()) {
+      return;
+    }
+    SendDownstream();
+  }
+
   void ExitTunnel::HandleFinish(QSharedPointer<Packet> packet)
   {
     FinishPacket *fin = dynamic_cast<FinishPacket*>(packet.data());
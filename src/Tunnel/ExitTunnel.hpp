@@ -5,6 +5,7 @@
 #include <QHash>
 #include <QHostInfo>
 #include <QHostAddress>
+#include <QSet>
 #include <QSharedPointer>
 #include <QNetworkProxy>
 #include <QTcpSocket>
@@ -15,6 +16,9 @@
 
 #include "Anonymity/Sessions/Session.hpp"
 #include "Anonymity/Sessions/SessionManager.hpp"
+#include "Tunnel/DnsCache.hpp"
+#include "Tunnel/DownstreamScheduler.hpp"
+#include "Tunnel/TcpConnectionPool.hpp"
 #include "Tunnel/TunnelConnectionTable.hpp"
 #include "Tunnel/Packets/Packet.hpp"
 
@@ -32,6 +36,19 @@ namespace Tunnel {
    * It broadcasts replies from the network connection
    * *non-anonymously* to all members of the group.
    *
+   * Request packets are authenticated by a signature or, for connections
+   * that agreed on a key in their start packet, by a sequence-numbered MAC.
+   *
+   * TCP responses are flow controlled: a connection may have at most
+   * TcpAckPacket::DownstreamWindow bytes read from its proxy socket that
+   * the entry has not acknowledged, beyond that the data is left in the
+   * socket. Queued responses are sent in deficit round-robin order across
+   * connections, optionally limited to a total rate and compressed.
+   *
+   * Host names are resolved through a DnsCache and, when enabled, new
+   * connections to recently used destinations take a warm connection from
+   * a TcpConnectionPool.
+   *
    * !!!IMPORTANT!!! By serving as an exit node, the user
    * running the exit node/remote tunnel gives up their
    * anonymity.
@@ -47,6 +64,22 @@ namespace Tunnel {
        */
       static const int UdpSocketTimeout = 30000;
 
+      /**
+       * Number of milliseconds that a disconnected TCP connection with
+       * responses left to send waits for an ack before they are dropped
+       */
+      static const int TcpClosingTimeout = 60000;
+
+      /**
+       * Bytes a connection may send per visit of the round-robin scheduler
+       */
+      static const int DownstreamQuantum = 16 * 1024;
+
+      /**
+       * Milliseconds between refills of the rate limited downstream budget
+       */
+      static const int DownstreamInterval = 50;
+
       typedef Dissent::Anonymity::Sessions::Session Session;
       typedef Dissent::Anonymity::Sessions::SessionManager SessionManager;
       typedef Dissent::Connections::Network Network;
@@ -69,6 +102,38 @@ namespace Tunnel {
        */
       void Start();
 
+      /**
+       * Sets whether TCP responses are sent compressed
+       * @param enabled true to compress responses that shrink
+       */
+      inline void SetCompression(bool enabled) { _compression = enabled; }
+
+      /**
+       * Limits the rate at which TCP responses are broadcast
+       * @param bytes_per_second the limit, 0 for none
+       */
+      inline void SetDownstreamRate(int bytes_per_second)
+      {
+        _scheduler.SetRate(bytes_per_second);
+      }
+
+      /**
+       * Sets the number of recently used destinations that are kept an
+       * idle connection open to
+       * @param destinations the number, 0 disables the pool
+       */
+      inline void SetConnectionPool(int destinations) { _pool.SetCapacity(destinations); }
+
+      /**
+       * Returns the cache of resolved host names
+       */
+      inline const DnsCache &GetDnsCache() const { return _dns; }
+
+      /**
+       * Returns the pool of warm upstream connections
+       */
+      inline const TcpConnectionPool &GetConnectionPool() const { return _pool; }
+
     signals:
       void Stopped();
     
@@ -101,10 +166,10 @@ namespace Tunnel {
 
       /**
        * Slot called when a DNS lookup has finished
-       * @param host name information with resolved domain name
+       * @param name the resolved host name
+       * @param addresses the addresses, empty if the lookup failed
        */
-      void TcpDnsLookupFinished(const QHostInfo& host_info);
-      void UdpDnsLookupFinished(const QHostInfo& host_info);
+      void DnsLookupFinished(const QString &name, const QList<QHostAddress> &addresses);
 
       /**
        * Connection error handler
@@ -112,9 +177,15 @@ namespace Tunnel {
       void HandleError(QAbstractSocket::SocketError);
 
       /**
-       * Called when a UDP connection times out
+       * Called when a UDP connection is idle or a closing TCP connection
+       * stops acknowledging for too long
+       */
+      void SocketTimeout();
+
+      /**
+       * Sends queued TCP responses in round-robin order
        */
-      void UdpTimeout();
+      void SendDownstream();
 
     protected:
       QSharedPointer<Session> GetSession() { return _sm.GetDefaultSession(); }
@@ -129,10 +200,51 @@ namespace Tunnel {
       void TcpCreateProxy(QSharedPointer<Packet> start_packet);
       void UdpCreateProxy(QSharedPointer<Packet> start_packet);
 
+      /**
+       * Agrees on a MAC key for a new connection whose start packet
+       * carried a signed Diffie-Hellman public component and replies
+       * with the exit's component
+       */
+      void AgreeKey(QAbstractSocket *socket, const QByteArray &dh_pub,
+          const QByteArray &sig);
+
       void TcpHandleRequest(QSharedPointer<Packet> req_packet);
       void UdpHandleRequest(QSharedPointer<Packet> req_packet);
 
       void HandleFinish(QSharedPointer<Packet> fin_packet);
+      void TcpHandleAck(QSharedPointer<Packet> ack_packet);
+
+      /**
+       * Queues as much of the socket's data as its window allows
+       */
+      void TcpReadSocket(QTcpSocket *socket);
+
+      /**
+       * Closes a disconnected socket once all its data has been sent
+       */
+      void TcpTryFinish(QAbstractSocket *socket);
+
+      /**
+       * Closes the socket unless the timer is restarted within timeout
+       * @param socket the socket
+       * @param timeout milliseconds
+       */
+      void StartSocketTimer(QAbstractSocket *socket, int timeout);
+
+      /**
+       * Starts sending queued responses, refilling the budget when idle
+       */
+      void ScheduleDownstream();
+
+      DownstreamScheduler _scheduler;
+
+      /**
+       * Sockets that disconnected and close once drained, or once their
+       * acks stall for TcpClosingTimeout
+       */
+      QSet<QAbstractSocket*> _closing;
+      QTimer _downstream_timer;
+      bool _compression;
 
       typedef struct {
         QTcpSocket* socket;
@@ -147,10 +259,11 @@ namespace Tunnel {
 
       /**
        * Used to keep track of the sockets waiting on a DNS lookup to complete.
-       * Hash of lookup_id -> multiple sockets waiting for the hostname resolution.
+       * Hash of host name -> multiple sockets waiting for the hostname resolution.
        */
-      QHash<int, TcpPendingDnsData> _tcp_pending_dns;
-      QHash<int, UdpPendingDnsData> _udp_pending_dns;
+      QMultiHash<QString, TcpPendingDnsData> _tcp_pending_dns;
+      QMultiHash<QString, UdpPendingDnsData> _udp_pending_dns;
+      DnsCache _dns;
 
       TunnelConnectionTable _table;
 
@@ -160,7 +273,8 @@ namespace Tunnel {
       /**
        * These are timeout timers for UDP "connections." Since a UDP
        * connection never really times out, we close a UDP socket after
-       * an interval of inactivity
+       * an interval of inactivity. Closing TCP sockets use them to drop
+       * responses the entry no longer acknowledges.
        */
       QHash<QAbstractSocket*, QSharedPointer<QTimer> > _timers;
       QHash<QTimer*, QAbstractSocket*> _timers_map;
@@ -168,6 +282,7 @@ namespace Tunnel {
       SessionManager &_sm;
       QSharedPointer<Network> _net;
       QNetworkProxy _exit_proxy;
+      TcpConnectionPool _pool;
   };
 }
 }
@@ -0,0 +1,27 @@
+
+#include "KeyAgreementPacket.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+namespace Packets {
+
+  KeyAgreementPacket::KeyAgreementPacket(const QByteArray &conn_id, const QByteArray &dh_pub) :
+      Packet(PacketType_KeyAgreement,
+        dh_pub.count(),
+        conn_id),
+      _dh_pub(dh_pub)
+  {};
+
+  QSharedPointer<Packet> KeyAgreementPacket::ReadFooters(const QByteArray &conn_id, const QByteArray &payload)
+  {
+    return QSharedPointer<Packet>(new KeyAgreementPacket(conn_id, payload));
+  }
+
+  QByteArray KeyAgreementPacket::PayloadToByteArray() const 
+  {
+    return _dh_pub;
+  }
+
+}
+}
+}
@@ -0,0 +1,45 @@
+#ifndef DISSENT_TUNNEL_PACKETS_KEY_AGREEMENT_PACKET_H_GUARD
+#define DISSENT_TUNNEL_PACKETS_KEY_AGREEMENT_PACKET_H_GUARD
+
+#include "Packet.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+namespace Packets {
+
+  /**
+   * Packet sent by the ExitTunnel in reply to a start packet carrying a
+   * Diffie-Hellman public component.  Once the SocksConnection has it,
+   * both sides share a per-connection MAC key and request packets are
+   * authenticated with sequence-numbered MACs instead of signatures.
+   */
+  class KeyAgreementPacket : public Packet {
+
+    public:
+      /**
+       * Constructor
+       * @param connection ID
+       * @param the exit's Diffie-Hellman public component
+       */
+      KeyAgreementPacket(const QByteArray &conn_id, const QByteArray &dh_pub);
+
+      /**
+       * Get the exit's Diffie-Hellman public component
+       */
+      inline QByteArray GetKeyAgreement() const { return _dh_pub; }
+
+      virtual QByteArray PayloadToByteArray() const;
+
+      static QSharedPointer<Packet> ReadFooters(const QByteArray &conn_id, const QByteArray &payload);
+
+    private:
+
+      QByteArray _dh_pub;
+
+  };
+
+}
+}
+}
+
+#endif
@@ -4,6 +4,8 @@
 
 #include "Packet.hpp"
 #include "FinishPacket.hpp"
+#include "KeyAgreementPacket.hpp"
+#include "TcpAckPacket.hpp"
 #include "TcpRequestPacket.hpp"
 #include "UdpRequestPacket.hpp"
 #include "TcpResponsePacket.hpp"
@@ -79,6 +81,12 @@ namespace Packets {
       case PacketType_Finish:
         packet = FinishPacket::ReadFooters(conn_id, payload);
         break;
+      case PacketType_KeyAgreement:
+        packet = KeyAgreementPacket::ReadFooters(conn_id, payload);
+        break;
+      case PacketType_TcpAck:
+        packet = TcpAckPacket::ReadFooters(conn_id, payload);
+        break;
       default:
         qWarning() << "Received packet of type" << ptype << "Len:" << payload.count();
         qWarning("Unknown packet type"); 
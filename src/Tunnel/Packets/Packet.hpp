@@ -30,7 +30,9 @@ namespace Packets {
         PacketType_UdpRequest,
         PacketType_TcpResponse,
         PacketType_UdpResponse,
-        PacketType_Finish
+        PacketType_Finish,
+        PacketType_KeyAgreement,
+        PacketType_TcpAck
       } PacketType;
 
       typedef Dissent::Crypto::Library Library;
@@ -0,0 +1,55 @@
+
+#include <QDataStream>
+
+#include "TcpAckPacket.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+namespace Packets {
+
+  TcpAckPacket::TcpAckPacket(const QByteArray &conn_id, const QByteArray &signature,
+      qint64 acked, int seq) :
+      Packet(PacketType_TcpAck, 0, conn_id),
+      _sig(signature),
+      _acked(acked),
+      _seq(seq)
+  {
+    SetPayloadSize(PayloadToByteArray().count());
+  };
+
+  QByteArray TcpAckPacket::AuthenticatedBytes(qint64 acked)
+  {
+    QByteArray bytes("TunnelAck");
+    QDataStream stream(&bytes, QIODevice::Append);
+    stream << acked;
+    return bytes;
+  }
+
+  QSharedPointer<Packet> TcpAckPacket::ReadFooters(const QByteArray &conn_id, const QByteArray &payload)
+  {
+    QByteArray sig;
+    qint32 seq = -1;
+    qint64 acked = -1;
+    QDataStream stream(payload);
+
+    stream >> seq >> sig >> acked;
+    if(stream.status() != QDataStream::Ok || acked < 0) {
+      return QSharedPointer<Packet>();
+    }
+
+    return QSharedPointer<Packet>(new TcpAckPacket(conn_id, sig, acked, seq));
+  }
+
+  QByteArray TcpAckPacket::PayloadToByteArray() const 
+  {
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+
+    stream << static_cast<qint32>(_seq) << _sig << _acked;
+
+    return payload;
+  }
+
+}
+}
+}
@@ -0,0 +1,81 @@
+#ifndef DISSENT_TUNNEL_PACKETS_TCP_ACK_PACKET_H_GUARD
+#define DISSENT_TUNNEL_PACKETS_TCP_ACK_PACKET_H_GUARD
+
+#include "Packet.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+namespace Packets {
+
+  /**
+   * Packet sent by LocalTunnel to RemoteTunnel acknowledging the
+   * response bytes delivered to the SOCKS client, which opens the
+   * connection's downstream window
+   */
+  class TcpAckPacket : public Packet {
+
+    public:
+      /**
+       * Response bytes the exit may have in flight on a connection
+       * before it must wait for an ack
+       */
+      static const int DownstreamWindow = 256 * 1024;
+
+      /**
+       * Newly delivered response bytes after which the entry sends an ack
+       */
+      static const int AckInterval = DownstreamWindow / 4;
+
+      /**
+       * Constructor
+       * @param connection ID
+       * @param signature or MAC on AuthenticatedBytes()
+       * @param total response bytes delivered on the connection
+       * @param sequence number among the connection's acks
+       */
+      TcpAckPacket(const QByteArray &conn_id, const QByteArray &signature,
+          qint64 acked, int seq = -1);
+
+      /**
+       * Get the signature or MAC bytes
+       */
+      inline QByteArray GetSignature() const { return _sig; }
+
+      /**
+       * Get the total response bytes delivered
+       */
+      inline qint64 GetAcked() const { return _acked; }
+
+      /**
+       * Get the sequence number
+       */
+      inline int GetSequence() const { return _seq; }
+
+      /**
+       * Returns the bytes covered by the packet's signature or MAC
+       */
+      inline QByteArray GetAuthenticatedBytes() const { return AuthenticatedBytes(_acked); }
+
+      /**
+       * Returns the bytes covered by the signature or MAC of an ack
+       * @param total response bytes delivered
+       */
+      static QByteArray AuthenticatedBytes(qint64 acked);
+
+      virtual QByteArray PayloadToByteArray() const;
+
+      static QSharedPointer<Packet> ReadFooters(const QByteArray &conn_id, const QByteArray &payload);
+
+    private:
+
+      QByteArray _sig;
+      qint64 _acked;
+      int _seq;
+
+  };
+
+}
+}
+}
+
+#endif
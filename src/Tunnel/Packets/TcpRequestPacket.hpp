@@ -17,16 +17,23 @@ namespace Packets {
       /**
        * Constructor
        * @param connection ID
-       * @param signature on the request data
+       * @param signature or MAC on the request data
        * @param the request data bytes
+       * @param sequence number among the connection's requests
        */
-      TcpRequestPacket(const QByteArray &conn_id, const QByteArray &signature, const QByteArray &req_data);
+      TcpRequestPacket(const QByteArray &conn_id, const QByteArray &signature,
+          const QByteArray &req_data, int seq = -1);
 
       /**
-       * Get the signature bytes
+       * Get the signature or MAC bytes
        */
       inline QByteArray GetSignature() const { return _sig; }
 
+      /**
+       * Get the sequence number
+       */
+      inline int GetSequence() const { return _seq; }
+
       /**
        * Get the request data bytes
        */
@@ -39,6 +46,7 @@ namespace Packets {
     private:
 
       QByteArray _sig, _req_data;
+      int _seq;
 
   };
 
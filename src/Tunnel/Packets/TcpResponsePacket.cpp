@@ -1,29 +1,74 @@
 
-#include "Utils/Serialization.hpp"
-
 #include "TcpResponsePacket.hpp"
 
-using Dissent::Utils::Serialization;
-
 namespace Dissent {
 namespace Tunnel {
 namespace Packets {
 
-  TcpResponsePacket::TcpResponsePacket(const QByteArray &conn_id, const QByteArray &resp_data) : 
-      Packet(PacketType_TcpResponse, 
-        resp_data.count(),
-        conn_id), 
+  TcpResponsePacket::TcpResponsePacket(const QByteArray &conn_id, const QByteArray &resp_data,
+      bool compress) : 
+      Packet(PacketType_TcpResponse, 0, conn_id), 
       _resp_data(resp_data)
+  {
+    if(compress && resp_data.count()) {
+      QByteArray compressed = qCompress(resp_data);
+      if(compressed.count() < resp_data.count()) {
+        _compressed = compressed;
+      }
+    }
+
+    SetPayloadSize(1 + (IsCompressed() ? _compressed.count() : _resp_data.count()));
+  };
+
+  TcpResponsePacket::TcpResponsePacket(const QByteArray &conn_id, const QByteArray &resp_data,
+      const QByteArray &compressed) :
+      Packet(PacketType_TcpResponse, 1 + (compressed.isEmpty() ? resp_data.count() :
+            compressed.count()), conn_id),
+      _resp_data(resp_data),
+      _compressed(compressed)
   {};
 
   QSharedPointer<Packet> TcpResponsePacket::ReadFooters(const QByteArray &conn_id, const QByteArray &payload)
   {
-    return QSharedPointer<Packet>(new TcpResponsePacket(conn_id, payload));
+    if(payload.isEmpty()) {
+      return QSharedPointer<Packet>();
+    }
+
+    QByteArray data = payload.mid(1);
+    if(!(payload[0] & Flag_Compressed)) {
+      return QSharedPointer<Packet>(new TcpResponsePacket(conn_id, data, QByteArray()));
+    }
+
+    // qCompress prefixes the big-endian uncompressed length
+    if(data.count() < 4) {
+      return QSharedPointer<Packet>();
+    }
+
+    quint32 length = 0;
+    for(int idx = 0; idx < 4; idx++) {
+      length = (length << 8) | static_cast<uchar>(data[idx]);
+    }
+
+    if(length == 0 || length > static_cast<quint32>(MaxResponseLength)) {
+      return QSharedPointer<Packet>();
+    }
+
+    QByteArray resp_data = qUncompress(data);
+    if(resp_data.isEmpty()) {
+      return QSharedPointer<Packet>();
+    }
+
+    return QSharedPointer<Packet>(new TcpResponsePacket(conn_id, resp_data, data));
   }
 
   QByteArray TcpResponsePacket::PayloadToByteArray() const 
   {
-    return _resp_data;
+    QByteArray flags(1, 0);
+    if(IsCompressed()) {
+      flags[0] = Flag_Compressed;
+      return flags + _compressed;
+    }
+    return flags + _resp_data;
   }
 
 }
@@ -9,30 +9,55 @@ namespace Packets {
 
   /**
    * Packet sent by RemoteTunnel back to LocalTunnel containing
-   * TCP response data from the proxy server.
+   * TCP response data from the proxy server. The response data
+   * may be sent compressed.
    */
   class TcpResponsePacket : public Packet {
 
     public:
+      /**
+       * Largest response that a packet may carry, bounds the
+       * memory used to decompress one
+       */
+      static const int MaxResponseLength = 1024 * 1024;
+
       /**
        * Constructor
        * @param connection ID
        * @param bytes representing the response
+       * @param compress the response if that makes it smaller
        */
-      TcpResponsePacket(const QByteArray &conn_id, const QByteArray &resp_data);
+      TcpResponsePacket(const QByteArray &conn_id, const QByteArray &resp_data,
+          bool compress = false);
 
       /**
        * Get the contents of the response
        */
       inline QByteArray GetResponseData() const { return _resp_data; }
 
+      /**
+       * Returns true if the response is sent compressed
+       */
+      inline bool IsCompressed() const { return !_compressed.isEmpty(); }
+
       virtual QByteArray PayloadToByteArray() const;
 
       static QSharedPointer<Packet> ReadFooters(const QByteArray &_conn_id, const QByteArray &payload);
 
     private:
 
+      /**
+       * Constructor for a received packet
+       */
+      TcpResponsePacket(const QByteArray &conn_id, const QByteArray &resp_data,
+          const QByteArray &compressed);
+
+      typedef enum {
+        Flag_Compressed = 0x01
+      } Flags;
+
       QByteArray _resp_data;
+      QByteArray _compressed;
 
   };
 
@@ -15,26 +15,31 @@ namespace Dissent {
 namespace Tunnel {
 namespace Packets {
 
-  TcpStartPacket::TcpStartPacket(const QByteArray &verif_key, const SocksHostAddress &dest_host) :
+  TcpStartPacket::TcpStartPacket(const QByteArray &verif_key, const SocksHostAddress &dest_host,
+      const QByteArray &dh_pub, const QByteArray &signature) :
       Packet(PacketType_TcpStart, 
         0,
         CryptoFactory::GetInstance().GetLibrary()->GetHashAlgorithm()->ComputeHash(verif_key)),
       _verif_key(verif_key),
-      _host(dest_host)
+      _host(dest_host),
+      _dh_pub(dh_pub),
+      _sig(signature)
   {
     SetPayloadSize(PayloadToByteArray().count());
   };
 
   QSharedPointer<Packet> TcpStartPacket::ReadFooters(const QByteArray &, const QByteArray &payload)
   {
-    QByteArray verif_key;
+    QByteArray verif_key, dh_pub, sig;
     SocksHostAddress name;
     QDataStream stream(payload);
 
     stream >> verif_key;
     name = SocksHostAddress(stream);
+    // Absent from packets of connections that sign their requests
+    stream >> dh_pub >> sig;
 
-    return QSharedPointer<TcpStartPacket>(new TcpStartPacket(verif_key, name));
+    return QSharedPointer<TcpStartPacket>(new TcpStartPacket(verif_key, name, dh_pub, sig));
   }
 
   QByteArray TcpStartPacket::PayloadToByteArray() const 
@@ -44,6 +49,9 @@ namespace Packets {
 
     stream << _verif_key; 
     _host.Serialize(stream);
+    if(!_dh_pub.isEmpty()) {
+      stream << _dh_pub << _sig;
+    }
 
     return payload;
   }
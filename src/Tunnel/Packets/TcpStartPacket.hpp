@@ -24,8 +24,12 @@ namespace Packets {
        * Constructor
        * @param per-connection public signature verification key for this connection
        * @param address of the destination host 
+       * @param optional Diffie-Hellman public component for agreeing on a
+       *        per-connection MAC key with the exit
+       * @param signature on the key agreement bytes
        */
-      TcpStartPacket(const QByteArray &verif_key, const SocksHostAddress &dest_host);
+      TcpStartPacket(const QByteArray &verif_key, const SocksHostAddress &dest_host,
+          const QByteArray &dh_pub = QByteArray(), const QByteArray &signature = QByteArray());
 
       /**
        * Get the verification key bytearray 
@@ -37,6 +41,17 @@ namespace Packets {
        */
       inline SocksHostAddress GetHostName() const { return _host; }
 
+      /**
+       * Get the Diffie-Hellman public component, empty if the connection
+       * signs its request packets
+       */
+      inline QByteArray GetKeyAgreement() const { return _dh_pub; }
+
+      /**
+       * Get the signature on the key agreement bytes
+       */
+      inline QByteArray GetSignature() const { return _sig; }
+
       virtual QByteArray PayloadToByteArray() const;
 
       static QSharedPointer<Packet> ReadFooters(const QByteArray &_conn_id, 
@@ -46,6 +61,8 @@ namespace Packets {
 
       QByteArray _verif_key;
       SocksHostAddress _host;
+      QByteArray _dh_pub;
+      QByteArray _sig;
   };
 
 }
@@ -18,11 +18,13 @@ namespace Packets {
   UdpRequestPacket::UdpRequestPacket(const QByteArray &conn_id, 
       const QByteArray &sig,
       const SocksHostAddress &dest_host,
-      const QByteArray &contents) :
+      const QByteArray &contents,
+      int seq) :
       Packet(PacketType_UdpRequest, 0, conn_id),
       _sig(sig),
       _host(dest_host),
-      _contents(contents)
+      _contents(contents),
+      _seq(seq)
   {
     SetPayloadSize(PayloadToByteArray().count());
   };
@@ -30,14 +32,15 @@ namespace Packets {
   QSharedPointer<Packet> UdpRequestPacket::ReadFooters(const QByteArray &conn_id, const QByteArray &payload)
   {
     QByteArray sig, contents;
+    qint32 seq = -1;
     SocksHostAddress name;
     QDataStream stream(payload);
 
-    stream >> sig;
+    stream >> seq >> sig;
     name = SocksHostAddress(stream);
     stream >> contents;
 
-    return QSharedPointer<UdpRequestPacket>(new UdpRequestPacket(conn_id, sig, name, contents));
+    return QSharedPointer<UdpRequestPacket>(new UdpRequestPacket(conn_id, sig, name, contents, seq));
   }
 
   QByteArray UdpRequestPacket::PayloadToByteArray() const 
@@ -45,7 +48,7 @@ namespace Packets {
     QByteArray payload;
     QDataStream stream(&payload, QIODevice::WriteOnly);
 
-    stream << _sig;
+    stream << static_cast<qint32>(_seq) << _sig;
     _host.Serialize(stream);
     stream << _contents;
 
@@ -23,19 +23,27 @@ namespace Packets {
       /**
        * Constructor
        * @param per-connection public signature verification key for this connection
+       * @param signature or MAC on the destination and payload
        * @param destination of the packet
        * @param packet payload
+       * @param sequence number among the connection's requests
        */
       UdpRequestPacket(const QByteArray &conn_id, 
           const QByteArray &sig,
           const SocksHostAddress &dest_host,
-          const QByteArray &contents);
+          const QByteArray &contents,
+          int seq = -1);
   
       /**
-       * Get the signature bytes on the packet
+       * Get the signature or MAC bytes on the packet
        */
       inline QByteArray GetSignature() const { return _sig; }
 
+      /**
+       * Get the sequence number
+       */
+      inline int GetSequence() const { return _seq; }
+
       /**
        * Get the address of the remote destination host
        */
@@ -56,6 +64,7 @@ namespace Packets {
       QByteArray _sig;
       SocksHostAddress _host;
       QByteArray _contents;
+      int _seq;
 
   };
 
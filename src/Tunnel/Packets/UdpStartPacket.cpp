@@ -15,22 +15,36 @@ namespace Dissent {
 namespace Tunnel {
 namespace Packets {
 
-  UdpStartPacket::UdpStartPacket(const QByteArray &verif_key) :
+  UdpStartPacket::UdpStartPacket(const QByteArray &verif_key, const QByteArray &dh_pub,
+      const QByteArray &signature) :
       Packet(PacketType_UdpStart, 
-        verif_key.count(),
+        0,
         CryptoFactory::GetInstance().GetLibrary()->GetHashAlgorithm()->ComputeHash(verif_key)),
-      _verif_key(verif_key)
+      _verif_key(verif_key),
+      _dh_pub(dh_pub),
+      _sig(signature)
   {
+    SetPayloadSize(PayloadToByteArray().count());
   };
 
   QSharedPointer<Packet> UdpStartPacket::ReadFooters(const QByteArray &, const QByteArray &payload)
   {
-    return QSharedPointer<UdpStartPacket>(new UdpStartPacket(payload));
+    QByteArray verif_key, dh_pub, sig;
+    QDataStream stream(payload);
+
+    stream >> verif_key >> dh_pub >> sig;
+
+    return QSharedPointer<UdpStartPacket>(new UdpStartPacket(verif_key, dh_pub, sig));
   }
 
   QByteArray UdpStartPacket::PayloadToByteArray() const 
   {
-    return _verif_key;
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+
+    stream << _verif_key << _dh_pub << _sig;
+
+    return payload;
   }
 
 }
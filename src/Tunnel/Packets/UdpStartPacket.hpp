@@ -23,14 +23,29 @@ namespace Packets {
        * Constructor
        * @param verification key to be used to sign request packet
        *        for this connection
+       * @param optional Diffie-Hellman public component for agreeing on a
+       *        per-connection MAC key with the exit
+       * @param signature on the key agreement bytes
        */
-      UdpStartPacket(const QByteArray &verif_key);
+      UdpStartPacket(const QByteArray &verif_key, const QByteArray &dh_pub = QByteArray(),
+          const QByteArray &signature = QByteArray());
   
       /**
        * Get the verification key bytes
        */
       inline QByteArray GetVerificationKey() const { return _verif_key; }
 
+      /**
+       * Get the Diffie-Hellman public component, empty if the connection
+       * signs its request packets
+       */
+      inline QByteArray GetKeyAgreement() const { return _dh_pub; }
+
+      /**
+       * Get the signature on the key agreement bytes
+       */
+      inline QByteArray GetSignature() const { return _sig; }
+
       virtual QByteArray PayloadToByteArray() const;
 
       static QSharedPointer<Packet> ReadFooters(const QByteArray &_conn_id, 
@@ -39,6 +54,8 @@ namespace Packets {
     private:
 
       QByteArray _verif_key;
+      QByteArray _dh_pub;
+      QByteArray _sig;
 
   };
 
@@ -3,10 +3,14 @@
 
 #include "Crypto/AsymmetricKey.hpp"
 #include "Crypto/CryptoFactory.hpp"
+#include "Crypto/DiffieHellman.hpp"
+#include "Crypto/Hmac.hpp"
 #include "Crypto/Library.hpp"
 
 #include "Tunnel/Packets/Packet.hpp"
 #include "Tunnel/Packets/FinishPacket.hpp"
+#include "Tunnel/Packets/KeyAgreementPacket.hpp"
+#include "Tunnel/Packets/TcpAckPacket.hpp"
 #include "Tunnel/Packets/TcpResponsePacket.hpp"
 #include "Tunnel/Packets/UdpResponsePacket.hpp"
 #include "Tunnel/Packets/TcpRequestPacket.hpp"
@@ -15,14 +19,30 @@
 #include "Tunnel/Packets/UdpStartPacket.hpp"
 
 #include "SocksConnection.hpp"
+#include "TunnelConnectionTable.hpp"
 
 using Dissent::Crypto::AsymmetricKey;
 using Dissent::Crypto::CryptoFactory;
+using Dissent::Crypto::DiffieHellman;
+using Dissent::Crypto::Hmac;
 using Dissent::Crypto::Library;
 using namespace Dissent::Tunnel::Packets;
 
 namespace Dissent {
 namespace Tunnel {
+namespace {
+  bool symmetric_authentication = false;
+}
+
+  void SocksConnection::SetSymmetricAuthentication(bool enabled)
+  {
+    symmetric_authentication = enabled;
+  }
+
+  bool SocksConnection::GetSymmetricAuthentication()
+  {
+    return symmetric_authentication;
+  }
 
   SocksConnection::SocksConnection(QTcpSocket *socket) :
     _state(ConnState_WaitingForMethodHeader),
@@ -31,9 +51,14 @@ namespace Tunnel {
     _crypto_lib(CryptoFactory::GetInstance().GetLibrary()),
     _hash_algo(_crypto_lib->GetHashAlgorithm()),
     _signing_key(_crypto_lib->CreatePrivateKey()),
-    _verif_key(_signing_key->GetPublicKey())
+    _verif_key(_signing_key->GetPublicKey()),
+    _next_request_seq(0),
+    _next_ack_seq(0),
+    _received(0),
+    _acked(0)
   {
     connect(socket, SIGNAL(readyRead()), this, SLOT(ReadFromSocket()));
+    connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(HandleBytesWritten(qint64)));
     connect(socket, SIGNAL(disconnected()), this, SLOT(Close()));
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), 
              SLOT(HandleError(QAbstractSocket::SocketError)));
@@ -58,6 +83,8 @@ namespace Tunnel {
         return;
       case Packet::PacketType_UdpRequest:
         return;
+      case Packet::PacketType_TcpAck:
+        return;
       case Packet::PacketType_TcpResponse:
         HandleTcpResponse(pp);
         return;
@@ -68,6 +95,9 @@ namespace Tunnel {
         qDebug() << "SOCKS got finish";
         Close();
         return;
+      case Packet::PacketType_KeyAgreement:
+        HandleKeyAgreement(pp);
+        return;
      default:
         qWarning() << "SOCKS Unknown packet type" << ptype;
     }
@@ -343,7 +373,9 @@ namespace Tunnel {
   void SocksConnection::StartConnect(const SocksHostAddress &dest_host) 
   {
     QByteArray verif_bytes = _verif_key->GetByteArray();
-    QByteArray packet = TcpStartPacket(verif_bytes, dest_host).ToByteArray();
+    QByteArray sig;
+    QByteArray dh_pub = StartKeyAgreement(sig);
+    QByteArray packet = TcpStartPacket(verif_bytes, dest_host, dh_pub, sig).ToByteArray();
 
     // Start the connection
     _conn_id = _hash_algo->ComputeHash(verif_bytes);
@@ -382,7 +414,9 @@ namespace Tunnel {
              SLOT(UdpHandleError(QAbstractSocket::SocketError)));
 
     QByteArray verif_bytes = _verif_key->GetByteArray();
-    QByteArray packet = UdpStartPacket(verif_bytes).ToByteArray();
+    QByteArray sig;
+    QByteArray dh_pub = StartKeyAgreement(sig);
+    QByteArray packet = UdpStartPacket(verif_bytes, dh_pub, sig).ToByteArray();
 
     // Start the connection
     _conn_id = _hash_algo->ComputeHash(verif_bytes);
@@ -405,7 +439,9 @@ namespace Tunnel {
     do {
       QByteArray data = _socket->read(BytesPerPacket);
       qDebug() << "SOCKS Read" << data.count() << "bytes from socket";
-      TcpRequestPacket reqp(_conn_id, _signing_key->Sign(data), data);
+      int seq = _next_request_seq++;
+      QByteArray tag = AuthenticateBytes(Packet::PacketType_TcpRequest, seq, data);
+      TcpRequestPacket reqp(_conn_id, tag, data, seq);
 
       QByteArray req_bytes = reqp.ToByteArray();
       qDebug() << "SOCKS Sending request packet of bytes" << req_bytes.count();
@@ -422,6 +458,32 @@ namespace Tunnel {
     }
     qDebug() << "SOCKS response : " << rp->GetResponseData().count();
     TryWrite(rp->GetResponseData());
+    _received += rp->GetResponseData().count();
+    TrySendAck();
+  }
+
+  void SocksConnection::HandleBytesWritten(qint64)
+  {
+    TrySendAck();
+  }
+
+  void SocksConnection::TrySendAck()
+  {
+    if(!_socket_open || !_conn_id.count()) {
+      return;
+    }
+
+    // Data still buffered in the socket has not reached the client
+    qint64 delivered = _received - _socket->bytesToWrite();
+    if(delivered - _acked < TcpAckPacket::AckInterval) {
+      return;
+    }
+
+    _acked = delivered;
+    int seq = _next_ack_seq++;
+    QByteArray tag = AuthenticateBytes(Packet::PacketType_TcpAck, seq,
+        TcpAckPacket::AuthenticatedBytes(_acked));
+    SendUpstreamPacket(TcpAckPacket(_conn_id, tag, _acked, seq).ToByteArray());
   }
 
   void SocksConnection::HandleUdpResponse(QSharedPointer<Packet> pp) 
@@ -440,6 +502,60 @@ namespace Tunnel {
     _udp_socket->writeDatagram(datagram, _udp_peer, _udp_peer_port);
   }
 
+  void SocksConnection::HandleKeyAgreement(QSharedPointer<Packet> pp)
+  {
+    KeyAgreementPacket *kp = dynamic_cast<KeyAgreementPacket*>(pp.data());
+    if(!kp) {
+      qWarning() << "SOCKS Could not cast KeyAgreementPacket";
+      return;
+    }
+
+    if(_dh_key.isNull()) {
+      qDebug() << "SOCKS Ignoring unexpected key agreement";
+      return;
+    }
+
+    QByteArray remote_pub = kp->GetKeyAgreement();
+    QByteArray secret;
+    if(remote_pub.count() == _dh_key->GetPublicComponent().count()) {
+      secret = _dh_key->GetSharedSecret(remote_pub);
+    }
+
+    if(secret.isEmpty()) {
+      qWarning() << "SOCKS Invalid key agreement, continuing to sign requests";
+      return;
+    }
+
+    _dh_key.clear();
+    _mac = QSharedPointer<Hmac>(new Hmac(secret));
+    qDebug() << "SOCKS Authenticating requests with MACs";
+  }
+
+  QByteArray SocksConnection::StartKeyAgreement(QByteArray &signature)
+  {
+    if(!symmetric_authentication) {
+      signature.clear();
+      return QByteArray();
+    }
+
+    _dh_key = QSharedPointer<DiffieHellman>(_crypto_lib->CreateDiffieHellman());
+    QByteArray dh_pub = _dh_key->GetPublicComponent();
+    signature = _signing_key->Sign(TunnelConnectionTable::KeyAgreementBytes(dh_pub));
+    return dh_pub;
+  }
+
+  QByteArray SocksConnection::AuthenticateBytes(int type, int seq,
+      const QByteArray &data)
+  {
+    // Packets sent before the exit's reply arrives are signed
+    QByteArray bytes = TunnelConnectionTable::AuthenticatedBytes(type, seq, data);
+    if(_mac.isNull()) {
+      return _signing_key->Sign(bytes);
+    }
+
+    return _mac->ComputeMac(bytes);
+  }
+
   void SocksConnection::SendUpstreamPacket(const QByteArray &packet)
   {
     qDebug() << "SOCKS sending upstream packet len " << packet.count();
@@ -487,12 +603,16 @@ namespace Tunnel {
     qDebug() << "SOCKS Host address" << dest_addr.ToString();
 
     QByteArray payload = datagram.mid(4 + bytes_read);
+    int seq = _next_request_seq++;
+    QByteArray tag = AuthenticateBytes(Packet::PacketType_UdpRequest, seq,
+        dest_addr.ToString().toAscii() + payload);
     SendUpstreamPacket(
         UdpRequestPacket(
           _conn_id, 
-          _signing_key->Sign(dest_addr.ToString().toAscii() + payload), 
+          tag,
           dest_addr, 
-          payload).ToByteArray()); 
+          payload,
+          seq).ToByteArray()); 
   }
 
   void SocksConnection::TryWrite(const QByteArray &data)
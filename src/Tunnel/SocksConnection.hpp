@@ -13,7 +13,9 @@
 namespace Dissent {
 namespace Crypto {
   class AsymmetricKey;
+  class DiffieHellman;
   class Hash;
+  class Hmac;
   class Library;
 }
 
@@ -31,6 +33,14 @@ namespace Tunnel {
    *
    * SocksConnection supports the SOCKS v5 CONNECT and UDP
    * ASSOCIATE commands.
+   *
+   * Request packets are signed with a per-connection key. With symmetric
+   * authentication enabled, the start packet also carries a signed
+   * Diffie-Hellman public component. Once the exit replies with its own,
+   * request packets carry a sequence-numbered MAC instead of a signature.
+   *
+   * Delivery of TCP response data to the client is acknowledged upstream,
+   * opening the exit's downstream window for the connection.
    */
   class SocksConnection : public QObject {
     Q_OBJECT
@@ -40,7 +50,9 @@ namespace Tunnel {
       static const int BytesPerPacket = 1024;
 
       typedef Dissent::Crypto::AsymmetricKey AsymmetricKey;
+      typedef Dissent::Crypto::DiffieHellman DiffieHellman;
       typedef Dissent::Crypto::Hash Hash;
+      typedef Dissent::Crypto::Hmac Hmac;
       typedef Dissent::Crypto::Library Library;
       typedef Dissent::Tunnel::Packets::Packet Packet;
 
@@ -106,6 +118,22 @@ namespace Tunnel {
        */
       inline QByteArray GetConnectionId() const { return _conn_id; }
 
+      /**
+       * Returns true once request packets are authenticated by MACs
+       */
+      inline bool UsesMacs() const { return !_mac.isNull(); }
+
+      /**
+       * Sets whether new connections agree on a MAC key with the exit
+       * @param enabled true to authenticate request packets with MACs
+       */
+      static void SetSymmetricAuthentication(bool enabled);
+
+      /**
+       * Returns true if new connections agree on a MAC key with the exit
+       */
+      static bool GetSymmetricAuthentication();
+
     public slots:
 
       /**
@@ -133,6 +161,11 @@ namespace Tunnel {
        */
       void UdpHandleError(QAbstractSocket::SocketError);
 
+      /**
+       * Acknowledges response data the TCP socket has written
+       */
+      void HandleBytesWritten(qint64);
+
 
     signals:
 
@@ -185,6 +218,27 @@ namespace Tunnel {
        */
       void HandleTcpResponse(QSharedPointer<Packet> pp);
       void HandleUdpResponse(QSharedPointer<Packet> pp);
+      void HandleKeyAgreement(QSharedPointer<Packet> pp);
+
+      /**
+       * Sends an ack once enough response data has been delivered
+       */
+      void TrySendAck();
+
+      /**
+       * Returns the key agreement bytes for a start packet and sets
+       * signature to their signature, both empty without symmetric
+       * authentication
+       */
+      QByteArray StartKeyAgreement(QByteArray &signature);
+
+      /**
+       * Returns the signature or MAC on an upstream packet's data
+       * @param packet type
+       * @param the packet's sequence number among requests or acks
+       * @param data bytes
+       */
+      QByteArray AuthenticateBytes(int type, int seq, const QByteArray &data);
 
       void SendUpstreamPacket(const QByteArray &packet);
       void UdpProcessDatagram(const QByteArray &datagram);
@@ -229,6 +283,15 @@ namespace Tunnel {
       QSharedPointer<AsymmetricKey> _signing_key;
       QSharedPointer<AsymmetricKey> _verif_key;
       QByteArray _conn_id;
+
+      QSharedPointer<DiffieHellman> _dh_key;
+      QSharedPointer<Hmac> _mac;
+      int _next_request_seq;
+      int _next_ack_seq;
+
+      /* Response bytes received and acknowledged */
+      qint64 _received;
+      qint64 _acked;
   };
 }
 }
@@ -0,0 +1,167 @@
+#include <QDebug>
+
+#include "Utils/Time.hpp"
+
+#include "TcpConnectionPool.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+
+  TcpConnectionPool::TcpConnectionPool(const QNetworkProxy &proxy,
+      DnsCache &dns) :
+    _proxy(proxy),
+    _dns(dns),
+    _capacity(0),
+    _hits(0),
+    _misses(0)
+  {
+    _expire_timer.setInterval(IdleTimeout / 2);
+    connect(&_expire_timer, SIGNAL(timeout()), this, SLOT(ExpireIdle()));
+  }
+
+  TcpConnectionPool::~TcpConnectionPool()
+  {
+    Clear();
+  }
+
+  void TcpConnectionPool::SetCapacity(int destinations)
+  {
+    _capacity = destinations;
+    while(_recent.count() > _capacity) {
+      Drop(_recent.takeFirst());
+    }
+  }
+
+  QTcpSocket *TcpConnectionPool::Take(const SocksHostAddress &dest)
+  {
+    if(!_capacity) {
+      return 0;
+    }
+
+    QString key = Key(dest);
+    QTcpSocket *socket = 0;
+
+    if(_idle.contains(key)) {
+      IdleConnection idle = _idle.take(key);
+      _keys.remove(idle.socket);
+      disconnect(idle.socket, 0, this, 0);
+
+      qint64 age = Dissent::Utils::Time::GetInstance().MSecsSinceEpoch() - idle.opened;
+      if(idle.socket->state() != QAbstractSocket::UnconnectedState && age < IdleTimeout) {
+        idle.socket->setParent(0);
+        socket = idle.socket;
+      } else {
+        idle.socket->abort();
+        idle.socket->deleteLater();
+      }
+    }
+
+    if(socket) {
+      _hits++;
+    } else {
+      _misses++;
+    }
+    qDebug() << "SOCKS pool" << key << (socket ? "hit" : "miss");
+
+    bool repeated = _recent.removeAll(key) > 0;
+    _recent.append(key);
+    while(_recent.count() > _capacity) {
+      Drop(_recent.takeFirst());
+    }
+
+    if(repeated) {
+      Open(dest);
+    }
+    return socket;
+  }
+
+  void TcpConnectionPool::Clear()
+  {
+    foreach(const QString &key, _idle.keys()) {
+      Drop(key);
+    }
+    _recent.clear();
+    _expire_timer.stop();
+  }
+
+  void TcpConnectionPool::HandleDisconnect()
+  {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if(!socket || !_keys.contains(socket)) {
+      return;
+    }
+    Drop(_keys[socket]);
+  }
+
+  void TcpConnectionPool::ExpireIdle()
+  {
+    qint64 now = Dissent::Utils::Time::GetInstance().MSecsSinceEpoch();
+    foreach(const QString &key, _idle.keys()) {
+      if(now - _idle[key].opened >= IdleTimeout) {
+        Drop(key);
+      }
+    }
+
+    if(_idle.isEmpty()) {
+      _expire_timer.stop();
+    }
+  }
+
+  void TcpConnectionPool::Open(const SocksHostAddress &dest)
+  {
+    QString key = Key(dest);
+    if(_idle.contains(key)) {
+      return;
+    }
+
+    bool proxy_does_lookups = _proxy.capabilities() & QNetworkProxy::HostNameLookupCapability;
+    QList<QHostAddress> addresses;
+    if(dest.IsHostName() && !proxy_does_lookups) {
+      QString name = QString(dest.GetName()).toLower();
+      if(_dns.Lookup(name, addresses) != DnsCache::Result_Hit) {
+        return;
+      }
+    }
+
+    QTcpSocket *socket = new QTcpSocket(this);
+    socket->setProxy(_proxy);
+    connect(socket, SIGNAL(disconnected()), this, SLOT(HandleDisconnect()));
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
+        this, SLOT(HandleDisconnect()));
+
+    IdleConnection idle = {socket, Dissent::Utils::Time::GetInstance().MSecsSinceEpoch()};
+    _idle[key] = idle;
+    _keys[socket] = key;
+
+    if(!addresses.isEmpty()) {
+      socket->connectToHost(addresses[0], dest.GetPort());
+    } else if(dest.IsHostName()) {
+      socket->connectToHost(dest.GetName(), dest.GetPort());
+    } else {
+      socket->connectToHost(dest.GetAddress(), dest.GetPort());
+    }
+
+    if(!_expire_timer.isActive()) {
+      _expire_timer.start();
+    }
+  }
+
+  void TcpConnectionPool::Drop(const QString &key)
+  {
+    if(!_idle.contains(key)) {
+      return;
+    }
+
+    IdleConnection idle = _idle.take(key);
+    _keys.remove(idle.socket);
+    disconnect(idle.socket, 0, this, 0);
+    idle.socket->abort();
+    idle.socket->deleteLater();
+  }
+
+  QString TcpConnectionPool::Key(const SocksHostAddress &dest)
+  {
+    return dest.ToString().toLower();
+  }
+}
+}
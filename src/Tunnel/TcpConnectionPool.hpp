@@ -0,0 +1,134 @@
+#ifndef DISSENT_TUNNEL_TCP_CONNECTION_POOL_H_GUARD
+#define DISSENT_TUNNEL_TCP_CONNECTION_POOL_H_GUARD
+
+#include <QHash>
+#include <QList>
+#include <QNetworkProxy>
+#include <QObject>
+#include <QString>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "DnsCache.hpp"
+#include "SocksHostAddress.hpp"
+
+namespace Dissent {
+namespace Tunnel {
+
+  /**
+   * Keeps one idle upstream connection open to each of the most recently
+   * used destinations of the exit tunnel. A new tunnel connection to such
+   * a destination takes the idle connection rather than waiting for a
+   * handshake. Only destinations used more than once are kept warm, so a
+   * destination seen a single time costs no extra connection. Host names
+   * are connected to through the tunnel's DnsCache and are not warmed
+   * until the cache has resolved them, unless the proxy does lookups. Idle
+   * connections are closed after IdleTimeout milliseconds or once the
+   * server closes them.
+   */
+  class TcpConnectionPool : public QObject {
+    Q_OBJECT
+
+    public:
+      /**
+       * Milliseconds an idle connection is kept
+       */
+      static const int IdleTimeout = 30000;
+
+      /**
+       * Constructor
+       * @param proxy the proxy used for upstream connections
+       * @param dns the cache used to resolve host names
+       */
+      TcpConnectionPool(const QNetworkProxy &proxy, DnsCache &dns);
+
+      virtual ~TcpConnectionPool();
+
+      /**
+       * Sets the number of destinations kept warm, 0 disables the pool
+       */
+      void SetCapacity(int destinations);
+
+      /**
+       * Returns the number of destinations kept warm
+       */
+      inline int GetCapacity() const { return _capacity; }
+
+      /**
+       * Returns an idle connection to the destination, owned by the caller
+       * and still connecting or connected, or 0 if there is none. The
+       * destination becomes the most recently used one and, if it was
+       * already among the recent ones, is refilled.
+       * @param dest the destination
+       */
+      QTcpSocket *Take(const SocksHostAddress &dest);
+
+      /**
+       * Closes all idle connections and forgets the destinations
+       */
+      void Clear();
+
+      /**
+       * Returns the number of idle connections
+       */
+      inline int Count() const { return _idle.count(); }
+
+      /**
+       * Returns the number of Take calls answered with a connection
+       */
+      inline int GetHits() const { return _hits; }
+
+      /**
+       * Returns the number of Take calls that found no connection
+       */
+      inline int GetMisses() const { return _misses; }
+
+    private slots:
+      /**
+       * Drops an idle connection closed by its server
+       */
+      void HandleDisconnect();
+
+      /**
+       * Closes idle connections that have been unused for too long
+       */
+      void ExpireIdle();
+
+    private:
+      /**
+       * Opens an idle connection to the destination if it has none and its
+       * address is known
+       */
+      void Open(const SocksHostAddress &dest);
+
+      /**
+       * Closes and forgets the destination's idle connection
+       */
+      void Drop(const QString &key);
+
+      static QString Key(const SocksHostAddress &dest);
+
+      typedef struct {
+        QTcpSocket *socket;
+        qint64 opened;
+      } IdleConnection;
+
+      QNetworkProxy _proxy;
+      DnsCache &_dns;
+      int _capacity;
+
+      /**
+       * Destinations, most recently used last
+       */
+      QList<QString> _recent;
+      QHash<QString, IdleConnection> _idle;
+      QHash<QTcpSocket *, QString> _keys;
+      QTimer _expire_timer;
+
+      int _hits;
+      int _misses;
+  };
+}
+}
+
+#endif
@@ -3,13 +3,22 @@
 
 #include "Crypto/AsymmetricKey.hpp"
 #include "Crypto/CryptoFactory.hpp"
+#include "Crypto/DiffieHellman.hpp"
+#include "Crypto/Hmac.hpp"
 #include "Crypto/Library.hpp"
+#include "Utils/Serialization.hpp"
+
+#include "Tunnel/Packets/Packet.hpp"
 
 #include "TunnelConnectionTable.hpp"
 
 using Dissent::Crypto::AsymmetricKey;
 using Dissent::Crypto::CryptoFactory;
+using Dissent::Crypto::DiffieHellman;
+using Dissent::Crypto::Hmac;
 using Dissent::Crypto::Library;
+using Dissent::Tunnel::Packets::Packet;
+using Dissent::Utils::Serialization;
 
 namespace Dissent {
 namespace Tunnel {
@@ -33,6 +42,9 @@ namespace Tunnel {
     cd.verif_key = QSharedPointer<AsymmetricKey>((cd.signing_key)->GetPublicKey());
     cd.verif_key_bytes = (cd.verif_key)->GetByteArray();
     cd.conn_id = _hash_algo->ComputeHash(cd.verif_key_bytes);
+    cd.next_request_seq = 0;
+    cd.next_ack_seq = 0;
+    cd.mac_in_use = false;
 
     _table[conn_object] = cd;
     _id_to_socket[cd.conn_id] = conn_object;
@@ -51,6 +63,9 @@ namespace Tunnel {
     cd.conn_id = hash;
     cd.verif_key = QSharedPointer<AsymmetricKey>(_crypto_lib->LoadPublicKeyFromByteArray(verif_key_bytes));
     cd.verif_key_bytes = verif_key_bytes;
+    cd.next_request_seq = 0;
+    cd.next_ack_seq = 0;
+    cd.mac_in_use = false;
 
     _table[conn_object] = cd;
     _id_to_socket[hash] = conn_object;
@@ -121,6 +136,80 @@ namespace Tunnel {
     return _table[ConnectionForId(id)].verif_key->Verify(data, sig);
   }
 
+  bool TunnelConnectionTable::VerifyKeyAgreement(const QByteArray &id,
+      const QByteArray &dh_pub, const QByteArray &sig) const
+  {
+    if(!_id_to_socket.contains(id)) {
+      qFatal("Invalid lookup in VerifyKeyAgreement()");
+    }
+
+    return _table[ConnectionForId(id)].verif_key->Verify(KeyAgreementBytes(dh_pub), sig);
+  }
+
+  QByteArray TunnelConnectionTable::AgreeKey(QAbstractSocket* conn_object,
+      const QByteArray &remote_pub)
+  {
+    if(!_table.contains(conn_object)) {
+      qFatal("Invalid lookup in AgreeKey()");
+    }
+
+    QScopedPointer<DiffieHellman> dh(_crypto_lib->CreateDiffieHellman());
+    QByteArray local_pub = dh->GetPublicComponent();
+    if(remote_pub.count() != local_pub.count()) {
+      return QByteArray();
+    }
+
+    QByteArray secret = dh->GetSharedSecret(remote_pub);
+    if(secret.isEmpty()) {
+      return QByteArray();
+    }
+
+    ConnectionData &cd = _table[conn_object];
+    cd.mac = QSharedPointer<Hmac>(new Hmac(secret));
+    return local_pub;
+  }
+
+  bool TunnelConnectionTable::VerifyRequest(const QByteArray &id, int type,
+      int seq, const QByteArray &data, const QByteArray &tag)
+  {
+    if(!_id_to_socket.contains(id)) {
+      qFatal("Invalid lookup in VerifyRequest()");
+    }
+
+    ConnectionData &cd = _table[ConnectionForId(id)];
+    int &next_seq = (type == Packet::PacketType_TcpAck) ?
+      cd.next_ack_seq : cd.next_request_seq;
+    if(seq < 0 || seq < next_seq) {
+      return false;
+    }
+
+    // Packets sent before the client learns the key are still signed, once
+    // a MAC arrives the client never signs again
+    QByteArray bytes = AuthenticatedBytes(type, seq, data);
+    if(!cd.mac.isNull() && cd.mac->VerifyMac(bytes, tag)) {
+      cd.mac_in_use = true;
+    } else if(cd.mac_in_use || !cd.verif_key->Verify(bytes, tag)) {
+      return false;
+    }
+
+    next_seq = seq + 1;
+    return true;
+  }
+
+  QByteArray TunnelConnectionTable::KeyAgreementBytes(const QByteArray &dh_pub)
+  {
+    return QByteArray("TunnelKeyAgreement") + dh_pub;
+  }
+
+  QByteArray TunnelConnectionTable::AuthenticatedBytes(int type, int seq,
+      const QByteArray &data)
+  {
+    QByteArray header(5, 0);
+    header[0] = static_cast<char>(type);
+    Serialization::WriteInt(seq, header, 1);
+    return QByteArray("TunnelAuth") + header + data;
+  }
+
   QByteArray TunnelConnectionTable::SignBytes(QAbstractSocket* conn_object, const QByteArray &bytes) const
   {
     if(!_table.contains(conn_object) 
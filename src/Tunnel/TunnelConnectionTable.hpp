@@ -11,6 +11,7 @@ namespace Dissent {
 namespace Crypto {
   class AsymmetricKey;
   class Hash;
+  class Hmac;
   class Library;
 }
 
@@ -26,6 +27,7 @@ namespace Tunnel {
     public:
       typedef Dissent::Crypto::AsymmetricKey AsymmetricKey;
       typedef Dissent::Crypto::Hash Hash;
+      typedef Dissent::Crypto::Hmac Hmac;
       typedef Dissent::Crypto::Library Library;
 
       /**
@@ -99,6 +101,41 @@ namespace Tunnel {
        */
       bool VerifyConnectionBytes(QByteArray &id, QByteArray &data, QByteArray &sig) const;
 
+      /**
+       * Verify the signature on a start packet's Diffie-Hellman public
+       * component for the given connection ID
+       * @param connection ID
+       * @param Diffie-Hellman public component
+       * @param signature on KeyAgreementBytes(dh_pub)
+       */
+      bool VerifyKeyAgreement(const QByteArray &id, const QByteArray &dh_pub,
+          const QByteArray &sig) const;
+
+      /**
+       * Complete a key agreement for a saved connection, after which its
+       * request packets may be authenticated by MACs. Returns the local
+       * Diffie-Hellman public component to send back, or an empty array
+       * if the remote component is invalid.
+       * @param socket object
+       * @param the remote Diffie-Hellman public component
+       */
+      QByteArray AgreeKey(QAbstractSocket* conn_object, const QByteArray &remote_pub);
+
+      /**
+       * Verify a request or ack packet for the given connection ID. Requests
+       * and acks are numbered separately and their sequence numbers must
+       * increase, so replayed packets fail. Packets carry a signature until
+       * the client completes the key agreement and a MAC after, once a MAC
+       * has been accepted signed packets are rejected.
+       * @param connection ID
+       * @param packet type of the request or ack
+       * @param sequence number
+       * @param data bytes
+       * @param signature or MAC of AuthenticatedBytes(type, seq, data)
+       */
+      bool VerifyRequest(const QByteArray &id, int type, int seq,
+          const QByteArray &data, const QByteArray &tag);
+
       /**
        * Return a signature on the data bytes using the connection's signing key
        * @param socket object whose signing key to use
@@ -111,6 +148,22 @@ namespace Tunnel {
        */
       inline int Count() const { return _table.count(); }
 
+      /**
+       * Returns the bytes signed to authenticate a key agreement
+       * @param Diffie-Hellman public component
+       */
+      static QByteArray KeyAgreementBytes(const QByteArray &dh_pub);
+
+      /**
+       * Returns the bytes covered by the signature or MAC of a request or
+       * ack, bound to its packet type so one cannot pass as the other
+       * @param packet type
+       * @param sequence number
+       * @param data bytes
+       */
+      static QByteArray AuthenticatedBytes(int type, int seq,
+          const QByteArray &data);
+
     private:
 
       typedef struct {
@@ -118,6 +171,10 @@ namespace Tunnel {
         QSharedPointer<AsymmetricKey> signing_key;
         QSharedPointer<AsymmetricKey> verif_key;
         QByteArray verif_key_bytes;
+        QSharedPointer<Hmac> mac;
+        bool mac_in_use;
+        int next_request_seq;
+        int next_ack_seq;
       } ConnectionData;
 
       QHash<QAbstractSocket*, ConnectionData> _table;
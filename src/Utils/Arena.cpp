@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include <new>
+
+#include <QAtomicInt>
+#include <QThreadStorage>
+
+#include "Arena.hpp"
+
+namespace Dissent {
+namespace Utils {
+  /**
+   * A block of arena memory.  Allocations are counted only by the owning
+   * thread, frees by any thread, so that allocating needs no atomic
+   * operation: pending starts at zero and is decremented by each free, and
+   * when the arena releases the block it adds the number of allocations,
+   * after which pending is the number of live objects.
+   */
+  class Arena::Block {
+    public:
+      QAtomicInt pending;
+      int allocated;
+      char *next;
+      char *end;
+  };
+
+namespace {
+  /**
+   * Prefixes every allocation, holds the owning block or 0 for the heap
+   */
+  const size_t HEADER_SIZE = 16;
+
+  inline size_t Align(size_t size)
+  {
+    return (size + 15) & ~size_t(15);
+  }
+
+  inline void *&GetOwner(char *mem)
+  {
+    return *reinterpret_cast<void **>(mem);
+  }
+
+  /**
+   * Holds a thread's innermost arena, QThreadStorage deletes the holder but
+   * not the arena when the thread exits
+   */
+  class CurrentArena {
+    public:
+      CurrentArena() : arena(0) {}
+      Arena *arena;
+  };
+
+  inline Arena *&GetCurrentArena()
+  {
+    static QThreadStorage<CurrentArena *> storage;
+    if(!storage.hasLocalData()) {
+      storage.setLocalData(new CurrentArena());
+    }
+    return storage.localData()->arena;
+  }
+
+  QAtomicInt arenas_enabled(1);
+  QAtomicInt counting(0);
+  QAtomicInt heap_allocations;
+  QAtomicInt arena_allocations;
+  QAtomicInt block_allocations;
+}
+
+  Arena::Arena(int block_size) :
+    _previous(GetCurrentArena()),
+    _installed(arenas_enabled != 0),
+    _block_size(block_size),
+    _current(0),
+    _scan(0)
+  {
+    if(_installed) {
+      GetCurrentArena() = this;
+    }
+  }
+
+  Arena::~Arena()
+  {
+    if(_installed) {
+      Arena *&current_arena = GetCurrentArena();
+      Q_ASSERT(current_arena == this);
+      current_arena = _previous;
+    }
+
+    foreach(Block *block, _blocks) {
+      Release(block);
+    }
+  }
+
+  void *Arena::Allocate(size_t size)
+  {
+    size_t total = Align(size + HEADER_SIZE);
+    Arena *arena = GetCurrentArena();
+    if(arena && total <= size_t(arena->_block_size / 4)) {
+      return arena->AllocateLocal(total);
+    }
+
+    char *mem = static_cast<char *>(malloc(size + HEADER_SIZE));
+    if(!mem) {
+      throw std::bad_alloc();
+    }
+
+    if(counting) {
+      heap_allocations.fetchAndAddRelaxed(1);
+    }
+
+    GetOwner(mem) = 0;
+    return mem + HEADER_SIZE;
+  }
+
+  void *Arena::AllocateLocal(size_t size)
+  {
+    if(!_current || _current->next + size > _current->end) {
+      _current = NextBlock();
+    }
+
+    char *mem = _current->next;
+    _current->next += size;
+    _current->allocated++;
+
+    if(counting) {
+      arena_allocations.fetchAndAddRelaxed(1);
+    }
+
+    GetOwner(mem) = _current;
+    return mem + HEADER_SIZE;
+  }
+
+  Arena::Block *Arena::NextBlock()
+  {
+    const size_t offset = Align(sizeof(Block));
+
+    // Reuse a block whose objects have all been destroyed, no other thread
+    // can touch an empty block
+    for(int count = 0; count < _blocks.count(); count++) {
+      _scan = (_scan + 1) % _blocks.count();
+      Block *block = _blocks[_scan];
+      if(block->pending.testAndSetAcquire(-block->allocated, 0)) {
+        block->allocated = 0;
+        block->next = reinterpret_cast<char *>(block) + offset;
+        return block;
+      }
+    }
+
+    char *mem = static_cast<char *>(malloc(_block_size));
+    if(!mem) {
+      throw std::bad_alloc();
+    }
+
+    if(counting) {
+      block_allocations.fetchAndAddRelaxed(1);
+    }
+
+    Block *block = new (mem) Block();
+    block->allocated = 0;
+    block->next = mem + offset;
+    block->end = mem + _block_size;
+    _blocks.append(block);
+    return block;
+  }
+
+  void Arena::Free(void *ptr)
+  {
+    if(!ptr) {
+      return;
+    }
+
+    char *mem = static_cast<char *>(ptr) - HEADER_SIZE;
+    Block *block = static_cast<Block *>(GetOwner(mem));
+    if(!block) {
+      free(mem);
+      return;
+    }
+
+    // The last object of a released block frees it
+    if(block->pending.fetchAndAddOrdered(-1) == 1) {
+      block->~Block();
+      free(block);
+    }
+  }
+
+  void Arena::Release(Block *block)
+  {
+    if(block->pending.fetchAndAddOrdered(block->allocated) == -block->allocated) {
+      block->~Block();
+      free(block);
+    }
+  }
+
+  NoArena::NoArena() :
+    _previous(GetCurrentArena())
+  {
+    GetCurrentArena() = 0;
+  }
+
+  NoArena::~NoArena()
+  {
+    GetCurrentArena() = _previous;
+  }
+
+  void Arena::SetEnabled(bool enabled)
+  {
+    arenas_enabled.fetchAndStoreOrdered(enabled ? 1 : 0);
+  }
+
+  bool Arena::GetEnabled()
+  {
+    return arenas_enabled != 0;
+  }
+
+  void Arena::SetCounting(bool enabled)
+  {
+    counting.fetchAndStoreOrdered(enabled ? 1 : 0);
+  }
+
+  int Arena::GetHeapAllocations()
+  {
+    return heap_allocations;
+  }
+
+  int Arena::GetArenaAllocations()
+  {
+    return arena_allocations;
+  }
+
+  int Arena::GetBlockAllocations()
+  {
+    return block_allocations;
+  }
+
+  void Arena::ResetCounters()
+  {
+    heap_allocations.fetchAndStoreOrdered(0);
+    arena_allocations.fetchAndStoreOrdered(0);
+    block_allocations.fetchAndStoreOrdered(0);
+  }
+}
+}
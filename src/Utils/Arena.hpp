@@ -0,0 +1,179 @@
+#ifndef DISSENT_UTILS_ARENA_H_GUARD
+#define DISSENT_UTILS_ARENA_H_GUARD
+
+#include <stddef.h>
+
+#include <QVector>
+
+namespace Dissent {
+namespace Utils {
+  /**
+   * A scoped, per-thread arena for small, short lived objects.  While an
+   * Arena exists on the stack, ArenaAllocated objects created by the same
+   * thread are bump allocated from the arena's blocks rather than the heap.
+   * When the Arena goes out of scope its blocks are released in bulk: a
+   * block is returned to the heap once the arena and every object allocated
+   * from it are gone, so objects may safely outlive the arena and may be
+   * destroyed by any thread.  Blocks whose objects have all been destroyed
+   * are reused while the arena is still in scope.
+   *
+   * Arenas nest, the innermost one on a thread is used.
+   */
+  class Arena {
+    public:
+      /**
+       * Constructor, makes this the calling thread's arena
+       * @param block_size the size of each block in bytes
+       */
+      explicit Arena(int block_size = DEFAULT_BLOCK_SIZE);
+
+      /**
+       * Destructor, restores the previous arena and releases the blocks
+       */
+      ~Arena();
+
+      /**
+       * Allocates memory from the calling thread's arena, or from the heap if
+       * there is no arena or size is large
+       * @param size number of bytes
+       */
+      static void *Allocate(size_t size);
+
+      /**
+       * Frees memory returned by Allocate
+       * @param ptr the memory
+       */
+      static void Free(void *ptr);
+
+      /**
+       * Enables or disables arenas, when disabled constructing an Arena has
+       * no effect
+       * @param enabled true to enable
+       */
+      static void SetEnabled(bool enabled);
+
+      /**
+       * Returns true if arenas are enabled
+       */
+      static bool GetEnabled();
+
+      /**
+       * Enables or disables allocation counting
+       * @param counting true to count allocations
+       */
+      static void SetCounting(bool counting);
+
+      /**
+       * Returns the number of heap allocations made by Allocate while
+       * counting
+       */
+      static int GetHeapAllocations();
+
+      /**
+       * Returns the number of arena allocations made by Allocate while
+       * counting
+       */
+      static int GetArenaAllocations();
+
+      /**
+       * Returns the number of arena blocks obtained from the heap while
+       * counting
+       */
+      static int GetBlockAllocations();
+
+      /**
+       * Resets the allocation counters
+       */
+      static void ResetCounters();
+
+      /**
+       * Default block size
+       */
+      static const int DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+    private:
+      class Block;
+
+      /**
+       * Allocates from this arena
+       */
+      void *AllocateLocal(size_t size);
+
+      /**
+       * Obtains a free block, reusing an empty one if possible
+       */
+      Block *NextBlock();
+
+      /**
+       * Drops a reference to a block, freeing it with the last reference
+       */
+      static void Release(Block *block);
+
+      Arena *_previous;
+      bool _installed;
+      const int _block_size;
+      QVector<Block *> _blocks;
+      Block *_current;
+      int _scan;
+
+      /**
+       * No copying
+       */
+      Arena(const Arena &);
+
+      /**
+       * No copying
+       */
+      Arena &operator=(const Arena &);
+  };
+
+  /**
+   * While a NoArena exists on the stack, the calling thread allocates from
+   * the heap even inside an Arena, for objects kept well beyond the arena's
+   * scope, such as cached tables, which would otherwise pin its blocks
+   */
+  class NoArena {
+    public:
+      /**
+       * Constructor, hides the calling thread's arena
+       */
+      NoArena();
+
+      /**
+       * Destructor, restores the calling thread's arena
+       */
+      ~NoArena();
+
+    private:
+      Arena *_previous;
+
+      /**
+       * No copying
+       */
+      NoArena(const NoArena &);
+
+      /**
+       * No copying
+       */
+      NoArena &operator=(const NoArena &);
+  };
+
+  /**
+   * Base class directing a class's dynamic allocations to Arena
+   */
+  class ArenaAllocated {
+    public:
+      static void *operator new(size_t size)
+      {
+        return Arena::Allocate(size);
+      }
+
+      static void operator delete(void *ptr)
+      {
+        Arena::Free(ptr);
+      }
+  };
+}
+}
+
+#endif
@@ -1,29 +1,441 @@
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QDateTime>
 #include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
 #include "Logging.hpp"
 #include "Time.hpp"
 
 namespace Dissent {
 namespace Utils {
-  QString Logging::_filename;
+namespace {
+  /**
+   * Maximum number of messages waiting for the writer, must be a power of 2
+   */
+  const int LOG_QUEUE_SIZE = 8192;
+
+  /**
+   * How often the writer wakes up to write out queued messages
+   */
+  const unsigned long LOG_FLUSH_INTERVAL = 50;
+
+  /**
+   * A bounded multi-producer queue.  Each cell carries a sequence number
+   * telling producers and the consumer whose turn it is, so pushing a
+   * message is a single compare and swap on the tail.
+   */
+  class LogQueue {
+    public:
+      LogQueue() : _cells(new Cell[LOG_QUEUE_SIZE]), _head(0)
+      {
+        for(int idx = 0; idx < LOG_QUEUE_SIZE; idx++) {
+          _cells[idx].sequence = idx;
+        }
+      }
+
+      ~LogQueue()
+      {
+        delete[] _cells;
+      }
+
+      /**
+       * Adds a message to the queue, returns false if the queue is full
+       * @param entry the message
+       */
+      bool Push(const QByteArray &entry)
+      {
+        int pos = _tail.fetchAndAddOrdered(0);
+        while(true) {
+          Cell &cell = _cells[pos & (LOG_QUEUE_SIZE - 1)];
+          int diff = Distance(cell.sequence.fetchAndAddAcquire(0), pos);
+          if(diff == 0) {
+            if(_tail.testAndSetOrdered(pos, Next(pos))) {
+              cell.entry = entry;
+              cell.sequence.fetchAndStoreRelease(Next(pos));
+              return true;
+            }
+            pos = _tail.fetchAndAddOrdered(0);
+          } else if(diff < 0) {
+            return false;
+          } else {
+            pos = _tail.fetchAndAddOrdered(0);
+          }
+        }
+      }
+
+      /**
+       * Removes the oldest message from the queue, only the writer thread
+       * may call this
+       * @param entry set to the message
+       * @returns false if the queue is empty
+       */
+      bool Pop(QByteArray &entry)
+      {
+        Cell &cell = _cells[_head & (LOG_QUEUE_SIZE - 1)];
+        if(Distance(cell.sequence.fetchAndAddAcquire(0), Next(_head)) != 0) {
+          return false;
+        }
+
+        entry = cell.entry;
+        cell.entry = QByteArray();
+        cell.sequence.fetchAndStoreRelease(static_cast<int>(
+              static_cast<uint>(_head) + LOG_QUEUE_SIZE));
+        _head = Next(_head);
+        return true;
+      }
+
+    private:
+      struct Cell {
+        QAtomicInt sequence;
+        QByteArray entry;
+      };
+
+      /**
+       * Positions wrap around, so compare them as unsigned offsets
+       */
+      inline static int Distance(int lhs, int rhs)
+      {
+        return static_cast<int>(static_cast<uint>(lhs) - static_cast<uint>(rhs));
+      }
+
+      inline static int Next(int pos)
+      {
+        return static_cast<int>(static_cast<uint>(pos) + 1);
+      }
+
+      Cell *_cells;
+      QAtomicInt _tail;
+      int _head;
+
+    public:
+      /**
+       * Number of messages dropped due to the queue being full
+       */
+      QAtomicInt dropped;
+  };
+
+  /**
+   * Writes queued messages into a file that is kept open, rotating it by
+   * size and age
+   */
+  class LogWriter : public QThread {
+    public:
+      LogWriter(const QString &filename, qint64 max_size, int max_age,
+          int backups) :
+        _filename(filename),
+        _max_size(max_size),
+        _max_age(max_age),
+        _backups(backups),
+        _stop(false),
+        _flush_requests(0),
+        _flushes_done(0),
+        _reported_drops(0)
+      {
+      }
+
+      /**
+       * Queues a message for writing
+       * @param entry the formatted message
+       */
+      inline bool Push(const QByteArray &entry)
+      {
+        if(_queue.Push(entry)) {
+          return true;
+        }
+        _queue.dropped.fetchAndAddRelaxed(1);
+        return false;
+      }
+
+      /**
+       * Returns the number of dropped messages
+       */
+      inline int GetDroppedCount()
+      {
+        return _queue.dropped.fetchAndAddRelaxed(0);
+      }
+
+      /**
+       * Waits until everything queued before this call has been written
+       */
+      void Flush()
+      {
+        QMutexLocker locker(&_mutex);
+        int ticket = ++_flush_requests;
+        _wake.wakeOne();
+        while(_flushes_done < ticket && isRunning()) {
+          _drained.wait(&_mutex, LOG_FLUSH_INTERVAL);
+        }
+      }
+
+      /**
+       * Writes out remaining messages and stops the thread
+       */
+      void Stop()
+      {
+        {
+          QMutexLocker locker(&_mutex);
+          _stop = true;
+          _wake.wakeOne();
+        }
+        wait();
+      }
+
+    protected:
+      virtual void run()
+      {
+        _file.setFileName(_filename);
+        Open();
+
+        while(true) {
+          int target;
+          bool stop;
+          {
+            QMutexLocker locker(&_mutex);
+            target = _flush_requests;
+            stop = _stop;
+          }
+
+          WriteQueued();
+
+          QMutexLocker locker(&_mutex);
+          _flushes_done = target;
+          _drained.wakeAll();
+          if(stop) {
+            break;
+          }
+
+          if(!_stop && _flush_requests == target) {
+            _wake.wait(&_mutex, LOG_FLUSH_INTERVAL);
+          }
+        }
+
+        _file.close();
+      }
+
+    private:
+      void Open()
+      {
+        _file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append);
+        _opened = QDateTime::currentDateTime();
+      }
+
+      void WriteQueued()
+      {
+        QByteArray batch;
+        QByteArray entry;
+        while(_queue.Pop(entry)) {
+          batch.append(entry);
+        }
+
+        int dropped = GetDroppedCount();
+        if(dropped != _reported_drops) {
+          batch.append(QString("Dropped %1 log messages\n").arg(
+                dropped - _reported_drops).toUtf8());
+          _reported_drops = dropped;
+        }
+
+        if(batch.isEmpty()) {
+          return;
+        }
+
+        _file.write(batch);
+        _file.flush();
+
+        if((_max_size > 0 && _file.size() >= _max_size) ||
+            (_max_age > 0 && _opened.secsTo(QDateTime::currentDateTime()) >= _max_age))
+        {
+          Rotate();
+        }
+      }
+
+      /**
+       * Shifts filename.i to filename.(i+1), dropping the oldest, and
+       * moves the current file to filename.1
+       */
+      void Rotate()
+      {
+        _file.close();
+
+        if(_backups > 0) {
+          QFile::remove(_filename + "." + QString::number(_backups));
+          for(int idx = _backups - 1; idx > 0; idx--) {
+            QFile::rename(_filename + "." + QString::number(idx),
+                _filename + "." + QString::number(idx + 1));
+          }
+          QFile::rename(_filename, _filename + ".1");
+        } else {
+          QFile::remove(_filename);
+        }
+
+        Open();
+      }
+
+      const QString _filename;
+      const qint64 _max_size;
+      const int _max_age;
+      const int _backups;
+
+      LogQueue _queue;
+      QFile _file;
+      QDateTime _opened;
 
-  void Logging::UseFile(const QString &filename)
+      QMutex _mutex;
+      QWaitCondition _wake;
+      QWaitCondition _drained;
+      bool _stop;
+      int _flush_requests;
+      int _flushes_done;
+      int _reported_drops;
+  };
+
+  /**
+   * The current writer.  Threads using it count themselves in the current
+   * epoch, so logging takes no lock; replacing the writer switches epochs
+   * and waits for the previous epoch's users to leave.
+   */
+  QAtomicPointer<LogWriter> log_writer;
+  QAtomicInt log_writer_epoch;
+  QAtomicInt log_writer_users[2];
+
+  /**
+   * Serializes replacing the writer
+   */
+  QMutex log_writer_swap_lock;
+
+  /**
+   * Keeps log_writer from being deleted while in scope
+   */
+  class WriterReference {
+    public:
+      WriterReference()
+      {
+        while(true) {
+          _epoch = log_writer_epoch.fetchAndAddOrdered(0);
+          log_writer_users[_epoch].fetchAndAddOrdered(1);
+          if(log_writer_epoch.fetchAndAddOrdered(0) == _epoch) {
+            break;
+          }
+          log_writer_users[_epoch].fetchAndAddOrdered(-1);
+        }
+        _writer = log_writer.fetchAndAddOrdered(0);
+      }
+
+      ~WriterReference()
+      {
+        log_writer_users[_epoch].fetchAndAddOrdered(-1);
+      }
+
+      inline LogWriter *Get() const { return _writer; }
+
+    private:
+      int _epoch;
+      LogWriter *_writer;
+  };
+
+  /**
+   * Replaces the writer.  The old writer is no longer in use once its
+   * epoch's users have left; it then writes out its queued messages and
+   * is deleted.
+   * @param writer the new writer, may be 0
+   */
+  void SwapWriter(LogWriter *writer)
   {
-    _filename = filename;
+    LogWriter *old = 0;
+    {
+      QMutexLocker locker(&log_writer_swap_lock);
+      old = log_writer.fetchAndStoreOrdered(writer);
+      int retired = log_writer_epoch.fetchAndAddOrdered(0);
+      log_writer_epoch.fetchAndStoreOrdered(1 - retired);
+      while(log_writer_users[retired].fetchAndAddOrdered(0)) {
+        QThread::yieldCurrentThread();
+      }
+    }
+
+    if(old) {
+      old->Stop();
+      delete old;
+    }
+  }
+
+  /**
+   * Writes out the remaining messages when the process exits
+   */
+  class LogWriterGuard {
+    public:
+      ~LogWriterGuard()
+      {
+        qInstallMsgHandler(0);
+        SwapWriter(0);
+      }
+  };
+
+  LogWriterGuard log_writer_guard;
+}
+
+  void Logging::UseFile(const QString &filename, qint64 max_size,
+      int max_age, int backups)
+  {
+    LogWriter *writer = new LogWriter(filename, max_size, max_age, backups);
+    writer->start();
+
+    // Messages logged meanwhile go to the old writer, which writes them out
+    SwapWriter(writer);
     qInstallMsgHandler(File);
   }
 
   void Logging::File(QtMsgType type, const char *msg)
   {
-    QFile file(_filename);
-    if(file.open(QFile::WriteOnly | QIODevice::Text | QIODevice::Append)) {
-      QTextStream stream(&file);
+    QByteArray entry;
+    {
+      QTextStream stream(&entry, QIODevice::WriteOnly);
       Write(stream, type, msg);
     }
+
+    WriterReference reference;
+    LogWriter *writer = reference.Get();
+    if(!writer) {
+      return;
+    }
+
+    if(type != QtFatalMsg) {
+      writer->Push(entry);
+      return;
+    }
+
+    // The process aborts once we return, so never drop a fatal message
+    while(!writer->Push(entry)) {
+      writer->Flush();
+    }
+    writer->Flush();
+  }
+
+  void Logging::Flush()
+  {
+    WriterReference reference;
+    if(reference.Get()) {
+      reference.Get()->Flush();
+    }
+  }
+
+  int Logging::GetDroppedCount()
+  {
+    WriterReference reference;
+    return reference.Get() ? reference.Get()->GetDroppedCount() : 0;
+  }
+
+  void Logging::StopWriter()
+  {
+    SwapWriter(0);
   }
 
   void Logging::UseStdout()
   {
     qInstallMsgHandler(Stdout);
+    StopWriter();
   }
 
   void Logging::Stdout(QtMsgType type, const char *msg)
@@ -35,6 +447,7 @@ namespace Utils {
   void Logging::UseStderr()
   {
     qInstallMsgHandler(Stderr);
+    StopWriter();
   }
 
   void Logging::Stderr(QtMsgType type, const char *msg)
@@ -70,11 +483,13 @@ namespace Utils {
   void Logging::UseDefault()
   {
     qInstallMsgHandler(0);
+    StopWriter();
   }
 
   void Logging::Disable()
   {
     qInstallMsgHandler(Disabled);
+    StopWriter();
   }
 
   void Logging::Disabled(QtMsgType, const char *)
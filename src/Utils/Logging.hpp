@@ -8,15 +8,29 @@
 namespace Dissent {
 namespace Utils {
   /**
-   * Interface into Qt's logging system
+   * Interface into Qt's logging system.  Messages below a level can be
+   * removed at compile time by defining QT_NO_DEBUG_OUTPUT and / or
+   * QT_NO_WARNING_OUTPUT (see LOG_LEVEL in dissent.pro), in which case the
+   * arguments to qDebug / qWarning are never evaluated.
    */
   class Logging {
     public:
       /**
-       * Store all logs into the specified file
+       * Store all logs into the specified file.  Messages are formatted by
+       * the logging thread, placed into a bounded lock-free queue, and
+       * written in batches by a dedicated writer thread that keeps the file
+       * open.  If the queue is full, messages are dropped and the number
+       * dropped is noted in the log.
        * @param filename the file in which to store logs
+       * @param max_size rotate the file once it reaches this many bytes,
+       * 0 disables size-based rotation
+       * @param max_age rotate the file once it has been open for this many
+       * seconds, 0 disables time-based rotation
+       * @param backups the number of rotated files (filename.1 being the
+       * most recent) to keep
        */
-      static void UseFile(const QString &filename);
+      static void UseFile(const QString &filename, qint64 max_size = 0,
+          int max_age = 0, int backups = DEFAULT_BACKUPS);
 
       /**
        * Output logs to stdout
@@ -38,13 +52,29 @@ namespace Utils {
        */
       static void Disable();
 
+      /**
+       * Blocks until all queued messages have been written to the log file,
+       * does nothing if not logging to a file
+       */
+      static void Flush();
+
+      /**
+       * Returns the number of messages dropped since UseFile was called
+       */
+      static int GetDroppedCount();
+
+      /**
+       * Number of rotated log files kept by default
+       */
+      static const int DEFAULT_BACKUPS = 5;
+
     private:
-      static QString _filename;
       static void File(QtMsgType type, const char *msg);
       static void Stdout(QtMsgType type, const char *msg);
       static void Stderr(QtMsgType type, const char *msg);
       static void Write(QTextStream &stream, QtMsgType type, const char *msg);
       static void Disabled(QtMsgType type, const char *msg);
+      static void StopWriter();
   };
 }
 }
@@ -0,0 +1,293 @@
+#include <QDebug>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThreadStorage>
+
+#include "Metrics.hpp"
+
+namespace Dissent {
+namespace Utils {
+  const qint64 Metrics::BucketBounds[Metrics::BucketCount - 1] = {
+    10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000, 500000,
+    1000000, 5000000, 10000000
+  };
+
+namespace {
+  enum MetricType {
+    CounterType,
+    GaugeType,
+    HistogramType
+  };
+
+  class Family {
+    public:
+      QString help;
+      MetricType type;
+
+      /**
+       * Labels and the slot holding each series
+       */
+      QMap<QString, int> series;
+  };
+
+  class ThreadSlots;
+
+  /**
+   * Never destroyed, as threads may exit after static destruction
+   */
+  class Registry {
+    public:
+      Registry() : next_slot(0)
+      {
+        for(int idx = 0; idx < Metrics::MaxSlots; idx++) {
+          retired[idx] = 0;
+          gauges[idx] = 0;
+        }
+      }
+
+      QMutex mutex;
+      QMap<QString, Family> families;
+      QList<ThreadSlots *> threads;
+      int next_slot;
+
+      /**
+       * Totals of threads that have exited
+       */
+      qint64 retired[Metrics::MaxSlots];
+
+      /**
+       * Gauge values, written and read with mutex held
+       */
+      qint64 gauges[Metrics::MaxSlots];
+  };
+
+  Registry &GetRegistry()
+  {
+    static Registry *registry = new Registry();
+    return *registry;
+  }
+
+  /**
+   * A thread's values, only that thread writes them but scrapes read them
+   * from other threads, so both sides take mutex. It is only contended
+   * during a scrape. When both are needed, the registry mutex is taken
+   * first.
+   */
+  class ThreadSlots {
+    public:
+      ThreadSlots()
+      {
+        for(int idx = 0; idx < Metrics::MaxSlots; idx++) {
+          values[idx] = 0;
+        }
+
+        Registry &registry = GetRegistry();
+        QMutexLocker locker(&registry.mutex);
+        registry.threads.append(this);
+      }
+
+      ~ThreadSlots()
+      {
+        Registry &registry = GetRegistry();
+        QMutexLocker locker(&registry.mutex);
+        QMutexLocker values_locker(&mutex);
+        for(int idx = 0; idx < registry.next_slot; idx++) {
+          registry.retired[idx] += values[idx];
+        }
+        registry.threads.removeOne(this);
+      }
+
+      QMutex mutex;
+      qint64 values[Metrics::MaxSlots];
+  };
+
+  inline ThreadSlots *GetThreadSlots()
+  {
+    static QThreadStorage<ThreadSlots *> storage;
+    if(!storage.hasLocalData()) {
+      storage.setLocalData(new ThreadSlots());
+    }
+    return storage.localData();
+  }
+
+  int Register(MetricType type, const QString &name, const QString &help,
+      const QString &labels)
+  {
+    Registry &registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    if(registry.families.contains(name)) {
+      const Family &family = registry.families[name];
+      if(family.type != type) {
+        qWarning() << "Metric" << name << "registered with another type";
+        return -1;
+      }
+
+      int slot = family.series.value(labels, -1);
+      if(slot != -1) {
+        return slot;
+      }
+    }
+
+    int size = type == HistogramType ? Metrics::BucketCount + 2 : 1;
+    if(registry.next_slot + size > Metrics::MaxSlots) {
+      qWarning() << "Out of metric slots, dropping" << name << labels;
+      return -1;
+    }
+
+    Family &family = registry.families[name];
+    family.help = help;
+    family.type = type;
+
+    int slot = registry.next_slot;
+    registry.next_slot += size;
+    family.series[labels] = slot;
+    return slot;
+  }
+
+  /**
+   * Sums a slot over all threads, the registry must be locked
+   */
+  qint64 Sum(const Registry &registry, int slot)
+  {
+    qint64 sum = registry.retired[slot];
+    foreach(ThreadSlots *thread, registry.threads) {
+      QMutexLocker locker(&thread->mutex);
+      sum += thread->values[slot];
+    }
+    return sum;
+  }
+
+  QString Series(const QString &name, const QString &labels)
+  {
+    return labels.isEmpty() ? name : name + "{" + labels + "}";
+  }
+
+  QString Seconds(qint64 usecs)
+  {
+    return QString::number(usecs / 1000000.0, 'g', 12);
+  }
+}
+
+  void Metrics::Counter::Add(qint64 value) const
+  {
+    if(_slot < 0) {
+      return;
+    }
+    ThreadSlots *thread_slots = GetThreadSlots();
+    QMutexLocker locker(&thread_slots->mutex);
+    thread_slots->values[_slot] += value;
+  }
+
+  void Metrics::Gauge::Set(qint64 value) const
+  {
+    if(_slot < 0) {
+      return;
+    }
+    Registry &registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+    registry.gauges[_slot] = value;
+  }
+
+  void Metrics::Histogram::Observe(qint64 usecs) const
+  {
+    if(_slot < 0) {
+      return;
+    }
+
+    int bucket = 0;
+    while(bucket < BucketCount - 1 && usecs > BucketBounds[bucket]) {
+      bucket++;
+    }
+
+    ThreadSlots *thread_slots = GetThreadSlots();
+    QMutexLocker locker(&thread_slots->mutex);
+    qint64 *values = thread_slots->values;
+    values[_slot + bucket]++;
+    values[_slot + BucketCount] += usecs;
+    values[_slot + BucketCount + 1]++;
+  }
+
+  Metrics::Counter Metrics::GetCounter(const QString &name,
+      const QString &help, const QString &labels)
+  {
+    return Counter(Register(CounterType, name, help, labels));
+  }
+
+  Metrics::Gauge Metrics::GetGauge(const QString &name,
+      const QString &help, const QString &labels)
+  {
+    return Gauge(Register(GaugeType, name, help, labels));
+  }
+
+  Metrics::Histogram Metrics::GetHistogram(const QString &name,
+      const QString &help, const QString &labels)
+  {
+    return Histogram(Register(HistogramType, name, help, labels));
+  }
+
+  QString Metrics::Label(const QString &key, const QString &value)
+  {
+    QString escaped = value;
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+    return key + "=\"" + escaped + "\"";
+  }
+
+  QString Metrics::Scrape()
+  {
+    static const char *types[] = { "counter", "gauge", "histogram" };
+
+    QString output;
+    QTextStream stream(&output);
+
+    Registry &registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    QMap<QString, Family>::const_iterator family;
+    for(family = registry.families.constBegin();
+        family != registry.families.constEnd(); family++)
+    {
+      const QString &name = family.key();
+      stream << "# HELP " << name << " " << family->help << "\n";
+      stream << "# TYPE " << name << " " << types[family->type] << "\n";
+
+      QMap<QString, int>::const_iterator series;
+      for(series = family->series.constBegin();
+          series != family->series.constEnd(); series++)
+      {
+        const QString &labels = series.key();
+        int slot = series.value();
+
+        if(family->type == CounterType) {
+          stream << Series(name, labels) << " " << Sum(registry, slot) << "\n";
+          continue;
+        } else if(family->type == GaugeType) {
+          stream << Series(name, labels) << " " << registry.gauges[slot] << "\n";
+          continue;
+        }
+
+        QString prefix = labels.isEmpty() ? QString() : labels + ",";
+        qint64 cumulative = 0;
+        for(int bucket = 0; bucket < BucketCount; bucket++) {
+          cumulative += Sum(registry, slot + bucket);
+          QString bound = bucket < BucketCount - 1 ?
+            Seconds(BucketBounds[bucket]) : QString("+Inf");
+          stream << Series(name + "_bucket", prefix + Label("le", bound)) <<
+            " " << cumulative << "\n";
+        }
+
+        stream << Series(name + "_sum", labels) << " " <<
+          Seconds(Sum(registry, slot + BucketCount)) << "\n";
+        stream << Series(name + "_count", labels) << " " <<
+          Sum(registry, slot + BucketCount + 1) << "\n";
+      }
+    }
+
+    stream.flush();
+    return output;
+  }
+}
+}
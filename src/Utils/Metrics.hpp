@@ -0,0 +1,171 @@
+#ifndef DISSENT_UTILS_METRICS_H_GUARD
+#define DISSENT_UTILS_METRICS_H_GUARD
+
+#include <QElapsedTimer>
+#include <QString>
+
+namespace Dissent {
+namespace Utils {
+  /**
+   * A process wide registry of counters, gauges, and latency histograms
+   * exported in the Prometheus text format. Counters and histograms are
+   * kept per thread behind a per thread mutex and summed when scraped, so
+   * updating them costs a thread local lookup and an uncontended lock. A
+   * gauge is set under the registry lock and the last writer wins.
+   *
+   * Metrics are identified by their name and labels, asking for a metric
+   * already registered returns the same one, so handles are best kept in
+   * function level statics or members. All series of a metric should use
+   * the same label names.
+   */
+  class Metrics {
+    public:
+      /**
+       * The number of values available to all metrics, a histogram takes
+       * BucketCount + 2 of them
+       */
+      static const int MaxSlots = 4096;
+
+      /**
+       * Histogram buckets, including +Inf
+       */
+      static const int BucketCount = 14;
+
+      /**
+       * Upper bounds of the finite buckets in microseconds
+       */
+      static const qint64 BucketBounds[BucketCount - 1];
+
+      /**
+       * A monotonically increasing value
+       */
+      class Counter {
+        public:
+          Counter() : _slot(-1) {}
+
+          /**
+           * Adds to the counter
+           * @param value the amount to add
+           */
+          void Add(qint64 value = 1) const;
+
+          inline bool IsValid() const { return _slot >= 0; }
+
+        private:
+          friend class Metrics;
+          explicit Counter(int slot) : _slot(slot) {}
+          int _slot;
+      };
+
+      /**
+       * A value that may go up and down
+       */
+      class Gauge {
+        public:
+          Gauge() : _slot(-1) {}
+
+          /**
+           * Sets the gauge
+           * @param value the new value
+           */
+          void Set(qint64 value) const;
+
+          inline bool IsValid() const { return _slot >= 0; }
+
+        private:
+          friend class Metrics;
+          explicit Gauge(int slot) : _slot(slot) {}
+          int _slot;
+      };
+
+      /**
+       * A distribution of durations over BucketBounds, exported in seconds
+       */
+      class Histogram {
+        public:
+          Histogram() : _slot(-1) {}
+
+          /**
+           * Records a duration
+           * @param usecs the duration in microseconds
+           */
+          void Observe(qint64 usecs) const;
+
+          inline bool IsValid() const { return _slot >= 0; }
+
+        private:
+          friend class Metrics;
+          explicit Histogram(int slot) : _slot(slot) {}
+          int _slot;
+      };
+
+      /**
+       * Observes the time between its construction and destruction
+       */
+      class ScopedTimer {
+        public:
+          explicit ScopedTimer(const Histogram &histogram) :
+            _histogram(histogram)
+          {
+            _timer.start();
+          }
+
+          ~ScopedTimer()
+          {
+            _histogram.Observe(_timer.nsecsElapsed() / 1000);
+          }
+
+        private:
+          const Histogram &_histogram;
+          QElapsedTimer _timer;
+      };
+
+      /**
+       * Returns a counter, registering it if necessary
+       * @param name the metric name, by convention ending in _total
+       * @param help a description of the metric
+       * @param labels the series' labels, see Label
+       */
+      static Counter GetCounter(const QString &name, const QString &help,
+          const QString &labels = QString());
+
+      /**
+       * Returns a gauge, registering it if necessary
+       * @param name the metric name
+       * @param help a description of the metric
+       * @param labels the series' labels, see Label
+       */
+      static Gauge GetGauge(const QString &name, const QString &help,
+          const QString &labels = QString());
+
+      /**
+       * Returns a histogram, registering it if necessary
+       * @param name the metric name, by convention ending in _seconds
+       * @param help a description of the metric
+       * @param labels the series' labels, see Label
+       */
+      static Histogram GetHistogram(const QString &name, const QString &help,
+          const QString &labels = QString());
+
+      /**
+       * Formats a label for a series, labels are joined by commas
+       * @param key the label name
+       * @param value the label value, escaped as necessary
+       */
+      static QString Label(const QString &key, const QString &value);
+
+      /**
+       * Returns all metrics in the Prometheus text exposition format
+       */
+      static QString Scrape();
+
+    private:
+      /**
+       * No instances
+       */
+      Metrics();
+  };
+}
+}
+
+#endif
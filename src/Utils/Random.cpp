@@ -1,16 +1,33 @@
 #include <time.h>
 #include <QtGlobal>
 #include <QDebug>
+#include <QThread>
+#include <QThreadStorage>
 
 #include "Random.hpp"
 #include "Serialization.hpp"
 
 namespace Dissent {
 namespace Utils {
+namespace {
+  QThreadStorage<Random *> &GetThreadRandoms()
+  {
+    static QThreadStorage<Random *> randoms;
+    return randoms;
+  }
+}
+
   Random &Random::GetInstance()
   {
-    static Random rand;
-    return rand;
+    QThreadStorage<Random *> &randoms = GetThreadRandoms();
+    if(!randoms.hasLocalData()) {
+      // Threads started within the same second must not share a sequence
+      QByteArray seed(8, 0);
+      Serialization::WriteUInt(time(NULL), seed, 0);
+      Serialization::WriteUInt(qHash(QThread::currentThread()), seed, 4);
+      randoms.setLocalData(new Random(seed));
+    }
+    return *randoms.localData();
   }
 
   Random::Random(const QByteArray &seed, uint index) :
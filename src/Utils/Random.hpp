@@ -3,14 +3,18 @@
 
 #include <stdlib.h>
 #include <QByteArray>
+#include <QtGlobal>
 
 namespace Dissent {
 namespace Utils {
   /**
-   * Random number generator -- base class is a singleton
+   * Random number generator -- base class is a per-thread singleton
    */
   class Random {
     public:
+      /**
+       * Returns the calling thread's instance
+       */
       static Random &GetInstance();
 
       /**
@@ -49,6 +53,19 @@ namespace Utils {
        */
       inline uint BytesGenerated() { return _byte_count; }
 
+      /**
+       * Returns true if the rng supports random access through Seek
+       */
+      virtual bool IsSeekable() const { return false; }
+
+      /**
+       * Moves the rng to an absolute byte offset of its output, so that the
+       * next GenerateBlock returns the bytes starting at offset
+       * @param offset the byte offset from the start of the output
+       * @returns false if the rng does not support random access
+       */
+      virtual bool Seek(qint64) { return false; }
+
     protected:
       Random(const Random &) {}
       /**
@@ -56,6 +73,11 @@ namespace Utils {
        */
       inline void IncrementByteCount(uint count) { _byte_count+= count; }
 
+      /**
+       * Sets the amount of bytes generated thus far, used after seeking
+       */
+      inline void SetByteCount(uint count) { _byte_count = count; }
+
       /**
        * Moves the rng to specified position
        * @param index the position
@@ -0,0 +1,177 @@
+#include <QQueue>
+#include <QSharedPointer>
+
+#include "SimulatedCpu.hpp"
+#include "Time.hpp"
+#include "Timer.hpp"
+
+namespace Dissent {
+namespace Utils {
+namespace {
+  /**
+   * Roughly 1024-bit RSA and DH on one core and SHA-1 at 200 MB/s
+   */
+  const qint64 DefaultCosts[SimulatedCpu::OperationCount] = {
+    1000, 50, 50, 1000, 500, 5
+  };
+
+  class CpuState {
+    public:
+      CpuState() : enabled(false), node(-1), start(0), pending(0), total(0)
+      {
+        for(int idx = 0; idx < SimulatedCpu::OperationCount; idx++) {
+          costs[idx] = DefaultCosts[idx];
+        }
+      }
+
+      bool enabled;
+      qint64 costs[SimulatedCpu::OperationCount];
+      QHash<int, qint64> busy;
+      QHash<int, QQueue<QSharedPointer<TimerCallback> > > waiting;
+      int node;
+      qint64 start;
+      qint64 pending;
+      qint64 total;
+  };
+
+  CpuState &GetState()
+  {
+    static CpuState state;
+    return state;
+  }
+
+  /**
+   * Wakes a node once it is no longer busy
+   */
+  class RunWaitingCallback : public TimerCallback {
+    public:
+      typedef void (*Function)(int node);
+
+      RunWaitingCallback(Function function, int node) :
+        _function(function), _node(node)
+      {
+      }
+
+      virtual void Invoke()
+      {
+        _function(_node);
+      }
+
+    private:
+      Function _function;
+      int _node;
+  };
+}
+
+  void SimulatedCpu::SetEnabled(bool enabled)
+  {
+    CpuState &state = GetState();
+    state.enabled = enabled;
+    state.busy.clear();
+    state.waiting.clear();
+    state.node = -1;
+    state.pending = 0;
+    state.total = 0;
+  }
+
+  bool SimulatedCpu::Enabled()
+  {
+    return GetState().enabled;
+  }
+
+  void SimulatedCpu::SetCost(Operation op, qint64 usecs)
+  {
+    GetState().costs[op] = usecs;
+  }
+
+  qint64 SimulatedCpu::GetCost(Operation op)
+  {
+    return GetState().costs[op];
+  }
+
+  void SimulatedCpu::Charge(Operation op, int count)
+  {
+    CpuState &state = GetState();
+    if(!state.enabled || state.node == -1) {
+      return;
+    }
+
+    qint64 cost = state.costs[op] * count;
+    state.pending += cost;
+    state.total += cost;
+  }
+
+  void SimulatedCpu::Begin(int node)
+  {
+    CpuState &state = GetState();
+    state.node = node;
+    state.start = Time::GetInstance().MSecsSinceEpoch() * 1000;
+    state.pending = 0;
+  }
+
+  void SimulatedCpu::End()
+  {
+    CpuState &state = GetState();
+    if(state.node != -1 && state.pending) {
+      state.busy[state.node] = state.start + state.pending;
+    }
+    state.node = -1;
+    state.pending = 0;
+  }
+
+  void SimulatedCpu::Run(int node, TimerCallback *callback)
+  {
+    QQueue<QSharedPointer<TimerCallback> > &waiting = GetState().waiting[node];
+    waiting.enqueue(QSharedPointer<TimerCallback>(callback));
+
+    // Otherwise the node is already working through its queue
+    if(waiting.count() == 1) {
+      RunWaiting(node);
+    }
+  }
+
+  void SimulatedCpu::RunWaiting(int node)
+  {
+    CpuState &state = GetState();
+    while(state.waiting.contains(node)) {
+      qint64 now = Time::GetInstance().MSecsSinceEpoch() * 1000;
+      qint64 busy = BusyUntil(node);
+      if(busy > now) {
+        Timer::GetInstance().QueueCallback(
+            new RunWaitingCallback(&SimulatedCpu::RunWaiting, node),
+            int((busy - now + 999) / 1000));
+        return;
+      }
+
+      // Stays queued while it runs, so that Run does not start another pass
+      QSharedPointer<TimerCallback> callback = state.waiting[node].head();
+      Begin(node);
+      callback->Invoke();
+      End();
+
+      QQueue<QSharedPointer<TimerCallback> > &waiting = state.waiting[node];
+      if(!waiting.isEmpty() && waiting.head() == callback) {
+        waiting.dequeue();
+      }
+      if(waiting.isEmpty()) {
+        state.waiting.remove(node);
+      }
+    }
+  }
+
+  qint64 SimulatedCpu::Pending()
+  {
+    return GetState().pending;
+  }
+
+  qint64 SimulatedCpu::BusyUntil(int node)
+  {
+    return GetState().busy.value(node, 0);
+  }
+
+  qint64 SimulatedCpu::TotalCharged()
+  {
+    return GetState().total;
+  }
+}
+}
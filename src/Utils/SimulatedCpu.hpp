@@ -0,0 +1,119 @@
+#ifndef DISSENT_UTILS_SIMULATED_CPU_H_GUARD
+#define DISSENT_UTILS_SIMULATED_CPU_H_GUARD
+
+#include <QHash>
+#include <QtGlobal>
+
+#include "TimerCallback.hpp"
+
+namespace Dissent {
+namespace Utils {
+  /**
+   * Charges virtual CPU time for operations that a simulation performs
+   * instantly, such as the NullLibrary's stand-in crypto. While a node
+   * handles an event, every charged operation adds to the event's pending
+   * time; messages the node sends are delayed by the time pending when
+   * they are sent and the node handles no further events until all of it
+   * has passed. Operations charged outside of an event are not attributed
+   * to any node and are dropped. Disabled by default, meant for single
+   * threaded simulations in virtual time.
+   */
+  class SimulatedCpu {
+    public:
+      /**
+       * Operations with a cost
+       */
+      enum Operation {
+        Sign = 0,
+        Verify,
+        Encrypt,
+        Decrypt,
+        KeyExchange,
+        /**
+         * Charged per KiB hashed
+         */
+        Hash,
+        OperationCount
+      };
+
+      /**
+       * Enables or disables charging, clearing all state
+       */
+      static void SetEnabled(bool enabled);
+
+      /**
+       * True if operations are charged
+       */
+      static bool Enabled();
+
+      /**
+       * Sets the cost of an operation
+       * @param op the operation
+       * @param usecs microseconds per operation or unit
+       */
+      static void SetCost(Operation op, qint64 usecs);
+
+      /**
+       * Returns the cost of an operation in microseconds
+       */
+      static qint64 GetCost(Operation op);
+
+      /**
+       * Charges the current event for an operation if enabled
+       * @param op the operation
+       * @param count the number of operations or units
+       */
+      static void Charge(Operation op, int count = 1);
+
+      /**
+       * Starts an event handled by a node
+       * @param node identifies the node
+       */
+      static void Begin(int node);
+
+      /**
+       * Ends the current event, keeping the node busy for the time charged
+       */
+      static void End();
+
+      /**
+       * Handles the callback as an event of the node once the node is no
+       * longer busy and the callbacks given to it before have been handled,
+       * so that a busy node handles messages in the order they arrived
+       * @param node identifies the node
+       * @param callback the event, owned by the SimulatedCpu
+       */
+      static void Run(int node, TimerCallback *callback);
+
+      /**
+       * Returns the microseconds charged during the current event
+       */
+      static qint64 Pending();
+
+      /**
+       * Returns the virtual time, in microseconds since the epoch, at which
+       * the node has finished all charged work
+       */
+      static qint64 BusyUntil(int node);
+
+      /**
+       * Returns the total microseconds charged since charging was enabled
+       */
+      static qint64 TotalCharged();
+
+    private:
+      /**
+       * Handles the node's waiting callbacks until it is busy
+       * @param node identifies the node
+       */
+      static void RunWaiting(int node);
+
+      /**
+       * No instances
+       */
+      SimulatedCpu();
+  };
+}
+}
+
+#endif
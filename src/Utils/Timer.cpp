@@ -1,14 +1,23 @@
 #include <QDebug>
+#include <QThreadStorage>
 
 #include "Sleeper.hpp"
 #include "Timer.hpp"
 
 namespace Dissent {
 namespace Utils {
-  Timer::Timer() : _next_timer(-1)
+namespace {
+  QThreadStorage<Timer *> &GetThreadTimers()
+  {
+    static QThreadStorage<Timer *> timers;
+    return timers;
+  }
+}
+
+  Timer::Timer() : _next_timer(-1), _next_run(0)
   {
     _queue = TimerQueue(&(TimerEvent::ReverseComparer));
-    _real_time = true;
+    _real_time = Time::GetInstance().UsingRealTime();
   }
 
   Timer::~Timer()
@@ -18,18 +27,42 @@ namespace Utils {
 
   Timer& Timer::GetInstance()
   {
-    static Timer timer;
-    return timer;
+    QThreadStorage<Timer *> &timers = GetThreadTimers();
+    if(!timers.hasLocalData()) {
+      timers.setLocalData(new Timer());
+    }
+    return *timers.localData();
+  }
+
+  void Timer::SetQueueType(QueueType type)
+  {
+    Clear();
+    if(type == WheelQueue) {
+      _wheel.reset(new TimerWheel());
+    } else {
+      _wheel.reset();
+    }
+  }
+
+  int Timer::QueuedCount() const
+  {
+    return _wheel ? _wheel->Count() : static_cast<int>(_queue.size());
   }
 
   void Timer::QueueEvent(TimerEvent te)
   {
-    _queue.push(te);
-    if(_queue.top() == te && _real_time) {
+    if(_wheel) {
+      _wheel->Insert(te);
+    } else {
+      _queue.push(te);
+    }
+
+    if(_real_time && (_next_timer == -1 || te.GetNextRun() < _next_run)) {
       if(_next_timer != -1) {
         killTimer(_next_timer);
       }
       _next_timer = startTimer(0);
+      _next_run = Time::GetInstance().MSecsSinceEpoch();
     }
   }
 
@@ -88,14 +121,27 @@ namespace Utils {
   void Timer::timerEvent(QTimerEvent *event)
   {
     killTimer(event->timerId());
+    _next_timer = -1;
+
     qint64 next = Run();
+    // Callbacks queueing new events may have armed a timer
+    if(_next_timer != -1) {
+      killTimer(_next_timer);
+      _next_timer = -1;
+    }
+
     if(next > -1) {
       _next_timer = startTimer(next);
+      _next_run = Time::GetInstance().MSecsSinceEpoch() + next;
     }
   }
 
   qint64 Timer::Run()
   {
+    if(_wheel) {
+      return RunWheel();
+    }
+
     int next = -1;
 
     while(true) {
@@ -119,6 +165,23 @@ namespace Utils {
     return next;
   }
 
+  qint64 Timer::RunWheel()
+  {
+    while(true) {
+      qint64 now = Time::GetInstance().MSecsSinceEpoch();
+      if(!_wheel->HasDue(now)) {
+        qint64 next = _wheel->NextRun();
+        return next == -1 ? -1 : next - now;
+      }
+
+      TimerEvent te = _wheel->PopDue();
+      te.Run();
+      if(te.GetPeriod() > 0) {
+        _wheel->Insert(te);
+      }
+    }
+  }
+
   qint64 Timer::VirtualRun()
   {
     if(_real_time) {
@@ -143,6 +206,9 @@ namespace Utils {
     }
     _next_timer = -1;
     _queue = TimerQueue(&(TimerEvent::ReverseComparer));
+    if(_wheel) {
+      _wheel->Clear();
+    }
   }
 }
 }
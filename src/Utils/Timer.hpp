@@ -5,29 +5,70 @@
 #include <vector>
 
 #include <QObject>
+#include <QScopedPointer>
 #include <QTimerEvent>
 #include <QThread>
 
 #include "TimerCallback.hpp"
 #include "Time.hpp"
 #include "TimerEvent.hpp"
+#include "TimerWheel.hpp"
 
 namespace Dissent {
 namespace Utils {
   /**
-   * Timers should be allocated on a per-thread basis or this class needs to be
-   * made thread-safe ... currently this is not thread-safe and is only a
-   * singleton...
+   * Schedules callbacks on the event loop of the calling thread. Each
+   * thread has its own Timer, returned by GetInstance, which is not
+   * thread-safe: events must be queued and stopped from the thread that
+   * owns the Timer they were queued on.
    */
   class Timer : public QObject {
     Q_OBJECT
 
     public:
       /**
-       * Returns the Timer singleton
+       * The data structure used to store queued events
+       */
+      enum QueueType {
+        /**
+         * A binary heap, stopped events remain until they are due
+         */
+        HeapQueue,
+        /**
+         * A hierarchical timing wheel, stopped events are removed immediately
+         */
+        WheelQueue
+      };
+
+      /**
+       * Returns the calling thread's Timer, created on first use with the
+       * current real or virtual time setting of Time
        */
       static Timer& GetInstance();
 
+      /**
+       * Destructor, a thread's Timer is destroyed when the thread exits
+       */
+      virtual ~Timer();
+
+      /**
+       * Selects the event store, clears all queued events and therefore
+       * should be called at startup
+       * @param type the event store to use
+       */
+      void SetQueueType(QueueType type);
+
+      /**
+       * Returns the event store in use
+       */
+      inline QueueType GetQueueType() const { return _wheel ? WheelQueue : HeapQueue; }
+
+      /**
+       * Returns the number of queued events, including stopped events
+       * waiting in the heap
+       */
+      int QueuedCount() const;
+
       /**
        * Timer and Time will be using virtual time
        */
@@ -93,15 +134,10 @@ namespace Utils {
 
     protected:
       /**
-       * Singleton, disabled
+       * Per-thread singleton, disabled
        */
       explicit Timer();
 
-      /**
-       * Singleton, protected
-       */
-      virtual ~Timer();
-
       /**
        * Singleton, disabled
        */
@@ -123,6 +159,11 @@ namespace Utils {
        */
       TimerQueue _queue;
 
+      /**
+       * Timing wheel for storing the Timers, if selected
+       */
+      QScopedPointer<TimerWheel> _wheel;
+
       /**
        * Currently using real time
        */
@@ -139,12 +180,22 @@ namespace Utils {
        */
       qint64 Run();
 
+      /**
+       * Run for the timing wheel
+       */
+      qint64 RunWheel();
+
       /**
        * The QThread interface
        */
       virtual void timerEvent(QTimerEvent *event);
 
       int _next_timer;
+
+      /**
+       * When the Qt timer identified by _next_timer is due
+       */
+      qint64 _next_run;
   };
 }
 }
@@ -1,8 +1,9 @@
 #include "TimerEvent.hpp"
+#include "TimerWheel.hpp"
 
 namespace Dissent {
 namespace Utils {
-  int TimerEventData::_uid_count = 0;
+  QAtomicInt TimerEventData::_uid_count(0);
 
   TimerEvent::TimerEvent() : _state(new TimerEventData(0, 0, 0))
   {
@@ -27,9 +28,16 @@ namespace Utils {
   {
   }
 
+  TimerEvent::TimerEvent(TimerEventData *state) : _state(state)
+  {
+  }
+
   void TimerEvent::Stop()
   {
     _state->stopped = true;
+    if(_state->wheel) {
+      _state->wheel->Remove(_state.data());
+    }
   }
 
   void TimerEvent::Run()
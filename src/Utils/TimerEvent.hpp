@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include <QtCore>
+#include <QAtomicInt>
 #include <QSharedData>
 #include <QSharedDataPointer>
 #include <QSharedPointer>
@@ -13,6 +14,8 @@
 
 namespace Dissent {
 namespace Utils {
+  class TimerWheel;
+
   /**
    * Private data for TimerEvent, so that Pointers for TimerEvents are not requried
    */
@@ -24,7 +27,11 @@ namespace Utils {
         next(next),
         period(period),
         stopped(callback == 0),
-        uid(_uid_count++)
+        uid(_uid_count.fetchAndAddOrdered(1)),
+        wheel(0),
+        slot(0),
+        prev_link(0),
+        next_link(0)
       {
       }
 
@@ -34,7 +41,11 @@ namespace Utils {
         next(next),
         period(period),
         stopped(callback == 0),
-        uid(_uid_count++)
+        uid(_uid_count.fetchAndAddOrdered(1)),
+        wheel(0),
+        slot(0),
+        prev_link(0),
+        next_link(0)
       {
       }
 
@@ -46,6 +57,15 @@ namespace Utils {
       bool stopped;
       int uid;
 
+      /**
+       * The TimerWheel holding this event, if any, and the event's position
+       * within it
+       */
+      TimerWheel *wheel;
+      TimerEventData **slot;
+      TimerEventData *prev_link;
+      TimerEventData *next_link;
+
       TimerEventData(const TimerEventData &other) : QSharedData(other)
       {
         throw std::logic_error("Not callable");
@@ -57,7 +77,7 @@ namespace Utils {
       }
 
       private:
-        static int _uid_count;
+        static QAtomicInt _uid_count;
   };
 
   /**
@@ -65,6 +85,7 @@ namespace Utils {
    */
   class TimerEvent {
     friend class Timer;
+    friend class TimerWheel;
 
     public:
       explicit TimerEvent();
@@ -87,6 +108,7 @@ namespace Utils {
       TimerEvent(TimerCallback *callback, int due_time, int period = 0);
       TimerEvent(const QSharedPointer<TimerCallback> &callback, int due_time,
           int period = 0);
+      explicit TimerEvent(TimerEventData *state);
       void Run();
       QExplicitlySharedDataPointer<TimerEventData> _state;
   };
@@ -0,0 +1,206 @@
+#include <string.h>
+
+#include "Time.hpp"
+#include "TimerWheel.hpp"
+
+namespace Dissent {
+namespace Utils {
+  TimerWheel::TimerWheel() :
+    _overflow(0),
+    _cursor(0),
+    _count(0),
+    _due(&(TimerEvent::ReverseComparer))
+  {
+    memset(_slots, 0, sizeof(_slots));
+  }
+
+  TimerWheel::~TimerWheel()
+  {
+    Clear();
+  }
+
+  void TimerWheel::Insert(const TimerEvent &event)
+  {
+    TimerEventData *data = event._state.data();
+    Q_ASSERT(data->wheel == 0);
+
+    // An empty wheel can be moved anywhere, keep the cursor at the present
+    // so that switching between real and virtual time is harmless
+    if(Count() == 0) {
+      _cursor = Time::GetInstance().MSecsSinceEpoch();
+    }
+
+    data->ref.ref();
+    Place(data);
+  }
+
+  void TimerWheel::Place(TimerEventData *data)
+  {
+    if(data->next <= _cursor) {
+      _due.push(TimerEvent(data));
+      data->ref.deref();
+      return;
+    }
+
+    TimerEventData **slot = &_overflow;
+    quint64 diff = static_cast<quint64>(data->next ^ _cursor);
+    if((diff >> (LEVELS * LEVEL_BITS)) == 0) {
+      int level = LEVELS - 1;
+      while(level > 0 && (diff >> (level * LEVEL_BITS)) == 0) {
+        level--;
+      }
+      slot = &_slots[level][SlotIndex(data->next, level)];
+    }
+
+    data->wheel = this;
+    data->slot = slot;
+    data->prev_link = 0;
+    data->next_link = *slot;
+    if(*slot) {
+      (*slot)->prev_link = data;
+    }
+    *slot = data;
+    _count++;
+  }
+
+  void TimerWheel::Remove(TimerEventData *data)
+  {
+    Q_ASSERT(data->wheel == this);
+
+    if(data->prev_link) {
+      data->prev_link->next_link = data->next_link;
+    } else {
+      *data->slot = data->next_link;
+    }
+
+    if(data->next_link) {
+      data->next_link->prev_link = data->prev_link;
+    }
+
+    data->wheel = 0;
+    data->slot = 0;
+    data->prev_link = 0;
+    data->next_link = 0;
+    _count--;
+
+    if(!data->ref.deref()) {
+      delete data;
+    }
+  }
+
+  void TimerWheel::Cascade(TimerEventData **slot)
+  {
+    TimerEventData *data = *slot;
+    *slot = 0;
+
+    while(data) {
+      TimerEventData *next = data->next_link;
+      data->wheel = 0;
+      data->slot = 0;
+      data->prev_link = 0;
+      data->next_link = 0;
+      _count--;
+      Place(data);
+      data = next;
+    }
+  }
+
+  void TimerWheel::MoveTo(qint64 time)
+  {
+    qint64 previous = _cursor;
+    _cursor = time;
+
+    if((previous >> (LEVELS * LEVEL_BITS)) != (time >> (LEVELS * LEVEL_BITS))) {
+      Cascade(&_overflow);
+    }
+
+    // Since there are no events before time, only the slots that the cursor
+    // now points into may hold events that belong on a lower wheel
+    for(int level = LEVELS - 1; level >= 0; level--) {
+      Cascade(&_slots[level][SlotIndex(time, level)]);
+    }
+  }
+
+  void TimerWheel::AdvanceTo(qint64 time)
+  {
+    while(_cursor < time) {
+      qint64 next = NextPending();
+      if(next == -1) {
+        _cursor = time;
+        break;
+      } else if(next > time) {
+        MoveTo(time);
+        break;
+      }
+      MoveTo(next);
+    }
+  }
+
+  bool TimerWheel::HasDue(qint64 now)
+  {
+    AdvanceTo(now);
+    return !_due.empty();
+  }
+
+  TimerEvent TimerWheel::PopDue()
+  {
+    TimerEvent event = _due.top();
+    _due.pop();
+    return event;
+  }
+
+  qint64 TimerWheel::Earliest(const TimerEventData *data)
+  {
+    qint64 earliest = data->next;
+    for(data = data->next_link; data; data = data->next_link) {
+      earliest = qMin(earliest, data->next);
+    }
+    return earliest;
+  }
+
+  qint64 TimerWheel::NextPending() const
+  {
+    if(_count == 0) {
+      return -1;
+    }
+
+    // Every event on a wheel is due before those on the wheels above it and
+    // the slots of a wheel are ordered from the cursor onward
+    for(int level = 0; level < LEVELS; level++) {
+      for(int idx = SlotIndex(_cursor, level) + 1; idx < SLOTS; idx++) {
+        if(_slots[level][idx]) {
+          return Earliest(_slots[level][idx]);
+        }
+      }
+    }
+
+    return _overflow ? Earliest(_overflow) : -1;
+  }
+
+  qint64 TimerWheel::NextRun() const
+  {
+    if(!_due.empty()) {
+      TimerEvent event = _due.top();
+      return event.GetNextRun();
+    }
+    return NextPending();
+  }
+
+  void TimerWheel::Clear()
+  {
+    for(int level = 0; level < LEVELS; level++) {
+      for(int idx = 0; idx < SLOTS; idx++) {
+        while(_slots[level][idx]) {
+          Remove(_slots[level][idx]);
+        }
+      }
+    }
+
+    while(_overflow) {
+      Remove(_overflow);
+    }
+
+    _due = DueQueue(&(TimerEvent::ReverseComparer));
+  }
+}
+}
@@ -0,0 +1,145 @@
+#ifndef DISSENT_UTILS_TIMER_WHEEL_H_GUARD
+#define DISSENT_UTILS_TIMER_WHEEL_H_GUARD
+
+#include <queue>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "TimerEvent.hpp"
+
+namespace Dissent {
+namespace Utils {
+  /**
+   * A hierarchical timing wheel with millisecond resolution.  Each of the
+   * LEVELS wheels has SLOTS slots and an event is stored in the slot of the
+   * lowest wheel that distinguishes its due time from the wheel's cursor, so
+   * inserting and cancelling an event are constant time operations.  As the
+   * cursor advances, the slots it enters on the higher wheels are cascaded
+   * down and the slots entered on the lowest wheel become due.  Events more
+   * than 2^32 ms out wait on an overflow list.
+   *
+   * Due events are returned in the same (due time, uid) order as the
+   * priority queue so that simulations remain deterministic.  Stopping an
+   * event removes it from the wheel immediately, see TimerEvent::Stop.
+   */
+  class TimerWheel {
+    public:
+      /**
+       * Constructor
+       */
+      explicit TimerWheel();
+
+      /**
+       * Destructor
+       */
+      ~TimerWheel();
+
+      /**
+       * Adds an event to the wheel
+       * @param event the event to add
+       */
+      void Insert(const TimerEvent &event);
+
+      /**
+       * Removes a stopped event from the wheel, called by TimerEvent::Stop
+       * @param data the event's private data
+       */
+      void Remove(TimerEventData *data);
+
+      /**
+       * Advances the wheel to now and returns true if an event is due
+       * @param now the current time
+       */
+      bool HasDue(qint64 now);
+
+      /**
+       * Removes and returns the earliest due event, must only be called after
+       * HasDue returns true
+       */
+      TimerEvent PopDue();
+
+      /**
+       * Returns the time of the earliest event or -1 if there are no events
+       */
+      qint64 NextRun() const;
+
+      /**
+       * Returns the number of events in the wheel
+       */
+      inline int Count() const { return _count + static_cast<int>(_due.size()); }
+
+      /**
+       * Removes all events from the wheel
+       */
+      void Clear();
+
+      /**
+       * Number of bits of the due time distinguished by each wheel
+       */
+      static const int LEVEL_BITS = 8;
+
+      /**
+       * Number of slots per wheel
+       */
+      static const int SLOTS = 1 << LEVEL_BITS;
+
+      /**
+       * Number of wheels
+       */
+      static const int LEVELS = 4;
+
+    private:
+      typedef std::priority_queue<TimerEvent, std::vector<TimerEvent>,
+              TimerEvent::ComparerFuncPtr> DueQueue;
+
+      /**
+       * Stores an event relative to the cursor, takes over one reference
+       */
+      void Place(TimerEventData *data);
+
+      /**
+       * Replaces all the events in a slot relative to the cursor
+       */
+      void Cascade(TimerEventData **slot);
+
+      /**
+       * Moves the cursor to time, placing all events up to and including
+       * time into the due queue
+       */
+      void AdvanceTo(qint64 time);
+
+      /**
+       * Moves the cursor to time, there must be no events between the cursor
+       * and time
+       */
+      void MoveTo(qint64 time);
+
+      /**
+       * Returns the time of the earliest event in the wheels or -1
+       */
+      qint64 NextPending() const;
+
+      /**
+       * Returns the earliest due time in a slot
+       */
+      static qint64 Earliest(const TimerEventData *data);
+
+      /**
+       * Returns the slot index for a time on a wheel
+       */
+      inline static int SlotIndex(qint64 time, int level)
+      {
+        return static_cast<int>((time >> (level * LEVEL_BITS)) & (SLOTS - 1));
+      }
+
+      TimerEventData *_slots[LEVELS][SLOTS];
+      TimerEventData *_overflow;
+      qint64 _cursor;
+      int _count;
+      DueQueue _due;
+  };
+}
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include <string.h>
+#include <QtGlobal>
+
+#include "Xor.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#ifdef __SSE2__
+#define DISSENT_XOR_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define DISSENT_XOR_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace Dissent {
+namespace Utils {
+namespace {
+  typedef void (*XorKernel)(char *dst, const char *t1, const char *t2,
+      int length);
+
+  /**
+   * Number of bytes of dst processed by XorAccumulate before moving on to
+   * the next block, sized to remain resident in L1
+   */
+  const int XOR_BLOCK_SIZE = 4096;
+
+  void XorWord(char *dst, const char *t1, const char *t2, int length)
+  {
+    int idx = 0;
+    for(; idx + 8 <= length; idx += 8) {
+      quint64 w1, w2;
+      memcpy(&w1, t1 + idx, 8);
+      memcpy(&w2, t2 + idx, 8);
+      w1 ^= w2;
+      memcpy(dst + idx, &w1, 8);
+    }
+
+    for(; idx < length; idx++) {
+      dst[idx] = t1[idx] ^ t2[idx];
+    }
+  }
+
+#ifdef DISSENT_XOR_SSE2
+  void XorSse2(char *dst, const char *t1, const char *t2, int length)
+  {
+    int idx = 0;
+    for(; idx + 16 <= length; idx += 16) {
+      __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(t1 + idx));
+      __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(t2 + idx));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + idx),
+          _mm_xor_si128(v1, v2));
+    }
+
+    XorWord(dst + idx, t1 + idx, t2 + idx, length - idx);
+  }
+#endif
+
+#ifdef DISSENT_XOR_AVX2
+  __attribute__((target("avx2")))
+  void XorAvx2(char *dst, const char *t1, const char *t2, int length)
+  {
+    int idx = 0;
+    for(; idx + 64 <= length; idx += 64) {
+      __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(t1 + idx));
+      __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(t2 + idx));
+      __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(t1 + idx + 32));
+      __m256i v4 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(t2 + idx + 32));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + idx),
+          _mm256_xor_si256(v1, v2));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + idx + 32),
+          _mm256_xor_si256(v3, v4));
+    }
+
+    for(; idx + 32 <= length; idx += 32) {
+      __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(t1 + idx));
+      __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(t2 + idx));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + idx),
+          _mm256_xor_si256(v1, v2));
+    }
+
+    XorWord(dst + idx, t1 + idx, t2 + idx, length - idx);
+  }
+#endif
+
+  /**
+   * Chooses the widest kernel supported by the running processor
+   */
+  class KernelSelection {
+    public:
+      KernelSelection()
+      {
+#ifdef DISSENT_XOR_AVX2
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) {
+          name = "avx2";
+          kernel = &XorAvx2;
+          return;
+        }
+#endif
+#ifdef DISSENT_XOR_SSE2
+        name = "sse2";
+        kernel = &XorSse2;
+#else
+        name = "word";
+        kernel = &XorWord;
+#endif
+      }
+
+      const char *name;
+      XorKernel kernel;
+  };
+
+  inline const KernelSelection &GetSelection()
+  {
+    static KernelSelection selection;
+    return selection;
+  }
+}
+
+  void XorBytes(char *dst, const char *t1, const char *t2, int length)
+  {
+    GetSelection().kernel(dst, t1, t2, length);
+  }
+
+  void XorBytes(QByteArray &dst, const QByteArray &t1, const QByteArray &t2)
+  {
+    int count = qMin(dst.size(), t1.size());
+    count = qMin(count, t2.size());
+    if(count <= 0) {
+      return;
+    }
+
+    // Detach dst before reading the sources, in case they share data
+    char *out = dst.data();
+    GetSelection().kernel(out, t1.constData(), t2.constData(), count);
+  }
+
+  void XorAccumulate(QByteArray &dst, const QList<QByteArray> &srcs)
+  {
+    const int length = dst.size();
+    if(length == 0 || srcs.isEmpty()) {
+      return;
+    }
+
+    XorKernel kernel = GetSelection().kernel;
+    char *out = dst.data();
+    for(int offset = 0; offset < length; offset += XOR_BLOCK_SIZE) {
+      int block = qMin(XOR_BLOCK_SIZE, length - offset);
+      foreach(const QByteArray &src, srcs) {
+        int count = qMin(block, src.size() - offset);
+        if(count <= 0) {
+          continue;
+        }
+        kernel(out + offset, out + offset, src.constData() + offset, count);
+      }
+    }
+  }
+
+  QString XorKernelName()
+  {
+    return QString(GetSelection().name);
+  }
+}
+}
@@ -0,0 +1,48 @@
+#ifndef DISSENT_UTILS_XOR_H_GUARD
+#define DISSENT_UTILS_XOR_H_GUARD
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+namespace Dissent {
+namespace Utils {
+  /**
+   * Xors t1 and t2 into dst, dst[i] = t1[i] ^ t2[i].  dst may alias either
+   * t1 or t2.  Operates on machine words or vector registers (SSE2 / AVX2
+   * selected at runtime) rather than bytes.
+   * @param dst the destination buffer
+   * @param t1 lhs of the xor operation
+   * @param t2 rhs of the xor operation
+   * @param length the number of bytes to xor
+   */
+  void XorBytes(char *dst, const char *t1, const char *t2, int length);
+
+  /**
+   * Xor operator for QByteArrays, only the bytes common to all three arrays
+   * are modified
+   * @param dst the destination byte array
+   * @param t1 lhs of the xor operation
+   * @param t2 rhs of the xor operation
+   */
+  void XorBytes(QByteArray &dst, const QByteArray &t1, const QByteArray &t2);
+
+  /**
+   * Folds all the sources into dst, dst ^= srcs[0] ^ ... ^ srcs[n - 1].
+   * Rather than walking dst once per source, dst is processed in cache
+   * sized blocks and every source is applied to a block before moving on.
+   * Sources shorter than dst only affect their common prefix.
+   * @param dst the destination byte array
+   * @param srcs the byte arrays to xor into dst
+   */
+  void XorAccumulate(QByteArray &dst, const QList<QByteArray> &srcs);
+
+  /**
+   * Returns the name of the xor kernel selected for this machine, i.e.,
+   * "avx2", "sse2", or "word"
+   */
+  QString XorKernelName();
+}
+}
+
+#endif
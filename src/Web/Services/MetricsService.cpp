@@ -0,0 +1,16 @@
+#include "Utils/Metrics.hpp"
+
+#include "MetricsService.hpp"
+
+namespace Dissent {
+namespace Web {
+namespace Services {
+  void MetricsService::Handle(QSharedPointer<WebRequest> wrp)
+  {
+    wrp->GetOutputData().setValue(Utils::Metrics::Scrape());
+    wrp->SetStatus(HttpResponse::STATUS_OK);
+    emit FinishedWebRequest(wrp, false);
+  }
+}
+}
+}
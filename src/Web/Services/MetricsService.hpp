@@ -0,0 +1,33 @@
+#ifndef DISSENT_WEB_SERVICES_METRICS_SERVICE_GUARD
+#define DISSENT_WEB_SERVICES_METRICS_SERVICE_GUARD
+
+#include <QObject>
+
+#include "WebService.hpp"
+
+namespace Dissent {
+namespace Web {
+namespace Services {
+  /**
+   * WebService returning the process' metrics in the Prometheus text format
+   */
+  class MetricsService : public WebService {
+    public:
+      explicit MetricsService() {}
+
+      virtual ~MetricsService() {}
+
+    private:
+      /**
+       * The main method for the web service. If the status code wrp->status
+       * is not STATUS_OK, then the output data might not be set.
+       * @param request to be handled
+       */
+      virtual void Handle(QSharedPointer<WebRequest> wrp);
+  };
+
+}
+}
+}
+
+#endif
@@ -51,6 +51,7 @@ HEADERS += ext/googletest/include/gtest/gtest-death-test.h \
 
 SOURCES += ext/googletest/src/gtest-all.cc \
            src/Tests/AddressTest.cpp \
+           src/Tests/ArenaTest.cpp \
            src/Tests/AuthenticateTest.cpp \
            src/Tests/Base64.cpp \
            src/Tests/BasicGossipTest.cpp \
@@ -67,8 +68,11 @@ SOURCES += ext/googletest/src/gtest-all.cc \
            src/Tests/Crypto.cpp \
            src/Tests/CSBulkRoundTest.cpp \
            src/Tests/CSOverlayTest.cpp \
+           src/Tests/DnsCacheTest.cpp \
+           src/Tests/DownstreamSchedulerTest.cpp \
            src/Tests/DsaCryptoTest.cpp \
            src/Tests/EdgeTest.cpp \
+           src/Tests/EnvelopeTest.cpp \
            src/Tests/GroupTest.cpp \
            src/Tests/HashTest.cpp \
            src/Tests/HttpRequestTest.cpp \
@@ -77,9 +81,11 @@ SOURCES += ext/googletest/src/gtest-all.cc \
            src/Tests/IntegerTest.cpp \
            src/Tests/IntegerGroupTest.cpp \
            src/Tests/KeyShareTest.cpp \
+           src/Tests/LoggingTest.cpp \
            src/Tests/LogTest.cpp \
            src/Tests/LRSTest.cpp \
            src/Tests/MainTest.cpp \
+           src/Tests/MetricsTest.cpp \
            src/Tests/NeffKeyShuffleTest.cpp \
            src/Tests/NeffShuffleRoundTest.cpp \
            src/Tests/NullRoundTest.cpp \
@@ -97,10 +103,12 @@ SOURCES += ext/googletest/src/gtest-all.cc \
            src/Tests/SerializationTest.cpp \
            src/Tests/SettingsTest.cpp \
            src/Tests/ShuffleRoundTest.cpp \
+           src/Tests/SimulatedCpuTest.cpp \
            src/Tests/TcpTest.cpp \
            src/Tests/TestNode.cpp \
            src/Tests/TestWebClient.cpp \
            src/Tests/TimeTest.cpp \
            src/Tests/TripleTest.cpp \
            src/Tests/WebServerTest.cpp \
-           src/Tests/WebServicesTest.cpp
+           src/Tests/WebServicesTest.cpp \
+           src/Tests/XorTest.cpp
@@ -0,0 +1,126 @@
+#include <QDateTime>
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  /**
+   * Reports the allocations and time taken by work with and without arenas
+   */
+  template<typename F> void CountAllocations(const char *name, F work)
+  {
+    for(int pass = 0; pass < 2; pass++) {
+      bool enabled = pass == 1;
+      Arena::SetEnabled(enabled);
+      Arena::ResetCounters();
+      Arena::SetCounting(true);
+
+      qint64 start = QDateTime::currentMSecsSinceEpoch();
+      work();
+      qint64 end = QDateTime::currentMSecsSinceEpoch();
+
+      Arena::SetCounting(false);
+      qDebug() << name << (enabled ? "arena" : "heap") <<
+        "heap allocations" << Arena::GetHeapAllocations() <<
+        "arena allocations" << Arena::GetArenaAllocations() <<
+        "blocks" << Arena::GetBlockAllocations() <<
+        "ms" << (end - start);
+    }
+    Arena::SetEnabled(true);
+  }
+
+  class NeffShuffleWork {
+    public:
+      NeffShuffleWork(int values, int keys)
+      {
+        QSharedPointer<CppDsaPrivateKey> base_key(new CppDsaPrivateKey());
+        Integer modulus = base_key->GetModulus();
+        Integer generator = base_key->GetGenerator();
+        Integer subgroup = base_key->GetSubgroup();
+
+        for(int idx = 0; idx < keys; idx++) {
+          pr_keys.append(QSharedPointer<CppDsaPrivateKey>(new CppDsaPrivateKey(
+                  modulus, subgroup, generator)));
+          pub_keys.append(QSharedPointer<AsymmetricKey>(pr_keys.last()->GetPublicKey()));
+        }
+
+        for(int idx = 0; idx < values; idx++) {
+          Integer value = generator.Pow(Integer::GetRandomInteger(0, subgroup), modulus);
+          input.append(CppDsaPublicKey::SeriesEncrypt(pub_keys, value.GetByteArray()));
+        }
+      }
+
+      void operator()()
+      {
+        CppNeffShuffle shuffle;
+        QVector<QByteArray> output;
+        QByteArray proof;
+        QVector<QSharedPointer<AsymmetricKey> > remaining = pub_keys;
+        remaining.pop_front();
+        EXPECT_TRUE(shuffle.Shuffle(input, pr_keys[0], remaining, output, proof));
+        EXPECT_TRUE(shuffle.Verify(input, pub_keys, proof, output));
+      }
+
+      QVector<QSharedPointer<CppDsaPrivateKey> > pr_keys;
+      QVector<QSharedPointer<AsymmetricKey> > pub_keys;
+      QVector<QByteArray> input;
+  };
+
+  TEST(Arena, CppNeffShuffle)
+  {
+    NeffShuffleWork work(1000, 4);
+    CountAllocations("CppNeffShuffle", work);
+  }
+
+  class ClientCiphertextWork {
+    public:
+      explicit ClientCiphertextWork(const QSharedPointer<const BlogDrop::Parameters> &params) :
+        params(params)
+      {
+        typedef BlogDrop::PrivateKey PrivateKey;
+        typedef BlogDrop::PublicKey PublicKey;
+
+        QSharedPointer<const PrivateKey> author_priv(new PrivateKey(params));
+        author_pk = QSharedPointer<const PublicKey>(new PublicKey(author_priv));
+
+        QList<QSharedPointer<const PublicKey> > server_pks;
+        for(int idx = 0; idx < 8; idx++) {
+          QSharedPointer<const PrivateKey> priv(new PrivateKey(params));
+          server_pks.append(QSharedPointer<const PublicKey>(new PublicKey(priv)));
+        }
+        server_pk_set = QSharedPointer<const BlogDrop::PublicKeySet>(
+            new BlogDrop::PublicKeySet(params, server_pks));
+
+        client_priv = QSharedPointer<const PrivateKey>(new PrivateKey(params));
+        client_pub = QSharedPointer<const PublicKey>(new PublicKey(client_priv));
+      }
+
+      void operator()()
+      {
+        for(int idx = 0; idx < 20; idx++) {
+          QSharedPointer<BlogDrop::ClientCiphertext> c =
+            BlogDrop::CiphertextFactory::CreateClientCiphertext(params,
+                server_pk_set, author_pk);
+          c->SetProof(0, client_priv);
+          EXPECT_TRUE(c->VerifyProof(0, client_pub));
+        }
+      }
+
+      QSharedPointer<const BlogDrop::Parameters> params;
+      QSharedPointer<const BlogDrop::PublicKey> author_pk;
+      QSharedPointer<const BlogDrop::PublicKeySet> server_pk_set;
+      QSharedPointer<const BlogDrop::PrivateKey> client_priv;
+      QSharedPointer<const BlogDrop::PublicKey> client_pub;
+  };
+
+  TEST(Arena, ElGamalClientCiphertext)
+  {
+    ClientCiphertextWork integer(BlogDrop::Parameters::IntegerElGamalTesting());
+    CountAllocations("ElGamalClientCiphertext integer", integer);
+
+    ClientCiphertextWork ec(BlogDrop::Parameters::CppECElGamalProduction());
+    CountAllocations("ElGamalClientCiphertext ec", ec);
+  }
+
+}
+}
@@ -0,0 +1,201 @@
+#include <QDateTime>
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  using Anonymity::BlogDropPrivate::SlotCiphertext;
+  using Anonymity::BlogDropPrivate::SlotValidation;
+
+  /**
+   * The state of one server in a BlogDropRound with every slot open:
+   * every client's ciphertexts for every slot and the ciphertexts the other
+   * servers produced for them
+   */
+  class ServerPhases {
+    public:
+      ServerPhases(const QSharedPointer<const Parameters> &params,
+          int nclients, int nservers) :
+        nclients(nclients)
+      {
+        QList<QSharedPointer<const PrivateKey> > client_sks;
+        for(int idx = 0; idx < nclients; idx++) {
+          QSharedPointer<const PrivateKey> priv(new PrivateKey(params));
+          client_sks.append(priv);
+          client_pks.append(QSharedPointer<const PublicKey>(new PublicKey(priv)));
+        }
+
+        QList<QSharedPointer<const PrivateKey> > server_sks;
+        for(int idx = 0; idx < nservers; idx++) {
+          QSharedPointer<const PrivateKey> priv(new PrivateKey(params));
+          server_sks.append(priv);
+          server_pks.append(QSharedPointer<const PublicKey>(new PublicKey(priv)));
+        }
+
+        QSharedPointer<const PublicKeySet> server_pk_set(
+            new PublicKeySet(params, server_pks));
+
+        Library *lib = CryptoFactory::GetInstance().GetLibrary();
+        QScopedPointer<Dissent::Utils::Random> rand(lib->GetRandomNumberGenerator());
+
+        // One slot per client, each slot owned by its own author
+        for(int slot_idx = 0; slot_idx < nclients; slot_idx++) {
+          QSharedPointer<Parameters> slot_params(new Parameters(*params));
+          QSharedPointer<const PrivateKey> author_priv(new PrivateKey(params));
+          QSharedPointer<const PublicKey> author_pk(new PublicKey(author_priv));
+
+          BlogDropAuthor author(slot_params, client_sks[slot_idx],
+              server_pk_set, author_priv);
+          QByteArray msg(author.MaxPlaintextLength(), 0);
+          rand->GenerateBlock(msg);
+
+          QList<QByteArray> ctexts;
+          for(int client_idx = 0; client_idx < nclients; client_idx++) {
+            QByteArray c;
+            if(client_idx == slot_idx) {
+              author.GenerateAuthorCiphertext(c, msg);
+            } else {
+              c = BlogDropClient(slot_params, client_sks[client_idx],
+                  server_pk_set, author_pk).GenerateCoverCiphertext();
+            }
+            ctexts.append(c);
+          }
+          client_ctexts.append(ctexts);
+
+          QList<QSharedPointer<BlogDropServer> > slot_servers;
+          for(int server_idx = 0; server_idx < nservers; server_idx++) {
+            slot_servers.append(QSharedPointer<BlogDropServer>(new BlogDropServer(
+                    QSharedPointer<Parameters>(new Parameters(*params)),
+                    server_sks[server_idx], server_pk_set, author_pk)));
+          }
+          servers.append(slot_servers);
+        }
+      }
+
+      /**
+       * Runs the server ciphertext phase on every server, returning the
+       * time taken by the first
+       */
+      qint64 GenerateServerCiphertexts()
+      {
+        server_ctexts.clear();
+        qint64 elapsed = 0;
+
+        for(int server_idx = 0; server_idx < server_pks.count(); server_idx++) {
+          QList<SlotCiphertext> open_slots;
+          for(int slot_idx = 0; slot_idx < nclients; slot_idx++) {
+            servers[slot_idx][server_idx]->ClearBin();
+
+            SlotCiphertext slot;
+            slot.slot_idx = slot_idx;
+            slot.server = servers[slot_idx][server_idx];
+            slot.client_ctexts = client_ctexts[slot_idx];
+            slot.client_pks = client_pks;
+            slot.verify_proofs = true;
+            open_slots.append(slot);
+          }
+
+          qint64 start = QDateTime::currentMSecsSinceEpoch();
+          Anonymity::BlogDropPrivate::CloseSlots(open_slots);
+          if(server_idx == 0) {
+            elapsed = QDateTime::currentMSecsSinceEpoch() - start;
+          }
+
+          QList<QByteArray> ctexts;
+          foreach(const SlotCiphertext &slot, open_slots) {
+            ctexts.append(slot.server_ctext);
+          }
+          server_ctexts.append(ctexts);
+        }
+
+        return elapsed;
+      }
+
+      /**
+       * Runs the validation phase on the first server, returning the time
+       * taken
+       */
+      qint64 GenerateServerValidation()
+      {
+        QList<SlotValidation> open_slots;
+        for(int slot_idx = 0; slot_idx < nclients; slot_idx++) {
+          SlotValidation slot;
+          slot.slot_idx = slot_idx;
+          slot.server = servers[slot_idx][0];
+          for(int server_idx = 0; server_idx < server_pks.count(); server_idx++) {
+            slot.server_ctexts.append(server_ctexts[server_idx][slot_idx]);
+          }
+          slot.server_pks = server_pks;
+          slot.valid = false;
+          slot.revealed = false;
+          open_slots.append(slot);
+        }
+
+        qint64 start = QDateTime::currentMSecsSinceEpoch();
+        Anonymity::BlogDropPrivate::RevealSlots(open_slots);
+        qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - start;
+
+        foreach(const SlotValidation &slot, open_slots) {
+          EXPECT_TRUE(slot.valid);
+          EXPECT_TRUE(slot.revealed);
+        }
+
+        return elapsed;
+      }
+
+      const int nclients;
+      QList<QSharedPointer<const PublicKey> > client_pks;
+      QList<QSharedPointer<const PublicKey> > server_pks;
+
+      /* list[slot][client] */
+      QList<QList<QByteArray> > client_ctexts;
+      /* list[slot][server] */
+      QList<QList<QSharedPointer<BlogDropServer> > > servers;
+      /* list[server][slot] */
+      QList<QList<QByteArray> > server_ctexts;
+  };
+
+  /**
+   * Times both server phases of a BlogDropRound with every slot open, single
+   * and multithreaded, as the number of clients (and so slots) grows
+   */
+  void BenchmarkServerPhases(const QSharedPointer<const Parameters> &params)
+  {
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::ThreadingType tt = cf.GetThreadingType();
+
+    qDebug() << "BlogDropRound" << params->ToString() <<
+      "threads" << QThread::idealThreadCount();
+
+    for(int nclients = 4; nclients <= 32; nclients *= 2) {
+      ServerPhases phases(params, nclients, 3);
+
+      for(int pass = 0; pass < 2; pass++) {
+        bool multi = pass == 1;
+        cf.SetThreading(multi ? CryptoFactory::MultiThreaded :
+            CryptoFactory::SingleThreaded);
+
+        qint64 ciphertext = phases.GenerateServerCiphertexts();
+        qint64 validation = phases.GenerateServerValidation();
+
+        qDebug() << "clients" << nclients <<
+          (multi ? "multi" : "single") <<
+          "server ciphertext ms" << ciphertext <<
+          "server validation ms" << validation;
+      }
+    }
+
+    cf.SetThreading(tt);
+  }
+
+  TEST(BlogDropRound, IntegerElGamalServerPhases)
+  {
+    BenchmarkServerPhases(Parameters::IntegerElGamalTesting());
+  }
+
+  TEST(BlogDropRound, CppECElGamalServerPhases)
+  {
+    BenchmarkServerPhases(Parameters::CppECElGamalProduction());
+  }
+}
+}
@@ -0,0 +1,63 @@
+#include <QDateTime>
+#include "EdgeBench.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  // Messages of increasing size pushed through a loopback TcpEdge, keeping a
+  // bounded amount of data in flight
+  TEST(TcpEdge, Throughput) {
+    const qint64 total = 256 * 1024 * 1024;
+    const qint64 window = 32 * 1024 * 1024;
+
+    Timer::GetInstance().UseRealTime();
+
+    TcpEdgeListener el0(TcpAddress("127.0.0.1", 0));
+    EdgeCollector ec0(&el0);
+    el0.Start();
+
+    TcpEdgeListener el1(TcpAddress("127.0.0.1", 0));
+    EdgeCollector ec1(&el1);
+    el1.Start();
+
+    el1.CreateEdgeTo(el0.GetAddress());
+    while(ec0.edge.isNull() || ec1.edge.isNull()) {
+      QCoreApplication::processEvents();
+    }
+
+    CountingSink sink;
+    ec0.edge->SetSink(&sink);
+
+    CppRandom rand;
+    for(int size = 1024; size <= 8 * 1024 * 1024; size *= 8) {
+      QByteArray msg(size, 0);
+      rand.GenerateBlock(msg);
+
+      const int count = total / size;
+      sink.count = 0;
+      sink.bytes = 0;
+      int sent = 0;
+
+      qint64 start = QDateTime::currentMSecsSinceEpoch();
+      while(sink.count < count) {
+        while(sent < count && qint64(sent - sink.count) * size < window) {
+          ec1.edge->Send(msg);
+          sent++;
+        }
+        QCoreApplication::processEvents();
+      }
+      qint64 end = QDateTime::currentMSecsSinceEpoch();
+
+      EXPECT_EQ(sink.bytes, qint64(count) * size);
+      double mbytes = double(sink.bytes) / (1024.0 * 1024.0);
+      qDebug() << "TcpEdge message size" << size << "messages" << count <<
+        "MB/s" << mbytes / (qMax(end - start, qint64(1)) / 1000.0);
+    }
+
+    ec1.edge->Stop("Finished");
+    el0.Stop();
+    el1.Stop();
+  }
+
+}
+}
@@ -0,0 +1,54 @@
+#ifndef DISSENT_UTILS_BENCH_EDGE_BENCH_H_GUARD
+#define DISSENT_UTILS_BENCH_EDGE_BENCH_H_GUARD
+
+#include <QObject>
+#include <QSharedPointer>
+
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+  /**
+   * Stores the most recent edge created by an EdgeListener
+   */
+  class EdgeCollector : public QObject {
+    Q_OBJECT
+
+    public:
+      explicit EdgeCollector(EdgeListener *el)
+      {
+        QObject::connect(el, SIGNAL(NewEdge(const QSharedPointer<Edge> &)),
+            this, SLOT(HandleEdge(const QSharedPointer<Edge> &)));
+      }
+
+      virtual ~EdgeCollector() {}
+      QSharedPointer<Edge> edge;
+
+    private slots:
+      void HandleEdge(const QSharedPointer<Edge> &edge)
+      {
+        this->edge = edge;
+      }
+  };
+
+  /**
+   * Counts the messages and bytes received from a source
+   */
+  class CountingSink : public ISinkObject {
+    public:
+      CountingSink() : count(0), bytes(0) {}
+
+      virtual void HandleData(const QSharedPointer<ISender> &,
+          const QByteArray &data)
+      {
+        count++;
+        bytes += data.size();
+      }
+
+      int count;
+      qint64 bytes;
+  };
+}
+}
+
+#endif
@@ -0,0 +1,68 @@
+#include <QDateTime>
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  // Hash many client sized seeds one at a time and in a single batch
+  void HashThroughput(CryptoFactory::HashName name, const QString &label)
+  {
+    const int length = 64;
+    const int ninputs = 4096;
+    const int iterations = 64;
+
+    CppRandom rand;
+    QVector<QByteArray> inputs;
+    for(int idx = 0; idx < ninputs; idx++) {
+      QByteArray input(length, 0);
+      rand.GenerateBlock(input);
+      inputs.append(input);
+    }
+
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::HashName hname = cf.GetHashName();
+    cf.SetHash(name);
+    QScopedPointer<Hash> hashalgo(cf.GetLibrary()->GetHashAlgorithm());
+    cf.SetHash(hname);
+
+    const double mhashes = double(ninputs) * iterations / 1000000.0;
+
+    QVector<QByteArray> single(ninputs);
+    qint64 start = QDateTime::currentMSecsSinceEpoch();
+    for(int iter = 0; iter < iterations; iter++) {
+      for(int idx = 0; idx < ninputs; idx++) {
+        single[idx] = hashalgo->ComputeHash(inputs[idx]);
+      }
+    }
+    qint64 end = QDateTime::currentMSecsSinceEpoch();
+    double one = mhashes / (qMax(end - start, qint64(1)) / 1000.0);
+
+    QVector<QByteArray> batch;
+    start = QDateTime::currentMSecsSinceEpoch();
+    for(int iter = 0; iter < iterations; iter++) {
+      batch = hashalgo->ComputeHashes(inputs);
+    }
+    end = QDateTime::currentMSecsSinceEpoch();
+    double many = mhashes / (qMax(end - start, qint64(1)) / 1000.0);
+
+    EXPECT_EQ(single, batch);
+
+    qDebug() << "Hash:" << label << "length" << length << "inputs" <<
+      ninputs << "single Mhash/s" << one << "batch Mhash/s" << many;
+  }
+
+  TEST(Hash, Sha1Throughput) {
+    HashThroughput(CryptoFactory::Sha1, "sha1");
+  }
+
+  TEST(Hash, Sha256Throughput) {
+    HashThroughput(CryptoFactory::Sha256, "sha256");
+  }
+
+  TEST(Hash, Blake2bThroughput) {
+    HashThroughput(CryptoFactory::Blake2b, "blake2b " +
+        Blake2bHash::BatchKernelName());
+  }
+
+}
+}
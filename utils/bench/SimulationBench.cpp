@@ -0,0 +1,169 @@
+#include <QDateTime>
+#include <QVector>
+
+#include "SimulationBench.hpp"
+#include "TestNode.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+  using Tests::CleanUp;
+  using Tests::ConstructOverlay;
+  using Tests::CreateSessions;
+  using Tests::SessionCreator;
+  using Tests::TestNode;
+
+  /**
+   * Returns an integer from the environment or the default when unset
+   */
+  qint64 SimulationSetting(const char *name, qint64 def)
+  {
+    QByteArray value = qgetenv(name);
+    bool ok = false;
+    qint64 result = value.toLongLong(&ok);
+    return ok ? result : def;
+  }
+
+  /**
+   * Simulates a session of the given round on nodes connected by a
+   * TieredLinkModel, every node sending one message, with the NullLibrary
+   * standing in for crypto and SimulatedCpu charging its cost. Reports the
+   * simulated time between the batches of messages node 0 receives, each
+   * batch being the output of one phase, and the goodput.
+   *
+   * Overridden by the environment: DISSENT_SIM_NODES, DISSENT_SIM_MESSAGE
+   * (bytes), DISSENT_SIM_SERVER_LATENCY and DISSENT_SIM_CLIENT_LATENCY (ms),
+   * DISSENT_SIM_SERVER_BANDWIDTH and DISSENT_SIM_CLIENT_BANDWIDTH (bytes
+   * per second) and DISSENT_SIM_LIMIT (simulated seconds).
+   */
+  void SimulateRound(const QString &name, SessionCreator callback,
+      Group::SubgroupPolicy sg_policy, int default_count)
+  {
+    int count = SimulationSetting("DISSENT_SIM_NODES", default_count);
+    int msg_size = SimulationSetting("DISSENT_SIM_MESSAGE", 1024);
+    qint64 limit = SimulationSetting("DISSENT_SIM_LIMIT", 3600) * 1000;
+
+    // Matches the server selection of ConstructOverlay, a complete group
+    // only has client links
+    int servers = sg_policy == Group::ManagedSubgroup ?
+      qMax(3, count / 10) : 0;
+
+    BufferEdgeListener::SetLinkModel(QSharedPointer<BufferLinkModel>(
+          new TieredLinkModel(servers,
+            SimulationSetting("DISSENT_SIM_SERVER_LATENCY", 10),
+            SimulationSetting("DISSENT_SIM_SERVER_BANDWIDTH", 125000000),
+            SimulationSetting("DISSENT_SIM_CLIENT_LATENCY", 50),
+            SimulationSetting("DISSENT_SIM_CLIENT_BANDWIDTH", 1250000))));
+
+    CryptoFactory &cf = CryptoFactory::GetInstance();
+    CryptoFactory::LibraryName cname = cf.GetLibraryName();
+    cf.SetLibrary(CryptoFactory::Null);
+
+    ConnectionManager::UseTimer = false;
+    Timer::GetInstance().UseVirtualTime();
+
+    qint64 wall_start = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<TestNode *> nodes;
+    Group group;
+    ConstructOverlay(count, nodes, group, sg_policy);
+    CreateSessions(nodes, group, Id(), callback);
+
+    Library *lib = cf.GetLibrary();
+    QScopedPointer<Dissent::Utils::Random> rand(lib->GetRandomNumberGenerator());
+    for(int idx = 0; idx < count; idx++) {
+      QByteArray msg(msg_size, 0);
+      rand->GenerateBlock(msg);
+      nodes[idx]->session->Send(msg);
+    }
+
+    DeliveryRecorder recorder(&nodes[0]->sink);
+    SimulatedCpu::SetEnabled(true);
+    TestNode::calledback = TestNode::failure = TestNode::success = 0;
+
+    qint64 start = Time::GetInstance().MSecsSinceEpoch();
+    for(int idx = 0; idx < count; idx++) {
+      nodes[idx]->session->Start();
+    }
+
+    qint64 next = Timer::GetInstance().VirtualRun();
+    while(next != -1 && recorder.GetDeliveries().count() < count &&
+        Time::GetInstance().MSecsSinceEpoch() - start < limit)
+    {
+      Time::GetInstance().IncrementVirtualClock(next);
+      next = Timer::GetInstance().VirtualRun();
+    }
+
+    qint64 cpu = SimulatedCpu::TotalCharged();
+    SimulatedCpu::SetEnabled(false);
+
+    const QList<DeliveryRecorder::Delivery> &deliveries = recorder.GetDeliveries();
+    EXPECT_EQ(count, deliveries.count());
+
+    qDebug() << name << "nodes:" << count << "servers:" << servers <<
+      "message bytes:" << msg_size;
+
+    qint64 phase_start = start;
+    qint64 bytes = 0;
+    int phase = 0;
+    for(int idx = 0; idx < deliveries.count(); phase++) {
+      qint64 time = deliveries[idx].time;
+      int messages = 0;
+      qint64 phase_bytes = 0;
+      for(; idx < deliveries.count() && deliveries[idx].time == time; idx++) {
+        messages++;
+        phase_bytes += deliveries[idx].bytes;
+      }
+      bytes += phase_bytes;
+
+      qDebug() << name << "phase" << phase << "latency ms:" <<
+        (time - phase_start) << "messages:" << messages << "bytes:" << phase_bytes;
+      phase_start = time;
+    }
+
+    qint64 elapsed = qMax(phase_start - start, qint64(1));
+    qDebug() << name << "simulated ms:" << elapsed <<
+      "goodput KB/s:" << (double(bytes) / 1024.0) / (elapsed / 1000.0) <<
+      "rounds finished:" << TestNode::calledback <<
+      "simulated cpu ms:" << cpu / 1000;
+
+    CleanUp(nodes);
+    qDebug() << name << "wall ms:" <<
+      (QDateTime::currentMSecsSinceEpoch() - wall_start);
+
+    ConnectionManager::UseTimer = true;
+    BufferEdgeListener::SetLinkModel(QSharedPointer<BufferLinkModel>());
+    cf.SetLibrary(cname);
+  }
+
+  TEST(Simulation, NullRound)
+  {
+    SimulateRound("NullRound", SessionCreator(TCreateRound<NullRound>),
+        Group::CompleteGroup, 200);
+  }
+
+  TEST(Simulation, CSBulkRound)
+  {
+    SimulateRound("CSBulkRound", SessionCreator(TCreateRound<CSBulkRound>),
+        Group::ManagedSubgroup, 1000);
+  }
+
+  TEST(Simulation, BlogDropRound)
+  {
+    SimulateRound("BlogDropRound",
+        SessionCreator(TCreateBlogDropRound_Testing<BlogDropRound>),
+        Group::ManagedSubgroup, 100);
+  }
+
+  TEST(Simulation, ShuffleRound)
+  {
+    SimulateRound("ShuffleRound", SessionCreator(TCreateRound<ShuffleRound>),
+        Group::CompleteGroup, 50);
+  }
+
+  TEST(Simulation, NeffShuffle)
+  {
+    SimulateRound("NeffShuffle", SessionCreator(TCreateRound<NeffShuffle>),
+        Group::ManagedSubgroup, 500);
+  }
+}
+}
@@ -0,0 +1,98 @@
+#ifndef DISSENT_UTILS_BENCH_SIMULATION_BENCH_H_GUARD
+#define DISSENT_UTILS_BENCH_SIMULATION_BENCH_H_GUARD
+
+#include <QList>
+#include <QObject>
+
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+  /**
+   * Server to server links are fast, links with a client are slow, following
+   * the BufferAddress ids assigned by ConstructOverlay, where servers come
+   * first
+   */
+  class TieredLinkModel : public BufferLinkModel {
+    public:
+      /**
+       * Constructor
+       * @param servers the number of servers, ids 1 to servers
+       * @param server_latency ms between servers
+       * @param server_bandwidth bytes per second between servers
+       * @param client_latency ms between a client and a server
+       * @param client_bandwidth bytes per second between a client and a server
+       */
+      TieredLinkModel(int servers, int server_latency, qint64 server_bandwidth,
+          int client_latency, qint64 client_bandwidth) :
+        _servers(servers),
+        _server_latency(server_latency),
+        _server_bandwidth(server_bandwidth),
+        _client_latency(client_latency),
+        _client_bandwidth(client_bandwidth)
+      {
+      }
+
+      virtual ~TieredLinkModel() {}
+
+      virtual int GetLatency(int from, int to)
+      {
+        return Servers(from, to) ? _server_latency : _client_latency;
+      }
+
+      virtual qint64 GetBandwidth(int from, int to)
+      {
+        return Servers(from, to) ? _server_bandwidth : _client_bandwidth;
+      }
+
+    private:
+      inline bool Servers(int from, int to) const
+      {
+        return from <= _servers && to <= _servers;
+      }
+
+      int _servers;
+      int _server_latency;
+      qint64 _server_bandwidth;
+      int _client_latency;
+      qint64 _client_bandwidth;
+  };
+
+  /**
+   * Records the virtual time and size of every message a sink receives
+   */
+  class DeliveryRecorder : public QObject {
+    Q_OBJECT
+
+    public:
+      typedef struct {
+        qint64 time;
+        int bytes;
+      } Delivery;
+
+      explicit DeliveryRecorder(BufferSink *sink) : _sink(sink)
+      {
+        QObject::connect(sink, SIGNAL(DataReceived()), this, SLOT(Record()));
+      }
+
+      virtual ~DeliveryRecorder() {}
+
+      inline const QList<Delivery> &GetDeliveries() const { return _deliveries; }
+
+    private slots:
+      void Record()
+      {
+        Delivery delivery;
+        delivery.time = Time::GetInstance().MSecsSinceEpoch();
+        delivery.bytes = _sink->Last().second.size();
+        _deliveries.append(delivery);
+      }
+
+    private:
+      BufferSink *_sink;
+      QList<Delivery> _deliveries;
+  };
+}
+}
+
+#endif
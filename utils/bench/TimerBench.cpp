@@ -0,0 +1,83 @@
+#include <QDateTime>
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  class TimerCounter {
+    public:
+      TimerCounter() : count(0) {}
+
+      void Increment(const int &)
+      {
+        count++;
+      }
+
+      int count;
+  };
+
+  /**
+   * Queues and cancels 1M request timeouts, as RpcHandler does for each
+   * request answered before its timeout, then drains the queue
+   */
+  void QueueCancel(Timer::QueueType type, const char *name)
+  {
+    const int operations = 1000 * 1000;
+    const int window = 64;
+
+    Timer &timer = Timer::GetInstance();
+    timer.UseVirtualTime();
+    timer.SetQueueType(type);
+
+    TimerCounter counter;
+    QSharedPointer<TimerCallback> cb(new TimerMethod<TimerCounter, int>(
+          &counter, &TimerCounter::Increment, 0));
+
+    QVector<TimerEvent> outstanding(window);
+    int max_queued = 0;
+
+    qint64 start = QDateTime::currentMSecsSinceEpoch();
+    for(int idx = 0; idx < operations; idx++) {
+      // Keep a window of outstanding requests, answering the oldest
+      TimerEvent &slot = outstanding[idx % window];
+      slot.Stop();
+      slot = timer.QueueCallback(cb, 60000 + (idx % 1000));
+      if(idx % 1000 == 0) {
+        Time::GetInstance().IncrementVirtualClock(1);
+        timer.VirtualRun();
+        max_queued = qMax(max_queued, timer.QueuedCount());
+      }
+    }
+
+    foreach(TimerEvent event, outstanding) {
+      event.Stop();
+    }
+    qint64 queued = QDateTime::currentMSecsSinceEpoch();
+    int remaining = timer.QueuedCount();
+
+    qint64 next = timer.VirtualRun();
+    while(next != -1) {
+      Time::GetInstance().IncrementVirtualClock(next);
+      next = timer.VirtualRun();
+    }
+    qint64 drained = QDateTime::currentMSecsSinceEpoch();
+
+    EXPECT_EQ(0, counter.count);
+    EXPECT_EQ(0, timer.QueuedCount());
+
+    qDebug() << name << "queue/cancel ops/s" <<
+      (operations * 1000.0 / qMax(queued - start, qint64(1))) <<
+      "max queued" << max_queued << "queued after cancel" << remaining <<
+      "drain ms" << (drained - queued);
+
+    timer.SetQueueType(Timer::HeapQueue);
+  }
+
+  TEST(Timer, QueueCancel)
+  {
+    QueueCancel(Timer::HeapQueue, "heap");
+    QueueCancel(Timer::WheelQueue, "wheel");
+  }
+
+}
+}
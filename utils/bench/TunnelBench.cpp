@@ -0,0 +1,98 @@
+#include <QDateTime>
+#include "TunnelBench.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  /**
+   * Reads exactly count bytes from the socket, running the event loop
+   * while waiting
+   */
+  QByteArray ReadBytes(QTcpSocket &socket, int count)
+  {
+    while(socket.bytesAvailable() < count) {
+      QCoreApplication::processEvents();
+    }
+    return socket.read(count);
+  }
+
+  /**
+   * Echoes bytes through a SocksConnection and the request path of an exit,
+   * keeping a bounded amount of data in flight, and returns MB/s
+   */
+  double TunnelThroughput(bool macs, qint64 total)
+  {
+    const qint64 window = 1024 * 1024;
+    const int chunk = 64 * 1024;
+
+    SocksConnection::SetSymmetricAuthentication(macs);
+
+    EchoServer echo;
+    SocksAcceptor acceptor;
+
+    QTcpSocket client;
+    client.connectToHost(QHostAddress::LocalHost, acceptor.server.serverPort());
+    while(!acceptor.socket) {
+      QCoreApplication::processEvents();
+    }
+
+    SocksConnection *socks = new SocksConnection(acceptor.socket);
+    LoopbackExit exit(socks);
+    QObject::connect(socks, SIGNAL(UpstreamPacketReady(const QByteArray &)),
+        &exit, SLOT(UpstreamPacket(const QByteArray &)));
+
+    // SOCKS v5 without authentication, CONNECT to the IPv4 echo server
+    client.write(QByteArray::fromHex("050100"));
+    EXPECT_EQ(QByteArray::fromHex("0500"), ReadBytes(client, 2));
+
+    QByteArray request = QByteArray::fromHex("050100017f000001");
+    request.append(char(echo.server.serverPort() >> 8));
+    request.append(char(echo.server.serverPort() & 0xff));
+    client.write(request);
+    EXPECT_EQ(char(SocksConnection::SocksReply_Succeeded), ReadBytes(client, 10)[1]);
+
+    while(exit.socket.state() != QAbstractSocket::ConnectedState) {
+      QCoreApplication::processEvents();
+    }
+    EXPECT_EQ(macs, socks->UsesMacs());
+
+    CppRandom rand;
+    QByteArray msg(chunk, 0);
+    rand.GenerateBlock(msg);
+
+    qint64 sent = 0;
+    qint64 received = 0;
+
+    qint64 start = QDateTime::currentMSecsSinceEpoch();
+    while(received < total) {
+      while(sent < total && sent - received < window) {
+        client.write(msg);
+        sent += msg.size();
+      }
+      QCoreApplication::processEvents();
+      received += client.readAll().size();
+    }
+    qint64 end = QDateTime::currentMSecsSinceEpoch();
+
+    EXPECT_EQ(total, received);
+    EXPECT_EQ(0, exit.rejected);
+
+    client.close();
+    socks->Close();
+    delete socks;
+    SocksConnection::SetSymmetricAuthentication(false);
+
+    double mbytes = double(received) / (1024.0 * 1024.0);
+    return mbytes / (qMax(end - start, qint64(1)) / 1000.0);
+  }
+
+  TEST(Tunnel, Throughput)
+  {
+    Timer::GetInstance().UseRealTime();
+
+    qDebug() << "Tunnel signatures MB/s" << TunnelThroughput(false, 8 * 1024 * 1024);
+    qDebug() << "Tunnel MACs MB/s" << TunnelThroughput(true, 128 * 1024 * 1024);
+  }
+
+}
+}
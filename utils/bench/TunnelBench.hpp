@@ -0,0 +1,151 @@
+#ifndef DISSENT_UTILS_BENCH_TUNNEL_BENCH_H_GUARD
+#define DISSENT_UTILS_BENCH_TUNNEL_BENCH_H_GUARD
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+  /**
+   * Writes back everything its clients send
+   */
+  class EchoServer : public QObject {
+    Q_OBJECT
+
+    public:
+      EchoServer()
+      {
+        QObject::connect(&server, SIGNAL(newConnection()),
+            this, SLOT(HandleConnection()));
+        server.listen(QHostAddress::LocalHost, 0);
+      }
+
+      virtual ~EchoServer() {}
+      QTcpServer server;
+
+    private slots:
+      void HandleConnection()
+      {
+        QTcpSocket *socket = server.nextPendingConnection();
+        QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(Echo()));
+      }
+
+      void Echo()
+      {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        socket->write(socket->readAll());
+      }
+  };
+
+  /**
+   * The request path of an ExitTunnel without the Dissent session: upstream
+   * packets of a single SocksConnection are authenticated and forwarded to
+   * their destination, responses are handed straight back and acks are
+   * only checked
+   */
+  class LoopbackExit : public QObject {
+    Q_OBJECT
+
+    public:
+      explicit LoopbackExit(SocksConnection *socks) :
+        socks(socks),
+        rejected(0)
+      {
+        QObject::connect(&socket, SIGNAL(readyRead()), this, SLOT(ReadFromProxy()));
+      }
+
+      virtual ~LoopbackExit() {}
+
+      SocksConnection *socks;
+      QTcpSocket socket;
+      TunnelConnectionTable table;
+      int rejected;
+
+    public slots:
+      void UpstreamPacket(const QByteArray &bytes)
+      {
+        int bytes_read = 0;
+        QSharedPointer<Packet> pp(Packet::ReadPacket(bytes, bytes_read));
+        if(pp.isNull()) {
+          rejected++;
+          return;
+        }
+
+        if(pp->GetType() == Packet::PacketType_TcpStart) {
+          TcpStartPacket *sp = dynamic_cast<TcpStartPacket *>(pp.data());
+          table.SaveConnection(&socket, sp->GetConnectionId(), sp->GetVerificationKey());
+          socket.connectToHost(sp->GetHostName().GetAddress(), sp->GetHostName().GetPort());
+
+          if(!sp->GetKeyAgreement().isEmpty() &&
+              table.VerifyKeyAgreement(sp->GetConnectionId(),
+                sp->GetKeyAgreement(), sp->GetSignature()))
+          {
+            Downstream(KeyAgreementPacket(sp->GetConnectionId(),
+                  table.AgreeKey(&socket, sp->GetKeyAgreement())).ToByteArray());
+          }
+        } else if(pp->GetType() == Packet::PacketType_TcpRequest) {
+          TcpRequestPacket *rp = dynamic_cast<TcpRequestPacket *>(pp.data());
+          if(!table.VerifyRequest(rp->GetConnectionId(), rp->GetSequence(),
+                rp->GetRequestData(), rp->GetSignature()))
+          {
+            rejected++;
+            return;
+          }
+          socket.write(rp->GetRequestData());
+        } else if(pp->GetType() == Packet::PacketType_TcpAck) {
+          TcpAckPacket *ap = dynamic_cast<TcpAckPacket *>(pp.data());
+          if(!table.VerifyRequest(ap->GetConnectionId(), ap->GetSequence(),
+                ap->GetAuthenticatedBytes(), ap->GetSignature()))
+          {
+            rejected++;
+          }
+        }
+      }
+
+    private slots:
+      void ReadFromProxy()
+      {
+        Downstream(TcpResponsePacket(table.IdForConnection(&socket),
+              socket.readAll()).ToByteArray());
+      }
+
+    private:
+      void Downstream(const QByteArray &bytes)
+      {
+        int bytes_read = 0;
+        socks->IncomingDownstreamPacket(Packet::ReadPacket(bytes, bytes_read));
+      }
+  };
+
+  /**
+   * Accepts the SOCKS client's connection
+   */
+  class SocksAcceptor : public QObject {
+    Q_OBJECT
+
+    public:
+      SocksAcceptor() : socket(0)
+      {
+        QObject::connect(&server, SIGNAL(newConnection()),
+            this, SLOT(HandleConnection()));
+        server.listen(QHostAddress::LocalHost, 0);
+      }
+
+      virtual ~SocksAcceptor() {}
+      QTcpServer server;
+      QTcpSocket *socket;
+
+    private slots:
+      void HandleConnection()
+      {
+        socket = server.nextPendingConnection();
+      }
+  };
+}
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include <QDateTime>
+#include "Benchmark.hpp"
+
+namespace Dissent {
+namespace Benchmarks {
+
+  // Combine many client sized pads one at a time and in a single pass
+  TEST(Xor, Throughput) {
+    const int length = 64 * 1024;
+    const int nsources = 1024;
+    const int iterations = 16;
+
+    CppRandom rand;
+    QList<QByteArray> srcs;
+    for(int idx = 0; idx < nsources; idx++) {
+      QByteArray src(length, 0);
+      rand.GenerateBlock(src);
+      srcs.append(src);
+    }
+
+    const double gbytes = double(length) * nsources * iterations /
+      (1024.0 * 1024.0 * 1024.0);
+
+    QByteArray dst(length, 0);
+    qint64 start = QDateTime::currentMSecsSinceEpoch();
+    for(int iter = 0; iter < iterations; iter++) {
+      foreach(const QByteArray &src, srcs) {
+        XorBytes(dst, dst, src);
+      }
+    }
+    qint64 end = QDateTime::currentMSecsSinceEpoch();
+    double pairwise = gbytes / (qMax(end - start, qint64(1)) / 1000.0);
+
+    QByteArray acc(length, 0);
+    start = QDateTime::currentMSecsSinceEpoch();
+    for(int iter = 0; iter < iterations; iter++) {
+      XorAccumulate(acc, srcs);
+    }
+    end = QDateTime::currentMSecsSinceEpoch();
+    double accumulate = gbytes / (qMax(end - start, qint64(1)) / 1000.0);
+
+    EXPECT_EQ(dst, acc);
+
+    qDebug() << "Xor kernel:" << XorKernelName() << "length" << length <<
+      "sources" << nsources << "pairwise GB/s" << pairwise <<
+      "accumulate GB/s" << accumulate;
+  }
+
+}
+}